@@ -0,0 +1,355 @@
+// Microbenchmark runner: calibration, cycle counting, JSON output and
+// baseline comparison
+//
+//   bench [--filter TEXT] [--min-time MS] [--repeat N] [--json FILE]
+//         [--baseline FILE] [--max-regression PCT]
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include "bench.h"
+
+#include "utils/error.h"
+#include "utils/json_scan.h"
+
+#include <fcntl.h>
+#include <linux/perf_event.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_MAX_RESULTS 128
+#define BENCH_NAME_MAX    64
+
+typedef struct {
+  char name[BENCH_NAME_MAX];
+  double ns_per_op;
+  double bytes_per_sec;  // 0 without a byte count
+  double cycles_per_op;  // < 0 when perf events are unavailable
+  uint64_t iterations;
+  double baseline_ns;    // < 0 without a baseline entry
+} bench_result_t;
+
+static struct {
+  const char *filter;
+  uint64_t min_time_ns;
+  int repeat;
+  const char *json_path;
+  const char *baseline_path;
+  double max_regression;  // Percent, < 0 to never fail
+} options = {
+    .min_time_ns = 50000000ull,
+    .repeat = 5,
+    .max_regression = -1.0,
+};
+
+static bench_result_t results[BENCH_MAX_RESULTS];
+static size_t num_results = 0;
+static FILE *report = NULL;
+static int cycles_fd = -1;
+static char *baseline_doc = NULL;
+
+// =============================================================================
+// TIMING
+// =============================================================================
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// User-space cycles of this thread. Most distributions allow this without
+// privileges (perf_event_paranoid <= 2); containers often do not.
+static void cycles_open(void) {
+  struct perf_event_attr attr = {
+      .type = PERF_TYPE_HARDWARE,
+      .size = sizeof(attr),
+      .config = PERF_COUNT_HW_CPU_CYCLES,
+      .disabled = 1,
+      .exclude_kernel = 1,
+      .exclude_hv = 1,
+  };
+  cycles_fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1,
+                           PERF_FLAG_FD_CLOEXEC);
+}
+
+static void cycles_start(void) {
+  if (cycles_fd >= 0) {
+    ioctl(cycles_fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(cycles_fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+static int64_t cycles_stop(void) {
+  if (cycles_fd < 0) {
+    return -1;
+  }
+  ioctl(cycles_fd, PERF_EVENT_IOC_DISABLE, 0);
+  uint64_t count = 0;
+  if (read(cycles_fd, &count, sizeof(count)) != (ssize_t)sizeof(count)) {
+    return -1;
+  }
+  return (int64_t)count;
+}
+
+// =============================================================================
+// BASELINE
+// =============================================================================
+
+static char *read_text_file(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    return NULL;
+  }
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  char *text = size >= 0 ? calloc(1, (size_t)size + 1) : NULL;
+  if (text && fread(text, 1, (size_t)size, f) != (size_t)size) {
+    free(text);
+    text = NULL;
+  }
+  fclose(f);
+  return text;
+}
+
+// ns/op of name in the baseline, or -1
+static double baseline_lookup(const char *name) {
+  const char *list =
+      baseline_doc ? json_object_get(baseline_doc, "results") : NULL;
+  for (const char *elem = json_array_first(list); elem;
+       elem = json_array_next(elem)) {
+    if (json_string_equals(json_object_get(elem, "name"), name)) {
+      const char *ns = json_object_get(elem, "ns_per_op");
+      return ns ? strtod(ns, NULL) : -1.0;
+    }
+  }
+  return -1.0;
+}
+
+// =============================================================================
+// RUNNER
+// =============================================================================
+
+static void print_result(const bench_result_t *r) {
+  fprintf(report, "%-34s %12.1f", r->name, r->ns_per_op);
+  if (r->bytes_per_sec > 0) {
+    fprintf(report, " %10.1f", r->bytes_per_sec / 1e6);
+  } else {
+    fprintf(report, " %10s", "-");
+  }
+  if (r->cycles_per_op >= 0) {
+    fprintf(report, " %12.0f", r->cycles_per_op);
+  } else {
+    fprintf(report, " %12s", "-");
+  }
+  if (r->baseline_ns > 0) {
+    double delta = (r->ns_per_op - r->baseline_ns) / r->baseline_ns * 100.0;
+    fprintf(report, " %+8.1f%%", delta);
+  }
+  fputc('\n', report);
+  fflush(report);
+}
+
+void bench_run(const char *name, size_t bytes_per_op, bench_fn_t fn,
+               void *ctx) {
+  if (options.filter && !strstr(name, options.filter)) {
+    return;
+  }
+  if (num_results >= BENCH_MAX_RESULTS) {
+    fprintf(stderr, "bench: too many results, skipping %s\n", name);
+    return;
+  }
+
+  // One warm-up pass, then size the runs to the minimum time
+  uint64_t start = now_ns();
+  fn(ctx, 1);
+  uint64_t single_ns = now_ns() - start;
+  uint64_t iterations = 1;
+  while (single_ns * iterations < options.min_time_ns / 4 &&
+         iterations < (1ull << 40)) {
+    iterations *= 2;
+    start = now_ns();
+    fn(ctx, iterations);
+    single_ns = (now_ns() - start) / iterations + 1;
+  }
+  iterations = options.min_time_ns / single_ns;
+  iterations = iterations > 0 ? iterations : 1;
+
+  double best_ns = -1.0;
+  int64_t best_cycles = -1;
+  for (int run = 0; run < options.repeat; run++) {
+    cycles_start();
+    start = now_ns();
+    fn(ctx, iterations);
+    uint64_t elapsed = now_ns() - start;
+    int64_t cycles = cycles_stop();
+    double ns = (double)elapsed / (double)iterations;
+    if (best_ns < 0 || ns < best_ns) {
+      best_ns = ns;
+      best_cycles = cycles;
+    }
+  }
+
+  bench_result_t *r = &results[num_results++];
+  snprintf(r->name, sizeof(r->name), "%s", name);
+  r->ns_per_op = best_ns;
+  r->bytes_per_sec =
+      bytes_per_op > 0 ? (double)bytes_per_op * 1e9 / best_ns : 0.0;
+  r->cycles_per_op =
+      best_cycles >= 0 ? (double)best_cycles / (double)iterations : -1.0;
+  r->iterations = iterations;
+  r->baseline_ns = baseline_lookup(name);
+  print_result(r);
+}
+
+// =============================================================================
+// OUTPUT
+// =============================================================================
+
+static bool write_json(const char *path) {
+  FILE *f = fopen(path, "w");
+  if (!f) {
+    return false;
+  }
+  fprintf(f, "{\n  \"version\": 1,\n  \"results\": [\n");
+  for (size_t i = 0; i < num_results; i++) {
+    const bench_result_t *r = &results[i];
+    fprintf(f, "    {\"name\": \"%s\", \"ns_per_op\": %.3f, ", r->name,
+            r->ns_per_op);
+    fprintf(f, "\"bytes_per_sec\": %.0f, ", r->bytes_per_sec);
+    if (r->cycles_per_op >= 0) {
+      fprintf(f, "\"cycles_per_op\": %.1f, ", r->cycles_per_op);
+    } else {
+      fprintf(f, "\"cycles_per_op\": null, ");
+    }
+    fprintf(f, "\"iterations\": %llu}%s\n", (unsigned long long)r->iterations,
+            i + 1 < num_results ? "," : "");
+  }
+  fprintf(f, "  ]\n}\n");
+  return fclose(f) == 0;
+}
+
+// Number of benchmarks slower than the baseline by more than the limit
+static int count_regressions(void) {
+  if (options.max_regression < 0) {
+    return 0;
+  }
+  int regressions = 0;
+  for (size_t i = 0; i < num_results; i++) {
+    const bench_result_t *r = &results[i];
+    if (r->baseline_ns > 0 &&
+        (r->ns_per_op - r->baseline_ns) / r->baseline_ns * 100.0 >
+            options.max_regression) {
+      fprintf(report, "regression: %s is %.1f%% slower than the baseline\n",
+              r->name,
+              (r->ns_per_op - r->baseline_ns) / r->baseline_ns * 100.0);
+      regressions++;
+    }
+  }
+  return regressions;
+}
+
+// =============================================================================
+// MAIN
+// =============================================================================
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "Usage: %s [--filter TEXT] [--min-time MS] [--repeat N]\n"
+          "          [--json FILE] [--baseline FILE] "
+          "[--max-regression PCT]\n",
+          argv0);
+}
+
+static bool parse_args(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+    if (strcmp(arg, "--help") == 0 || !value) {
+      return false;
+    }
+    if (strcmp(arg, "--filter") == 0) {
+      options.filter = value;
+    } else if (strcmp(arg, "--min-time") == 0) {
+      options.min_time_ns = strtoull(value, NULL, 10) * 1000000ull;
+    } else if (strcmp(arg, "--repeat") == 0) {
+      options.repeat = atoi(value);
+    } else if (strcmp(arg, "--json") == 0) {
+      options.json_path = value;
+    } else if (strcmp(arg, "--baseline") == 0) {
+      options.baseline_path = value;
+    } else if (strcmp(arg, "--max-regression") == 0) {
+      options.max_regression = strtod(value, NULL);
+    } else {
+      return false;
+    }
+    i++;
+  }
+  if (options.min_time_ns == 0 || options.repeat < 1) {
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  if (!parse_args(argc, argv)) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  // Log lines from the code under test would interleave with the table
+  report = fdopen(dup(STDOUT_FILENO), "w");
+  int devnull = open("/dev/null", O_WRONLY | O_CLOEXEC);
+  if (!report || devnull < 0) {
+    perror("bench");
+    return 2;
+  }
+  fflush(stdout);
+  dup2(devnull, STDOUT_FILENO);
+  close(devnull);
+  bongocat_error_init(0);
+
+  if (options.baseline_path) {
+    baseline_doc = read_text_file(options.baseline_path);
+    if (!baseline_doc) {
+      fprintf(stderr, "bench: cannot read baseline %s\n",
+              options.baseline_path);
+      return 2;
+    }
+  }
+
+  cycles_open();
+  fprintf(report, "%-34s %12s %10s %12s%s\n", "benchmark", "ns/op", "MB/s",
+          "cycles/op", baseline_doc ? "  vs base" : "");
+
+  bench_render_suite();
+  bench_config_suite();
+  bench_toplevel_suite();
+
+  int status = 0;
+  if (options.json_path) {
+    if (write_json(options.json_path)) {
+      fprintf(report, "wrote %s\n", options.json_path);
+    } else {
+      fprintf(stderr, "bench: cannot write %s\n", options.json_path);
+      status = 2;
+    }
+  }
+  if (count_regressions() > 0) {
+    status = 1;
+  }
+
+  free(baseline_doc);
+  if (cycles_fd >= 0) {
+    close(cycles_fd);
+  }
+  fclose(report);
+  return status;
+}
@@ -0,0 +1,35 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// =============================================================================
+// MICROBENCHMARK HARNESS
+// =============================================================================
+//
+// Each benchmark is a function that runs its operation `iterations` times.
+// bench_run() calibrates the iteration count to the minimum run time, keeps
+// the fastest of several runs, and records ns/op, bytes/s and (when the
+// kernel allows perf events) CPU cycles/op. Results go to the report, and
+// optionally to a JSON file and a comparison with a saved baseline.
+
+typedef void (*bench_fn_t)(void *ctx, uint64_t iterations);
+
+// Run one benchmark. name is "<group>/<case>" and is the key baseline
+// comparisons match on. bytes_per_op is 0 when throughput is meaningless.
+// Skipped when it does not match --filter.
+void bench_run(const char *name, size_t bytes_per_op, bench_fn_t fn,
+               void *ctx);
+
+// Keep the compiler from optimizing away work whose result is unused
+static inline void bench_clobber(const void *ptr) {
+  __asm__ volatile("" : : "g"(ptr) : "memory");
+}
+
+// Suites, run in this order
+void bench_render_suite(void);
+void bench_config_suite(void);
+void bench_toplevel_suite(void);
+
+#endif  // BENCH_H
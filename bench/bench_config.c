@@ -0,0 +1,223 @@
+// Benchmarks for loading the config file
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench.h"
+
+#include "config/config.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Every key of the example config with typical values
+static const char typical_config[] =
+    "# bongocat.conf\n"
+    "cat_x_offset=100\n"
+    "cat_y_offset=10\n"
+    "cat_height=40\n"
+    "cat_align=center\n"
+    "mirror_x=0\n"
+    "mirror_y=0\n"
+    "enable_antialiasing=1\n"
+    "overlay_height=50\n"
+    "overlay_opacity=150\n"
+    "overlay_position=top\n"
+    "layer=top\n"
+    "monitor=eDP-1, HDMI-A-1\n"
+    "multi_monitor_mode=process\n"
+    "idle_frame=0\n"
+    "keypress_duration=100\n"
+    "test_animation_duration=200\n"
+    "test_animation_interval=0\n"
+    "fps=60\n"
+    "enable_hand_mapping=1\n"
+    "keyboard_device=/dev/input/event4\n"
+    "keyboard_device=/dev/input/event5\n"
+    "hotplug_scan_interval=30\n"
+    "enable_scheduled_sleep=1\n"
+    "sleep_begin=22:00  # bedtime\n"
+    "sleep_end=07:30\n"
+    "idle_sleep_timeout=300\n"
+    "disable_fullscreen_hide=0\n"
+    "enable_output_power_tracking=1\n"
+    "enable_debug=0\n";
+
+// Eight lines repeated to 20k. Keys late in the old strcmp chain are the
+// common worst case.
+static const char large_config_block[] =
+    "# comment line\n"
+    "enable_output_power_tracking=1\n"
+    "disable_fullscreen_hide = 0  # inline comment\n"
+    "hotplug_scan_interval=30\n"
+    "layer=top\n"
+    "cat_align=center\n"
+    "sleep_begin=22:00\n"
+    "fps=60\n";
+#define LARGE_CONFIG_COPIES 2500
+
+typedef struct {
+  const char *path;
+  int failures;
+} config_ctx_t;
+
+static void run_load(void *arg, uint64_t iterations) {
+  config_ctx_t *ctx = arg;
+  for (uint64_t i = 0; i < iterations; i++) {
+    config_t config = {0};
+    ctx->failures += load_config(&config, ctx->path) != BONGOCAT_SUCCESS;
+    config_cleanup_full(&config);
+  }
+}
+
+// =============================================================================
+// STRCMP-CHAIN BASELINE
+// =============================================================================
+//
+// The parser load_config() replaced: fgets into a 512-byte buffer, then a
+// strcmp chain over every known key until one matches. Parses only, without
+// validation or device resolution.
+
+static const char *const baseline_int_keys[] = {
+    "cat_x_offset",          "cat_y_offset",
+    "cat_height",            "overlay_height",
+    "idle_frame",            "keypress_duration",
+    "test_animation_duration", "test_animation_interval",
+    "fps",                   "overlay_opacity",
+    "mirror_x",              "mirror_y",
+    "enable_antialiasing",   "enable_hand_mapping",
+    "enable_debug",          "enable_scheduled_sleep",
+    "idle_sleep_timeout",    "hotplug_scan_interval",
+    "disable_fullscreen_hide", "enable_output_power_tracking",
+};
+
+static const char *const baseline_other_keys[] = {
+    "layer",       "overlay_position", "multi_monitor_mode", "cat_align",
+    "sleep_begin", "sleep_end",        "monitor",            "keyboard_name",
+};
+
+static char *baseline_trim(char *text) {
+  while (*text == ' ' || *text == '\t') {
+    text++;
+  }
+  char *end = text + strlen(text);
+  while (end > text && (end[-1] == ' ' || end[-1] == '\t')) {
+    *--end = '\0';
+  }
+  return text;
+}
+
+static int baseline_parse(const char *path) {
+  FILE *file = fopen(path, "r");
+  if (!file) {
+    return -1;
+  }
+
+  char line[512];
+  int matched = 0;
+  long checksum = 0;
+  while (fgets(line, sizeof(line), file)) {
+    size_t len = strlen(line);
+    if (len > 0 && line[len - 1] == '\n') {
+      line[len - 1] = '\0';
+    }
+    char *p = line;
+    while (*p == ' ' || *p == '\t') {
+      p++;
+    }
+    if (*p == '#' || *p == '\0') {
+      continue;
+    }
+    char *equals = strchr(line, '=');
+    if (!equals) {
+      continue;
+    }
+    *equals = '\0';
+    char *key = baseline_trim(line);
+    char *value = baseline_trim(equals + 1);
+    char *comment = strstr(value, " #");
+    if (comment) {
+      *comment = '\0';
+    }
+
+    bool found = false;
+    for (size_t i = 0; i < sizeof(baseline_int_keys) / sizeof(char *); i++) {
+      if (strcmp(key, baseline_int_keys[i]) == 0) {
+        checksum += strtol(value, NULL, 10);
+        found = true;
+        break;
+      }
+    }
+    for (size_t i = 0;
+         !found && i < sizeof(baseline_other_keys) / sizeof(char *); i++) {
+      found = strcmp(key, baseline_other_keys[i]) == 0;
+    }
+    matched += found;
+  }
+  fclose(file);
+  bench_clobber(&checksum);
+  return matched;
+}
+
+static void run_baseline(void *arg, uint64_t iterations) {
+  config_ctx_t *ctx = arg;
+  for (uint64_t i = 0; i < iterations; i++) {
+    ctx->failures += baseline_parse(ctx->path) < 0;
+  }
+}
+
+// =============================================================================
+// SUITE
+// =============================================================================
+
+static size_t write_config(char *path, const char *text, int copies) {
+  int fd = mkstemp(path);
+  if (fd < 0) {
+    return 0;
+  }
+  FILE *f = fdopen(fd, "w");
+  if (!f) {
+    close(fd);
+    return 0;
+  }
+  for (int i = 0; i < copies; i++) {
+    fputs(text, f);
+  }
+  fclose(f);
+  return strlen(text) * (size_t)copies;
+}
+
+void bench_config_suite(void) {
+  // The 20k-line cases time one whole file; divide by 20000 for ns/line
+  static const struct {
+    const char *name;
+    const char *text;
+    int copies;
+    bench_fn_t fn;
+  } files[] = {
+      {"config/load/typical", typical_config, 1, run_load},
+      {"config/load/x100", typical_config, 100, run_load},
+      {"config/load/20k-lines", large_config_block, LARGE_CONFIG_COPIES,
+       run_load},
+      {"config/strcmp-chain/20k-lines", large_config_block,
+       LARGE_CONFIG_COPIES, run_baseline},
+  };
+
+  for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+    char path[] = "/tmp/bongocat_bench_XXXXXX";
+    size_t bytes = write_config(path, files[i].text, files[i].copies);
+    if (bytes == 0) {
+      fprintf(stderr, "bench: cannot write a temporary config\n");
+      return;
+    }
+    config_ctx_t ctx = {path, 0};
+    bench_run(files[i].name, bytes, files[i].fn, &ctx);
+    if (ctx.failures > 0) {
+      fprintf(stderr, "bench: %s failed to load %d times\n", files[i].name,
+              ctx.failures);
+    }
+    unlink(path);
+  }
+}
@@ -0,0 +1,291 @@
+// Benchmarks for the per-frame rendering path and the frame cache
+
+#include "bench.h"
+
+#include "graphics/frame_cache.h"
+#include "graphics/hand_mapping.h"
+#include "graphics/offscreen.h"
+#include "graphics/render_backend.h"
+#include "utils/memory.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define BAR_WIDTH 1920
+
+// Cat heights: the default, a tall bar, and a 4K-sized cat
+static const int cat_heights[] = {40, 100, 200};
+
+static int cat_width(int cat_h) {
+  return (cat_h * CAT_IMAGE_WIDTH) / CAT_IMAGE_HEIGHT;
+}
+
+// =============================================================================
+// BLIT
+// =============================================================================
+
+typedef struct {
+  uint8_t *dest;
+  int dest_w;
+  int dest_h;
+  const uint8_t *src;
+  int src_w;
+  int src_h;
+} blit_ctx_t;
+
+static void run_blit(void *arg, uint64_t iterations) {
+  blit_ctx_t *ctx = arg;
+  for (uint64_t i = 0; i < iterations; i++) {
+    blit_cached_frame(ctx->dest, ctx->dest_w, ctx->dest_h, ctx->src,
+                      ctx->src_w, ctx->src_h, 100, 5);
+    bench_clobber(ctx->dest);
+  }
+}
+
+// Premultiplied pixels of one alpha everywhere: 0 and 255 take the skip and
+// copy branches, anything else the blend
+static uint8_t *solid_frame(int w, int h, uint8_t alpha) {
+  size_t size = (size_t)w * (size_t)h * 4U;
+  uint8_t *data = bongocat_malloc(size);
+  if (!data) {
+    return NULL;
+  }
+  for (size_t i = 0; i < size; i += 4) {
+    data[i + 0] = (uint8_t)(alpha / 2);
+    data[i + 1] = (uint8_t)(alpha / 3);
+    data[i + 2] = (uint8_t)(alpha / 4);
+    data[i + 3] = alpha;
+  }
+  return data;
+}
+
+static void bench_blit(void) {
+  static const struct {
+    const char *name;
+    int alpha;  // < 0 for the rasterized cat
+  } sources[] = {
+      {"clear", 0}, {"half", 128}, {"opaque", 255}, {"cat", -1}};
+
+  for (size_t h = 0; h < sizeof(cat_heights) / sizeof(cat_heights[0]); h++) {
+    int src_h = cat_heights[h];
+    int src_w = cat_width(src_h);
+    int dest_h = src_h + 10;
+    uint8_t *dest = bongocat_calloc((size_t)BAR_WIDTH * (size_t)dest_h, 4);
+    frame_set_t *cat = frame_cache_acquire(src_w, src_h, 0, 0);
+
+    for (size_t s = 0; s < sizeof(sources) / sizeof(sources[0]); s++) {
+      uint8_t *owned = sources[s].alpha >= 0
+                           ? solid_frame(src_w, src_h,
+                                         (uint8_t)sources[s].alpha)
+                           : NULL;
+      const uint8_t *src =
+          owned ? owned
+                : cat ? cat->frames[BONGOCAT_FRAME_BOTH_UP].data : NULL;
+      if (dest && src) {
+        char name[64];
+        snprintf(name, sizeof(name), "blit/h%d/%s", src_h, sources[s].name);
+        blit_ctx_t ctx = {dest, BAR_WIDTH, dest_h, src, src_w, src_h};
+        bench_run(name, (size_t)src_w * (size_t)src_h * 4U, run_blit, &ctx);
+      }
+      bongocat_free(owned);
+    }
+
+    frame_set_release(cat);
+    bongocat_free(dest);
+  }
+}
+
+// =============================================================================
+// BAR FILL
+// =============================================================================
+
+typedef struct {
+  uint8_t *pixels;
+  int width;
+  int height;
+  int opacity;
+} fill_ctx_t;
+
+static void run_fill(void *arg, uint64_t iterations) {
+  fill_ctx_t *ctx = arg;
+  for (uint64_t i = 0; i < iterations; i++) {
+    fill_bar_background(ctx->pixels, ctx->width, ctx->height, ctx->opacity);
+    bench_clobber(ctx->pixels);
+  }
+}
+
+static void bench_fill(void) {
+  static const struct {
+    int width;
+    int height;
+  } bars[] = {{1920, 50}, {3840, 100}};
+  static const int opacities[] = {0, 150};
+
+  for (size_t b = 0; b < sizeof(bars) / sizeof(bars[0]); b++) {
+    size_t size = (size_t)bars[b].width * (size_t)bars[b].height * 4U;
+    uint8_t *pixels = bongocat_malloc(size);
+    if (!pixels) {
+      continue;
+    }
+    for (size_t o = 0; o < sizeof(opacities) / sizeof(opacities[0]); o++) {
+      char name[64];
+      snprintf(name, sizeof(name), "fill/%dx%d/opacity%d", bars[b].width,
+               bars[b].height, opacities[o]);
+      fill_ctx_t ctx = {pixels, bars[b].width, bars[b].height, opacities[o]};
+      bench_run(name, size, run_fill, &ctx);
+    }
+    bongocat_free(pixels);
+  }
+}
+
+// =============================================================================
+// FRAME CACHE
+// =============================================================================
+
+typedef struct {
+  int width;
+  int height;
+  bool rasterize;  // Drop the prepared set first, as a cat size change does
+} cache_ctx_t;
+
+static void run_cache(void *arg, uint64_t iterations) {
+  cache_ctx_t *ctx = arg;
+  for (uint64_t i = 0; i < iterations; i++) {
+    if (ctx->rasterize) {
+      frame_cache_drop_warm();
+    }
+    frame_set_release(frame_cache_acquire(ctx->width, ctx->height, 0, 0));
+  }
+}
+
+static void bench_cache(void) {
+  for (int pass = 0; pass < 2; pass++) {
+    for (size_t h = 0; h < sizeof(cat_heights) / sizeof(cat_heights[0]);
+         h++) {
+      cache_ctx_t ctx = {cat_width(cat_heights[h]), cat_heights[h],
+                         pass == 0};
+      char name[64];
+      snprintf(name, sizeof(name), "cache/%s/h%d",
+               ctx.rasterize ? "rasterize" : "share", ctx.height);
+      // Sharing moves no pixels, so only rasterizing reports a rate
+      size_t bytes = ctx.rasterize ? (size_t)NUM_FRAMES * (size_t)ctx.width *
+                                         (size_t)ctx.height * 4U
+                                   : 0;
+      bench_run(name, bytes, run_cache, &ctx);
+    }
+  }
+}
+
+// =============================================================================
+// WHOLE FRAMES
+// =============================================================================
+
+typedef struct {
+  const render_backend_t *backend;
+  const render_snapshot_t *snap;
+} frame_ctx_t;
+
+static void run_frame(void *arg, uint64_t iterations) {
+  frame_ctx_t *ctx = arg;
+  for (uint64_t i = 0; i < iterations; i++) {
+    // Alternate frames as typing does
+    render_frame(ctx->backend, ctx->snap, (int)(i & 1U));
+  }
+}
+
+// render_frame() through the offscreen backend: fill, blit and present of
+// every target, as draw_bar() does minus the Wayland commit. 1e9 / ns/op is
+// the frame rate the render path alone could sustain.
+static void bench_frames(void) {
+  static const struct {
+    const char *name;
+    int width;
+    int height;
+    int cat_height;
+    int opacity;
+    int outputs;
+  } setups[] = {
+      {"1080p", 1920, 50, 40, 150, 1},
+      {"1080p/transparent", 1920, 50, 40, 0, 1},
+      {"4k", 3840, 100, 80, 150, 1},
+      {"1080p/3-outputs", 1920, 50, 40, 150, 3},
+  };
+
+  for (size_t s = 0; s < sizeof(setups) / sizeof(setups[0]); s++) {
+    config_t config = {
+        .screen_width = setups[s].width,
+        .overlay_height = setups[s].height,
+        .overlay_opacity = setups[s].opacity,
+        .cat_height = setups[s].cat_height,
+        .cat_align = ALIGN_CENTER,
+    };
+    render_snapshot_t *snap = render_snapshot_create(&config);
+    if (!snap) {
+      continue;
+    }
+    int cat_h = setups[s].cat_height;
+    snap->frame_set = frame_cache_acquire(cat_width(cat_h), cat_h, 0, 0);
+
+    offscreen_surface_t surfaces[3] = {0};
+    bool ready = true;
+    for (int i = 0; i < setups[s].outputs && ready; i++) {
+      ready = offscreen_surface_init(&surfaces[i], setups[s].width,
+                                     setups[s].height) == BONGOCAT_SUCCESS &&
+              offscreen_add_target(snap, &surfaces[i]);
+    }
+
+    if (ready) {
+      offscreen_t offscreen = {0};
+      render_backend_t backend = offscreen_backend(&offscreen);
+      frame_ctx_t ctx = {&backend, snap};
+      char name[64];
+      snprintf(name, sizeof(name), "frame/%s", setups[s].name);
+      size_t bytes = (size_t)setups[s].outputs * (size_t)setups[s].width *
+                     (size_t)setups[s].height * 4U;
+      bench_run(name, bytes, run_frame, &ctx);
+    }
+
+    render_snapshot_release(snap);
+    for (int i = 0; i < setups[s].outputs; i++) {
+      offscreen_surface_destroy(&surfaces[i]);
+    }
+  }
+}
+
+// =============================================================================
+// HAND MAPPING
+// =============================================================================
+
+// Keycodes of ordinary typing: letters, space, enter, backspace
+static const int typing_keys[] = {30, 48, 46, 32, 18, 33, 34, 35, 23, 36,
+                                  37, 38, 50, 49, 24, 25, 16, 19, 31, 20,
+                                  22, 47, 17, 45, 21, 44, 57, 28, 14, 57};
+
+static void run_keycode(void *arg, uint64_t iterations) {
+  int *sink = arg;
+  int sum = 0;
+  size_t n = sizeof(typing_keys) / sizeof(typing_keys[0]);
+  for (uint64_t i = 0; i < iterations; i++) {
+    sum += get_frame_for_keycode(typing_keys[i % n]);
+  }
+  *sink = sum;
+  bench_clobber(sink);
+}
+
+static void bench_hand_mapping(void) {
+  int sink = 0;
+  bench_run("hand_mapping/keycode", 0, run_keycode, &sink);
+}
+
+void bench_render_suite(void) {
+  if (frame_cache_load_assets() != BONGOCAT_SUCCESS) {
+    fprintf(stderr, "bench: SVG assets failed to load\n");
+    return;
+  }
+  bench_blit();
+  bench_fill();
+  bench_cache();
+  bench_frames();
+  bench_hand_mapping();
+  frame_cache_cleanup();
+}
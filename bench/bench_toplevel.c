@@ -0,0 +1,167 @@
+// Benchmarks for the foreign toplevel tracker
+
+#include "bench.h"
+
+#include "platform/toplevel_tracker.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// One op is one workspace switch: state + done for every toplevel, then one
+// window closes and another opens. Divide ns/op by 2 * TOPLEVELS + 2 for
+// ns/event.
+#define TOPLEVELS 2000
+
+// Stand-in for the wl_output every toplevel is on
+static int output;
+
+// =============================================================================
+// LINEAR BASELINE
+// =============================================================================
+//
+// The layout the tracker replaced: a fixed array searched linearly per
+// event, evaluated on every state event and compacted on close.
+
+typedef struct {
+  void *handle;
+  void *output;
+  bool fullscreen;
+  bool activated;
+} linear_entry_t;
+
+typedef struct {
+  linear_entry_t entries[TOPLEVELS + 1];
+  size_t count;
+  uintptr_t next_handle;
+  size_t switches;
+  size_t evaluations;
+} linear_ctx_t;
+
+static linear_entry_t *linear_find(linear_ctx_t *ctx, void *handle) {
+  for (size_t i = 0; i < ctx->count; i++) {
+    if (ctx->entries[i].handle == handle) {
+      return &ctx->entries[i];
+    }
+  }
+  return NULL;
+}
+
+static void linear_close(linear_ctx_t *ctx, void *handle) {
+  for (size_t i = 0; i < ctx->count; i++) {
+    if (ctx->entries[i].handle == handle) {
+      for (size_t j = i; j + 1 < ctx->count; j++) {
+        ctx->entries[j] = ctx->entries[j + 1];
+      }
+      ctx->count--;
+      return;
+    }
+  }
+}
+
+static void run_linear(void *arg, uint64_t iterations) {
+  linear_ctx_t *ctx = arg;
+  for (uint64_t n = 0; n < iterations; n++) {
+    size_t s = ctx->switches++;
+    for (size_t i = 0; i < ctx->count; i++) {
+      // state: looked up and evaluated at once; done: looked up, ignored
+      linear_entry_t *entry = linear_find(ctx, ctx->entries[i].handle);
+      if (entry) {
+        entry->activated = (i + s) % 97 == 0;
+        ctx->evaluations++;
+      }
+      bench_clobber(linear_find(ctx, ctx->entries[i].handle));
+    }
+    linear_close(ctx, ctx->entries[s % ctx->count].handle);
+    ctx->entries[ctx->count++] = (linear_entry_t){
+        .handle = (void *)ctx->next_handle++, .output = &output};
+  }
+}
+
+static void bench_linear(void) {
+  linear_ctx_t *ctx = calloc(1, sizeof(*ctx));
+  if (!ctx) {
+    fprintf(stderr, "bench: cannot allocate the linear toplevel table\n");
+    return;
+  }
+  for (uintptr_t i = 0; i < TOPLEVELS; i++) {
+    ctx->entries[ctx->count++] =
+        (linear_entry_t){.handle = (void *)(i + 1), .output = &output};
+  }
+  ctx->next_handle = TOPLEVELS + 1;
+  bench_run("toplevel/switch/linear", 0, run_linear, ctx);
+  free(ctx);
+}
+
+// =============================================================================
+// TRACKER
+// =============================================================================
+
+typedef struct {
+  toplevel_tracker_t tracker;
+  toplevel_entry_t *entries[TOPLEVELS];
+  uintptr_t next_handle;
+  size_t switches;
+  size_t evaluations;
+  bool failed;
+} tracker_ctx_t;
+
+static void run_tracker(void *arg, uint64_t iterations) {
+  tracker_ctx_t *ctx = arg;
+  toplevel_change_t change;
+  for (uint64_t n = 0; n < iterations && !ctx->failed; n++) {
+    size_t s = ctx->switches++;
+    for (size_t i = 0; i < TOPLEVELS; i++) {
+      toplevel_entry_set_state(ctx->entries[i], false, (i + s) % 97 == 0);
+      if (toplevel_tracker_commit(&ctx->tracker, ctx->entries[i], &change)) {
+        ctx->evaluations++;
+      }
+    }
+    size_t victim = s % TOPLEVELS;
+    toplevel_tracker_remove(&ctx->tracker, ctx->entries[victim]);
+    ctx->entries[victim] =
+        toplevel_tracker_add(&ctx->tracker, (void *)ctx->next_handle++);
+    if (!ctx->entries[victim]) {
+      ctx->failed = true;
+      return;
+    }
+    toplevel_entry_output_enter(ctx->entries[victim], &output);
+  }
+}
+
+static void bench_tracker(void) {
+  tracker_ctx_t *ctx = calloc(1, sizeof(*ctx));
+  if (!ctx) {
+    fprintf(stderr, "bench: cannot allocate the toplevel tracker\n");
+    return;
+  }
+  toplevel_change_t change;
+  for (uintptr_t i = 0; i < TOPLEVELS; i++) {
+    ctx->entries[i] = toplevel_tracker_add(&ctx->tracker, (void *)(i + 1));
+    if (!ctx->entries[i]) {
+      fprintf(stderr, "bench: cannot add toplevel %zu\n", (size_t)i);
+      toplevel_tracker_clear(&ctx->tracker);
+      free(ctx);
+      return;
+    }
+    toplevel_entry_output_enter(ctx->entries[i], &output);
+    (void)toplevel_tracker_commit(&ctx->tracker, ctx->entries[i], &change);
+  }
+  ctx->next_handle = TOPLEVELS + 1;
+
+  bench_run("toplevel/switch/tracker", 0, run_tracker, ctx);
+  if (ctx->failed) {
+    fprintf(stderr, "bench: toplevel/switch/tracker ran out of memory\n");
+  }
+  toplevel_tracker_clear(&ctx->tracker);
+  free(ctx);
+}
+
+// =============================================================================
+// SUITE
+// =============================================================================
+
+void bench_toplevel_suite(void) {
+  bench_linear();
+  bench_tracker();
+}
@@ -3,8 +3,11 @@
 
 #include "core/bongocat.h"
 #include "utils/error.h"
+#include "utils/memory.h"
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 // =============================================================================
 // CONFIGURATION ENUMS
@@ -20,6 +23,12 @@ typedef enum {
   LAYER_OVERLAY = 1
 } layer_type_t;
 
+// How multiple `monitor=` entries are served
+typedef enum {
+  MULTI_MONITOR_PROCESS = 0,  // One child process per monitor
+  MULTI_MONITOR_SHARED = 1,   // One process with a surface per monitor
+} multi_monitor_mode_t;
+
 typedef enum {
   ALIGN_LEFT = -1,
   ALIGN_CENTER = 0,
@@ -45,6 +54,7 @@ typedef struct {
   int overlay_opacity;
   layer_type_t layer;
   overlay_position_t overlay_position;
+  multi_monitor_mode_t multi_monitor_mode;
 
   // Cat appearance
   const char *asset_paths[NUM_FRAMES];
@@ -82,10 +92,27 @@ typedef struct {
   // Fullscreen behavior
   int disable_fullscreen_hide;
 
+  // Pause while the compositor reports our outputs powered off
+  int enable_output_power_tracking;
+
   // Debug
   int enable_debug;
+
+  // Owns every string and string array above. Each loaded config is one
+  // generation, released as a whole by config_cleanup_full().
+  memory_arena_t arena;
 } config_t;
 
+// What a reload has to redo, cheapest first. config_diff() returns a mask.
+typedef enum {
+  CONFIG_CHANGE_NONE = 0,
+  CONFIG_CHANGE_REDRAW = 1 << 0,   // New render snapshot (placement, timing)
+  CONFIG_CHANGE_CACHE = 1 << 1,    // Frames rasterized again (size, mirroring)
+  CONFIG_CHANGE_BUFFER = 1 << 2,   // SHM buffer recreated (dimensions)
+  CONFIG_CHANGE_SURFACE = 1 << 3,  // Layer properties, outputs, bars
+  CONFIG_CHANGE_INPUT = 1 << 4,    // Input child restarted
+} config_change_t;
+
 // =============================================================================
 // CONFIGURATION FUNCTIONS
 // =============================================================================
@@ -102,6 +129,18 @@ BONGOCAT_NODISCARD int get_screen_width(void);
 // Caller must free the returned string.
 char *config_resolve_path(const char *explicit_path);
 
+// FNV-1a hash of the file contents, so a reload can tell a rewrite with
+// identical bytes from a real edit. Returns false if the file can't be read.
+BONGOCAT_NODISCARD bool config_file_hash(const char *path, uint64_t *out);
+
+// Mask of config_change_t actions needed to go from old_config to
+// new_config. CONFIG_CHANGE_NONE if every setting is equal.
+BONGOCAT_NODISCARD unsigned config_diff(const config_t *old_config,
+                                        const config_t *new_config);
+
+// Short names of the actions in changes, e.g. "cache, buffer"
+void config_change_describe(unsigned changes, char *buf, size_t size);
+
 // Cleanup functions
 void config_cleanup(void);
 void config_cleanup_full(config_t *config);
@@ -0,0 +1,233 @@
+#ifndef CONFIG_KEYS_H
+#define CONFIG_KEYS_H
+
+// Generated by scripts/gen_config_keys.sh - do not edit.
+// Perfect hash over every config key: config_key_lookup() costs one hash
+// and one comparison however many keys there are.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef enum {
+  CONFIG_KEY_NONE = -1,
+  CONFIG_KEY_CAT_X_OFFSET,
+  CONFIG_KEY_CAT_Y_OFFSET,
+  CONFIG_KEY_CAT_HEIGHT,
+  CONFIG_KEY_OVERLAY_HEIGHT,
+  CONFIG_KEY_IDLE_FRAME,
+  CONFIG_KEY_KEYPRESS_DURATION,
+  CONFIG_KEY_TEST_ANIMATION_DURATION,
+  CONFIG_KEY_TEST_ANIMATION_INTERVAL,
+  CONFIG_KEY_FPS,
+  CONFIG_KEY_OVERLAY_OPACITY,
+  CONFIG_KEY_MIRROR_X,
+  CONFIG_KEY_MIRROR_Y,
+  CONFIG_KEY_ENABLE_ANTIALIASING,
+  CONFIG_KEY_ENABLE_HAND_MAPPING,
+  CONFIG_KEY_ENABLE_DEBUG,
+  CONFIG_KEY_ENABLE_SCHEDULED_SLEEP,
+  CONFIG_KEY_IDLE_SLEEP_TIMEOUT,
+  CONFIG_KEY_HOTPLUG_SCAN_INTERVAL,
+  CONFIG_KEY_DISABLE_FULLSCREEN_HIDE,
+  CONFIG_KEY_ENABLE_OUTPUT_POWER_TRACKING,
+  CONFIG_KEY_LAYER,
+  CONFIG_KEY_OVERLAY_POSITION,
+  CONFIG_KEY_MULTI_MONITOR_MODE,
+  CONFIG_KEY_CAT_ALIGN,
+  CONFIG_KEY_SLEEP_BEGIN,
+  CONFIG_KEY_SLEEP_END,
+  CONFIG_KEY_MONITOR,
+  CONFIG_KEY_KEYBOARD_NAME,
+  CONFIG_KEY_KEYBOARD_DEVICE,
+  CONFIG_KEY_KEYBOARD_DEVICES,
+  CONFIG_KEY_COUNT,
+} config_key_t;
+
+#define CONFIG_KEY_HASH_SEED  93U
+#define CONFIG_KEY_HASH_SLOTS 128U
+
+static const char *const config_key_names[CONFIG_KEY_COUNT] = {
+    [CONFIG_KEY_CAT_X_OFFSET] = "cat_x_offset",
+    [CONFIG_KEY_CAT_Y_OFFSET] = "cat_y_offset",
+    [CONFIG_KEY_CAT_HEIGHT] = "cat_height",
+    [CONFIG_KEY_OVERLAY_HEIGHT] = "overlay_height",
+    [CONFIG_KEY_IDLE_FRAME] = "idle_frame",
+    [CONFIG_KEY_KEYPRESS_DURATION] = "keypress_duration",
+    [CONFIG_KEY_TEST_ANIMATION_DURATION] = "test_animation_duration",
+    [CONFIG_KEY_TEST_ANIMATION_INTERVAL] = "test_animation_interval",
+    [CONFIG_KEY_FPS] = "fps",
+    [CONFIG_KEY_OVERLAY_OPACITY] = "overlay_opacity",
+    [CONFIG_KEY_MIRROR_X] = "mirror_x",
+    [CONFIG_KEY_MIRROR_Y] = "mirror_y",
+    [CONFIG_KEY_ENABLE_ANTIALIASING] = "enable_antialiasing",
+    [CONFIG_KEY_ENABLE_HAND_MAPPING] = "enable_hand_mapping",
+    [CONFIG_KEY_ENABLE_DEBUG] = "enable_debug",
+    [CONFIG_KEY_ENABLE_SCHEDULED_SLEEP] = "enable_scheduled_sleep",
+    [CONFIG_KEY_IDLE_SLEEP_TIMEOUT] = "idle_sleep_timeout",
+    [CONFIG_KEY_HOTPLUG_SCAN_INTERVAL] = "hotplug_scan_interval",
+    [CONFIG_KEY_DISABLE_FULLSCREEN_HIDE] = "disable_fullscreen_hide",
+    [CONFIG_KEY_ENABLE_OUTPUT_POWER_TRACKING] = "enable_output_power_tracking",
+    [CONFIG_KEY_LAYER] = "layer",
+    [CONFIG_KEY_OVERLAY_POSITION] = "overlay_position",
+    [CONFIG_KEY_MULTI_MONITOR_MODE] = "multi_monitor_mode",
+    [CONFIG_KEY_CAT_ALIGN] = "cat_align",
+    [CONFIG_KEY_SLEEP_BEGIN] = "sleep_begin",
+    [CONFIG_KEY_SLEEP_END] = "sleep_end",
+    [CONFIG_KEY_MONITOR] = "monitor",
+    [CONFIG_KEY_KEYBOARD_NAME] = "keyboard_name",
+    [CONFIG_KEY_KEYBOARD_DEVICE] = "keyboard_device",
+    [CONFIG_KEY_KEYBOARD_DEVICES] = "keyboard_devices",
+};
+
+// Slot -> key
+static const int8_t config_key_slots[CONFIG_KEY_HASH_SLOTS] = {
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_KEYPRESS_DURATION,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_SLEEP_BEGIN,
+    CONFIG_KEY_OVERLAY_OPACITY,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_CAT_HEIGHT,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_HOTPLUG_SCAN_INTERVAL,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_CAT_X_OFFSET,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_CAT_ALIGN,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_OVERLAY_POSITION,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_MONITOR,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_ENABLE_HAND_MAPPING,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_KEYBOARD_NAME,
+    CONFIG_KEY_CAT_Y_OFFSET,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_LAYER,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_FPS,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_KEYBOARD_DEVICE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_KEYBOARD_DEVICES,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_TEST_ANIMATION_INTERVAL,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_ENABLE_ANTIALIASING,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_ENABLE_OUTPUT_POWER_TRACKING,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_ENABLE_SCHEDULED_SLEEP,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_ENABLE_DEBUG,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_TEST_ANIMATION_DURATION,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_DISABLE_FULLSCREEN_HIDE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_IDLE_SLEEP_TIMEOUT,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_OVERLAY_HEIGHT,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_MIRROR_X,
+    CONFIG_KEY_MIRROR_Y,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_IDLE_FRAME,
+    CONFIG_KEY_NONE,
+    CONFIG_KEY_MULTI_MONITOR_MODE,
+    CONFIG_KEY_SLEEP_END,
+};
+
+static inline uint32_t config_key_hash(const char *key, size_t len) {
+  uint32_t h = 0;
+  for (size_t i = 0; i < len; i++) {
+    h = h * CONFIG_KEY_HASH_SEED + (unsigned char)key[i];
+  }
+  return h;
+}
+
+// Key for the len bytes at key (not NUL-terminated), or CONFIG_KEY_NONE
+static inline config_key_t config_key_lookup(const char *key, size_t len) {
+  int id = config_key_slots[config_key_hash(key, len) % CONFIG_KEY_HASH_SLOTS];
+  if (id < 0 || strncmp(config_key_names[id], key, len) != 0 ||
+      config_key_names[id][len] != '\0') {
+    return CONFIG_KEY_NONE;
+  }
+  return (config_key_t)id;
+}
+
+#endif  // CONFIG_KEYS_H
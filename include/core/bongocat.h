@@ -33,7 +33,6 @@
 #define DEFAULT_SCREEN_WIDTH 1920
 #define DEFAULT_BAR_HEIGHT   40
 #define MAX_OUTPUTS          8  // Maximum monitor outputs to store
-#define MAX_TOPLEVELS        512
 
 // Frame constants
 #define NUM_FRAMES       5
@@ -51,17 +50,29 @@
 #define INOTIFY_EVENT_SIZE (sizeof(struct inotify_event))
 #define INOTIFY_BUF_LEN    (16 * (INOTIFY_EVENT_SIZE + 256))
 
+// Quiet period after the last config file event before reloading
+#define CONFIG_RELOAD_DEBOUNCE_MS 30
+
 // =============================================================================
 // TYPE DEFINITIONS
 // =============================================================================
 
-// Config watcher for hot-reload support
+// Config watcher for hot-reload support. Watches the directories holding
+// the config file (and its symlink target), so saves by rename never drop
+// the watch.
 typedef struct {
   int inotify_fd;
-  int watch_fd;
+  int watch_fd;         // Directory of config_path
+  int target_watch_fd;  // Directory of the symlink target (may be watch_fd)
+  int debounce_fd;      // timerfd: reload once events stop arriving
+  int shutdown_fd;      // eventfd written by config_watcher_stop()
   pthread_t watcher_thread;
+  bool thread_started;
   atomic_bool watching;
   char *config_path;
+  char *watch_name;   // File name of config_path inside its directory
+  char *target_path;  // Resolved symlink target, NULL if not a symlink
+  char *target_name;
   void (*reload_callback)(const char *config_path);
 } ConfigWatcher;
 
@@ -97,6 +108,11 @@ int config_watcher_init(ConfigWatcher *watcher, const char *config_path,
 // Start watching for config changes
 void config_watcher_start(ConfigWatcher *watcher);
 
+// Read pending inotify events and debounce expirations without blocking;
+// call when inotify_fd or debounce_fd is readable. Used by the watcher
+// thread, or directly by the event loop in single-threaded mode.
+void config_watcher_dispatch(ConfigWatcher *watcher);
+
 // Stop watching for config changes
 void config_watcher_stop(ConfigWatcher *watcher);
 
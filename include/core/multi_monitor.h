@@ -9,23 +9,27 @@
 
 #define MULTI_MONITOR_MAX_OUTPUTS 16
 
+// multi_monitor_launch() results other than an exit code
+#define MULTI_MONITOR_FALLBACK -1  // Fewer than 2 monitors, run in-process
+#define MULTI_MONITOR_IN_CHILD -2  // Returned in a forked child
+
 /**
- * Launch bongocat on configured monitors via forking.
+ * Launch bongocat on configured monitors via forking (zygote style).
  *
- * Forks one child per configured output. Each child receives
- * `--monitor <name>` and runs the normal startup path. The parent waits
- * on all children.
+ * Forks one child per configured output without exec, so children inherit
+ * the parsed config and any preloaded assets copy-on-write. The caller must
+ * not have started threads or opened a Wayland connection yet. In each
+ * child this returns MULTI_MONITOR_IN_CHILD with *child_output_name set, and
+ * the child continues the normal startup path for that monitor. The parent
+ * waits on all children and returns their exit code.
  *
- * @param argc Original argc from main
- * @param argv Original argv from main
- * @param config_path Resolved config file path (may be NULL)
- * @param watch_config Whether to enable config watching
  * @param output_names List of monitor/output names
  * @param output_count Number of outputs in output_names
- * @return Exit code (0 on success)
+ * @param child_output_name Set to the monitor name in each child
+ * @return Exit code (0 on success), MULTI_MONITOR_FALLBACK or
+ *         MULTI_MONITOR_IN_CHILD
  */
-int multi_monitor_launch(int argc, char *argv[], const char *config_path,
-                         int watch_config, char **output_names,
-                         size_t output_count);
+int multi_monitor_launch(char **output_names, size_t output_count,
+                         const char **child_output_name);
 
 #endif  // MULTI_MONITOR_H
@@ -3,55 +3,53 @@
 
 #include "config/config.h"
 #include "core/bongocat.h"
+#include "graphics/frame_cache.h"
+#include "graphics/render_state.h"
 #include "utils/error.h"
 
-#include <pthread.h>
+#include <stdatomic.h>
 #include <stdint.h>
 
 // =============================================================================
 // ANIMATION STATE
 // =============================================================================
 
-// Current frame and synchronization
-extern int anim_index;
-extern pthread_mutex_t anim_lock;
-
-// Pre-scaled frame cache (avoids repeated scaling of constant source images)
-typedef struct {
-  uint8_t *data;  // Pre-scaled BGRA pixel data (NULL if not cached)
-  int width;
-  int height;
-} cached_frame_t;
-
-extern cached_frame_t anim_cached_frames[NUM_FRAMES];
-
-void animation_cache_frames(int target_w, int target_h, int mirror_x,
-                            int mirror_y, int enable_aa);
-void animation_invalidate_cache(void);
+// Current frame. Written by the animation state machine, read by draw_bar().
+extern atomic_int anim_index;
 
 // =============================================================================
 // ANIMATION LIFECYCLE
 // =============================================================================
 
-// Initialize animation system - must be checked
+// Parse the SVG assets and rasterize the frame cache for config before
+// forking multi-monitor children, which inherit both copy-on-write. Safe to
+// call without animation_init(); animation_cleanup() frees the result.
+BONGOCAT_NODISCARD bongocat_error_t animation_preload(const config_t *config);
+
+// Initialize animation system (reuses preloaded SVGs) - must be checked
 BONGOCAT_NODISCARD bongocat_error_t animation_init(config_t *config);
 
 // Start animation thread - must be checked
 BONGOCAT_NODISCARD bongocat_error_t animation_start(void);
 
+// Run the animation state machine inline on the Wayland event loop instead
+// of a thread (--single-threaded). Call after wayland_init() and
+// input_start_monitoring() - must be checked
+BONGOCAT_NODISCARD bongocat_error_t animation_start_single_threaded(void);
+
 // Cleanup animation resources
 void animation_cleanup(void);
 
+// Ask the animation thread (or the event loop in single-threaded mode) to
+// redraw. draw_bar() only ever runs there, so the pixel buffer has a single
+// writer. Safe from any thread.
+void animation_request_redraw(void);
+
 // Trigger key press animation
 void animation_trigger(void);
 
-// =============================================================================
-// RENDERING UTILITIES
-// =============================================================================
-
-// Blit pre-converted cached frame (BGRA to BGRA, no channel swap)
-void blit_cached_frame(uint8_t *dest, int dest_w, int dest_h,
-                       const uint8_t *src, int src_w, int src_h, int offset_x,
-                       int offset_y);
+// Wake the animation thread to pick up new timing settings after a config
+// reload (fps, test animation, sleep schedule)
+void animation_notify_config_changed(void);
 
 #endif  // ANIMATION_H
\ No newline at end of file
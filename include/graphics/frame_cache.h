@@ -0,0 +1,58 @@
+#ifndef FRAME_CACHE_H
+#define FRAME_CACHE_H
+
+#include "core/bongocat.h"
+#include "graphics/render_state.h"
+#include "utils/error.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// =============================================================================
+// FRAME CACHE
+// =============================================================================
+//
+// The embedded SVG assets, their rasterization into pre-scaled BGRA frames,
+// and the pixel routines draw_bar() runs on every frame. Nothing here
+// touches Wayland, so the benchmarks link this module on its own.
+
+// Parse the embedded SVGs and create the rasterizer. Does nothing if they are
+// already loaded (for example by a multi-monitor parent before forking).
+BONGOCAT_NODISCARD bongocat_error_t frame_cache_load_assets(void);
+
+// True once frame_cache_load_assets() has succeeded
+BONGOCAT_NODISCARD bool frame_cache_assets_loaded(void);
+
+// Rasterize the frame set that frame_cache_acquire() hands out
+void frame_cache_prepare(int target_w, int target_h, int mirror_x,
+                         int mirror_y);
+
+// Forget the prepared frame set, so the next frame_cache_acquire()
+// rasterizes again. Holders of the old set keep it.
+void frame_cache_drop_warm(void);
+
+// A reference to the frame set at the target size (frames left NULL on
+// failure, or NULL before the assets are loaded). Shares the last
+// rasterized set when size and mirroring match and rasterizes only
+// otherwise. Release with frame_set_release().
+BONGOCAT_NODISCARD frame_set_t *frame_cache_acquire(int target_w,
+                                                    int target_h,
+                                                    int mirror_x,
+                                                    int mirror_y);
+
+// Free the SVGs, the rasterizer and the prepared frame set
+void frame_cache_cleanup(void);
+
+// =============================================================================
+// RENDERING UTILITIES
+// =============================================================================
+
+// Clear a width x height ARGB8888 buffer to black at the given opacity
+void fill_bar_background(uint8_t *pixels, int width, int height, int opacity);
+
+// Blit pre-converted cached frame (BGRA to BGRA, no channel swap)
+void blit_cached_frame(uint8_t *dest, int dest_w, int dest_h,
+                       const uint8_t *src, int src_w, int src_h, int offset_x,
+                       int offset_y);
+
+#endif  // FRAME_CACHE_H
@@ -0,0 +1,13 @@
+#ifndef HAND_MAPPING_H
+#define HAND_MAPPING_H
+
+// =============================================================================
+// HAND MAPPING
+// =============================================================================
+
+// Frame for a key press with enable_hand_mapping: BONGOCAT_FRAME_LEFT_DOWN
+// for keys on the left half of a QWERTY keyboard, BONGOCAT_FRAME_RIGHT_DOWN
+// otherwise. keycode is a Linux input keycode.
+int get_frame_for_keycode(int keycode);
+
+#endif  // HAND_MAPPING_H
@@ -0,0 +1,63 @@
+#ifndef OFFSCREEN_H
+#define OFFSCREEN_H
+
+#include "graphics/render_backend.h"
+#include "graphics/render_state.h"
+#include "utils/error.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// =============================================================================
+// OFFSCREEN RENDER BACKEND
+// =============================================================================
+//
+// Renders into plain memory instead of Wayland SHM buffers, so the whole
+// render path runs without a compositor: for benchmarks and golden-image
+// tests. Presented frames can be written out as PPM or PAM images.
+
+typedef enum {
+  OFFSCREEN_IMAGE_PPM,  // RGB composited over black (P6)
+  OFFSCREEN_IMAGE_PAM,  // Straight-alpha RGBA (P7, TUPLTYPE RGB_ALPHA)
+} offscreen_image_format_t;
+
+// One in-memory bar, standing in for a layer surface and its SHM buffer.
+// Like a surface it outlives the snapshots that draw into it.
+typedef struct {
+  uint8_t *pixels;  // width x height ARGB8888, premultiplied
+  int width;
+  int height;
+  atomic_bool configured;  // Always true: there is no configure to wait for
+  atomic_bool fullscreen;  // Set to hide the bar as a fullscreen window does
+} offscreen_surface_t;
+
+// Backend state, passed as the backend context
+typedef struct {
+  uint64_t frames;     // render_frame() calls that presented a target
+  uint64_t presented;  // Targets presented in total
+  const char *dump_dir;  // Write every presented target here, or NULL
+  offscreen_image_format_t dump_format;
+} offscreen_t;
+
+// Allocate a cleared width x height surface
+BONGOCAT_NODISCARD bongocat_error_t
+offscreen_surface_init(offscreen_surface_t *surface, int width, int height);
+
+void offscreen_surface_destroy(offscreen_surface_t *surface);
+
+// Add surface as a target of snap, before publishing. Fails if the target
+// table is full or the surface height is not the snapshot's overlay_height.
+BONGOCAT_NODISCARD bool offscreen_add_target(render_snapshot_t *snap,
+                                             offscreen_surface_t *surface);
+
+// Backend presenting into the surfaces of a snapshot and counting frames in
+// offscreen. Targets hidden by fullscreen are skipped as on Wayland.
+render_backend_t offscreen_backend(offscreen_t *offscreen);
+
+// Write width x height premultiplied ARGB8888 pixels to path
+BONGOCAT_NODISCARD bongocat_error_t
+offscreen_write_image(const char *path, const uint8_t *pixels, int width,
+                      int height, offscreen_image_format_t format);
+
+#endif  // OFFSCREEN_H
@@ -0,0 +1,49 @@
+#ifndef RENDER_BACKEND_H
+#define RENDER_BACKEND_H
+
+#include "graphics/render_state.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// =============================================================================
+// RENDER BACKEND
+// =============================================================================
+//
+// render_frame() composes a frame into the pixels of every target of a
+// snapshot. Getting those pixels onto a screen is up to a backend: Wayland
+// attaches and commits the SHM buffers, the offscreen backend keeps them in
+// memory and can write them out as images.
+
+typedef struct {
+  const char *name;
+  void *ctx;
+
+  // Called for each target before composing it. Returns false to skip the
+  // target (not configured, hidden, powered off). A backend that commits on
+  // its own here, to unmap or remap a surface, sets *committed.
+  bool (*begin_target)(void *ctx, const render_snapshot_t *snap,
+                       const render_target_t *target, bool *committed);
+
+  // Show the composed pixels of targets[index]. first is true for the first
+  // target presented in this frame.
+  void (*present_target)(void *ctx, const render_snapshot_t *snap,
+                         size_t index, bool first);
+
+  // End of the frame. presented is the number of targets presented,
+  // committed is true if begin_target() committed anything.
+  void (*end_frame)(void *ctx, size_t presented, bool committed);
+} render_backend_t;
+
+// Fill one target's buffer with the bar background and blit frame_index of
+// the snapshot's frame cache. Returns false if that frame is not cached (the
+// bar is still filled).
+bool render_compose_target(const render_snapshot_t *snap,
+                           const render_target_t *target, int frame_index);
+
+// Compose frame_index into every target the backend accepts and present it.
+// Returns the number of targets presented.
+size_t render_frame(const render_backend_t *backend,
+                    const render_snapshot_t *snap, int frame_index);
+
+#endif  // RENDER_BACKEND_H
@@ -0,0 +1,144 @@
+#ifndef RENDER_STATE_H
+#define RENDER_STATE_H
+
+#include "config/config.h"
+#include "core/bongocat.h"
+#include "utils/error.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct wl_surface;
+struct wl_buffer;
+
+// =============================================================================
+// RENDER SNAPSHOT
+// =============================================================================
+
+// Pre-scaled frame cache (avoids repeated scaling of constant source images)
+typedef struct {
+  uint8_t *data;  // Pre-scaled BGRA pixel data (NULL if not cached)
+  int width;
+  int height;
+} cached_frame_t;
+
+// Every frame at one cat size and mirroring. Immutable once rasterized and
+// shared by reference: all snapshots at the same size hold the same set,
+// so publishing a snapshot never copies pixels. Freed with the last
+// reference.
+typedef struct frame_set {
+  atomic_uint refs;
+  int mirror_x;
+  int mirror_y;
+  cached_frame_t frames[NUM_FRAMES];
+} frame_set_t;
+
+// One surface to draw into. The surface and buffer are borrowed from the
+// platform layer: they are only destroyed after every snapshot referencing
+// them has been retired with render_state_retire().
+typedef struct {
+  struct wl_surface *surface;
+  struct wl_buffer *buffer;
+  uint8_t *pixels;
+  int width;
+  int height;
+  int cat_x;  // Cat placement inside this buffer, derived from config
+  int cat_y;
+  atomic_bool *configured;        // Surface acked its configure event
+  const atomic_bool *fullscreen;  // Fullscreen window on this output
+  atomic_bool *unmapped;          // NULL buffer attached while hidden
+  const atomic_bool *powered_off; // Output off (NULL = not tracked)
+} render_target_t;
+
+#define RENDER_MAX_TARGETS 16
+
+// Everything the animation thread and draw_bar() read, frozen at publish
+// time. Snapshots are immutable once published and freed when the last
+// reference is dropped, so readers never take a lock and a reload never
+// waits for (or blocks) a redraw in progress.
+typedef struct render_snapshot {
+  atomic_uint refs;
+
+  // Copy of the scalar settings. Pointer members (output names, devices,
+  // asset paths) are NULL: they are owned by the live config only.
+  config_t config;
+
+  // Frame cache (a held reference, NULL if none), shared by every target:
+  // all outputs use the same cat size
+  frame_set_t *frame_set;
+
+  // Surfaces to draw into: one per output
+  render_target_t targets[RENDER_MAX_TARGETS];
+  size_t num_targets;
+} render_snapshot_t;
+
+// Allocate a snapshot (one reference held by the caller) with a scalar copy
+// of config and no targets
+BONGOCAT_NODISCARD render_snapshot_t *
+render_snapshot_create(const config_t *config);
+
+// Append a width x overlay_height target and place the cat in it. Before
+// publishing only. Returns false if the target table is full.
+bool render_snapshot_add_target(render_snapshot_t *snap,
+                                const render_target_t *target);
+
+// Drop a reference; the last one frees the snapshot and releases its frame
+// set
+void render_snapshot_release(render_snapshot_t *snap);
+
+// Frame at index, or NULL if the snapshot has no such frame cached
+BONGOCAT_NODISCARD const cached_frame_t *
+render_snapshot_frame(const render_snapshot_t *snap, int index);
+
+// =============================================================================
+// FRAME SETS
+// =============================================================================
+
+// Allocate an empty frame set (one reference held by the caller)
+BONGOCAT_NODISCARD frame_set_t *frame_set_create(void);
+
+// Take another reference; returns set (NULL is passed through)
+frame_set_t *frame_set_retain(frame_set_t *set);
+
+// Drop a reference; the last one frees the set and its pixels
+void frame_set_release(frame_set_t *set);
+
+// True if target should be hidden: a fullscreen window covers its output
+// and the settings allow hiding (not the overlay layer, not disabled)
+BONGOCAT_NODISCARD bool
+render_target_is_hidden(const render_snapshot_t *snap,
+                        const render_target_t *target);
+
+// True if the compositor reports the target's output powered off
+BONGOCAT_NODISCARD bool
+render_target_is_powered_off(const render_target_t *target);
+
+// True if there are targets and every one is hidden or powered off.
+// Rendering is suspended while this holds: nothing on screen can change.
+BONGOCAT_NODISCARD bool
+render_snapshot_nothing_visible(const render_snapshot_t *snap);
+
+// =============================================================================
+// PUBLICATION (single writer, any number of readers)
+// =============================================================================
+
+// Current snapshot with an extra reference, or NULL if none is published.
+// Lock-free; pair with render_snapshot_release().
+BONGOCAT_NODISCARD render_snapshot_t *render_state_acquire(void);
+
+// Atomically replace the published snapshot, taking over the caller's
+// reference to snap (may be NULL). The previous snapshot is released; it
+// stays alive for readers that still hold it.
+void render_state_publish(render_snapshot_t *snap);
+
+// Unpublish the current snapshot and wait until no reader holds it, so the
+// surface and buffer it borrows can be destroyed. Only the writer waits,
+// and only for draws already in progress.
+void render_state_retire(void);
+
+// Number of snapshots currently allocated (for tests and leak checks)
+BONGOCAT_NODISCARD size_t render_state_live_snapshots(void);
+
+#endif  // RENDER_STATE_H
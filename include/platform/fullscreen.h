@@ -25,6 +25,32 @@ void fullscreen_cleanup(void);
 /// toplevel is covering our output).
 bool fullscreen_is_detected(void);
 
+/// Re-read the active Hyprland window after a fullscreen or focus event from
+/// the Hyprland event socket (ignored while foreign-toplevel output events
+/// already track fullscreen per output).
+void fullscreen_handle_hypr_event(void);
+
+/// Record the fullscreen state of a named output as reported by a
+/// compositor IPC backend. Updates our bar when it is that output's, and the
+/// extra bars of shared multi-monitor mode. While any output state is known,
+/// foreign-toplevel heuristics no longer change the fullscreen state.
+void fullscreen_set_output_state(const char *output_name, bool fullscreen);
+
+/// Forget IPC-reported output states (the backend disconnected), handing
+/// fullscreen detection back to the foreign-toplevel protocol.
+void fullscreen_clear_output_states(void);
+
+/// Start the compositor IPC backend matching the environment (Hyprland,
+/// sway or niri), if any. Call after wayland_init() has created the loop.
+void fullscreen_backends_start(void);
+
+/// Stop every compositor IPC backend.
+void fullscreen_backends_stop(void);
+
+/// Returns true if a tracked toplevel is fullscreen on wl_output (used by
+/// the extra bars of shared multi-monitor mode).
+bool fullscreen_output_has_fullscreen(struct wl_output *wl_output);
+
 /// Returns true if the foreign-toplevel manager protocol was bound
 /// (fullscreen detection is available).
 bool fs_detector_available(void);
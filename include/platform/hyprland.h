@@ -1,33 +1,31 @@
 #ifndef HYPRLAND_H
 #define HYPRLAND_H
 
+#include "platform/hyprland_ipc.h"
+
 #include <stdbool.h>
 #include <stddef.h>
-#include <sys/types.h>
-
-// =============================================================================
-// HYPRLAND-SPECIFIC TYPES
-// =============================================================================
-
-typedef struct {
-  int monitor_id;  // monitor number in Hyprland
-  int x, y;
-  int width, height;
-  bool fullscreen;
-} window_info_t;
 
 // =============================================================================
 // HYPRLAND HELPER FUNCTIONS
 // =============================================================================
 
-/// Execute a command and capture its stdout into buf. Returns bytes read or -1.
-/// Uses fork/execvp instead of popen to avoid shell interpretation.
-ssize_t safe_exec_read(const char *const argv[], char *buf, size_t buf_size);
-
-/// Map xdg-output names to Hyprland monitor IDs via `hyprctl monitors`.
+/// Map xdg-output names to Hyprland monitor IDs via a `j/monitors` request.
 void hypr_update_outputs_with_monitor_ids(void);
 
-/// Query the active Hyprland window and fill @p win. Returns true on success.
+/// Query the active Hyprland window over the IPC socket and fill @p win.
+/// Returns true on success; false at once outside Hyprland.
 bool hypr_get_active_window(window_info_t *win);
 
+/// Subscribe to the Hyprland event socket on the Wayland event loop, so
+/// fullscreen and focus changes are pushed instead of queried. No-op
+/// outside Hyprland. Call after wayland_init() has created the loop.
+void hypr_events_start(void);
+
+/// Unsubscribe and close the event socket.
+void hypr_events_stop(void);
+
+/// True while the event stream is connected.
+bool hypr_events_active(void);
+
 #endif  // HYPRLAND_H
@@ -0,0 +1,91 @@
+#ifndef HYPRLAND_IPC_H
+#define HYPRLAND_IPC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+// =============================================================================
+// HYPRLAND IPC TYPES
+// =============================================================================
+
+typedef struct {
+  int monitor_id;  // monitor number in Hyprland
+  int x, y;
+  int width, height;
+  bool fullscreen;
+} window_info_t;
+
+typedef struct {
+  int id;
+  char name[128];
+} hypr_monitor_t;
+
+typedef enum {
+  HYPR_EVENT_OTHER = 0,
+  HYPR_EVENT_FULLSCREEN,     // fullscreen>>0|1
+  HYPR_EVENT_ACTIVE_WINDOW,  // activewindow>>class,title
+  HYPR_EVENT_MONITOR_ADDED,  // monitoradded>>name
+} hypr_event_type_t;
+
+typedef struct {
+  hypr_event_type_t type;
+  bool fullscreen;        // HYPR_EVENT_FULLSCREEN
+  char monitor_name[128];  // HYPR_EVENT_MONITOR_ADDED
+} hypr_event_t;
+
+// Buffered reader for the line-based .socket2.sock event stream
+#define HYPR_EVENT_BUF_SIZE 4096
+typedef struct {
+  int fd;
+  size_t len;
+  bool discarding;  // Dropping the rest of an overlong line
+  char buf[HYPR_EVENT_BUF_SIZE];
+} hypr_event_reader_t;
+
+typedef void (*hypr_event_handler_t)(const hypr_event_t *event, void *data);
+
+// =============================================================================
+// SOCKET CLIENT
+// =============================================================================
+
+// Path of a socket of the running Hyprland instance (".socket.sock" for
+// requests, ".socket2.sock" for events):
+// $XDG_RUNTIME_DIR/hypr/$HYPRLAND_INSTANCE_SIGNATURE/<name>, falling back to
+// the pre-0.40 /tmp/hypr location. False outside Hyprland.
+bool hypr_ipc_socket_path(const char *socket_name, char *out, size_t size);
+
+// Send one request (e.g. "j/activewindow") to the socket at path and read
+// the reply into buf (NUL-terminated). Returns the reply length or -1.
+// Send and receive time out after 500ms so a stuck compositor cannot hang
+// the caller.
+ssize_t hypr_ipc_request(const char *path, const char *request, char *buf,
+                         size_t buf_size);
+
+// Connect to the event socket at path. Returns a non-blocking fd or -1.
+int hypr_ipc_connect_events(const char *path);
+
+// =============================================================================
+// PARSERS (no allocation)
+// =============================================================================
+
+// Parse a `j/activewindow` reply. Returns false for "{}" (no active window)
+// or malformed input.
+bool hypr_parse_active_window(const char *json, window_info_t *win);
+
+// Parse a `j/monitors` reply into at most max entries. Returns the count.
+size_t hypr_parse_monitors(const char *json, hypr_monitor_t *out, size_t max);
+
+// Parse one event line (without the trailing newline)
+bool hypr_parse_event(const char *line, size_t len, hypr_event_t *event);
+
+// Start reading events from fd (ownership stays with the caller)
+void hypr_event_reader_init(hypr_event_reader_t *reader, int fd);
+
+// Read everything available on the fd and dispatch each complete line.
+// Returns the number of events dispatched, or -1 once the stream is closed
+// or fails.
+int hypr_event_reader_dispatch(hypr_event_reader_t *reader,
+                               hypr_event_handler_t handler, void *data);
+
+#endif  // HYPRLAND_IPC_H
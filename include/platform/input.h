@@ -5,6 +5,7 @@
 #include "utils/error.h"
 
 #include <stdatomic.h>
+#include <stdbool.h>
 
 // =============================================================================
 // INPUT STATE
@@ -16,6 +17,15 @@ extern atomic_int *any_key_pressed;
 // Last pressed key code for hand mapping (0 = none)
 extern atomic_int *last_key_code;
 
+// Timestamps of the most recent key press (CLOCK_MONOTONIC, microseconds).
+// Written by the input child before it raises any_key_pressed.
+typedef struct {
+  atomic_llong event_us;  // evdev input_event.time
+  atomic_llong read_us;   // When the input child read() the event
+} input_key_timing_t;
+
+extern input_key_timing_t *last_key_timing;
+
 // =============================================================================
 // INPUT MONITORING FUNCTIONS
 // =============================================================================
@@ -39,4 +49,17 @@ pid_t input_get_child_pid(void);
 // Get eventfd for waking animation thread on input events (-1 if unavailable)
 int input_get_wake_fd(void);
 
+// Stop (or resume) key presses waking the animation thread. Timing is still
+// recorded in last_key_timing, so the renderer can resync on resume.
+void input_set_wake_suspended(bool suspended);
+
+// Record every event the input child reads to path (see input_record.h).
+// Call before input_start_monitoring(); path must outlive monitoring.
+void input_set_record_file(const char *path);
+
+// Replay the recording at path instead of reading /dev/input. speed scales
+// the recorded timing (2.0 is twice as fast); 0 replays without pauses.
+// Call before input_start_monitoring(); path must outlive monitoring.
+void input_set_replay(const char *path, double speed);
+
 #endif  // INPUT_H
\ No newline at end of file
@@ -0,0 +1,84 @@
+#ifndef INPUT_RECORD_H
+#define INPUT_RECORD_H
+
+#include "utils/error.h"
+
+#include <linux/input.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// =============================================================================
+// INPUT RECORDINGS
+// =============================================================================
+//
+// Evdev events captured by the input child (--record) and fed back through
+// it (--replay). A recording is an 8-byte header followed by 12-byte
+// little-endian records, about half the size of struct input_event:
+//
+//   header: "BCIR" | u16 version | u16 record size
+//   record: u32 delta_us | u8 device | u8 type | u16 code | s32 value
+//
+// delta_us is the time since the previous record from the events' own
+// timestamps, so the typing cadence survives however late the child read
+// them. device is the input child's device slot, which tells keyboards
+// apart without storing their paths.
+
+#define INPUT_RECORD_MAGIC       "BCIR"
+#define INPUT_RECORD_VERSION     1
+#define INPUT_RECORD_HEADER_SIZE 8
+#define INPUT_RECORD_SIZE        12
+
+// One decoded record
+typedef struct {
+  uint32_t delta_us;
+  uint8_t device;
+  uint8_t type;
+  uint16_t code;
+  int32_t value;
+} input_record_t;
+
+// Writer side, opened before the input child forks. The child appends
+// through the inherited fd, so a restarted child keeps adding to the same
+// file (the gap across the restart is not recorded).
+typedef struct {
+  int fd;            // -1 when closed, or after a write failed
+  int64_t last_us;   // Time of the previous record, monotonic
+  bool has_last;
+  uint64_t records;  // Records written by this process
+} input_recorder_t;
+
+// A whole recording loaded into memory for replay
+typedef struct {
+  input_record_t *records;
+  size_t count;
+  uint64_t duration_us;  // Sum of all deltas
+} input_recording_t;
+
+// Create (or truncate) path with mode 0600 and write the header
+BONGOCAT_NODISCARD bongocat_error_t
+input_recorder_open(input_recorder_t *rec, const char *path);
+
+// Append count events read at once from device slot. offset_us converts
+// the events' timestamps to CLOCK_MONOTONIC microseconds. Returns false and
+// closes the recorder if the write fails.
+bool input_recorder_write(input_recorder_t *rec, uint8_t device,
+                          const struct input_event *ev, size_t count,
+                          int64_t offset_us);
+
+void input_recorder_close(input_recorder_t *rec);
+
+// Read and validate a recording. A truncated last record is dropped.
+BONGOCAT_NODISCARD bongocat_error_t
+input_recording_load(input_recording_t *out, const char *path);
+
+void input_recording_free(input_recording_t *rec);
+
+// End of the batch starting at start: the records one read() returned,
+// which share a device and a time and end with SYN_REPORT. At most max
+// records.
+BONGOCAT_NODISCARD size_t
+input_recording_next_batch(const input_recording_t *rec, size_t start,
+                           size_t max);
+
+#endif  // INPUT_RECORD_H
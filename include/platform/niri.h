@@ -0,0 +1,23 @@
+#ifndef NIRI_H
+#define NIRI_H
+
+#include "platform/niri_ipc.h"
+
+#include <stdbool.h>
+
+// =============================================================================
+// NIRI FULLSCREEN BACKEND
+// =============================================================================
+
+/// Open the niri event stream on the Wayland event loop and report
+/// per-output fullscreen state to the fullscreen module. No-op when
+/// $NIRI_SOCKET is unset. Call after wayland_init() has created the loop.
+void niri_events_start(void);
+
+/// Close the event stream.
+void niri_events_stop(void);
+
+/// True while the event stream is connected.
+bool niri_events_active(void);
+
+#endif  // NIRI_H
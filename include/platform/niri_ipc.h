@@ -0,0 +1,102 @@
+#ifndef NIRI_IPC_H
+#define NIRI_IPC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+// =============================================================================
+// NIRI IPC TYPES
+// =============================================================================
+//
+// niri speaks newline-delimited JSON on $NIRI_SOCKET. After the request
+// "EventStream" the connection streams the full workspace and window lists
+// followed by incremental changes, which are folded into the tables below.
+
+#define NIRI_MAX_OUTPUTS    16
+#define NIRI_MAX_WORKSPACES 64
+#define NIRI_MAX_WINDOWS    256
+
+// Longest event line accepted (WindowsChanged grows with open windows)
+#define NIRI_MAX_LINE (4u * 1024u * 1024u)
+
+typedef struct {
+  char name[128];
+  int width, height;  // Logical size, 0 if unknown
+  bool reported;      // Handler has been told the current state
+  bool fullscreen;
+} niri_output_t;
+
+typedef struct {
+  uint64_t id;
+  char output[128];
+  bool is_active;  // Visible on its output
+  bool has_active_window;
+  uint64_t active_window_id;
+} niri_workspace_t;
+
+typedef struct {
+  uint64_t id;
+  uint64_t workspace_id;
+  bool has_workspace;
+  int width, height;  // Window size in logical pixels
+  int fullscreen;     // 1/0 when niri reports it, -1 to compare sizes
+} niri_window_t;
+
+// Called when an output's fullscreen state is first known or changes
+typedef void (*niri_output_handler_t)(const char *output_name,
+                                      bool fullscreen, void *data);
+
+typedef struct {
+  int fd;
+  char path[108];
+  char *buf;
+  size_t len;
+  size_t cap;
+  bool discarding;  // Dropping the rest of an overlong line
+  bool handled_first_reply;
+
+  niri_output_t outputs[NIRI_MAX_OUTPUTS];
+  size_t output_count;
+  niri_workspace_t workspaces[NIRI_MAX_WORKSPACES];
+  size_t workspace_count;
+  niri_window_t windows[NIRI_MAX_WINDOWS];
+  size_t window_count;
+
+  niri_output_handler_t handler;
+  void *data;
+} niri_session_t;
+
+// =============================================================================
+// CLIENT
+// =============================================================================
+
+// $NIRI_SOCKET. False outside niri.
+bool niri_ipc_socket_path(char *out, size_t size);
+
+// Send one request line (e.g. "\"Outputs\"") and read the one-line reply
+// into buf (NUL-terminated). Returns the reply length or -1. Send and
+// receive time out after 500ms.
+ssize_t niri_ipc_request(const char *path, const char *request, char *buf,
+                         size_t buf_size);
+
+// Parse an "Outputs" reply into at most max entries. Returns the count.
+size_t niri_parse_outputs(const char *json, niri_output_t *out, size_t max);
+
+// Query the outputs, then connect the event stream at path. The fd is
+// non-blocking afterwards.
+bool niri_session_open(niri_session_t *session, const char *path,
+                       niri_output_handler_t handler, void *data);
+
+// Apply one line of the event stream and report changed outputs. Returns
+// false if niri rejected the request.
+bool niri_session_handle_line(niri_session_t *session, const char *line);
+
+// Read everything available and apply each complete line. Returns the
+// number of lines handled, or -1 once the stream is closed or fails.
+int niri_session_dispatch(niri_session_t *session);
+
+void niri_session_close(niri_session_t *session);
+
+#endif  // NIRI_IPC_H
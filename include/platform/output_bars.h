@@ -0,0 +1,49 @@
+#ifndef OUTPUT_BARS_H
+#define OUTPUT_BARS_H
+
+#include "config/config.h"
+#include "core/bongocat.h"
+#include "graphics/render_state.h"
+#include "utils/error.h"
+
+#include <stdbool.h>
+#include <wayland-client.h>
+
+// =============================================================================
+// SHARED MULTI-MONITOR BARS
+// =============================================================================
+//
+// With multi_monitor_mode=shared one process serves every `monitor=` entry:
+// wayland.c owns the bar on the first configured output and this module owns
+// one layer surface and buffer per additional output. All bars are targets
+// of the same render snapshot, so there is one input reader, one animation
+// clock and one frame cache however many monitors are configured.
+//
+// Everything here runs on the main thread.
+
+// Number of extra bars that can be tracked (the primary bar is not counted)
+#define OUTPUT_BARS_MAX (RENDER_MAX_TARGETS - 1)
+
+// (Re)create bars for config's second and later monitors if the mode is
+// shared, or remove them otherwise. Retires the render state first when the
+// set of surfaces changes; the caller publishes a new snapshot afterwards.
+void output_bars_sync(const config_t *config);
+
+// Destroy every bar (retires the render state first)
+void output_bars_cleanup(void);
+
+// True while shared mode is on and at least one extra monitor is configured
+BONGOCAT_NODISCARD bool output_bars_active(void);
+
+// Add every configured bar to snap as a draw target
+void output_bars_add_targets(render_snapshot_t *snap);
+
+// Hotplug: an output announced its xdg-output name, or a wl_output is about
+// to be destroyed. Both republish the render state if a bar was affected.
+void output_bars_output_named(const output_ref_t *oref);
+void output_bars_output_removed(struct wl_output *wl_output);
+
+// Re-read per-output fullscreen state after a foreign-toplevel change
+void output_bars_refresh_fullscreen(void);
+
+#endif  // OUTPUT_BARS_H
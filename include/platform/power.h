@@ -0,0 +1,59 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include "config/config.h"
+#include "utils/error.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <wayland-client.h>
+
+// Forward-declare the protocol types so callers don't need to include
+// the generated headers just for the global pointers.
+struct ext_idle_notifier_v1;
+struct zwlr_output_power_manager_v1;
+
+// =============================================================================
+// USER IDLE AND OUTPUT POWER
+// =============================================================================
+//
+// ext-idle-notify-v1 reports when the seat has been idle for
+// idle_sleep_timeout seconds, so idle sleep needs no timer in the animation
+// thread. wlr-output-power-management reports outputs the compositor has
+// powered off (DPMS, usually right after the session locks); rendering is
+// suspended while every output we draw on is off. Without either protocol
+// the animation falls back to its own timer logic and keeps drawing.
+//
+// Everything here runs on the main thread except the two idle queries and
+// the output flags, which the animation thread reads.
+
+// Take ownership of globals bound in registry_global
+void power_bind_idle_notifier(struct ext_idle_notifier_v1 *notifier);
+void power_bind_seat(struct wl_seat *seat);
+void power_bind_output_power_manager(
+    struct zwlr_output_power_manager_v1 *manager);
+
+// Create or replace the idle notification for idle_sleep_timeout and start
+// or stop output power tracking. Call once the globals are bound and again
+// on every reload, before the render state is published.
+void power_apply_config(const config_t *config);
+
+// True while the compositor's idle notification drives idle sleep
+BONGOCAT_NODISCARD bool power_idle_tracked(void);
+
+// True between the idled and resumed events
+BONGOCAT_NODISCARD bool power_user_idle(void);
+
+// Flag that is true while output is powered off, valid until
+// power_cleanup(). Starts tracking output on first use. NULL if output
+// power is not tracked.
+BONGOCAT_NODISCARD const atomic_bool *
+power_output_off_flag(struct wl_output *output);
+
+// Stop tracking an output before its wl_output is destroyed
+void power_output_removed(struct wl_output *output);
+
+// Destroy the notification, the power objects and the globals
+void power_cleanup(void);
+
+#endif  // POWER_H
@@ -0,0 +1,52 @@
+#ifndef PRESENTATION_H
+#define PRESENTATION_H
+
+#include "utils/latency.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <wayland-client.h>
+
+// Forward-declare the protocol type so callers don't need to include
+// the generated header just for the global pointer.
+struct wp_presentation;
+
+// =============================================================================
+// PRESENTATION FEEDBACK PUBLIC API
+// =============================================================================
+
+/// Counters and histograms built from wp_presentation_feedback events.
+typedef struct {
+  uint64_t presented;        // Commits the compositor put on screen
+  uint64_t discarded;        // Commits superseded before being shown
+  uint64_t untracked;        // Commits made while all feedback slots were busy
+  uint64_t late;             // Presented one or more refresh cycles late
+  uint32_t refresh_ns;       // Last refresh period reported (0 = variable)
+  latency_summary_t commit_to_present;  // wl_surface_commit -> photons
+  latency_summary_t key_to_present;     // evdev event -> photons
+} presentation_stats_t;
+
+/// Take ownership of the wp_presentation global bound in registry_global.
+void presentation_init(struct wp_presentation *presentation);
+
+/// Destroy in-flight feedback objects and the global.  Safe to call even if
+/// presentation_init was never called.
+void presentation_cleanup(void);
+
+/// Returns true if the compositor supports wp_presentation.
+bool presentation_available(void);
+
+/// Request feedback for the next commit on surface.  key_event_us is the
+/// evdev timestamp (CLOCK_MONOTONIC us) of the key press that triggered the
+/// frame, or 0.  Must be called right before wl_surface_commit() and is
+/// serialized by the caller (only the animation thread runs draw_bar()).
+void presentation_request_feedback(struct wl_surface *surface,
+                                   int64_t key_event_us);
+
+/// Snapshot the current statistics.
+void presentation_get_stats(presentation_stats_t *out);
+
+/// Log presented/discarded counts and photon latency percentiles.
+void presentation_report(void);
+
+#endif  // PRESENTATION_H
@@ -0,0 +1,23 @@
+#ifndef SWAY_H
+#define SWAY_H
+
+#include "platform/sway_ipc.h"
+
+#include <stdbool.h>
+
+// =============================================================================
+// SWAY FULLSCREEN BACKEND
+// =============================================================================
+
+/// Subscribe to sway window and workspace events on the Wayland event loop
+/// and report per-output fullscreen state to the fullscreen module. No-op
+/// when $SWAYSOCK is unset. Call after wayland_init() has created the loop.
+void sway_events_start(void);
+
+/// Unsubscribe and close the IPC connection.
+void sway_events_stop(void);
+
+/// True while the IPC connection is up.
+bool sway_events_active(void);
+
+#endif  // SWAY_H
@@ -0,0 +1,88 @@
+#ifndef SWAY_IPC_H
+#define SWAY_IPC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// =============================================================================
+// I3-IPC PROTOCOL
+// =============================================================================
+//
+// Every message is "i3-ipc", a 32-bit payload length and a 32-bit type in
+// native byte order, then the JSON payload. Events carry the high bit in
+// their type.
+
+#define SWAY_IPC_MAGIC       "i3-ipc"
+#define SWAY_IPC_MAGIC_LEN   6
+#define SWAY_IPC_HEADER_SIZE (SWAY_IPC_MAGIC_LEN + 8)
+
+#define SWAY_IPC_SUBSCRIBE 2u
+#define SWAY_IPC_GET_TREE  4u
+
+#define SWAY_IPC_EVENT_BIT       0x80000000u
+#define SWAY_IPC_EVENT_WORKSPACE (SWAY_IPC_EVENT_BIT | 0u)
+#define SWAY_IPC_EVENT_WINDOW    (SWAY_IPC_EVENT_BIT | 3u)
+#define SWAY_IPC_EVENT_SHUTDOWN  (SWAY_IPC_EVENT_BIT | 6u)
+
+// Largest payload accepted (a GET_TREE reply grows with open windows)
+#define SWAY_IPC_MAX_PAYLOAD (8u * 1024u * 1024u)
+
+typedef struct {
+  char name[128];
+  bool fullscreen;
+} sway_output_state_t;
+
+// Called with the fullscreen state of every real output after each tree
+typedef void (*sway_output_handler_t)(const char *output_name,
+                                      bool fullscreen, void *data);
+
+// =============================================================================
+// SESSION
+// =============================================================================
+//
+// One connection subscribed to window and workspace events. Relevant events
+// trigger a GET_TREE on the same connection; the reply is matched by type,
+// so nothing ever blocks. Events that arrive while a tree is outstanding
+// are coalesced into one follow-up request.
+
+typedef struct {
+  int fd;
+  bool tree_pending;  // GET_TREE sent, reply outstanding
+  bool tree_dirty;    // Relevant event seen while the reply is outstanding
+  uint8_t *buf;
+  size_t len;
+  size_t cap;
+  sway_output_handler_t handler;
+  void *data;
+} sway_session_t;
+
+// $SWAYSOCK, or $I3SOCK. False if neither is set.
+bool sway_ipc_socket_path(char *out, size_t size);
+
+// Write the header for a message of type with payload_len bytes into
+// header[SWAY_IPC_HEADER_SIZE]
+void sway_ipc_encode_header(uint8_t *header, uint32_t type,
+                            uint32_t payload_len);
+
+// Parse a GET_TREE reply: one entry per output (scratchpad excluded), with
+// fullscreen set when the output's visible workspace holds a fullscreen
+// container. Returns the number of outputs stored.
+size_t sway_parse_tree(const char *json, sway_output_state_t *out, size_t max);
+
+// True if a window or workspace event can change fullscreen state
+bool sway_event_is_relevant(uint32_t type, const char *json);
+
+// Connect to the socket at path, subscribe and request the initial tree.
+// The fd is non-blocking afterwards.
+bool sway_session_open(sway_session_t *session, const char *path,
+                       sway_output_handler_t handler, void *data);
+
+// Read everything available and handle each complete message. Returns the
+// number of messages handled, or -1 once the connection is closed, the
+// compositor shuts down or the stream is corrupt.
+int sway_session_dispatch(sway_session_t *session);
+
+void sway_session_close(sway_session_t *session);
+
+#endif  // SWAY_IPC_H
@@ -0,0 +1,81 @@
+#ifndef TOPLEVEL_TRACKER_H
+#define TOPLEVEL_TRACKER_H
+
+#include "utils/error.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// =============================================================================
+// FOREIGN TOPLEVEL TRACKER
+// =============================================================================
+//
+// Double-buffered state of every foreign toplevel, as the protocol defines
+// it: state, output_enter and output_leave only touch the pending copy, and
+// the done event commits it. Entries are heap allocated and handed to the
+// handle listener as user data, so every event finds its entry in O(1) and
+// closing a toplevel unlinks it in O(1). There is no fixed cap.
+//
+// Handles and outputs are opaque pointers here, which keeps the module free
+// of Wayland dependencies (the tests replay synthetic event streams).
+
+typedef struct toplevel_entry {
+  struct toplevel_entry *prev;
+  struct toplevel_entry *next;
+  void *handle;
+
+  // Committed by the last done event
+  void *output;  // NULL until the compositor sends output_enter
+  bool fullscreen;
+  bool activated;
+
+  // Accumulated since the last done event
+  void *pending_output;
+  bool pending_fullscreen;
+  bool pending_activated;
+} toplevel_entry_t;
+
+// What a commit changed, with the values it replaced
+typedef struct {
+  bool state_changed;
+  bool output_changed;
+  bool was_fullscreen;
+  bool was_activated;
+  void *old_output;
+} toplevel_change_t;
+
+typedef struct {
+  toplevel_entry_t *head;
+  size_t count;
+  size_t fullscreen_count;  // Committed fullscreen entries
+} toplevel_tracker_t;
+
+// Start tracking handle. Returns NULL on allocation failure.
+BONGOCAT_NODISCARD toplevel_entry_t *
+toplevel_tracker_add(toplevel_tracker_t *tracker, void *handle);
+
+// Stop tracking entry and free it
+void toplevel_tracker_remove(toplevel_tracker_t *tracker,
+                             toplevel_entry_t *entry);
+
+// Free every entry
+void toplevel_tracker_clear(toplevel_tracker_t *tracker);
+
+// Pending updates (take effect on toplevel_tracker_commit)
+void toplevel_entry_set_state(toplevel_entry_t *entry, bool fullscreen,
+                              bool activated);
+void toplevel_entry_output_enter(toplevel_entry_t *entry, void *output);
+void toplevel_entry_output_leave(toplevel_entry_t *entry, void *output);
+
+// Apply the pending state (the done event). Returns true and fills change
+// if anything differs from the committed state.
+bool toplevel_tracker_commit(toplevel_tracker_t *tracker,
+                             toplevel_entry_t *entry,
+                             toplevel_change_t *change);
+
+// True if a committed fullscreen toplevel is on output
+BONGOCAT_NODISCARD bool
+toplevel_tracker_output_has_fullscreen(const toplevel_tracker_t *tracker,
+                                       const void *output);
+
+#endif  // TOPLEVEL_TRACKER_H
@@ -44,6 +44,21 @@ BONGOCAT_NODISCARD bongocat_error_t wayland_init(config_t *config);
 // Run Wayland event loop - must be checked
 BONGOCAT_NODISCARD bongocat_error_t wayland_run(volatile sig_atomic_t *running);
 
+// Wake the event loop so it re-checks *running and runs the tick callback.
+// Async-signal-safe; callable from any thread.
+void wayland_wake(void);
+
+// Handler for an extra fd polled by the event loop. Runs on the main thread
+// once the fd is readable (or hung up), after Wayland events are dispatched.
+typedef void (*wayland_fd_handler_t)(int fd, void *data);
+
+// Poll fd alongside the display in wayland_run(). Valid after wayland_init().
+BONGOCAT_NODISCARD bongocat_error_t
+wayland_add_fd_source(int fd, wayland_fd_handler_t handler, void *data);
+
+// Stop polling fd (the caller still owns and closes it)
+void wayland_remove_fd_source(int fd);
+
 // Cleanup Wayland resources
 void wayland_cleanup(void);
 
@@ -62,12 +77,33 @@ extern size_t output_count;
 // Update configuration (hot-reload support)
 void wayland_update_config(config_t *config);
 
-// Draw the overlay bar
+// Rasterize frames for the current config and publish them with the
+// current surface and buffer as the new render snapshot (main thread only)
+void wayland_publish_render_state(void);
+
+// Draw the overlay bar from the published render snapshot. Only called by
+// the animation thread (or loop); others use animation_request_redraw().
 void draw_bar(void);
 
 // Create shared memory buffer - returns fd or -1 on error
 BONGOCAT_NODISCARD int create_shm(int size);
 
+// Create a click-through layer surface for config on wl_output (NULL lets
+// the compositor pick) and commit it. The listener receives data.
+BONGOCAT_NODISCARD bongocat_error_t wayland_create_layer_surface(
+    struct wl_output *wl_output, const config_t *config,
+    const struct zwlr_layer_surface_v1_listener *listener, void *data,
+    struct wl_surface **out_surface,
+    struct zwlr_layer_surface_v1 **out_layer_surface);
+
+// Create a width x height ARGB8888 buffer backed by mapped shared memory
+BONGOCAT_NODISCARD bongocat_error_t
+wayland_create_shm_buffer(int width, int height, struct wl_buffer **out_buffer,
+                          uint8_t **out_pixels, size_t *out_size);
+
+// Unmap the pixels of a buffer from wayland_create_shm_buffer()
+void wayland_unmap_shm_buffer(uint8_t *map, size_t size);
+
 // Get detected screen width
 BONGOCAT_NODISCARD int wayland_get_screen_width(void);
 
@@ -77,7 +113,8 @@ BONGOCAT_NODISCARD const char *wayland_get_output_name(void);
 // Get the wl_output associated with the current screen info (may be NULL)
 BONGOCAT_NODISCARD struct wl_output *wayland_get_current_screen_output(void);
 
-// Register a per-loop callback executed on Wayland main thread.
+// Register a per-loop callback executed on Wayland main thread. The loop
+// has no timeout, so whoever sets state for the callback must wayland_wake().
 void wayland_set_tick_callback(void (*callback)(void));
 
 // Get current layer name for logging
@@ -2,6 +2,7 @@
 #define ERROR_H
 
 #include <errno.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdio.h>
@@ -83,11 +84,69 @@ typedef enum {
 // =============================================================================
 // LOGGING FUNCTIONS
 // =============================================================================
+//
+// Once bongocat_log_start() has run, a log call takes the time, formats the
+// message straight into a slot of a lock-free ring and returns. A writer
+// thread turns records into lines and hands them to writev() in batches. A
+// full ring drops the message and counts it. Before the writer starts (and
+// in the tests) lines are written synchronously.
 
-void bongocat_log_error(const char *format, ...);
-void bongocat_log_warning(const char *format, ...);
-void bongocat_log_info(const char *format, ...);
-void bongocat_log_debug(const char *format, ...);
+typedef enum {
+  BONGOCAT_LOG_LEVEL_DEBUG = 0,
+  BONGOCAT_LOG_LEVEL_INFO,
+  BONGOCAT_LOG_LEVEL_WARNING,
+  BONGOCAT_LOG_LEVEL_ERROR,
+} bongocat_log_level_t;
+
+// Calls below this level compile to nothing (make LOG_MIN_LEVEL=1)
+#ifndef BONGOCAT_LOG_MIN_LEVEL
+#  define BONGOCAT_LOG_MIN_LEVEL BONGOCAT_LOG_LEVEL_DEBUG
+#endif
+
+extern atomic_int bongocat_log_debug_flag;
+
+static inline bool bongocat_log_debug_enabled(void) {
+  return atomic_load_explicit(&bongocat_log_debug_flag,
+                              memory_order_relaxed) != 0;
+}
+
+void bongocat_log_write(bongocat_log_level_t level, const char *format, ...)
+    __attribute__((format(printf, 2, 3)));
+
+// Disabled levels still type-check their arguments but never evaluate them
+#define BONGOCAT_LOG_AT(level, ...)             \
+  do {                                          \
+    if ((level) >= BONGOCAT_LOG_MIN_LEVEL) {    \
+      bongocat_log_write((level), __VA_ARGS__); \
+    }                                           \
+  } while (0)
+
+#define bongocat_log_error(...) \
+  BONGOCAT_LOG_AT(BONGOCAT_LOG_LEVEL_ERROR, __VA_ARGS__)
+#define bongocat_log_warning(...) \
+  BONGOCAT_LOG_AT(BONGOCAT_LOG_LEVEL_WARNING, __VA_ARGS__)
+#define bongocat_log_info(...) \
+  BONGOCAT_LOG_AT(BONGOCAT_LOG_LEVEL_INFO, __VA_ARGS__)
+#define bongocat_log_debug(...)                                  \
+  do {                                                           \
+    if (BONGOCAT_LOG_LEVEL_DEBUG >= BONGOCAT_LOG_MIN_LEVEL &&    \
+        bongocat_log_debug_enabled()) {                          \
+      bongocat_log_write(BONGOCAT_LOG_LEVEL_DEBUG, __VA_ARGS__); \
+    }                                                            \
+  } while (0)
+
+// Start the writer thread. Forked children start their own on first use.
+// Pending records are written at exit().
+void bongocat_log_start(void);
+
+// Write every record logged so far before returning
+void bongocat_log_flush(void);
+
+// Stop the writer after draining the ring; later calls write synchronously
+void bongocat_log_stop(void);
+
+// Messages lost to a full ring since start (also reported in the log)
+BONGOCAT_NODISCARD size_t bongocat_log_dropped(void);
 
 // =============================================================================
 // ERROR HANDLING
@@ -0,0 +1,59 @@
+#ifndef JSON_SCAN_H
+#define JSON_SCAN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// =============================================================================
+// IN-PLACE JSON SCANNER
+// =============================================================================
+//
+// Just enough JSON to walk compositor IPC replies where they lie: values are
+// located by pointer into a NUL-terminated document and converted on demand,
+// so nothing is allocated or copied except the strings the caller asks for.
+// Every function accepts NULL and then fails, so lookups can be chained.
+
+typedef struct {
+  const char *key;  // First character of the (still escaped) key
+  size_t key_len;
+  const char *value;
+} json_member_t;
+
+// Skip whitespace at p
+const char *json_skip_ws(const char *p);
+
+// Position after the value at p, or NULL if it is malformed
+const char *json_skip_value(const char *p);
+
+// Value of key in the object at obj, or NULL
+const char *json_object_get(const char *obj, const char *key);
+
+// Object iteration:
+//   for (const char *it = json_object_first(obj, &m); it;
+//        it = json_object_next(it, &m))
+const char *json_object_first(const char *obj, json_member_t *member);
+const char *json_object_next(const char *it, json_member_t *member);
+
+// First element of the array at value, or NULL if empty or not an array
+const char *json_array_first(const char *value);
+
+// Element following elem, or NULL at the end of the array
+const char *json_array_next(const char *elem);
+
+// Integer (or boolean as 0/1) at value. Fractions are truncated.
+bool json_get_int(const char *value, int *out);
+
+// Unsigned 64-bit integer at value
+bool json_get_u64(const char *value, uint64_t *out);
+
+// Unescaped copy of the string at value (truncated to size)
+bool json_get_string(const char *value, char *out, size_t size);
+
+// True if the value is a string equal to s (no escapes in s)
+bool json_string_equals(const char *value, const char *s);
+
+// Two-element integer array such as "at": [x, y]
+bool json_get_pair(const char *value, int *a, int *b);
+
+#endif  // JSON_SCAN_H
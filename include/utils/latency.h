@@ -0,0 +1,106 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include "utils/error.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// =============================================================================
+// LOG-LINEAR HISTOGRAM
+// =============================================================================
+
+// Values below 2^LATENCY_HIST_SUB_BITS microseconds get one bucket each;
+// every power of two above that is split into 2^LATENCY_HIST_SUB_BITS linear
+// sub-buckets, so the relative error stays below ~6% at any magnitude.
+#define LATENCY_HIST_SUB_BITS    4
+#define LATENCY_HIST_SUB_BUCKETS (1 << LATENCY_HIST_SUB_BITS)
+#define LATENCY_HIST_MAX_BITS    32  // Values are clamped to 2^32 us (~71 min)
+#define LATENCY_HIST_BUCKETS                                   \
+  (LATENCY_HIST_SUB_BUCKETS +                                  \
+   (LATENCY_HIST_MAX_BITS - LATENCY_HIST_SUB_BITS) *           \
+       LATENCY_HIST_SUB_BUCKETS)
+
+// Lock-free histogram of microsecond values. Recording is a handful of
+// relaxed atomic adds, so it is safe to call from any thread on hot paths.
+typedef struct {
+  atomic_uint_fast64_t buckets[LATENCY_HIST_BUCKETS];
+  atomic_uint_fast64_t count;
+  atomic_uint_fast64_t sum_us;
+  atomic_uint_fast64_t max_us;
+} latency_histogram_t;
+
+// Summary of a histogram at a point in time
+typedef struct {
+  uint64_t count;
+  uint64_t p50_us;
+  uint64_t p99_us;
+  uint64_t max_us;
+} latency_summary_t;
+
+void latency_histogram_record(latency_histogram_t *hist, uint64_t value_us);
+void latency_histogram_reset(latency_histogram_t *hist);
+
+// Value at the given percentile (0-100), or 0 if the histogram is empty
+BONGOCAT_NODISCARD uint64_t
+latency_histogram_percentile(const latency_histogram_t *hist, double pct);
+
+void latency_histogram_summarize(const latency_histogram_t *hist,
+                                 latency_summary_t *out);
+
+// Number of values below limit_us. Exact when limit_us is a power of two
+// (or below 2^LATENCY_HIST_SUB_BITS); otherwise the bucket holding limit_us
+// is left out.
+BONGOCAT_NODISCARD uint64_t
+latency_histogram_count_below(const latency_histogram_t *hist,
+                              uint64_t limit_us);
+
+// =============================================================================
+// KEYPRESS-TO-COMMIT PIPELINE STAGES
+// =============================================================================
+
+// Every stage is measured from the evdev timestamp of the triggering key
+// event, so each histogram holds the cumulative latency up to that point.
+typedef enum {
+  LATENCY_STAGE_CHILD_READ = 0,  // Input child read() the event
+  LATENCY_STAGE_WAKE,            // Animation thread woke up
+  LATENCY_STAGE_UPDATE,          // anim_update_state() picked the frame
+  LATENCY_STAGE_BLIT,            // Frame blitted into the shm buffer
+  LATENCY_STAGE_COMMIT,          // wl_surface_commit() issued
+  LATENCY_STAGE_FLUSH,           // wl_display_flush() returned
+  LATENCY_STAGE_COUNT
+} latency_stage_t;
+
+// Current CLOCK_MONOTONIC time in microseconds
+BONGOCAT_NODISCARD int64_t latency_now_us(void);
+
+// Start a sample on the calling thread for a key event with the given
+// evdev and child read timestamps (CLOCK_MONOTONIC, microseconds), woken
+// at wake_us. Replaces any sample still pending on this thread.
+void latency_sample_begin(int64_t event_us, int64_t read_us, int64_t wake_us);
+
+// Timestamp a stage of the pending sample on the calling thread (no-op if
+// the thread has no pending sample)
+void latency_sample_mark(latency_stage_t stage);
+
+// Record the pending sample into the stage histograms and clear it
+void latency_sample_finish(void);
+
+// Drop the pending sample without recording it (e.g. no redraw happened)
+void latency_sample_abort(void);
+
+// Evdev timestamp of the pending sample on this thread, or 0 if none
+BONGOCAT_NODISCARD int64_t latency_sample_event_us(void);
+
+// Log p50/p99/max for every stage. Safe to call while samples are recorded.
+void latency_report(void);
+
+// Human-readable stage name
+BONGOCAT_NODISCARD const char *latency_stage_name(latency_stage_t stage);
+
+// Direct access for reporting and tests
+BONGOCAT_NODISCARD const latency_histogram_t *
+latency_get_stage_histogram(latency_stage_t stage);
+
+#endif  // LATENCY_H
@@ -77,12 +77,37 @@ typedef struct memory_pool {
 // =============================================================================
 // MEMORY ALLOCATION FUNCTIONS
 // =============================================================================
+//
+// Blocks carry a small header with their size and subsystem tag, so frees
+// and reallocs are accounted exactly. Memory from these functions must be
+// released with bongocat_free() and never with free().
+
+// Subsystems reported separately by memory_print_stats()
+typedef enum {
+  MEMORY_TAG_OTHER = 0,
+  MEMORY_TAG_CONFIG,
+  MEMORY_TAG_FRAME_CACHE,
+  MEMORY_TAG_SVG,
+  MEMORY_TAG_WAYLAND,
+  MEMORY_TAG_COUNT
+} memory_tag_t;
 
 // All allocation functions are nodiscard - caller must handle the result
 BONGOCAT_NODISCARD void *bongocat_malloc(size_t size);
 BONGOCAT_NODISCARD void *bongocat_calloc(size_t count, size_t size);
 BONGOCAT_NODISCARD void *bongocat_realloc(void *ptr, size_t size);
 
+BONGOCAT_NODISCARD void *bongocat_malloc_tagged(memory_tag_t tag, size_t size);
+BONGOCAT_NODISCARD void *bongocat_calloc_tagged(memory_tag_t tag, size_t count,
+                                                size_t size);
+BONGOCAT_NODISCARD char *bongocat_strdup_tagged(memory_tag_t tag,
+                                                const char *str);
+
+// Account memory the allocator does not hand out: SHM mappings and the
+// internals of vendored libraries. Untrack with the same size.
+void memory_track_external(memory_tag_t tag, size_t size);
+void memory_untrack_external(memory_tag_t tag, size_t size);
+
 // =============================================================================
 // MEMORY POOL FUNCTIONS
 // =============================================================================
@@ -101,18 +126,58 @@ static inline void bongocat_auto_pool_impl(memory_pool_t **pool) {
   }
 }
 
+// =============================================================================
+// MEMORY ARENA
+// =============================================================================
+//
+// Growable bump allocator made of memory pools, for data that lives and dies
+// together. Blocks are never freed one by one: memory_arena_reset() keeps the
+// first chunk for reuse and memory_arena_destroy() releases everything. A
+// zeroed arena is empty and valid. Allocations are pointer-aligned.
+
+#define MEMORY_ARENA_CHUNK_SIZE 1024
+
+struct memory_arena_chunk;
+
+typedef struct {
+  struct memory_arena_chunk *chunks;  // Newest first
+  size_t chunk_size;                  // 0 for MEMORY_ARENA_CHUNK_SIZE
+  memory_tag_t tag;                   // Accounting tag of the chunks
+} memory_arena_t;
+
+BONGOCAT_NODISCARD void *memory_arena_alloc(memory_arena_t *arena,
+                                            size_t size);
+BONGOCAT_NODISCARD char *memory_arena_strdup(memory_arena_t *arena,
+                                             const char *str);
+BONGOCAT_NODISCARD char *memory_arena_strndup(memory_arena_t *arena,
+                                              const char *str, size_t len);
+void memory_arena_reset(memory_arena_t *arena);
+void memory_arena_destroy(memory_arena_t *arena);
+
+// Bytes handed out and bytes held in chunks
+void memory_arena_usage(const memory_arena_t *arena, size_t *used,
+                        size_t *capacity);
+
 // =============================================================================
 // MEMORY STATISTICS
 // =============================================================================
 
+typedef struct {
+  size_t live_bytes;
+  size_t live_blocks;
+} memory_tag_stats_t;
+
 typedef struct {
   size_t total_allocated;
   size_t current_allocated;
   size_t peak_allocated;
   size_t allocation_count;
   size_t free_count;
+  memory_tag_stats_t tags[MEMORY_TAG_COUNT];
 } memory_stats_t;
 
+BONGOCAT_NODISCARD const char *memory_tag_name(memory_tag_t tag);
+
 void memory_get_stats(memory_stats_t *stats);
 void memory_print_stats(void);
 
@@ -0,0 +1,99 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "utils/error.h"
+#include "utils/latency.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// =============================================================================
+// RUNTIME METRICS
+// =============================================================================
+//
+// Counters for the metrics socket. Every update is one relaxed atomic add
+// or store, so the hot paths pay nothing that a scrape could make worse.
+// metrics_init() moves the counters into a shared mapping before the input
+// child is forked, so its key presses and wakeups are counted as well.
+// Until then (and in tests) they live in process memory.
+
+typedef enum {
+  METRIC_FRAMES_DRAWN = 0,       // draw_bar() presented at least one target
+  METRIC_FRAMES_SKIPPED,         // draw_bar() presented nothing
+  METRIC_KEY_PRESSES,            // Key presses read by the input child
+  METRIC_KEY_PRESSES_COALESCED,  // Presses that shared a wake with another
+  METRIC_KEY_PRESSES_SUPPRESSED, // Presses while rendering was suspended
+  METRIC_COUNTER_COUNT
+} metrics_counter_t;
+
+// Threads whose wakeups are counted. In single-threaded mode the animation
+// state machine runs on the main thread.
+typedef enum {
+  METRICS_THREAD_MAIN = 0,
+  METRICS_THREAD_ANIMATION,
+  METRICS_THREAD_CONFIG_WATCHER,
+  METRICS_THREAD_INPUT,  // The input child process
+  METRICS_THREAD_COUNT
+} metrics_thread_t;
+
+// Map the counters where the input child will see them and reset them.
+// Call once per instance, before any thread or the input child starts.
+BONGOCAT_NODISCARD bongocat_error_t metrics_init(void);
+void metrics_cleanup(void);
+
+void metrics_add(metrics_counter_t counter, uint64_t value);
+void metrics_count_wakeup(metrics_thread_t thread);
+void metrics_set_input_devices(int count);
+void metrics_record_draw(uint64_t duration_us);
+void metrics_record_reload(uint64_t duration_us);
+
+// =============================================================================
+// SNAPSHOTS AND FORMATS
+// =============================================================================
+
+// Upper bounds of the exported histogram buckets: powers of two from 64 us
+// to about 1 s, which the log-linear histogram counts exactly
+#define METRICS_HIST_MIN_BITS 6
+#define METRICS_HIST_BOUNDS   15
+
+typedef struct {
+  uint64_t count;
+  uint64_t sum_us;
+  uint64_t max_us;
+  uint64_t p50_us;
+  uint64_t p99_us;
+  uint64_t below[METRICS_HIST_BOUNDS];  // Values below each bound
+} metrics_histogram_t;
+
+typedef struct {
+  int64_t taken_us;  // CLOCK_MONOTONIC time of the snapshot
+  uint64_t uptime_us;
+  int pid;
+  uint64_t counters[METRIC_COUNTER_COUNT];
+  uint64_t wakeups[METRICS_THREAD_COUNT];
+  // Wakeups per second since the previous snapshot passed to
+  // metrics_snapshot(), or since metrics_init() without one
+  double wakeups_per_sec[METRICS_THREAD_COUNT];
+  int input_devices;
+  metrics_histogram_t draw;
+  metrics_histogram_t reload;
+  size_t frame_cache_bytes;
+  size_t shm_bytes;
+} metrics_snapshot_t;
+
+void metrics_snapshot(metrics_snapshot_t *out, const metrics_snapshot_t *prev);
+
+// Upper bound of histogram bucket i in microseconds
+BONGOCAT_NODISCARD uint64_t metrics_hist_bound_us(size_t i);
+
+BONGOCAT_NODISCARD const char *metrics_thread_name(metrics_thread_t thread);
+
+// Write the snapshot as a JSON object or an OpenMetrics text exposition.
+// Like snprintf(), the result is NUL-terminated and truncated to size, and
+// the return value is the length the whole text needs.
+size_t metrics_format_json(const metrics_snapshot_t *snap, char *buf,
+                           size_t size);
+size_t metrics_format_openmetrics(const metrics_snapshot_t *snap, char *buf,
+                                  size_t size);
+
+#endif  // METRICS_H
@@ -0,0 +1,29 @@
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include "utils/error.h"
+
+// =============================================================================
+// METRICS SOCKET
+// =============================================================================
+//
+// A read-only UNIX socket at $XDG_RUNTIME_DIR/bongocat/<pid>.sock, served
+// by a thread that sleeps in poll() until a client connects. Each
+// connection gets one metrics snapshot and is closed:
+//
+//   socat - UNIX-CONNECT:$sock </dev/null          JSON
+//   echo openmetrics | socat - UNIX-CONNECT:$sock  OpenMetrics text
+//   curl --unix-socket $sock http://localhost/metrics   (or /json)
+//
+// Only clients running as the same user are answered.
+
+// Create the socket and start serving. Fails without XDG_RUNTIME_DIR.
+BONGOCAT_NODISCARD bongocat_error_t metrics_server_start(void);
+
+// Stop the thread and remove the socket
+void metrics_server_stop(void);
+
+// Socket path while the server runs, or NULL
+BONGOCAT_NODISCARD const char *metrics_server_path(void);
+
+#endif  // METRICS_SERVER_H
@@ -0,0 +1,60 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "utils/error.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// =============================================================================
+// THREAD ACTIVITY TRACE (--trace)
+// =============================================================================
+//
+// Spans and instant events from every thread and the input child, written
+// as Chrome trace-event JSON that ui.perfetto.dev and chrome://tracing open.
+// Each thread appends to a buffer of its own with no lock: one writer per
+// buffer, which publishes its event count with a release store. All buffers
+// sit in one shared mapping made before the input child is forked, so the
+// child's events are written out by the parent. Timestamps are
+// CLOCK_MONOTONIC microseconds in every process.
+//
+// Names must be string literals: forked children share the parent's
+// addresses, so the parent can print the names the child recorded.
+//
+// Disabled (the default), every call is one relaxed load and a branch.
+
+#define TRACE_MAX_THREADS     16
+#define TRACE_EVENTS_PER_SLOT 131072  // 4 MB, touched only as it fills
+
+extern atomic_bool trace_enabled_flag;
+
+static inline bool trace_enabled(void) {
+  return atomic_load_explicit(&trace_enabled_flag, memory_order_relaxed);
+}
+
+// Map the buffers and start recording. Call before any thread starts and
+// before the input child is forked.
+BONGOCAT_NODISCARD bongocat_error_t trace_init(const char *path);
+
+// Give the calling thread its own track, shown under name
+void trace_set_thread_name(const char *name);
+
+// Start of a span: the current time, or 0 when tracing is off
+BONGOCAT_NODISCARD int64_t trace_begin(void);
+
+// Record a span from start_us (as returned by trace_begin()) to now
+void trace_end(const char *name, int64_t start_us);
+void trace_end_arg(const char *name, int64_t start_us, int64_t arg);
+
+void trace_instant(const char *name);
+void trace_instant_arg(const char *name, int64_t arg);
+
+// Write everything recorded so far to the trace file, replacing it. Safe
+// while other threads keep recording; their newest events may be missed.
+BONGOCAT_NODISCARD bongocat_error_t trace_write(void);
+
+// Stop recording and release the buffers
+void trace_cleanup(void);
+
+#endif  // TRACE_H
@@ -0,0 +1,130 @@
+#!/usr/bin/env bash
+# Generate the perfect-hash table for config keys.
+# NOTE: This script should be run manually when a config key is added
+# (make config-keys). The generated header is committed to git.
+
+set -euo pipefail
+
+OUTPUT_FILE="include/config/config_keys.h"
+
+# Every key the parser accepts, in config_key_t order
+KEYS=(
+    cat_x_offset cat_y_offset cat_height overlay_height idle_frame
+    keypress_duration test_animation_duration test_animation_interval fps
+    overlay_opacity mirror_x mirror_y enable_antialiasing enable_hand_mapping
+    enable_debug enable_scheduled_sleep idle_sleep_timeout
+    hotplug_scan_interval disable_fullscreen_hide enable_output_power_tracking
+    layer overlay_position multi_monitor_mode cat_align
+    sleep_begin sleep_end
+    monitor keyboard_name keyboard_device keyboard_devices
+)
+
+# A power of two well above the key count, so a seed is quick to find
+SLOTS=128
+
+# Must match config_key_hash() below: h = h * seed + c (mod 2^32)
+HASH_AWK='
+    BEGIN { for (i = 1; i < 256; i++) ord[sprintf("%c", i)] = i }
+    function key_slot(key, seed,    h, i, n) {
+        h = 0
+        n = length(key)
+        for (i = 1; i <= n; i++) {
+            h = (h * seed + ord[substr(key, i, 1)]) % 4294967296
+        }
+        return h % slots
+    }'
+
+# Smallest odd multiplier that gives every key its own slot
+SEED=$(printf '%s\n' "${KEYS[@]}" | awk -v slots="$SLOTS" "$HASH_AWK"'
+    { keys[NR] = $0 }
+    END {
+        for (seed = 3; seed < 65536; seed += 2) {
+            split("", used)
+            ok = 1
+            for (k = 1; k <= NR && ok; k++) {
+                s = key_slot(keys[k], seed)
+                if (s in used) ok = 0
+                used[s] = 1
+            }
+            if (ok) { print seed; exit }
+        }
+        exit 1
+    }')
+
+echo "Generating $OUTPUT_FILE (seed $SEED, $SLOTS slots)..."
+
+{
+    cat << 'EOF'
+#ifndef CONFIG_KEYS_H
+#define CONFIG_KEYS_H
+
+// Generated by scripts/gen_config_keys.sh - do not edit.
+// Perfect hash over every config key: config_key_lookup() costs one hash
+// and one comparison however many keys there are.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef enum {
+  CONFIG_KEY_NONE = -1,
+EOF
+
+    for key in "${KEYS[@]}"; do
+        echo "  CONFIG_KEY_${key^^},"
+    done
+
+    cat << EOF
+  CONFIG_KEY_COUNT,
+} config_key_t;
+
+#define CONFIG_KEY_HASH_SEED  ${SEED}U
+#define CONFIG_KEY_HASH_SLOTS ${SLOTS}U
+
+static const char *const config_key_names[CONFIG_KEY_COUNT] = {
+EOF
+
+    for key in "${KEYS[@]}"; do
+        echo "    [CONFIG_KEY_${key^^}] = \"${key}\","
+    done
+
+    echo "};"
+    echo ""
+    echo "// Slot -> key"
+    echo "static const int8_t config_key_slots[CONFIG_KEY_HASH_SLOTS] = {"
+
+    printf '%s\n' "${KEYS[@]}" | awk -v slots="$SLOTS" -v seed="$SEED" \
+        "$HASH_AWK"'
+        { slot[key_slot($0, seed)] = "CONFIG_KEY_" toupper($0) }
+        END {
+            for (s = 0; s < slots; s++) {
+                printf "    %s,\n", (s in slot) ? slot[s] : "CONFIG_KEY_NONE"
+            }
+        }'
+
+    cat << 'EOF'
+};
+
+static inline uint32_t config_key_hash(const char *key, size_t len) {
+  uint32_t h = 0;
+  for (size_t i = 0; i < len; i++) {
+    h = h * CONFIG_KEY_HASH_SEED + (unsigned char)key[i];
+  }
+  return h;
+}
+
+// Key for the len bytes at key (not NUL-terminated), or CONFIG_KEY_NONE
+static inline config_key_t config_key_lookup(const char *key, size_t len) {
+  int id = config_key_slots[config_key_hash(key, len) % CONFIG_KEY_HASH_SLOTS];
+  if (id < 0 || strncmp(config_key_names[id], key, len) != 0 ||
+      config_key_names[id][len] != '\0') {
+    return CONFIG_KEY_NONE;
+  }
+  return (config_key_t)id;
+}
+
+#endif  // CONFIG_KEYS_H
+EOF
+} > "$OUTPUT_FILE"
+
+echo "Done."
@@ -1,6 +1,7 @@
 #define _POSIX_C_SOURCE 200809L
 #include "config/config.h"
 
+#include "config/config_keys.h"
 #include "utils/error.h"
 #include "utils/memory.h"
 
@@ -13,6 +14,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/ioctl.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 // =============================================================================
@@ -145,6 +147,8 @@ static bongocat_error_t config_validate(config_t *config) {
   config->mirror_x = config->mirror_x ? 1 : 0;
   config->mirror_y = config->mirror_y ? 1 : 0;
   config->enable_antialiasing = config->enable_antialiasing ? 1 : 0;
+  config->enable_output_power_tracking =
+      config->enable_output_power_tracking ? 1 : 0;
   config_validate_time(config);
   return BONGOCAT_SUCCESS;
 }
@@ -153,31 +157,40 @@ static bongocat_error_t config_validate(config_t *config) {
 // DEVICE MANAGEMENT MODULE
 // =============================================================================
 
-static bongocat_error_t config_expand_array(char ***array_ptr, int *count,
-                                            const char *str) {
-  char **new_array =
-      bongocat_realloc(*array_ptr, (*count + 1) * sizeof(char *));
-  if (!new_array) {
+// Appends str, which must already live in the config's arena. Arrays have
+// room for the next power of two of entries (at least 4) and move to a
+// twice larger copy when full; the arena drops the old copy with the rest
+// of the generation.
+static bongocat_error_t config_push_string(config_t *config, char ***array_ptr,
+                                           int *count, char *str) {
+  if (!str) {
     return BONGOCAT_ERROR_MEMORY;
   }
-  *array_ptr = new_array;
 
-  size_t len = strlen(str);
-  (*array_ptr)[*count] = BONGOCAT_MALLOC(len + 1);
-  if (!(*array_ptr)[*count]) {
-    return BONGOCAT_ERROR_MEMORY;
+  int n = *count;
+  if (n == 0 || (n >= 4 && (n & (n - 1)) == 0)) {
+    size_t capacity = n == 0 ? 4 : (size_t)n * 2;
+    char **grown =
+        memory_arena_alloc(&config->arena, capacity * sizeof(char *));
+    if (!grown) {
+      return BONGOCAT_ERROR_MEMORY;
+    }
+    if (n > 0) {
+      memcpy(grown, *array_ptr, (size_t)n * sizeof(char *));
+    }
+    *array_ptr = grown;
   }
 
-  memcpy((*array_ptr)[*count], str, len + 1);  // includes null terminator
+  (*array_ptr)[n] = str;
   (*count)++;
-
   return BONGOCAT_SUCCESS;
 }
 
 static bongocat_error_t config_add_keyboard_device(config_t *config,
                                                    const char *device_path) {
-  bongocat_error_t err = config_expand_array(
-      &config->keyboard_devices, &config->num_keyboard_devices, device_path);
+  bongocat_error_t err = config_push_string(
+      config, &config->keyboard_devices, &config->num_keyboard_devices,
+      memory_arena_strdup(&config->arena, device_path));
   if (err != BONGOCAT_SUCCESS) {
     bongocat_log_error("Failed to add keyboard device: %s",
                        bongocat_error_string(err));
@@ -240,207 +253,260 @@ static bongocat_error_t config_resolve_devices(config_t *config) {
   return BONGOCAT_SUCCESS;
 }
 
-static void config_free_string_array(char ***array_ptr, int *count) {
-  if (*array_ptr) {
-    for (int i = 0; i < *count; i++) {
-      BONGOCAT_SAFE_FREE((*array_ptr)[i]);
-    }
-    BONGOCAT_SAFE_FREE(*array_ptr);
-    *count = 0;
-  }
-}
-
-static void config_cleanup_devices(config_t *config) {
-  if (!config) {
-    return;
-  }
+// =============================================================================
+// FIELD DESCRIPTORS
+// =============================================================================
 
-  config_free_string_array(&config->keyboard_devices,
-                           &config->num_keyboard_devices);
-  config_free_string_array(&config->keyboard_names, &config->num_names);
-}
+// How the value of each key is parsed and where it is stored. Indexed by
+// the config_key_t that config_key_lookup() returns.
+typedef enum {
+  CONFIG_FIELD_INT,
+  CONFIG_FIELD_ENUM,
+  CONFIG_FIELD_TIME,
+  CONFIG_FIELD_MONITORS,
+  CONFIG_FIELD_KEYBOARD_NAME,
+  CONFIG_FIELD_KEYBOARD_DEVICE,
+} config_field_type_t;
+
+typedef struct {
+  const char *name;
+  int value;
+} config_enum_name_t;
+
+typedef struct {
+  config_field_type_t type;
+  size_t offset;                    // Into config_t (int, enum, time)
+  const config_enum_name_t *names;  // Enum values; the first is the fallback
+  size_t num_names;
+} config_field_t;
+
+// Enum fields are written through an int
+_Static_assert(sizeof(layer_type_t) == sizeof(int), "enum size");
+_Static_assert(sizeof(overlay_position_t) == sizeof(int), "enum size");
+_Static_assert(sizeof(multi_monitor_mode_t) == sizeof(int), "enum size");
+_Static_assert(sizeof(align_type_t) == sizeof(int), "enum size");
+
+static const config_enum_name_t config_layer_names[] = {
+    {"top", LAYER_TOP},
+    {"overlay", LAYER_OVERLAY},
+};
+static const config_enum_name_t config_position_names[] = {
+    {"top", POSITION_TOP},
+    {"bottom", POSITION_BOTTOM},
+};
+static const config_enum_name_t config_multi_monitor_names[] = {
+    {"process", MULTI_MONITOR_PROCESS},
+    {"shared", MULTI_MONITOR_SHARED},
+};
+static const config_enum_name_t config_align_names[] = {
+    {"center", ALIGN_CENTER},
+    {"left", ALIGN_LEFT},
+    {"right", ALIGN_RIGHT},
+};
+
+#define FIELD_INT(field)                                                       \
+  {.type = CONFIG_FIELD_INT, .offset = offsetof(config_t, field)}
+#define FIELD_ENUM(field, values)                                              \
+  {.type = CONFIG_FIELD_ENUM,                                                  \
+   .offset = offsetof(config_t, field),                                        \
+   .names = values,                                                            \
+   .num_names = sizeof(values) / sizeof(values[0])}
+#define FIELD_TIME(field)                                                      \
+  {.type = CONFIG_FIELD_TIME, .offset = offsetof(config_t, field)}
+
+static const config_field_t config_fields[CONFIG_KEY_COUNT] = {
+    [CONFIG_KEY_CAT_X_OFFSET] = FIELD_INT(cat_x_offset),
+    [CONFIG_KEY_CAT_Y_OFFSET] = FIELD_INT(cat_y_offset),
+    [CONFIG_KEY_CAT_HEIGHT] = FIELD_INT(cat_height),
+    [CONFIG_KEY_OVERLAY_HEIGHT] = FIELD_INT(overlay_height),
+    [CONFIG_KEY_IDLE_FRAME] = FIELD_INT(idle_frame),
+    [CONFIG_KEY_KEYPRESS_DURATION] = FIELD_INT(keypress_duration),
+    [CONFIG_KEY_TEST_ANIMATION_DURATION] = FIELD_INT(test_animation_duration),
+    [CONFIG_KEY_TEST_ANIMATION_INTERVAL] = FIELD_INT(test_animation_interval),
+    [CONFIG_KEY_FPS] = FIELD_INT(fps),
+    [CONFIG_KEY_OVERLAY_OPACITY] = FIELD_INT(overlay_opacity),
+    [CONFIG_KEY_MIRROR_X] = FIELD_INT(mirror_x),
+    [CONFIG_KEY_MIRROR_Y] = FIELD_INT(mirror_y),
+    [CONFIG_KEY_ENABLE_ANTIALIASING] = FIELD_INT(enable_antialiasing),
+    [CONFIG_KEY_ENABLE_HAND_MAPPING] = FIELD_INT(enable_hand_mapping),
+    [CONFIG_KEY_ENABLE_DEBUG] = FIELD_INT(enable_debug),
+    [CONFIG_KEY_ENABLE_SCHEDULED_SLEEP] = FIELD_INT(enable_scheduled_sleep),
+    [CONFIG_KEY_IDLE_SLEEP_TIMEOUT] = FIELD_INT(idle_sleep_timeout_sec),
+    [CONFIG_KEY_HOTPLUG_SCAN_INTERVAL] = FIELD_INT(hotplug_scan_interval),
+    [CONFIG_KEY_DISABLE_FULLSCREEN_HIDE] = FIELD_INT(disable_fullscreen_hide),
+    [CONFIG_KEY_ENABLE_OUTPUT_POWER_TRACKING] =
+        FIELD_INT(enable_output_power_tracking),
+    [CONFIG_KEY_LAYER] = FIELD_ENUM(layer, config_layer_names),
+    [CONFIG_KEY_OVERLAY_POSITION] =
+        FIELD_ENUM(overlay_position, config_position_names),
+    [CONFIG_KEY_MULTI_MONITOR_MODE] =
+        FIELD_ENUM(multi_monitor_mode, config_multi_monitor_names),
+    [CONFIG_KEY_CAT_ALIGN] = FIELD_ENUM(cat_align, config_align_names),
+    [CONFIG_KEY_SLEEP_BEGIN] = FIELD_TIME(sleep_begin),
+    [CONFIG_KEY_SLEEP_END] = FIELD_TIME(sleep_end),
+    [CONFIG_KEY_MONITOR] = {.type = CONFIG_FIELD_MONITORS},
+    [CONFIG_KEY_KEYBOARD_NAME] = {.type = CONFIG_FIELD_KEYBOARD_NAME},
+    [CONFIG_KEY_KEYBOARD_DEVICE] = {.type = CONFIG_FIELD_KEYBOARD_DEVICE},
+    [CONFIG_KEY_KEYBOARD_DEVICES] = {.type = CONFIG_FIELD_KEYBOARD_DEVICE},
+};
+
+#undef FIELD_INT
+#undef FIELD_ENUM
+#undef FIELD_TIME
 
 // =============================================================================
 // CONFIGURATION PARSING MODULE
 // =============================================================================
 
-static char *config_trim_whitespace(char *text) {
-  while (*text == ' ' || *text == '\t') {
-    text++;
-  }
+// Position of the token being parsed, for warnings
+typedef struct {
+  const char *path;
+  int line;
+  const char *line_start;
+} config_pos_t;
 
-  if (*text == '\0') {
-    return text;
-  }
+#define CONFIG_POS_FMT "%s:%d:%d: "
+#define CONFIG_POS_ARGS(pos, at)                                               \
+  (pos)->path, (pos)->line, (int)((at) - (pos)->line_start) + 1
 
-  char *end = text + strlen(text) - 1;
-  while (end > text && (*end == ' ' || *end == '\t')) {
-    *end = '\0';
-    end--;
-  }
-
-  return text;
+static bool config_is_blank(char c) {
+  return c == ' ' || c == '\t' || c == '\r';
 }
 
-static bool config_parse_int(const char *str, int *out) {
-  if (!str || str[0] == '\0')
+// Decimal int filling [s, s + len), optionally followed by blanks
+static bool config_parse_int_span(const char *s, size_t len, int *out) {
+  size_t i = 0;
+  bool negative = false;
+  if (i < len && (s[i] == '+' || s[i] == '-')) {
+    negative = s[i] == '-';
+    i++;
+  }
+  if (i == len || !isdigit((unsigned char)s[i])) {
     return false;
-  errno = 0;
-  char *endptr;
-  long val = strtol(str, &endptr, 10);
-  if (errno != 0 || endptr == str ||
-      (*endptr != '\0' && *endptr != ' ' && *endptr != '\t'))
+  }
+
+  long long value = 0;
+  for (; i < len && isdigit((unsigned char)s[i]); i++) {
+    value = value * 10 + (s[i] - '0');
+    if (value > (long long)INT_MAX + 1) {
+      return false;
+    }
+  }
+  if (i < len && !config_is_blank(s[i])) {
     return false;
-  if (val < INT_MIN || val > INT_MAX)
+  }
+
+  value = negative ? -value : value;
+  if (value < INT_MIN || value > INT_MAX) {
     return false;
-  *out = (int)val;
+  }
+  *out = (int)value;
   return true;
 }
 
-static bongocat_error_t
-config_parse_integer_key(config_t *config, const char *key, const char *value) {
-  // Identify which field this key maps to (NULL = not an integer key)
-  int *target = NULL;
-  if (strcmp(key, "cat_x_offset") == 0)
-    target = &config->cat_x_offset;
-  else if (strcmp(key, "cat_y_offset") == 0)
-    target = &config->cat_y_offset;
-  else if (strcmp(key, "cat_height") == 0)
-    target = &config->cat_height;
-  else if (strcmp(key, "overlay_height") == 0)
-    target = &config->overlay_height;
-  else if (strcmp(key, "idle_frame") == 0)
-    target = &config->idle_frame;
-  else if (strcmp(key, "keypress_duration") == 0)
-    target = &config->keypress_duration;
-  else if (strcmp(key, "test_animation_duration") == 0)
-    target = &config->test_animation_duration;
-  else if (strcmp(key, "test_animation_interval") == 0)
-    target = &config->test_animation_interval;
-  else if (strcmp(key, "fps") == 0)
-    target = &config->fps;
-  else if (strcmp(key, "overlay_opacity") == 0)
-    target = &config->overlay_opacity;
-  else if (strcmp(key, "mirror_x") == 0)
-    target = &config->mirror_x;
-  else if (strcmp(key, "mirror_y") == 0)
-    target = &config->mirror_y;
-  else if (strcmp(key, "enable_antialiasing") == 0)
-    target = &config->enable_antialiasing;
-  else if (strcmp(key, "enable_hand_mapping") == 0)
-    target = &config->enable_hand_mapping;
-  else if (strcmp(key, "enable_debug") == 0)
-    target = &config->enable_debug;
-  else if (strcmp(key, "enable_scheduled_sleep") == 0)
-    target = &config->enable_scheduled_sleep;
-  else if (strcmp(key, "idle_sleep_timeout") == 0)
-    target = &config->idle_sleep_timeout_sec;
-  else if (strcmp(key, "hotplug_scan_interval") == 0)
-    target = &config->hotplug_scan_interval;
-  else if (strcmp(key, "disable_fullscreen_hide") == 0)
-    target = &config->disable_fullscreen_hide;
-
-  if (!target)
-    return BONGOCAT_ERROR_INVALID_PARAM;  // Not an integer key
-
-  int int_value;
-  if (!config_parse_int(value, &int_value)) {
-    bongocat_log_warning("Invalid integer value '%s' for key '%s'", value, key);
+static bongocat_error_t config_apply_int(config_t *config,
+                                         const config_field_t *field,
+                                         const config_pos_t *pos,
+                                         const char *key, const char *value,
+                                         size_t value_len) {
+  int parsed;
+  if (!config_parse_int_span(value, value_len, &parsed)) {
+    bongocat_log_warning(CONFIG_POS_FMT "invalid integer '%.*s' for '%s'",
+                         CONFIG_POS_ARGS(pos, value), (int)value_len, value,
+                         key);
     return BONGOCAT_ERROR_INVALID_PARAM;
   }
-
-  *target = int_value;
+  *(int *)((char *)config + field->offset) = parsed;
   return BONGOCAT_SUCCESS;
 }
 
-static bongocat_error_t config_parse_enum_key(config_t *config, const char *key,
-                                              const char *value) {
-  if (strcmp(key, "layer") == 0) {
-    if (strcmp(value, "top") == 0) {
-      config->layer = LAYER_TOP;
-    } else if (strcmp(value, "overlay") == 0) {
-      config->layer = LAYER_OVERLAY;
-    } else {
-      bongocat_log_warning("Invalid layer '%s', using 'top'", value);
-      config->layer = LAYER_TOP;
-    }
-  } else if (strcmp(key, "overlay_position") == 0) {
-    if (strcmp(value, "top") == 0) {
-      config->overlay_position = POSITION_TOP;
-    } else if (strcmp(value, "bottom") == 0) {
-      config->overlay_position = POSITION_BOTTOM;
-    } else {
-      bongocat_log_warning("Invalid overlay_position '%s', using 'top'", value);
-      config->overlay_position = POSITION_TOP;
+static bongocat_error_t config_apply_enum(config_t *config,
+                                          const config_field_t *field,
+                                          const config_pos_t *pos,
+                                          const char *key, const char *value,
+                                          size_t value_len) {
+  int *target = (int *)((char *)config + field->offset);
+  for (size_t i = 0; i < field->num_names; i++) {
+    const char *name = field->names[i].name;
+    if (strlen(name) == value_len && memcmp(name, value, value_len) == 0) {
+      *target = field->names[i].value;
+      return BONGOCAT_SUCCESS;
     }
-  } else if (strcmp(key, "cat_align") == 0) {
-    if (strcmp(value, "left") == 0) {
-      config->cat_align = ALIGN_LEFT;
-    } else if (strcmp(value, "center") == 0) {
-      config->cat_align = ALIGN_CENTER;
-    } else if (strcmp(value, "right") == 0) {
-      config->cat_align = ALIGN_RIGHT;
-    } else {
-      bongocat_log_warning("Invalid cat_align '%s', using 'center'", value);
-      config->cat_align = ALIGN_CENTER;
-    }
-  } else {
-    return BONGOCAT_ERROR_INVALID_PARAM;  // Unknown key
   }
 
+  bongocat_log_warning(CONFIG_POS_FMT "invalid %s '%.*s', using '%s'",
+                       CONFIG_POS_ARGS(pos, value), key, (int)value_len,
+                       value, field->names[0].name);
+  *target = field->names[0].value;
   return BONGOCAT_SUCCESS;
 }
 
-static bongocat_error_t config_parse_time_key(config_t *config, const char *key,
-                                              const char *value) {
-  // Only try to parse time for time-related keys
-  if (strcmp(key, "sleep_begin") != 0 && strcmp(key, "sleep_end") != 0) {
-    return BONGOCAT_ERROR_INVALID_PARAM;  // Not a time key
-  }
-
-  int hour, min;
-  if (sscanf(value, "%d:%d", &hour, &min) != 2) {
-    bongocat_log_warning("Invalid time format '%s', expected HH:MM", value);
+static bongocat_error_t config_apply_time(config_t *config,
+                                          const config_field_t *field,
+                                          const config_pos_t *pos,
+                                          const char *value,
+                                          size_t value_len) {
+  const char *colon = memchr(value, ':', value_len);
+  int hour;
+  int min;
+  if (!colon || !config_parse_int_span(value, (size_t)(colon - value), &hour) ||
+      !config_parse_int_span(colon + 1, value_len - (size_t)(colon - value) - 1,
+                             &min)) {
+    bongocat_log_warning(CONFIG_POS_FMT
+                         "invalid time format '%.*s', expected HH:MM",
+                         CONFIG_POS_ARGS(pos, value), (int)value_len, value);
     return BONGOCAT_ERROR_INVALID_PARAM;
   }
 
   if (hour < 0 || hour > 23 || min < 0 || min > 59) {
-    bongocat_log_warning(
-        "Invalid time values '%s', hour must be 0-23, minute must be 0-59",
-        value);
+    bongocat_log_warning(CONFIG_POS_FMT "invalid time '%.*s', hour must be "
+                         "0-23, minute must be 0-59",
+                         CONFIG_POS_ARGS(pos, value), (int)value_len, value);
     return BONGOCAT_ERROR_INVALID_PARAM;
   }
 
-  if (strcmp(key, "sleep_begin") == 0) {
-    config->sleep_begin.hour = hour;
-    config->sleep_begin.min = min;
-  } else if (strcmp(key, "sleep_end") == 0) {
-    config->sleep_end.hour = hour;
-    config->sleep_end.min = min;
-  }
-
+  config_time_t *target = (config_time_t *)((char *)config + field->offset);
+  target->hour = hour;
+  target->min = min;
   return BONGOCAT_SUCCESS;
 }
 
-static bongocat_error_t config_parse_monitor_list(config_t *config,
-                                                  const char *value) {
-  config_free_string_array(&config->output_names, &config->num_output_names);
-  BONGOCAT_SAFE_FREE(config->output_name);
+static char *config_trim_whitespace(char *text) {
+  while (*text == ' ' || *text == '\t') {
+    text++;
+  }
 
-  char *monitor_list = strdup(value);
-  if (!monitor_list) {
-    return BONGOCAT_ERROR_MEMORY;
+  if (*text == '\0') {
+    return text;
+  }
+
+  char *end = text + strlen(text) - 1;
+  while (end > text && (*end == ' ' || *end == '\t')) {
+    *end = '\0';
+    end--;
   }
 
+  return text;
+}
+
+// Splits monitor_list, an arena copy of the value, in place: the names
+// point into it
+static bongocat_error_t config_parse_monitor_list(config_t *config,
+                                                  char *monitor_list) {
+  // A later monitor= line replaces the list; the old one stays in the arena
+  config->output_names = NULL;
+  config->num_output_names = 0;
+  config->output_name = NULL;
+
   char *saveptr = NULL;
   char *token = strtok_r(monitor_list, ",", &saveptr);
   while (token) {
     char *monitor_name = config_trim_whitespace(token);
     if (monitor_name[0] != '\0') {
-      bongocat_error_t err = config_expand_array(
-          &config->output_names, &config->num_output_names, monitor_name);
+      bongocat_error_t err = config_push_string(
+          config, &config->output_names, &config->num_output_names,
+          monitor_name);
       if (err != BONGOCAT_SUCCESS) {
-        free(monitor_list);
         return err;
       }
     }
@@ -448,13 +514,8 @@ static bongocat_error_t config_parse_monitor_list(config_t *config,
     token = strtok_r(NULL, ",", &saveptr);
   }
 
-  free(monitor_list);
-
   if (config->num_output_names > 0) {
-    config->output_name = strdup(config->output_names[0]);
-    if (!config->output_name) {
-      return BONGOCAT_ERROR_MEMORY;
-    }
+    config->output_name = config->output_names[0];
   } else {
     bongocat_log_warning(
         "monitor is empty, falling back to automatic output selection");
@@ -463,102 +524,207 @@ static bongocat_error_t config_parse_monitor_list(config_t *config,
   return BONGOCAT_SUCCESS;
 }
 
-static bongocat_error_t
-config_parse_string_key(config_t *config, const char *key, const char *value) {
-  if (strcmp(key, "monitor") == 0) {
-    return config_parse_monitor_list(config, value);
-  } else if (strcmp(key, "keyboard_name") == 0) {
-    return config_expand_array(&config->keyboard_names, &config->num_names,
-                               value);
-  } else {
-    return BONGOCAT_ERROR_INVALID_PARAM;  // Unknown key
+static bongocat_error_t config_apply_device(config_t *config,
+                                            const config_pos_t *pos,
+                                            const char *at, char *value) {
+  // Validate path starts with /dev/input/ and has no traversal
+  if (strncmp(value, "/dev/input/", 11) != 0) {
+    bongocat_log_warning(CONFIG_POS_FMT "keyboard_device path must start "
+                         "with /dev/input/: %s",
+                         CONFIG_POS_ARGS(pos, at), value);
+    return BONGOCAT_ERROR_INVALID_PARAM;
   }
+  if (strstr(value, "..") != NULL) {
+    bongocat_log_warning(CONFIG_POS_FMT
+                         "path traversal detected in device path: %s",
+                         CONFIG_POS_ARGS(pos, at), value);
+    return BONGOCAT_ERROR_INVALID_PARAM;
+  }
+  return config_push_string(config, &config->keyboard_devices,
+                            &config->num_keyboard_devices, value);
 }
 
-static bongocat_error_t
-config_parse_key_value(config_t *config, const char *key, const char *value) {
-  // Try integer keys first
-  if (config_parse_integer_key(config, key, value) == BONGOCAT_SUCCESS) {
-    return BONGOCAT_SUCCESS;
+// String values are the only ones copied out of the file buffer, once,
+// into the config's arena
+static bongocat_error_t config_apply_string(config_t *config,
+                                            const config_field_t *field,
+                                            const config_pos_t *pos,
+                                            const char *value,
+                                            size_t value_len) {
+  char *copy = memory_arena_strndup(&config->arena, value, value_len);
+  if (!copy) {
+    return BONGOCAT_ERROR_MEMORY;
+  }
+
+  switch (field->type) {
+  case CONFIG_FIELD_MONITORS:
+    return config_parse_monitor_list(config, copy);
+  case CONFIG_FIELD_KEYBOARD_NAME:
+    return config_push_string(config, &config->keyboard_names,
+                              &config->num_names, copy);
+  case CONFIG_FIELD_KEYBOARD_DEVICE:
+    return config_apply_device(config, pos, value, copy);
+  default:
+    return BONGOCAT_ERROR_INVALID_PARAM;
+  }
+}
+
+static bongocat_error_t config_apply_key(config_t *config,
+                                        const config_pos_t *pos,
+                                        const char *key, size_t key_len,
+                                        const char *value, size_t value_len) {
+  config_key_t id = config_key_lookup(key, key_len);
+  if (id == CONFIG_KEY_NONE) {
+    bongocat_log_warning(CONFIG_POS_FMT "unknown configuration key '%.*s'",
+                         CONFIG_POS_ARGS(pos, key), (int)key_len, key);
+    return BONGOCAT_ERROR_INVALID_PARAM;
   }
 
-  // Try enum keys
-  if (config_parse_enum_key(config, key, value) == BONGOCAT_SUCCESS) {
+  const config_field_t *field = &config_fields[id];
+  const char *name = config_key_names[id];
+  switch (field->type) {
+  case CONFIG_FIELD_INT:
+    return config_apply_int(config, field, pos, name, value, value_len);
+  case CONFIG_FIELD_ENUM:
+    return config_apply_enum(config, field, pos, name, value, value_len);
+  case CONFIG_FIELD_TIME:
+    return config_apply_time(config, field, pos, value, value_len);
+  case CONFIG_FIELD_MONITORS:
+  case CONFIG_FIELD_KEYBOARD_NAME:
+  case CONFIG_FIELD_KEYBOARD_DEVICE:
+    return config_apply_string(config, field, pos, value, value_len);
+  }
+  return BONGOCAT_ERROR_INVALID_PARAM;
+}
+
+// Value ends at an inline comment: " #" or "\t#", or a leading '#'
+static const char *config_value_end(const char *value, const char *end) {
+  if (value < end && *value == '#') {
+    return value;
+  }
+  for (const char *p = value; p + 1 < end; p++) {
+    if ((*p == ' ' || *p == '\t') && p[1] == '#') {
+      return p;
+    }
+  }
+  return end;
+}
+
+// Parse one line [start, end) without copying it. Only a failed allocation
+// is an error; anything malformed is logged with its position and skipped.
+static bongocat_error_t config_parse_line(config_t *config, config_pos_t *pos,
+                                          const char *start, const char *end) {
+  const char *p = start;
+  while (p < end && config_is_blank(*p)) {
+    p++;
+  }
+  if (p >= end || *p == '#') {
     return BONGOCAT_SUCCESS;
   }
 
-  // Try time keys
-  if (config_parse_time_key(config, key, value) == BONGOCAT_SUCCESS) {
+  const char *equals = memchr(p, '=', (size_t)(end - p));
+  if (!equals) {
+    const char *line_end = end;
+    while (line_end > p && config_is_blank(line_end[-1])) {
+      line_end--;
+    }
+    bongocat_log_warning(CONFIG_POS_FMT "expected key=value: %.*s",
+                         CONFIG_POS_ARGS(pos, p), (int)(line_end - p), p);
     return BONGOCAT_SUCCESS;
   }
 
-  // Try string keys
-  if (config_parse_string_key(config, key, value) == BONGOCAT_SUCCESS) {
+  const char *key_end = equals;
+  while (key_end > p && config_is_blank(key_end[-1])) {
+    key_end--;
+  }
+  if (key_end == p) {
+    bongocat_log_warning(CONFIG_POS_FMT "missing key before '='",
+                         CONFIG_POS_ARGS(pos, equals));
     return BONGOCAT_SUCCESS;
   }
 
-  // Handle device keys
-  if (strcmp(key, "keyboard_device") == 0 ||
-      strcmp(key, "keyboard_devices") == 0) {
-    // Validate path starts with /dev/input/ and has no traversal
-    if (strncmp(value, "/dev/input/", 11) != 0) {
-      bongocat_log_warning(
-          "keyboard_device path must start with /dev/input/: %s", value);
-      return BONGOCAT_ERROR_INVALID_PARAM;
-    }
-    if (strstr(value, "..") != NULL) {
-      bongocat_log_warning("Path traversal detected in device path: %s", value);
-      return BONGOCAT_ERROR_INVALID_PARAM;
-    }
-    return config_add_keyboard_device(config, value);
+  const char *value = equals + 1;
+  while (value < end && config_is_blank(*value)) {
+    value++;
+  }
+  const char *value_end = config_value_end(value, end);
+  while (value_end > value && config_is_blank(value_end[-1])) {
+    value_end--;
   }
 
-  // Unknown key
-  return BONGOCAT_ERROR_INVALID_PARAM;
+  bongocat_error_t result =
+      config_apply_key(config, pos, p, (size_t)(key_end - p), value,
+                       (size_t)(value_end - value));
+  return result == BONGOCAT_ERROR_INVALID_PARAM ? BONGOCAT_SUCCESS : result;
 }
 
-static bool config_is_comment_or_empty(const char *line) {
-  const unsigned char *p = (const unsigned char *)line;
-  while (*p == ' ' || *p == '\t') {
-    p++;
+// Tokenize the whole buffer in one pass. Lines have no length limit.
+static bongocat_error_t config_parse_buffer(config_t *config, const char *path,
+                                            const char *data, size_t size) {
+  config_pos_t pos = {.path = path, .line = 0, .line_start = data};
+  const char *end = data + size;
+  const char *line = data;
+
+  while (line < end) {
+    const char *newline = memchr(line, '\n', (size_t)(end - line));
+    const char *line_end = newline ? newline : end;
+
+    pos.line++;
+    pos.line_start = line;
+    bongocat_error_t result = config_parse_line(config, &pos, line, line_end);
+    if (result != BONGOCAT_SUCCESS) {
+      return result;
+    }
+
+    line = newline ? newline + 1 : end;
   }
-  return (*p == '#' || *p == '\0');
+  return BONGOCAT_SUCCESS;
 }
 
-static bool config_parse_line(char *line, char **out_key, char **out_value) {
-  char *equals = strchr(line, '=');
-  if (!equals) {
-    return false;
+// Whole file in one buffer. A plain read instead of mmap: an editor
+// truncating the file mid-parse would raise SIGBUS on a mapping.
+static bongocat_error_t config_read_file(int fd, char **out, size_t *out_len) {
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    return BONGOCAT_ERROR_FILE_IO;
   }
 
-  *equals = '\0';
-  *out_key = config_trim_whitespace(line);
-  *out_value = config_trim_whitespace(equals + 1);
+  size_t capacity = st.st_size > 0 ? (size_t)st.st_size + 1 : 4096;
+  size_t len = 0;
+  char *buf = malloc(capacity);
+  if (!buf) {
+    return BONGOCAT_ERROR_MEMORY;
+  }
 
-  // Support inline comments: key=value # comment
-  if ((*out_value)[0] == '#') {
-    (*out_value)[0] = '\0';
-  } else {
-    char *space_comment = strstr(*out_value, " #");
-    char *tab_comment = strstr(*out_value, "\t#");
-    char *comment_start = NULL;
-
-    if (space_comment && tab_comment) {
-      comment_start =
-          (space_comment < tab_comment) ? space_comment : tab_comment;
-    } else if (space_comment) {
-      comment_start = space_comment;
-    } else if (tab_comment) {
-      comment_start = tab_comment;
+  for (;;) {
+    if (len == capacity) {
+      // Grew since fstat
+      char *grown = realloc(buf, capacity * 2);
+      if (!grown) {
+        free(buf);
+        return BONGOCAT_ERROR_MEMORY;
+      }
+      buf = grown;
+      capacity *= 2;
     }
 
-    if (comment_start) {
-      comment_start[1] = '\0';
-      *out_value = config_trim_whitespace(*out_value);
+    ssize_t n = read(fd, buf + len, capacity - len);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      free(buf);
+      return BONGOCAT_ERROR_FILE_IO;
     }
+    if (n == 0) {
+      break;
+    }
+    len += (size_t)n;
   }
 
-  return (*out_key)[0] != '\0';
+  *out = buf;
+  *out_len = len;
+  return BONGOCAT_SUCCESS;
 }
 
 static bongocat_error_t config_parse_file(config_t *config,
@@ -593,50 +759,24 @@ static bongocat_error_t config_parse_file(config_t *config,
     }
   }
 
-  FILE *file = fopen(file_path, "r");
-  if (!file) {
+  int fd = open(file_path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
     bongocat_log_info("Config file '%s' not found, using defaults", file_path);
     return BONGOCAT_SUCCESS;
   }
 
-  char line[512];
-  int line_number = 0;
-  bongocat_error_t result = BONGOCAT_SUCCESS;
-
-  while (fgets(line, sizeof(line), file)) {
-    line_number++;
-
-    // Remove trailing newline
-    size_t len = strlen(line);
-    if (len > 0 && line[len - 1] == '\n') {
-      line[len - 1] = '\0';
-    }
-
-    // Skip comments and empty lines
-    if (config_is_comment_or_empty(line)) {
-      continue;
-    }
-
-    // Parse key=value pairs
-    char *key = NULL;
-    char *value = NULL;
-    if (config_parse_line(line, &key, &value)) {
-      bongocat_error_t parse_result =
-          config_parse_key_value(config, key, value);
-      if (parse_result == BONGOCAT_ERROR_INVALID_PARAM) {
-        bongocat_log_warning("Unknown configuration key '%s' at line %d", key,
-                             line_number);
-      } else if (parse_result != BONGOCAT_SUCCESS) {
-        result = parse_result;
-        break;
-      }
-    } else if (strlen(line) > 0) {
-      bongocat_log_warning("Invalid configuration line %d: %s", line_number,
-                           line);
-    }
+  char *data = NULL;
+  size_t size = 0;
+  bongocat_error_t result = config_read_file(fd, &data, &size);
+  close(fd);
+  if (result != BONGOCAT_SUCCESS) {
+    bongocat_log_error("Failed to read config file '%s': %s", file_path,
+                       bongocat_error_string(result));
+    return result;
   }
 
-  fclose(file);
+  result = config_parse_buffer(config, file_path, data, size);
+  free(data);
 
   if (result == BONGOCAT_SUCCESS) {
     bongocat_log_info("Loaded configuration from %s", file_path);
@@ -681,12 +821,15 @@ static void config_set_defaults(config_t *config) {
       .enable_debug = 0,
       .layer = LAYER_TOP, // Default to TOP for broader compatibility
       .overlay_position = POSITION_TOP,
+      .multi_monitor_mode = MULTI_MONITOR_PROCESS,
       .cat_align = ALIGN_CENTER,
       .enable_scheduled_sleep = 0,
       .sleep_begin = (config_time_t){0, 0},
       .sleep_end = (config_time_t){0, 0},
       .idle_sleep_timeout_sec = 0,
       .disable_fullscreen_hide = 0,
+      .enable_output_power_tracking = 0,
+      .arena = {.tag = MEMORY_TAG_CONFIG},
   };
 }
 
@@ -721,7 +864,10 @@ static void config_log_summary(const config_t *config) {
                                            : "bottom");
   bongocat_log_debug("  Layer: %s",
                      config->layer == LAYER_TOP ? "top" : "overlay");
-  bongocat_log_debug("  Monitors: %d configured", config->num_output_names);
+  bongocat_log_debug("  Monitors: %d configured (%s)", config->num_output_names,
+                     config->multi_monitor_mode == MULTI_MONITOR_SHARED
+                         ? "shared process"
+                         : "process per monitor");
 }
 
 // =============================================================================
@@ -786,14 +932,15 @@ void config_cleanup_full(config_t *config) {
     return;
   }
 
-  config_cleanup_devices(config);
-
-  if (config->output_name) {
-    free(config->output_name);
-    config->output_name = NULL;
-  }
-
-  config_free_string_array(&config->output_names, &config->num_output_names);
+  // Every string and array is in the arena
+  memory_arena_destroy(&config->arena);
+  config->output_name = NULL;
+  config->output_names = NULL;
+  config->num_output_names = 0;
+  config->keyboard_devices = NULL;
+  config->num_keyboard_devices = 0;
+  config->keyboard_names = NULL;
+  config->num_names = 0;
 }
 
 int get_screen_width(void) {
@@ -835,3 +982,150 @@ char *config_resolve_path(const char *explicit_path) {
   // No config found — will use defaults
   return NULL;
 }
+
+// =============================================================================
+// RELOAD DIFF MODULE
+// =============================================================================
+
+#define FNV1A_OFFSET_BASIS 14695981039346656037ULL
+#define FNV1A_PRIME        1099511628211ULL
+
+bool config_file_hash(const char *path, uint64_t *out) {
+  if (!path || !out) {
+    return false;
+  }
+
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+
+  uint64_t hash = FNV1A_OFFSET_BASIS;
+  unsigned char buf[4096];
+  ssize_t n;
+  while ((n = read(fd, buf, sizeof(buf))) != 0) {
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      close(fd);
+      return false;
+    }
+    for (ssize_t i = 0; i < n; i++) {
+      hash = (hash ^ buf[i]) * FNV1A_PRIME;
+    }
+  }
+  close(fd);
+
+  *out = hash;
+  return true;
+}
+
+static bool config_str_equal(const char *a, const char *b) {
+  if (!a || !b) {
+    return a == b;
+  }
+  return strcmp(a, b) == 0;
+}
+
+static bool config_str_array_equal(char *const *a, int count_a, char *const *b,
+                                   int count_b) {
+  if (count_a != count_b) {
+    return false;
+  }
+  for (int i = 0; i < count_a; i++) {
+    if (!config_str_equal(a ? a[i] : NULL, b ? b[i] : NULL)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+unsigned config_diff(const config_t *old_config, const config_t *new_config) {
+  if (!old_config || !new_config) {
+    return CONFIG_CHANGE_REDRAW | CONFIG_CHANGE_CACHE | CONFIG_CHANGE_BUFFER |
+           CONFIG_CHANGE_SURFACE | CONFIG_CHANGE_INPUT;
+  }
+
+  const config_t *a = old_config;
+  const config_t *b = new_config;
+  unsigned changes = CONFIG_CHANGE_NONE;
+#define CHANGED(field) (a->field != b->field)
+
+  if (!config_str_equal(a->output_name, b->output_name) ||
+      !config_str_array_equal(a->output_names, a->num_output_names,
+                              b->output_names, b->num_output_names) ||
+      CHANGED(layer) || CHANGED(overlay_position) ||
+      CHANGED(multi_monitor_mode)) {
+    changes |= CONFIG_CHANGE_SURFACE;
+  }
+
+  if (CHANGED(screen_width) || CHANGED(overlay_height)) {
+    changes |= CONFIG_CHANGE_BUFFER;
+  }
+
+  bool assets_changed = false;
+  for (int i = 0; i < NUM_FRAMES; i++) {
+    assets_changed |= !config_str_equal(a->asset_paths[i], b->asset_paths[i]);
+  }
+  if (assets_changed || CHANGED(cat_height) || CHANGED(mirror_x) ||
+      CHANGED(mirror_y) || CHANGED(enable_antialiasing)) {
+    changes |= CONFIG_CHANGE_CACHE;
+  }
+
+  if (CHANGED(overlay_opacity) || CHANGED(cat_x_offset) ||
+      CHANGED(cat_y_offset) || CHANGED(cat_align) || CHANGED(idle_frame) ||
+      CHANGED(keypress_duration) || CHANGED(test_animation_duration) ||
+      CHANGED(test_animation_interval) || CHANGED(fps) ||
+      CHANGED(enable_hand_mapping) || CHANGED(enable_scheduled_sleep) ||
+      CHANGED(sleep_begin.hour) || CHANGED(sleep_begin.min) ||
+      CHANGED(sleep_end.hour) || CHANGED(sleep_end.min) ||
+      CHANGED(idle_sleep_timeout_sec) || CHANGED(disable_fullscreen_hide) ||
+      CHANGED(enable_output_power_tracking)) {
+    changes |= CONFIG_CHANGE_REDRAW;
+  }
+
+  // The input child gets the debug flag on restart
+  if (!config_str_array_equal(a->keyboard_devices, a->num_keyboard_devices,
+                              b->keyboard_devices, b->num_keyboard_devices) ||
+      !config_str_array_equal(a->keyboard_names, a->num_names,
+                              b->keyboard_names, b->num_names) ||
+      CHANGED(hotplug_scan_interval) || CHANGED(enable_debug)) {
+    changes |= CONFIG_CHANGE_INPUT;
+  }
+
+#undef CHANGED
+  return changes;
+}
+
+void config_change_describe(unsigned changes, char *buf, size_t size) {
+  static const struct {
+    config_change_t flag;
+    const char *name;
+  } names[] = {
+      {CONFIG_CHANGE_REDRAW, "redraw"},   {CONFIG_CHANGE_CACHE, "cache"},
+      {CONFIG_CHANGE_BUFFER, "buffer"},   {CONFIG_CHANGE_SURFACE, "surface"},
+      {CONFIG_CHANGE_INPUT, "input"},
+  };
+
+  if (!buf || size == 0) {
+    return;
+  }
+  buf[0] = '\0';
+
+  size_t used = 0;
+  for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+    if (!(changes & (unsigned)names[i].flag) || used >= size) {
+      continue;
+    }
+    int n = snprintf(buf + used, size - used, "%s%s", used ? ", " : "",
+                     names[i].name);
+    if (n < 0) {
+      break;
+    }
+    used += (size_t)n;
+  }
+  if (buf[0] == '\0') {
+    snprintf(buf, size, "none");
+  }
+}
@@ -3,41 +3,217 @@
 #include "config/config.h"
 #include "core/bongocat.h"
 #include "utils/error.h"
+#include "utils/metrics.h"
+#include "utils/trace.h"
 
 #include <errno.h>
 #include <poll.h>
+#include <stdlib.h>
 #include <string.h>
-#include <time.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
 #include <unistd.h>
 
-static int config_watcher_add_watch(ConfigWatcher *watcher, bool log_errors) {
-  if (!watcher || watcher->inotify_fd < 0 || !watcher->config_path) {
+// Directory events that can mean new config contents. The file itself is
+// never watched: editors that save by renaming a temporary file over it
+// would replace the watched inode.
+#define CONFIG_DIR_EVENTS                                                      \
+  (IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_MOVE_SELF | IN_DELETE_SELF)
+
+// =============================================================================
+// WATCH MANAGEMENT
+// =============================================================================
+
+// Split path into a newly allocated directory and a pointer to its last
+// component inside path
+static char *config_watcher_dir_of(const char *path, const char **name) {
+  const char *slash = strrchr(path, '/');
+  if (!slash) {
+    *name = path;
+    return strdup(".");
+  }
+  *name = slash + 1;
+  if (slash == path) {
+    return strdup("/");
+  }
+  return strndup(path, (size_t)(slash - path));
+}
+
+static int config_watcher_watch_dir(ConfigWatcher *watcher, const char *path,
+                                    char **name_out, bool log_errors) {
+  const char *name = NULL;
+  char *dir = config_watcher_dir_of(path, &name);
+  if (!dir) {
+    return -1;
+  }
+
+  int wd = inotify_add_watch(watcher->inotify_fd, dir, CONFIG_DIR_EVENTS);
+  if (wd < 0) {
+    if (log_errors) {
+      bongocat_log_error("Failed to watch config directory %s: %s", dir,
+                         strerror(errno));
+    }
+    free(dir);
     return -1;
   }
+  free(dir);
+
+  *name_out = strdup(name);
+  if (!*name_out) {
+    return -1;
+  }
+  return wd;
+}
+
+static void config_watcher_drop_target(ConfigWatcher *watcher) {
+  if (watcher->target_watch_fd >= 0 &&
+      watcher->target_watch_fd != watcher->watch_fd) {
+    inotify_rm_watch(watcher->inotify_fd, watcher->target_watch_fd);
+  }
+  watcher->target_watch_fd = -1;
+  free(watcher->target_path);
+  watcher->target_path = NULL;
+  free(watcher->target_name);
+  watcher->target_name = NULL;
+}
+
+// A symlinked config (dotfile managers) is edited through its target, so
+// that directory is watched too. Called again after every change in case
+// the link now points elsewhere.
+static void config_watcher_watch_target(ConfigWatcher *watcher) {
+  char *resolved = realpath(watcher->config_path, NULL);
+  if (resolved && watcher->target_path &&
+      strcmp(resolved, watcher->target_path) == 0) {
+    free(resolved);
+    return;
+  }
+
+  config_watcher_drop_target(watcher);
+  if (!resolved) {
+    return;  // Missing for now; the directory watch sees it come back
+  }
 
-  int fd = inotify_add_watch(watcher->inotify_fd, watcher->config_path,
-                             IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO |
-                                 IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF);
-  if (fd < 0 && log_errors) {
-    bongocat_log_error("Failed to add inotify watch for %s: %s",
-                       watcher->config_path, strerror(errno));
+  struct stat st;
+  if (lstat(watcher->config_path, &st) != 0 || !S_ISLNK(st.st_mode)) {
+    free(resolved);
+    return;
   }
 
-  watcher->watch_fd = fd;
-  return fd;
+  int wd = config_watcher_watch_dir(watcher, resolved, &watcher->target_name,
+                                    false);
+  if (wd < 0) {
+    bongocat_log_warning("Cannot watch symlink target %s: %s", resolved,
+                         strerror(errno));
+    free(resolved);
+    return;
+  }
+  watcher->target_watch_fd = wd;
+  watcher->target_path = resolved;
+  bongocat_log_debug("Also watching symlink target %s", resolved);
 }
 
-static long long config_watcher_now_ms(void) {
-  struct timespec ts;
-  clock_gettime(CLOCK_MONOTONIC, &ts);
-  return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000LL;
+static bool config_watcher_is_config(const ConfigWatcher *watcher,
+                                     const struct inotify_event *event) {
+  if (event->len == 0) {
+    return false;
+  }
+  if (event->wd == watcher->watch_fd && watcher->watch_name &&
+      strcmp(event->name, watcher->watch_name) == 0) {
+    return true;
+  }
+  return event->wd == watcher->target_watch_fd && watcher->target_name &&
+         strcmp(event->name, watcher->target_name) == 0;
+}
+
+// =============================================================================
+// EVENT DISPATCH
+// =============================================================================
+
+// Trailing debounce: every event pushes the reload back, so a burst of
+// writes (or a rename save's create + move) reloads once, right after the
+// last of them
+static void config_watcher_arm_debounce(ConfigWatcher *watcher) {
+  struct itimerspec spec = {
+      .it_value = {.tv_sec = CONFIG_RELOAD_DEBOUNCE_MS / 1000,
+                   .tv_nsec = (CONFIG_RELOAD_DEBOUNCE_MS % 1000) * 1000000L},
+  };
+  if (timerfd_settime(watcher->debounce_fd, 0, &spec, NULL) < 0) {
+    bongocat_log_error("Failed to arm config reload timer: %s",
+                       strerror(errno));
+  }
+}
+
+static void config_watcher_read_events(ConfigWatcher *watcher) {
+  char buffer[INOTIFY_BUF_LEN]
+      __attribute__((aligned(__alignof__(struct inotify_event))));
+  ssize_t length = read(watcher->inotify_fd, buffer, INOTIFY_BUF_LEN);
+
+  if (length < 0) {
+    if (errno != EINTR && errno != EAGAIN) {
+      bongocat_log_error("Config watcher read failed: %s", strerror(errno));
+    }
+    return;
+  }
+
+  bool changed = false;
+  ssize_t i = 0;
+  while (i < length) {
+    const struct inotify_event *event =
+        (const struct inotify_event *)&buffer[i];
+
+    if (config_watcher_is_config(watcher, event)) {
+      changed = true;
+    }
+
+    if (event->mask & (IN_MOVE_SELF | IN_DELETE_SELF | IN_IGNORED)) {
+      if (event->wd == watcher->watch_fd) {
+        bongocat_log_warning("Config directory moved or deleted; hot-reload "
+                             "stops until restart");
+        watcher->watch_fd = -1;
+      } else if (event->wd == watcher->target_watch_fd) {
+        watcher->target_watch_fd = -1;
+        changed = true;  // Re-resolved when the timer fires
+      }
+    }
+
+    i += (ssize_t)INOTIFY_EVENT_SIZE + event->len;
+  }
+
+  if (changed) {
+    config_watcher_arm_debounce(watcher);
+  }
+}
+
+static void config_watcher_check_debounce(ConfigWatcher *watcher) {
+  uint64_t expirations = 0;
+  if (read(watcher->debounce_fd, &expirations, sizeof(expirations)) !=
+          (ssize_t)sizeof(expirations) ||
+      expirations == 0) {
+    return;
+  }
+
+  bongocat_log_info("Config file changed, reloading...");
+  trace_instant("config change");
+  config_watcher_watch_target(watcher);
+  if (watcher->reload_callback) {
+    watcher->reload_callback(watcher->config_path);
+  }
+}
+
+void config_watcher_dispatch(ConfigWatcher *watcher) {
+  if (!watcher || watcher->inotify_fd < 0 || watcher->debounce_fd < 0) {
+    return;
+  }
+
+  config_watcher_read_events(watcher);
+  config_watcher_check_debounce(watcher);
 }
 
 static void *config_watcher_thread(void *arg) {
   ConfigWatcher *watcher = (ConfigWatcher *)arg;
-  char buffer[INOTIFY_BUF_LEN];
-  long long last_reload_ms = 0;
 
+  trace_set_thread_name("config watcher");
   bongocat_log_info("Config watcher started for: %s", watcher->config_path);
 
   while (watcher->watching) {
@@ -45,13 +221,18 @@ static void *config_watcher_thread(void *arg) {
       break;
     }
 
-    struct pollfd pfd = {
-        .fd = watcher->inotify_fd,
-        .events = POLLIN,
-        .revents = 0,
+    // Block until the file changes, the debounce expires or
+    // config_watcher_stop() signals
+    struct pollfd pfds[3] = {
+        {.fd = watcher->inotify_fd, .events = POLLIN},
+        {.fd = watcher->debounce_fd, .events = POLLIN},
+        {.fd = watcher->shutdown_fd, .events = POLLIN},
     };
 
-    int poll_result = poll(&pfd, 1, 1000);
+    int64_t span = trace_begin();
+    int poll_result = poll(pfds, 3, -1);
+    trace_end("wait", span);
+    metrics_count_wakeup(METRICS_THREAD_CONFIG_WATCHER);
 
     if (poll_result < 0) {
       if (errno == EINTR)
@@ -60,76 +241,12 @@ static void *config_watcher_thread(void *arg) {
       break;
     }
 
-    if (poll_result == 0) {
-      // Timeout, continue to check watching flag
-      continue;
+    if (pfds[2].revents & POLLIN) {
+      break;
     }
 
-    if (pfd.revents & POLLIN) {
-      ssize_t length = read(watcher->inotify_fd, buffer, INOTIFY_BUF_LEN);
-
-      if (length < 0) {
-        if (errno == EINTR || errno == EAGAIN) {
-          continue;
-        }
-        bongocat_log_error("Config watcher read failed: %s", strerror(errno));
-        continue;
-      }
-
-      bool should_reload = false;
-      bool watch_invalidated = false;
-      ssize_t i = 0;
-      while (i < length) {
-        struct inotify_event *event = (struct inotify_event *)&buffer[i];
-
-        if (event->wd == watcher->watch_fd &&
-            (event->mask &
-             (IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_ATTRIB))) {
-          should_reload = true;
-        }
-
-        if (event->wd == watcher->watch_fd &&
-            (event->mask & (IN_MOVE_SELF | IN_DELETE_SELF | IN_IGNORED))) {
-          watch_invalidated = true;
-        }
-
-        i += INOTIFY_EVENT_SIZE + event->len;
-      }
-
-      // File can be replaced atomically; re-register watch on the new inode.
-      if (watch_invalidated && watcher->watching) {
-        watcher->watch_fd = -1;
-        bool rewatch_ok = false;
-        for (int retry = 0; retry < 20 && watcher->watching; retry++) {
-          if (config_watcher_add_watch(watcher, false) >= 0) {
-            rewatch_ok = true;
-            bongocat_log_debug("Re-armed config file watcher");
-            break;
-          }
-          usleep(100000);  // 100ms retry interval
-        }
-
-        if (!rewatch_ok) {
-          bongocat_log_warning(
-              "Config watcher lost file watch; hot-reload may stop working");
-        }
-      }
-
-      // Debounce reloads (300ms)
-      if (should_reload) {
-        long long current_ms = config_watcher_now_ms();
-        if (current_ms - last_reload_ms >= 300) {
-          bongocat_log_info("Config file changed, reloading...");
-          last_reload_ms = current_ms;
-
-          // Small delay to ensure file write is complete
-          usleep(100000);  // 100ms
-
-          if (watcher->reload_callback) {
-            watcher->reload_callback(watcher->config_path);
-          }
-        }
-      }
+    if ((pfds[0].revents | pfds[1].revents) & POLLIN) {
+      config_watcher_dispatch(watcher);
     }
   }
 
@@ -137,38 +254,85 @@ static void *config_watcher_thread(void *arg) {
   return NULL;
 }
 
+// =============================================================================
+// LIFECYCLE
+// =============================================================================
+
+static void config_watcher_reset(ConfigWatcher *watcher) {
+  memset(watcher, 0, sizeof(ConfigWatcher));
+  watcher->inotify_fd = -1;
+  watcher->watch_fd = -1;
+  watcher->target_watch_fd = -1;
+  watcher->debounce_fd = -1;
+  watcher->shutdown_fd = -1;
+}
+
+static void config_watcher_close(ConfigWatcher *watcher) {
+  config_watcher_drop_target(watcher);
+  if (watcher->inotify_fd >= 0 && watcher->watch_fd >= 0) {
+    inotify_rm_watch(watcher->inotify_fd, watcher->watch_fd);
+  }
+  if (watcher->inotify_fd >= 0) {
+    close(watcher->inotify_fd);
+  }
+  if (watcher->debounce_fd >= 0) {
+    close(watcher->debounce_fd);
+  }
+  if (watcher->shutdown_fd >= 0) {
+    close(watcher->shutdown_fd);
+  }
+  free(watcher->config_path);
+  free(watcher->watch_name);
+  config_watcher_reset(watcher);
+}
+
 int config_watcher_init(ConfigWatcher *watcher, const char *config_path,
                         void (*callback)(const char *)) {
   if (!watcher || !config_path || !callback) {
     return -1;
   }
 
-  memset(watcher, 0, sizeof(ConfigWatcher));
-  watcher->inotify_fd = -1;
-  watcher->watch_fd = -1;
+  config_watcher_reset(watcher);
 
   // Initialize inotify
-  watcher->inotify_fd = inotify_init1(IN_NONBLOCK);
+  watcher->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
   if (watcher->inotify_fd < 0) {
     bongocat_log_error("Failed to initialize inotify: %s", strerror(errno));
     return -1;
   }
 
+  watcher->debounce_fd =
+      timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (watcher->debounce_fd < 0) {
+    bongocat_log_error("Failed to create config reload timer: %s",
+                       strerror(errno));
+    config_watcher_close(watcher);
+    return -1;
+  }
+
+  // Lets config_watcher_stop() wake the thread without a poll timeout
+  watcher->shutdown_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (watcher->shutdown_fd < 0) {
+    bongocat_log_error("Failed to create config watcher eventfd: %s",
+                       strerror(errno));
+    config_watcher_close(watcher);
+    return -1;
+  }
+
   // Store config path
   watcher->config_path = strdup(config_path);
   if (!watcher->config_path) {
-    close(watcher->inotify_fd);
-    watcher->inotify_fd = -1;
+    config_watcher_close(watcher);
     return -1;
   }
 
-  if (config_watcher_add_watch(watcher, true) < 0) {
-    free(watcher->config_path);
-    watcher->config_path = NULL;
-    close(watcher->inotify_fd);
-    watcher->inotify_fd = -1;
+  watcher->watch_fd = config_watcher_watch_dir(watcher, config_path,
+                                               &watcher->watch_name, true);
+  if (watcher->watch_fd < 0) {
+    config_watcher_close(watcher);
     return -1;
   }
+  config_watcher_watch_target(watcher);
 
   watcher->reload_callback = callback;
   watcher->watching = false;
@@ -192,21 +356,29 @@ void config_watcher_start(ConfigWatcher *watcher) {
     return;
   }
 
+  watcher->thread_started = true;
   bongocat_log_info("Config watcher thread started");
 }
 
 void config_watcher_stop(ConfigWatcher *watcher) {
-  if (!watcher || !watcher->watching) {
+  if (!watcher || !watcher->thread_started) {
     return;
   }
 
   watcher->watching = false;
 
+  uint64_t val = 1;
+  if (write(watcher->shutdown_fd, &val, sizeof(val)) < 0) {
+    bongocat_log_warning("Failed to signal config watcher: %s",
+                         strerror(errno));
+  }
+
   // Wait for thread to finish
   if (pthread_join(watcher->watcher_thread, NULL) != 0) {
     bongocat_log_error("Failed to join config watcher thread: %s",
                        strerror(errno));
   }
+  watcher->thread_started = false;
 }
 
 void config_watcher_cleanup(ConfigWatcher *watcher) {
@@ -215,23 +387,5 @@ void config_watcher_cleanup(ConfigWatcher *watcher) {
   }
 
   config_watcher_stop(watcher);
-
-  if (watcher->inotify_fd >= 0 && watcher->watch_fd >= 0) {
-    inotify_rm_watch(watcher->inotify_fd, watcher->watch_fd);
-    watcher->watch_fd = -1;
-  }
-
-  if (watcher->inotify_fd >= 0) {
-    close(watcher->inotify_fd);
-    watcher->inotify_fd = -1;
-  }
-
-  if (watcher->config_path) {
-    free(watcher->config_path);
-    watcher->config_path = NULL;
-  }
-
-  memset(watcher, 0, sizeof(ConfigWatcher));
-  watcher->inotify_fd = -1;
-  watcher->watch_fd = -1;
+  config_watcher_close(watcher);
 }
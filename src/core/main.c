@@ -5,15 +5,21 @@
 #include "core/multi_monitor.h"
 #include "graphics/animation.h"
 #include "platform/input.h"
+#include "platform/presentation.h"
 #include "platform/wayland.h"
 #include "utils/error.h"
+#include "utils/latency.h"
 #include "utils/memory.h"
+#include "utils/metrics.h"
+#include "utils/metrics_server.h"
+#include "utils/trace.h"
 
 #include <limits.h>
 #include <signal.h>
 #include <stdatomic.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/file.h>
@@ -26,10 +32,23 @@
 
 static volatile sig_atomic_t running = 1;
 static config_t g_config;
-static ConfigWatcher g_config_watcher = {.inotify_fd = -1, .watch_fd = -1};
+static ConfigWatcher g_config_watcher = {.inotify_fd = -1,
+                                         .watch_fd = -1,
+                                         .target_watch_fd = -1,
+                                         .debounce_fd = -1,
+                                         .shutdown_fd = -1};
 static bool g_manage_pid_file = true;
+static bool g_single_threaded = false;
+static bool g_metrics_socket = true;
 static const char *g_forced_monitor_name = NULL;
+// Monitor assigned to a forked multi-monitor child (outlives g_config)
+static char g_child_monitor_name[128];
 static atomic_bool g_reload_pending = false;
+// Content hash of the config file last loaded, to skip identical reloads
+static uint64_t g_config_hash = 0;
+static bool g_config_hash_valid = false;
+static atomic_bool g_latency_report_pending = false;
+static atomic_bool g_trace_write_pending = false;
 static int g_pid_fd = -1;
 
 static const char *get_pid_file_path(void) {
@@ -51,9 +70,14 @@ static const char *get_pid_file_path(void) {
 
 typedef struct {
   const char *config_file;
-  const char *monitor_name;  // --monitor override for multi-monitor children
-  bool multi_monitor_child;  // Internal flag to skip PID file management
+  const char *monitor_name;  // --monitor override
   bool watch_config;
+  bool single_threaded;  // Run everything on the main event loop
+  const char *record_file;  // --record: save input events here
+  const char *replay_file;  // --replay: read input events from here
+  double replay_speed;      // --replay-speed multiplier, 0 = no pauses
+  bool no_metrics;          // --no-metrics: no metrics socket
+  const char *trace_file;   // --trace: write a thread activity trace here
   bool toggle_mode;
   bool show_help;
   bool show_version;
@@ -217,20 +241,31 @@ static int process_handle_toggle(void) {
 
 static void signal_handler(int sig) {
   // Only async-signal-safe functions allowed here
+  int saved_errno = errno;
   switch (sig) {
   case SIGINT:
   case SIGTERM:
   case SIGQUIT:
   case SIGHUP:
     running = 0;
+    wayland_wake();
     break;
   case SIGCHLD:
     while (waitpid(-1, NULL, WNOHANG) > 0)
       ;
     break;
+  case SIGUSR1:
+    atomic_store(&g_trace_write_pending, true);
+    wayland_wake();
+    break;
+  case SIGUSR2:
+    atomic_store(&g_latency_report_pending, true);
+    wayland_wake();
+    break;
   default:
     break;
   }
+  errno = saved_errno;
 }
 
 // Crash signal handler - only async-signal-safe operations
@@ -285,6 +320,18 @@ static bongocat_error_t signal_setup_handlers(void) {
     return BONGOCAT_ERROR_THREAD;
   }
 
+  // SIGUSR1 writes the --trace file so far
+  if (sigaction(SIGUSR1, &sa, NULL) == -1) {
+    bongocat_log_error("Failed to setup SIGUSR1 handler: %s", strerror(errno));
+    return BONGOCAT_ERROR_THREAD;
+  }
+
+  // SIGUSR2 dumps the keypress latency histograms
+  if (sigaction(SIGUSR2, &sa, NULL) == -1) {
+    bongocat_log_error("Failed to setup SIGUSR2 handler: %s", strerror(errno));
+    return BONGOCAT_ERROR_THREAD;
+  }
+
   // Ignore SIGPIPE
   signal(SIGPIPE, SIG_IGN);
 
@@ -306,36 +353,17 @@ static bongocat_error_t signal_setup_handlers(void) {
 // CONFIGURATION MANAGEMENT MODULE
 // =============================================================================
 
-static void config_free_output_selection(config_t *config) {
-  if (!config) {
-    return;
-  }
-
-  if (config->output_name) {
-    free(config->output_name);
-    config->output_name = NULL;
-  }
-
-  if (config->output_names) {
-    for (int i = 0; i < config->num_output_names; i++) {
-      free(config->output_names[i]);
-    }
-    free(config->output_names);
-    config->output_names = NULL;
-  }
-
-  config->num_output_names = 0;
-}
-
 static bongocat_error_t config_apply_forced_monitor(config_t *config,
                                                     const char *monitor_name) {
   if (!config || !monitor_name) {
     return BONGOCAT_ERROR_INVALID_PARAM;
   }
 
-  config_free_output_selection(config);
-
-  config->output_name = strdup(monitor_name);
+  // The configured list stays in the config's arena until its generation is
+  // released
+  config->output_names = NULL;
+  config->num_output_names = 0;
+  config->output_name = memory_arena_strdup(&config->arena, monitor_name);
   if (!config->output_name) {
     bongocat_log_error("Failed to allocate monitor override '%s'",
                        monitor_name);
@@ -346,25 +374,23 @@ static bongocat_error_t config_apply_forced_monitor(config_t *config,
   return BONGOCAT_SUCCESS;
 }
 
-static void config_reload_apply(const char *config_path) {
-  bongocat_log_info("Reloading configuration from: %s", config_path);
+static double config_elapsed_ms(int64_t since_us) {
+  return (double)(latency_now_us() - since_us) / 1000.0;
+}
 
-  // Save old device info before loading so we can detect input-device changes.
-  int old_num_devices = g_config.num_keyboard_devices;
-
-  // Copy old device paths so we can compare after reload
-  char **old_device_paths = NULL;
-  if (old_num_devices > 0 && g_config.keyboard_devices != NULL) {
-    old_device_paths = malloc(sizeof(char *) * old_num_devices);
-    if (old_device_paths != NULL) {
-      for (int i = 0; i < old_num_devices; i++) {
-        old_device_paths[i] = g_config.keyboard_devices[i]
-                                  ? strdup(g_config.keyboard_devices[i])
-                                  : NULL;
-      }
-    }
+static void config_reload_apply(const char *config_path) {
+  // inotify reports one editor save as several events; identical bytes
+  // mean there is nothing to do
+  uint64_t hash = 0;
+  bool hashed = config_file_hash(config_path, &hash);
+  if (hashed && g_config_hash_valid && hash == g_config_hash) {
+    bongocat_log_debug("Config file unchanged, skipping reload");
+    return;
   }
 
+  bongocat_log_info("Reloading configuration from: %s", config_path);
+  int64_t start_us = latency_now_us();
+
   // Create a temporary config to test loading
   config_t temp_config = {0};
   bongocat_error_t result = load_config(&temp_config, config_path);
@@ -374,61 +400,51 @@ static void config_reload_apply(const char *config_path) {
                        bongocat_error_string(result));
     bongocat_log_info("Keeping current configuration");
     config_cleanup_full(&temp_config);
-    // Free saved paths
-    if (old_device_paths != NULL) {
-      for (int i = 0; i < old_num_devices; i++) {
-        free(old_device_paths[i]);
-      }
-      free(old_device_paths);
-    }
     return;
   }
 
-  // Check if devices changed (count or any path differs)
-  bool devices_changed = (old_num_devices != temp_config.num_keyboard_devices);
-  if (!devices_changed && old_device_paths != NULL) {
-    // Same count - check if any paths differ
-    for (int i = 0; i < old_num_devices; i++) {
-      const char *old_path = old_device_paths[i];
-      const char *new_path = temp_config.keyboard_devices[i];
-      if ((old_path == NULL) != (new_path == NULL) ||
-          (old_path != NULL && new_path != NULL &&
-           strcmp(old_path, new_path) != 0)) {
-        devices_changed = true;
-        break;
-      }
-    }
-  }
-
-  // Free saved paths
-  if (old_device_paths != NULL) {
-    for (int i = 0; i < old_num_devices; i++) {
-      free(old_device_paths[i]);
-    }
-    free(old_device_paths);
-  }
-
-  // Swap in new config under animation lock to avoid reader races
-  pthread_mutex_lock(&anim_lock);
-  config_cleanup_full(&g_config);
-  g_config = temp_config;
-
+  // Before the diff, so a forced monitor does not look like an output change
   if (g_forced_monitor_name) {
     bongocat_error_t force_result =
-        config_apply_forced_monitor(&g_config, g_forced_monitor_name);
+        config_apply_forced_monitor(&temp_config, g_forced_monitor_name);
     if (force_result != BONGOCAT_SUCCESS) {
       bongocat_log_warning("Failed to keep forced monitor '%s' during reload",
                            g_forced_monitor_name);
     }
   }
-  pthread_mutex_unlock(&anim_lock);
 
-  // Update the running systems with new config
-  wayland_update_config(&g_config);
+  g_config_hash = hash;
+  g_config_hash_valid = hashed;
+
+  unsigned changes = config_diff(&g_config, &temp_config);
+  double parse_ms = config_elapsed_ms(start_us);
+  if (changes == CONFIG_CHANGE_NONE) {
+    bongocat_log_info("No settings changed (%.2f ms), keeping current state",
+                      parse_ms);
+    config_cleanup_full(&temp_config);
+    return;
+  }
+
+  // Other threads only read the render snapshot that wayland_update_config()
+  // publishes below, so the live config is swapped without a lock
+  config_cleanup_full(&g_config);
+  g_config = temp_config;
 
-  // Check if input devices changed and restart monitoring if needed
-  if (devices_changed) {
-    bongocat_log_info("Input devices changed, restarting input monitoring");
+  // Redraw-only changes publish a snapshot sharing the current frame set;
+  // the cache, buffer and surface paths are picked inside
+  // wayland_update_config()
+  double display_ms = 0.0;
+  if (changes & ~(unsigned)CONFIG_CHANGE_INPUT) {
+    int64_t display_us = latency_now_us();
+    wayland_update_config(&g_config);
+    animation_notify_config_changed();
+    display_ms = config_elapsed_ms(display_us);
+  }
+
+  double input_ms = 0.0;
+  if (changes & CONFIG_CHANGE_INPUT) {
+    int64_t input_us = latency_now_us();
+    bongocat_log_info("Input settings changed, restarting input monitoring");
     bongocat_error_t input_result = input_restart_monitoring(
         g_config.keyboard_devices, g_config.num_keyboard_devices,
         g_config.keyboard_names, g_config.num_names,
@@ -439,9 +455,16 @@ static void config_reload_apply(const char *config_path) {
     } else {
       bongocat_log_info("Input monitoring restarted successfully");
     }
+    input_ms = config_elapsed_ms(input_us);
   }
 
-  bongocat_log_info("Configuration reloaded successfully!");
+  metrics_record_reload((uint64_t)(latency_now_us() - start_us));
+  char applied[64];
+  config_change_describe(changes, applied, sizeof(applied));
+  bongocat_log_info("Configuration reloaded in %.2f ms (%s): parse %.2f ms, "
+                    "display %.2f ms, input %.2f ms",
+                    config_elapsed_ms(start_us), applied, parse_ms, display_ms,
+                    input_ms);
   bongocat_log_info("New screen dimensions: %dx%d", g_config.screen_width,
                     g_config.overlay_height);
 }
@@ -449,6 +472,7 @@ static void config_reload_apply(const char *config_path) {
 static void config_reload_callback(const char *config_path) {
   (void)config_path;
   atomic_store(&g_reload_pending, true);
+  wayland_wake();
 }
 
 static void config_process_pending_reload(void) {
@@ -460,11 +484,26 @@ static void config_process_pending_reload(void) {
       (g_config_watcher.config_path && g_config_watcher.config_path[0] != '\0')
           ? g_config_watcher.config_path
           : "bongocat.conf";
+  int64_t span = trace_begin();
   config_reload_apply(config_path);
+  trace_end("config reload", span);
 }
 
 static void wayland_tick_callback(void) {
   config_process_pending_reload();
+
+  if (atomic_exchange(&g_latency_report_pending, false)) {
+    latency_report();
+    presentation_report();
+  }
+
+  if (atomic_exchange(&g_trace_write_pending, false)) {
+    if (!trace_enabled()) {
+      bongocat_log_info("SIGUSR1 ignored: start with --trace FILE to trace");
+    } else if (trace_write() != BONGOCAT_SUCCESS) {
+      bongocat_log_warning("Trace not written");
+    }
+  }
 }
 
 static bongocat_error_t config_setup_watcher(const char *config_file) {
@@ -472,7 +511,10 @@ static bongocat_error_t config_setup_watcher(const char *config_file) {
 
   if (config_watcher_init(&g_config_watcher, watch_path,
                           config_reload_callback) == 0) {
-    config_watcher_start(&g_config_watcher);
+    // In single-threaded mode the event loop polls the watcher fds instead
+    if (!g_single_threaded) {
+      config_watcher_start(&g_config_watcher);
+    }
     bongocat_log_info("Config file watching enabled for: %s", watch_path);
     return BONGOCAT_SUCCESS;
   } else {
@@ -486,6 +528,10 @@ static bongocat_error_t config_setup_watcher(const char *config_file) {
 // SYSTEM INITIALIZATION AND CLEANUP MODULE
 // =============================================================================
 
+static void config_watcher_fd_ready([[maybe_unused]] int fd, void *data) {
+  config_watcher_dispatch((ConfigWatcher *)data);
+}
+
 static bongocat_error_t system_initialize_components(void) {
   bongocat_error_t result;
 
@@ -505,13 +551,9 @@ static bongocat_error_t system_initialize_components(void) {
     return result;
   }
 
-  // Build initial pre-scaled frame cache (images loaded, config set)
-  {
-    int cat_h = g_config.cat_height;
-    int cat_w = (cat_h * CAT_IMAGE_WIDTH) / CAT_IMAGE_HEIGHT;
-    animation_cache_frames(cat_w, cat_h, g_config.mirror_x, g_config.mirror_y,
-                           g_config.enable_antialiasing);
-  }
+  // Publish the first render snapshot with the pre-scaled frame cache
+  // (images loaded, config set, surface and buffer created)
+  wayland_publish_render_state();
 
   // Start input monitoring
   result = input_start_monitoring(
@@ -524,12 +566,42 @@ static bongocat_error_t system_initialize_components(void) {
     return result;
   }
 
-  // Start animation thread
-  result = animation_start();
-  if (result != BONGOCAT_SUCCESS) {
-    bongocat_log_error("Failed to start animation thread: %s",
-                       bongocat_error_string(result));
-    return result;
+  if (g_single_threaded) {
+    // One epoll loop owns the display, input wake, frame timer and watcher
+    // fds; the animation state machine runs inline on the main thread
+    if (g_config_watcher.inotify_fd >= 0) {
+      result = wayland_add_fd_source(g_config_watcher.inotify_fd,
+                                     config_watcher_fd_ready,
+                                     &g_config_watcher);
+      if (result == BONGOCAT_SUCCESS) {
+        result = wayland_add_fd_source(g_config_watcher.debounce_fd,
+                                       config_watcher_fd_ready,
+                                       &g_config_watcher);
+      }
+      if (result != BONGOCAT_SUCCESS) {
+        return result;
+      }
+    }
+
+    result = animation_start_single_threaded();
+    if (result != BONGOCAT_SUCCESS) {
+      bongocat_log_error("Failed to start single-threaded animation: %s",
+                         bongocat_error_string(result));
+      return result;
+    }
+  } else {
+    // Start animation thread
+    result = animation_start();
+    if (result != BONGOCAT_SUCCESS) {
+      bongocat_log_error("Failed to start animation thread: %s",
+                         bongocat_error_string(result));
+      return result;
+    }
+  }
+
+  // Optional: the overlay runs the same without it
+  if (g_metrics_socket && metrics_server_start() != BONGOCAT_SUCCESS) {
+    bongocat_log_warning("Continuing without a metrics socket");
   }
 
   return BONGOCAT_SUCCESS;
@@ -538,6 +610,9 @@ static bongocat_error_t system_initialize_components(void) {
 _Noreturn static void system_cleanup_and_exit(int exit_code) {
   bongocat_log_info("Performing cleanup...");
 
+  // Stop answering scrapes before the counted subsystems go away
+  metrics_server_stop();
+
   // Remove PID file and release lock
   if (g_manage_pid_file) {
     process_remove_pid_file();
@@ -548,17 +623,29 @@ _Noreturn static void system_cleanup_and_exit(int exit_code) {
   }
 
   // Stop config watcher
+  wayland_remove_fd_source(g_config_watcher.inotify_fd);
+  wayland_remove_fd_source(g_config_watcher.debounce_fd);
   config_watcher_cleanup(&g_config_watcher);
 
   // Stop animation system
   animation_cleanup();
 
+  // Report keypress latency now that no more samples can arrive
+  latency_report();
+  presentation_report();
+
   // Cleanup Wayland
   wayland_cleanup();
 
   // Cleanup input system
   input_cleanup();
 
+  // Every thread and the input child has stopped recording
+  if (trace_enabled() && trace_write() != BONGOCAT_SUCCESS) {
+    bongocat_log_warning("Trace not written");
+  }
+  trace_cleanup();
+
   // Capture debug flag before cleanup to avoid use-after-free
   bool debug_mode = g_config.enable_debug;
 
@@ -596,6 +683,20 @@ static void cli_show_help(const char *program_name) {
   printf("  -t, --toggle          Toggle bongocat on/off (start if not "
          "running, stop if running)\n");
   printf("  -m, --monitor NAME    Bind to a specific monitor output\n");
+  printf("      --single-threaded Run animation, input wakeups and config "
+         "watching\n"
+         "                        on one epoll loop (no extra threads)\n");
+  printf("      --record FILE     Save every input event to FILE (contains "
+         "all keystrokes)\n");
+  printf("      --replay FILE     Read input from a --record file instead of "
+         "/dev/input\n");
+  printf("      --replay-speed N  Replay N times faster (default 1, 0 = no "
+         "pauses)\n");
+  printf("      --no-metrics      Do not serve metrics on "
+         "$XDG_RUNTIME_DIR/bongocat/PID.sock\n");
+  printf("      --trace FILE      Write a Chrome trace of thread activity to "
+         "FILE\n"
+         "                        on exit and on SIGUSR1\n");
   printf("\nConfiguration search order:\n");
   printf("  1. $XDG_CONFIG_HOME/bongocat/bongocat.conf\n");
   printf("  2. ~/.config/bongocat/bongocat.conf\n");
@@ -613,8 +714,13 @@ static int cli_parse_arguments(int argc, char *argv[], cli_args_t *args) {
   // Initialize arguments with defaults
   *args = (cli_args_t){.config_file = NULL,
                        .monitor_name = NULL,
-                       .multi_monitor_child = false,
                        .watch_config = false,
+                       .single_threaded = false,
+                       .record_file = NULL,
+                       .replay_file = NULL,
+                       .replay_speed = 1.0,
+                       .no_metrics = false,
+                       .trace_file = NULL,
                        .toggle_mode = false,
                        .show_help = false,
                        .show_version = false};
@@ -636,6 +742,43 @@ static int cli_parse_arguments(int argc, char *argv[], cli_args_t *args) {
     } else if (strcmp(argv[i], "--watch-config") == 0 ||
                strcmp(argv[i], "-w") == 0) {
       args->watch_config = true;
+    } else if (strcmp(argv[i], "--single-threaded") == 0) {
+      args->single_threaded = true;
+    } else if (strcmp(argv[i], "--record") == 0) {
+      if (i + 1 < argc) {
+        args->record_file = argv[i + 1];
+        i++;
+      } else {
+        bongocat_log_error("--record option requires a file path");
+        return 1;
+      }
+    } else if (strcmp(argv[i], "--replay") == 0) {
+      if (i + 1 < argc) {
+        args->replay_file = argv[i + 1];
+        i++;
+      } else {
+        bongocat_log_error("--replay option requires a file path");
+        return 1;
+      }
+    } else if (strcmp(argv[i], "--replay-speed") == 0) {
+      char *end = NULL;
+      double speed = i + 1 < argc ? strtod(argv[i + 1], &end) : -1.0;
+      if (!end || end == argv[i + 1] || *end != '\0' || !(speed >= 0.0)) {
+        bongocat_log_error("--replay-speed requires a number >= 0");
+        return 1;
+      }
+      args->replay_speed = speed;
+      i++;
+    } else if (strcmp(argv[i], "--no-metrics") == 0) {
+      args->no_metrics = true;
+    } else if (strcmp(argv[i], "--trace") == 0) {
+      if (i + 1 < argc) {
+        args->trace_file = argv[i + 1];
+        i++;
+      } else {
+        bongocat_log_error("--trace option requires a file path");
+        return 1;
+      }
     } else if (strcmp(argv[i], "--toggle") == 0 || strcmp(argv[i], "-t") == 0) {
       args->toggle_mode = true;
     } else if (strcmp(argv[i], "--monitor") == 0 ||
@@ -647,8 +790,6 @@ static int cli_parse_arguments(int argc, char *argv[], cli_args_t *args) {
         bongocat_log_error("--monitor option requires an output name");
         return 1;
       }
-    } else if (strcmp(argv[i], "--multi-monitor-child") == 0) {
-      args->multi_monitor_child = true;
     } else {
       bongocat_log_warning("Unknown argument: %s", argv[i]);
     }
@@ -661,11 +802,37 @@ static int cli_parse_arguments(int argc, char *argv[], cli_args_t *args) {
 // MAIN APPLICATION ENTRY POINT
 // =============================================================================
 
+// Multi-monitor children write trace.json as trace-<monitor>.json
+static void trace_setup(const char *path) {
+  char child_path[PATH_MAX];
+  if (g_child_monitor_name[0] != '\0') {
+    const char *ext = strrchr(path, '.');
+    if (!ext || strchr(ext, '/')) {
+      ext = path + strlen(path);
+    }
+    int len = snprintf(child_path, sizeof(child_path), "%.*s-%s%s",
+                       (int)(ext - path), path, g_child_monitor_name, ext);
+    if (len < 0 || (size_t)len >= sizeof(child_path)) {
+      bongocat_log_warning("Trace path is too long, continuing without a "
+                           "trace");
+      return;
+    }
+    path = child_path;
+  }
+
+  if (trace_init(path) != BONGOCAT_SUCCESS) {
+    bongocat_log_warning("Continuing without a trace");
+    return;
+  }
+  trace_set_thread_name("main");
+}
+
 int main(int argc, char *argv[]) {
   bongocat_error_t result;
 
   // Initialize error system early
   bongocat_error_init(1);  // Enable debug initially
+  bongocat_log_start();
 
   bongocat_log_info("Starting Bongo Cat Overlay v" BONGOCAT_VERSION);
 
@@ -675,12 +842,16 @@ int main(int argc, char *argv[]) {
     return 1;
   }
 
-  g_manage_pid_file = !args.multi_monitor_child;
   g_forced_monitor_name = args.monitor_name;
-
-  if (args.multi_monitor_child && !args.monitor_name) {
-    bongocat_log_error("--multi-monitor-child requires --monitor");
-    return 1;
+  g_single_threaded = args.single_threaded;
+  g_metrics_socket = !args.no_metrics;
+  if (args.replay_file) {
+    if (args.record_file) {
+      bongocat_log_warning("--record is ignored with --replay");
+    }
+    input_set_replay(args.replay_file, args.replay_speed);
+  } else if (args.record_file) {
+    input_set_record_file(args.record_file);
   }
 
   // Handle help and version requests
@@ -695,16 +866,12 @@ int main(int argc, char *argv[]) {
   }
 
   // Handle toggle mode
-  if (args.toggle_mode && g_manage_pid_file) {
+  if (args.toggle_mode) {
     int toggle_result = process_handle_toggle();
     if (toggle_result >= 0) {
       return toggle_result;  // Either successfully toggled off or error
     }
     // toggle_result == -1 means continue with startup
-  } else if (args.toggle_mode) {
-    bongocat_log_error(
-        "--toggle is not valid in internal multi-monitor child mode");
-    return 1;
   }
 
   // Setup signal handlers
@@ -730,6 +897,8 @@ int main(int argc, char *argv[]) {
 
   // Resolve and load configuration
   char *resolved_config = config_resolve_path(args.config_file);
+  g_config_hash_valid =
+      resolved_config && config_file_hash(resolved_config, &g_config_hash);
   result = load_config(&g_config, resolved_config);
   if (result != BONGOCAT_SUCCESS) {
     bongocat_log_error("Failed to load configuration: %s",
@@ -760,19 +929,49 @@ int main(int argc, char *argv[]) {
       free(resolved_config);
       return 1;
     }
+  } else if (g_config.num_output_names > 1 &&
+             g_config.multi_monitor_mode == MULTI_MONITOR_SHARED) {
+    // One process: wayland_init() adds a surface per configured monitor
+    bongocat_log_info("Shared multi-monitor mode with %d configured monitors",
+                      g_config.num_output_names);
   } else if (g_config.num_output_names > 1) {
     // Parent process: launch one child per configured monitor
     bongocat_log_info("Multi-monitor mode enabled with %d configured monitors",
                       g_config.num_output_names);
 
-    int mm_result =
-        multi_monitor_launch(argc, argv, resolved_config, args.watch_config,
-                             g_config.output_names, g_config.num_output_names);
+    // Parse SVGs and rasterize frames once; children are forked without
+    // exec and share the result copy-on-write
+    if (animation_preload(&g_config) != BONGOCAT_SUCCESS) {
+      bongocat_log_warning("Asset preload failed, each monitor loads its own");
+    }
+
+    const char *child_monitor = NULL;
+    int mm_result = multi_monitor_launch(
+        g_config.output_names, (size_t)g_config.num_output_names,
+        &child_monitor);
+
+    if (mm_result == MULTI_MONITOR_IN_CHILD) {
+      // The parent owns the PID file; drop our copy of its fd (the lock
+      // stays with the parent's open file description)
+      g_manage_pid_file = false;
+      if (g_pid_fd >= 0) {
+        close(g_pid_fd);
+        g_pid_fd = -1;
+      }
 
-    if (mm_result == -1) {
+      snprintf(g_child_monitor_name, sizeof(g_child_monitor_name), "%s",
+               child_monitor);
+      g_forced_monitor_name = g_child_monitor_name;
+      if (config_apply_forced_monitor(&g_config, g_forced_monitor_name) !=
+          BONGOCAT_SUCCESS) {
+        free(resolved_config);
+        return 1;
+      }
+    } else if (mm_result == MULTI_MONITOR_FALLBACK) {
       // Single monitor after config filtering, fall through
       bongocat_log_info("Falling back to single-monitor mode");
     } else {
+      animation_cleanup();
       free(resolved_config);
       config_cleanup_full(&g_config);
       config_cleanup();
@@ -780,6 +979,16 @@ int main(int argc, char *argv[]) {
     }
   }
 
+  // Per instance: multi-monitor children get counters of their own
+  if (metrics_init() != BONGOCAT_SUCCESS) {
+    bongocat_log_warning("Input child metrics will read as zero");
+  }
+
+  // Before any thread starts and before the input child is forked
+  if (args.trace_file) {
+    trace_setup(args.trace_file);
+  }
+
   // Initialize config watcher if requested
   if (args.watch_config) {
     config_setup_watcher(resolved_config);
@@ -6,26 +6,23 @@
 
 #include <errno.h>
 #include <signal.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
-#define MAX_CHILD_ARGV 20
-
-int multi_monitor_launch(int argc, char *argv[], const char *config_path,
-                         int watch_config, char **output_names,
-                         size_t output_count) {
-  (void)argc;
-  if (!output_names || output_count == 0) {
+int multi_monitor_launch(char **output_names, size_t output_count,
+                         const char **child_output_name) {
+  if (!output_names || output_count == 0 || !child_output_name) {
     bongocat_log_warning("No monitor names configured, using single monitor");
-    return -1;
+    return MULTI_MONITOR_FALLBACK;
   }
 
   if (output_count == 1) {
     bongocat_log_info("Only 1 monitor configured, running single instance");
-    return -1;
+    return MULTI_MONITOR_FALLBACK;
   }
 
   if (output_count > MULTI_MONITOR_MAX_OUTPUTS) {
@@ -55,6 +52,11 @@ int multi_monitor_launch(int argc, char *argv[], const char *config_path,
     children[i] = -1;
   }
 
+  // Children start with a copy of the stdio buffers; flush them so nothing
+  // is printed once per child. Queued log records stay with our writer.
+  fflush(stdout);
+  fflush(stderr);
+
   int alive = 0;
   for (size_t i = 0; i < output_count; i++) {
     if (!output_names[i] || output_names[i][0] == '\0') {
@@ -70,31 +72,13 @@ int multi_monitor_launch(int argc, char *argv[], const char *config_path,
     }
 
     if (pid == 0) {
-      char *new_argv[MAX_CHILD_ARGV];
-      int idx = 0;
-
-      new_argv[idx++] = argv[0];
-      if (config_path) {
-        new_argv[idx++] = "-c";
-        new_argv[idx++] = (char *)config_path;
-      }
-      if (watch_config) {
-        new_argv[idx++] = "-w";
+      // No exec: the child keeps the parent's parsed config and warm caches
+      // and goes on to open its own Wayland connection
+      if (restore_sigchld) {
+        sigaction(SIGCHLD, &old_sigchld, NULL);
       }
-      new_argv[idx++] = "--monitor";
-      new_argv[idx++] = output_names[i];
-      new_argv[idx++] = "--multi-monitor-child";
-      if (idx >= MAX_CHILD_ARGV) {
-        bongocat_log_error("Too many child argv entries for output '%s'",
-                           output_names[i]);
-        _exit(1);
-      }
-      new_argv[idx] = NULL;
-
-      execvp(argv[0], new_argv);
-      bongocat_log_error("execvp failed for output '%s': %s", output_names[i],
-                         strerror(errno));
-      _exit(1);
+      *child_output_name = output_names[i];
+      return MULTI_MONITOR_IN_CHILD;
     }
 
     children[i] = pid;
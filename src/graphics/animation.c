@@ -1,27 +1,21 @@
 #define _POSIX_C_SOURCE 199309L
-#define NANOSVG_IMPLEMENTATION
-#define NANOSVGRAST_IMPLEMENTATION
 #include "graphics/animation.h"
 
-#include "graphics/embedded_assets.h"
+#include "graphics/frame_cache.h"
+#include "graphics/hand_mapping.h"
 #include "platform/input.h"
+#include "platform/power.h"
 #include "platform/wayland.h"
+#include "utils/latency.h"
 #include "utils/memory.h"
+#include "utils/metrics.h"
+#include "utils/trace.h"
 
-#if defined(__GNUC__)
-#  pragma GCC diagnostic push
-#  pragma GCC diagnostic ignored "-Wshadow"
-#  pragma GCC diagnostic ignored "-Wdouble-promotion"
-#  pragma GCC diagnostic ignored "-Wmissing-prototypes"
-#  pragma GCC diagnostic ignored "-Wstrict-prototypes"
-#  pragma GCC diagnostic ignored "-Wold-style-definition"
-#endif
-#include <nanosvg.h>
-#include <nanosvgrast.h>
-#if defined(__GNUC__)
-#  pragma GCC diagnostic pop
-#endif
+#include <errno.h>
 #include <poll.h>
+#include <stdatomic.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -29,19 +23,15 @@
 // GLOBAL STATE AND CONFIGURATION
 // =============================================================================
 
-int anim_index = 0;
-pthread_mutex_t anim_lock = PTHREAD_MUTEX_INITIALIZER;
-cached_frame_t anim_cached_frames[NUM_FRAMES] = {0};
+atomic_int anim_index = 0;
 
-// SVG parsed data and rasterizer
-static NSVGimage *anim_svgs[NUM_FRAMES];
-static NSVGrasterizer *anim_rasterizer;
-
-// Animation system state
-static config_t *current_config;
+// Animation system state. current_config points into the render snapshot
+// held for the duration of one anim_run_once() pass (NULL otherwise).
+static const config_t *current_config;
 static pthread_t anim_thread;
 static atomic_bool animation_running = false;
 static bool animation_thread_started = false;
+static bool animation_single_threaded = false;
 static bool animation_initialized = false;
 
 // =============================================================================
@@ -50,22 +40,73 @@ static bool animation_initialized = false;
 
 typedef struct {
   long hold_until;
-  int test_counter;
-  int test_interval_frames;
+  long next_test_us;  // Next test animation trigger (0 = disabled)
   long frame_time_ns;
   long last_key_pressed_timestamp;
+
+  // Scheduled sleep state is only recomputed with localtime_r() when the
+  // wall clock leaves [sleep_valid_from_us, sleep_valid_until_us), i.e. at
+  // the next sleep_begin/sleep_end boundary or after a clock jump.
+  bool in_sleep_time;
+  long long sleep_valid_from_us;
+  long long sleep_valid_until_us;
 } animation_state_t;
 
+// Control eventfd: wakes the animation thread for shutdown and config reloads
+static int anim_control_fd = -1;
+static atomic_bool anim_config_changed = false;
+static atomic_bool anim_redraw_requested = false;
+
+// State machine, owned by whichever thread runs anim_run_once()
+static animation_state_t anim_state;
+static int anim_last_drawn_frame = -1;  // Skips redundant redraws
+static bool anim_force_redraw = true;
+
+// Every target is hidden behind a fullscreen window: no frames, deadlines
+// or key wakeups until one is visible again
+static bool anim_suspended = false;
+
+// Frame deadline timer of the single-threaded runtime
+static int anim_timer_fd = -1;
+
 static long anim_get_current_time_us(void) {
   struct timespec ts;
   clock_gettime(CLOCK_MONOTONIC, &ts);
   return ts.tv_sec * 1000000L + ts.tv_nsec / 1000L;
 }
 
-static bool anim_is_sleep_time(const config_t *config) {
-  time_t raw_time;
+static long long anim_get_wall_time_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (long long)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000L;
+}
+
+// Next wall-clock time after now at which the local time reads hour:min
+static time_t anim_next_local_time(time_t now, const struct tm *now_tm,
+                                   config_time_t at) {
+  struct tm tm = *now_tm;
+  tm.tm_hour = at.hour;
+  tm.tm_min = at.min;
+  tm.tm_sec = 0;
+  tm.tm_isdst = -1;
+  time_t t = mktime(&tm);
+  if (t <= now) {
+    tm = *now_tm;
+    tm.tm_mday += 1;
+    tm.tm_hour = at.hour;
+    tm.tm_min = at.min;
+    tm.tm_sec = 0;
+    tm.tm_isdst = -1;
+    t = mktime(&tm);
+  }
+  return t;
+}
+
+static void anim_refresh_sleep_schedule(animation_state_t *state,
+                                        const config_t *config,
+                                        long long wall_us) {
+  time_t raw_time = (time_t)(wall_us / 1000000LL);
   struct tm time_info;
-  time(&raw_time);
   localtime_r(&raw_time, &time_info);
 
   const int now_minutes = time_info.tm_hour * 60 + time_info.tm_min;
@@ -75,43 +116,29 @@ static bool anim_is_sleep_time(const config_t *config) {
   // Normal range (e.g., 10:00–22:00): begin < end && (now_minutes >= begin &&
   // now_minutes < end) Overnight range (e.g., 22:00–06:00): begin > end &&
   // (now_minutes >= begin || now_minutes < end)
-  return (begin == end) ||
-         (begin < end ? (now_minutes >= begin && now_minutes < end)
-                      : (now_minutes >= begin || now_minutes < end));
-}
-
-// Get frame based on keyboard position (left=1, right=2)
-// Uses Linux input keycodes from <linux/input-event-codes.h>
-static int get_frame_for_keycode(int keycode) {
-  // Left-hand keys on QWERTY keyboard
-  // clang-format off
-  static const int left_keys[] = {
-    // Number row left half (1-6)
-    2, 3, 4, 5, 6, 7,           // KEY_1 to KEY_6
-    // QWERTY row left half
-    16, 17, 18, 19, 20,         // KEY_Q, KEY_W, KEY_E, KEY_R, KEY_T
-    // Home row left half
-    30, 31, 32, 33, 34,         // KEY_A, KEY_S, KEY_D, KEY_F, KEY_G
-    // Bottom row left half
-    44, 45, 46, 47, 48,         // KEY_Z, KEY_X, KEY_C, KEY_V, KEY_B
-    // Modifiers and special keys (left side)
-    1,                          // KEY_ESC
-    15,                         // KEY_TAB
-    58,                         // KEY_CAPSLOCK
-    42,                         // KEY_LEFTSHIFT
-    29,                         // KEY_LEFTCTRL
-    56,                         // KEY_LEFTALT
-    41,                         // KEY_GRAVE (backtick)
-    125,                        // KEY_LEFTMETA (super)
-  };
-  // clang-format on
-
-  for (size_t i = 0; i < sizeof(left_keys) / sizeof(left_keys[0]); i++) {
-    if (keycode == left_keys[i]) {
-      return 1;  // Left hand
-    }
+  state->in_sleep_time =
+      (begin == end) ||
+      (begin < end ? (now_minutes >= begin && now_minutes < end)
+                   : (now_minutes >= begin || now_minutes < end));
+
+  time_t next_begin =
+      anim_next_local_time(raw_time, &time_info, config->sleep_begin);
+  time_t next_end =
+      anim_next_local_time(raw_time, &time_info, config->sleep_end);
+  time_t next_boundary = next_begin < next_end ? next_begin : next_end;
+
+  state->sleep_valid_from_us = (long long)raw_time * 1000000LL;
+  state->sleep_valid_until_us = (long long)next_boundary * 1000000LL;
+}
+
+static bool anim_is_sleep_time(animation_state_t *state,
+                               const config_t *config) {
+  long long wall_us = anim_get_wall_time_us();
+  if (wall_us < state->sleep_valid_from_us ||
+      wall_us >= state->sleep_valid_until_us) {
+    anim_refresh_sleep_schedule(state, config, wall_us);
   }
-  return 2;  // Right hand (default for all other keys)
+  return state->in_sleep_time;
 }
 
 static int anim_get_active_frame(void) {
@@ -135,25 +162,24 @@ static void anim_trigger_frame_change(int new_frame, long duration_us,
                        new_frame, duration_us);
   }
 
-  anim_index = new_frame;
+  atomic_store(&anim_index, new_frame);
   state->hold_until = current_time_us + duration_us;
 }
 
 static void anim_handle_test_animation(animation_state_t *state,
                                        long current_time_us) {
-  if (current_config->test_animation_interval <= 0) {
+  if (current_config->test_animation_interval <= 0 ||
+      state->next_test_us == 0 || current_time_us < state->next_test_us) {
     return;
   }
 
-  state->test_counter++;
-  if (state->test_counter > state->test_interval_frames) {
-    int new_frame = anim_get_active_frame();
-    long duration_us = current_config->test_animation_duration * 1000;
+  int new_frame = anim_get_active_frame();
+  long duration_us = current_config->test_animation_duration * 1000;
 
-    bongocat_log_debug("Test animation trigger");
-    anim_trigger_frame_change(new_frame, duration_us, current_time_us, state);
-    state->test_counter = 0;
-  }
+  bongocat_log_debug("Test animation trigger");
+  anim_trigger_frame_change(new_frame, duration_us, current_time_us, state);
+  state->next_test_us =
+      current_time_us + current_config->test_animation_interval * 1000000L;
 }
 
 static void anim_handle_key_press(animation_state_t *state,
@@ -163,15 +189,23 @@ static void anim_handle_key_press(animation_state_t *state,
   }
 
   if (!current_config->enable_scheduled_sleep ||
-      !anim_is_sleep_time(current_config)) {
+      !anim_is_sleep_time(state, current_config)) {
     int new_frame = anim_get_active_frame();
     long duration_us = current_config->keypress_duration * 1000;
 
     bongocat_log_debug("Key press detected - switching to frame %d", new_frame);
+    if (last_key_timing) {
+      latency_sample_begin(atomic_load(&last_key_timing->event_us),
+                           atomic_load(&last_key_timing->read_us),
+                           current_time_us);
+    }
     anim_trigger_frame_change(new_frame, duration_us, current_time_us, state);
 
     atomic_store(any_key_pressed, 0);
-    state->test_counter = 0;  // Reset test counter
+    if (state->next_test_us > 0) {  // Restart the test animation interval
+      state->next_test_us =
+          current_time_us + current_config->test_animation_interval * 1000000L;
+    }
     state->last_key_pressed_timestamp = current_time_us;
   }
 }
@@ -181,23 +215,28 @@ static void anim_handle_idle_return(animation_state_t *state,
   int show_sleep_frame = 0;
   // Sleep Mode
   if (current_config->enable_scheduled_sleep) {
-    if (anim_is_sleep_time(current_config)) {
+    if (anim_is_sleep_time(state, current_config)) {
       show_sleep_frame = 1;
     }
   }
-  // Idle Sleep
-  if (current_config->idle_sleep_timeout_sec > 0 &&
-      state->last_key_pressed_timestamp > 0) {
-    if (anim_get_current_time_us() - state->last_key_pressed_timestamp >=
+  // Idle Sleep: the compositor's idle notification when available, which
+  // also sees pointer activity and idle inhibitors
+  if (power_idle_tracked()) {
+    if (power_user_idle()) {
+      show_sleep_frame = 1;
+    }
+  } else if (current_config->idle_sleep_timeout_sec > 0 &&
+             state->last_key_pressed_timestamp > 0) {
+    if (current_time_us - state->last_key_pressed_timestamp >=
         current_config->idle_sleep_timeout_sec * 1000000L) {
       show_sleep_frame = 1;
     }
   }
 
   if (show_sleep_frame) {
-    if (anim_index != BONGOCAT_FRAME_SLEEPING) {
+    if (atomic_load(&anim_index) != BONGOCAT_FRAME_SLEEPING) {
       bongocat_log_debug("Returning to sleep frame");
-      anim_index = BONGOCAT_FRAME_SLEEPING;
+      atomic_store(&anim_index, BONGOCAT_FRAME_SLEEPING);
     }
     return;
   }
@@ -206,316 +245,354 @@ static void anim_handle_idle_return(animation_state_t *state,
     return;
   }
 
-  if (anim_index != current_config->idle_frame) {
+  if (atomic_load(&anim_index) != current_config->idle_frame) {
     bongocat_log_debug("Returning to idle frame %d",
                        current_config->idle_frame);
-    anim_index = current_config->idle_frame;
+    atomic_store(&anim_index, current_config->idle_frame);
   }
 }
 
 static void anim_update_state(animation_state_t *state) {
   long current_time_us = anim_get_current_time_us();
 
-  pthread_mutex_lock(&anim_lock);
-
   anim_handle_test_animation(state, current_time_us);
   anim_handle_key_press(state, current_time_us);
   anim_handle_idle_return(state, current_time_us);
-
-  pthread_mutex_unlock(&anim_lock);
 }
 
 // =============================================================================
 // ANIMATION THREAD MANAGEMENT MODULE
 // =============================================================================
 
+// Timing settings come from the first snapshot (see anim_run_once())
 static void anim_init_state(animation_state_t *state) {
+  long now = anim_get_current_time_us();
+
   state->hold_until = 0;
-  state->test_counter = 0;
-  state->test_interval_frames =
-      current_config->test_animation_interval * current_config->fps;
-  state->frame_time_ns = 1000000000L / current_config->fps;
-  state->last_key_pressed_timestamp = anim_get_current_time_us();
+  state->next_test_us = 0;
+  state->frame_time_ns = 0;
+  state->last_key_pressed_timestamp = now;
+  state->in_sleep_time = false;
+  state->sleep_valid_from_us = 0;
+  state->sleep_valid_until_us = 0;  // Force a refresh on first use
+  atomic_store(&anim_config_changed, true);
 }
 
-static void *anim_thread_main([[maybe_unused]] void *arg) {
-  animation_state_t state;
-  anim_init_state(&state);
-
-  struct timespec frame_delay = {0, state.frame_time_ns};
-
-  bongocat_log_debug("Animation thread main loop started");
-
-  // Track last drawn state to skip redundant redraws
-  int last_drawn_frame = -1;
-  bool force_redraw = true;  // Force first draw
-
-  while (animation_running) {
-    int prev_frame = anim_index;
-    anim_update_state(&state);
-
-    // Check if frame actually changed
-    bool frame_changed = (anim_index != last_drawn_frame);
-    bool state_changed = (anim_index != prev_frame);
+// Pick up timing settings after a config reload
+static void anim_apply_config_change(animation_state_t *state) {
+  long now = anim_get_current_time_us();
+  state->next_test_us =
+      current_config->test_animation_interval > 0
+          ? now + current_config->test_animation_interval * 1000000L
+          : 0;
+  state->frame_time_ns = 1000000000L / current_config->fps;
+  state->sleep_valid_until_us = 0;
+}
 
-    // Only redraw if something changed
-    if (frame_changed || force_redraw) {
-      draw_bar();
-      last_drawn_frame = anim_index;
-      force_redraw = false;
-    }
+// Nothing ran while suspended. Drop a press that raced the suspension, count
+// idle time from the last key the input child recorded meanwhile, and start
+// over from the idle frame; anim_update_state() then picks the sleep frame
+// if one is due.
+static void anim_resync_state(animation_state_t *state) {
+  long now = anim_get_current_time_us();
 
-    // Stay at FPS-rate while animating (non-idle frame or state just changed).
-    // Drop to eventfd-driven idle sleep only when truly idle.
-    bool animating = state_changed || anim_index != current_config->idle_frame;
-    if (animating) {
-      nanosleep(&frame_delay, NULL);
-    } else {
-      int wfd = input_get_wake_fd();
-      if (wfd >= 0) {
-        struct pollfd pfd = {.fd = wfd, .events = POLLIN};
-        poll(&pfd, 1, 1000);
-        if (pfd.revents & POLLIN) {
-          uint64_t val;
-          if (read(wfd, &val, sizeof(val)) < 0) {
-            // Best-effort drain; ignore errors
-          }
-        }
-      } else {
-        long idle_ns = state.frame_time_ns * 2;
-        if (idle_ns > 999999999L)
-          idle_ns = 999999999L;
-        struct timespec idle_delay = {0, idle_ns};
-        nanosleep(&idle_delay, NULL);
-      }
+  if (any_key_pressed) {
+    atomic_store(any_key_pressed, 0);
+  }
+  if (last_key_timing) {
+    long read_us = (long)atomic_load(&last_key_timing->read_us);
+    if (read_us > state->last_key_pressed_timestamp && read_us <= now) {
+      state->last_key_pressed_timestamp = read_us;
     }
   }
+  state->hold_until = 0;
+  if (state->next_test_us > 0) {
+    state->next_test_us =
+        now + current_config->test_animation_interval * 1000000L;
+  }
+  state->sleep_valid_until_us = 0;
 
-  bongocat_log_debug("Animation thread main loop exited");
-  return NULL;
+  atomic_store(&anim_index, current_config->idle_frame);
+  anim_last_drawn_frame = -1;
 }
 
-// =============================================================================
-// SVG LOADING MODULE
-// =============================================================================
+static void anim_set_suspended(animation_state_t *state, bool suspended) {
+  anim_suspended = suspended;
+  input_set_wake_suspended(suspended);
+  // Unmaps every surface on suspend, maps them again on resume
+  anim_force_redraw = true;
+
+  if (suspended) {
+    bongocat_log_info("No output visible (fullscreen or powered off), "
+                      "rendering suspended");
+  } else {
+    bongocat_log_info("Rendering resumed");
+    anim_resync_state(state);
+  }
+}
 
-typedef struct {
-  const unsigned char *data;
-  size_t size;
-  const char *name;
-} embedded_svg_t;
-
-static embedded_svg_t embedded_svgs[NUM_FRAMES];
-
-static void init_embedded_svgs(void) {
-  embedded_svgs[BONGOCAT_FRAME_BOTH_UP] = (embedded_svg_t){
-      bongo_both_up_svg, bongo_both_up_svg_size, "bongo-both-up.svg"};
-  embedded_svgs[BONGOCAT_FRAME_LEFT_DOWN] = (embedded_svg_t){
-      bongo_left_down_svg, bongo_left_down_svg_size, "bongo-left-down.svg"};
-  embedded_svgs[BONGOCAT_FRAME_RIGHT_DOWN] = (embedded_svg_t){
-      bongo_right_down_svg, bongo_right_down_svg_size, "bongo-right-down.svg"};
-  embedded_svgs[BONGOCAT_FRAME_BOTH_DOWN] = (embedded_svg_t){
-      bongo_both_down_svg, bongo_both_down_svg_size, "bongo-both-down.svg"};
-  embedded_svgs[BONGOCAT_FRAME_SLEEPING] = (embedded_svg_t){
-      bongo_sleeping_svg, bongo_sleeping_svg_size, "bongo-sleeping.svg"};
-}
-
-static void anim_cleanup_svgs(void) {
-  for (int i = 0; i < NUM_FRAMES; i++) {
-    if (anim_svgs[i]) {
-      nsvgDelete(anim_svgs[i]);
-      anim_svgs[i] = NULL;
+static void anim_wake_thread(void) {
+  if (anim_control_fd >= 0) {
+    uint64_t val = 1;
+    if (write(anim_control_fd, &val, sizeof(val)) < 0) {
+      // Counter overflow is impossible in practice; nothing to do
     }
   }
-  if (anim_rasterizer) {
-    nsvgDeleteRasterizer(anim_rasterizer);
-    anim_rasterizer = NULL;
-  }
 }
 
-static bongocat_error_t anim_parse_embedded_svgs(void) {
-  for (int i = 0; i < NUM_FRAMES; i++) {
-    const embedded_svg_t *svg = &embedded_svgs[i];
-
-    bongocat_log_debug("Parsing embedded SVG: %s", svg->name);
+static void anim_consider_deadline(long *deadline, long candidate) {
+  if (candidate > 0 && (*deadline == 0 || candidate < *deadline)) {
+    *deadline = candidate;
+  }
+}
 
-    // nsvgParse modifies the string in-place, so make a mutable copy
-    char *svg_copy = malloc(svg->size + 1);
-    if (!svg_copy) {
-      bongocat_log_error("Failed to allocate SVG copy for: %s", svg->name);
-      anim_cleanup_svgs();
-      return BONGOCAT_ERROR_MEMORY;
-    }
-    memcpy(svg_copy, svg->data, svg->size);
-    svg_copy[svg->size] = '\0';
+// Earliest monotonic time at which anim_update_state() could pick a
+// different frame without new input, or 0 if nothing is scheduled.
+static long anim_next_deadline(const animation_state_t *state, long now) {
+  long deadline = 0;
 
-    anim_svgs[i] = nsvgParse(svg_copy, "px", 96.0f);
-    free(svg_copy);
+  // Key press / test animation hold expires (held while now <= hold_until)
+  if (state->hold_until >= now) {
+    anim_consider_deadline(&deadline, state->hold_until + 1);
+  }
 
-    if (!anim_svgs[i]) {
-      bongocat_log_error("Failed to parse embedded SVG: %s", svg->name);
-      anim_cleanup_svgs();
-      return BONGOCAT_ERROR_FILE_IO;
+  // Idle sleep timeout, unless the idled event will wake us
+  if (!power_idle_tracked() && current_config->idle_sleep_timeout_sec > 0 &&
+      state->last_key_pressed_timestamp > 0) {
+    long idle_at = state->last_key_pressed_timestamp +
+                   current_config->idle_sleep_timeout_sec * 1000000L;
+    if (idle_at > now) {
+      anim_consider_deadline(&deadline, idle_at);
     }
+  }
 
-    bongocat_log_debug("Parsed SVG %s: %.0fx%.0f", svg->name,
-                       (double)anim_svgs[i]->width,
-                       (double)anim_svgs[i]->height);
+  // Next sleep_begin/sleep_end boundary, translated to the monotonic clock
+  if (current_config->enable_scheduled_sleep &&
+      state->sleep_valid_until_us > 0) {
+    long long until_wall = state->sleep_valid_until_us - anim_get_wall_time_us();
+    anim_consider_deadline(&deadline,
+                           until_wall > 0 ? now + (long)until_wall : now);
   }
 
-  anim_rasterizer = nsvgCreateRasterizer();
-  if (!anim_rasterizer) {
-    bongocat_log_error("Failed to create SVG rasterizer");
-    anim_cleanup_svgs();
-    return BONGOCAT_ERROR_MEMORY;
+  // Test animation tick
+  anim_consider_deadline(&deadline, state->next_test_us);
+
+  // Without an input eventfd key presses are only seen by polling
+  if (input_get_wake_fd() < 0) {
+    anim_consider_deadline(&deadline, now + state->frame_time_ns / 1000L);
   }
 
-  return BONGOCAT_SUCCESS;
+  return deadline;
 }
 
-// =============================================================================
-// FRAME CACHE MODULE
-// =============================================================================
+static void anim_drain_fd(int fd) {
+  uint64_t val;
+  if (read(fd, &val, sizeof(val)) < 0) {
+    // Best-effort drain; ignore errors
+    return;
+  }
+  // The input eventfd adds up the presses written since the last drain;
+  // all but one of them were handled by this single wakeup
+  if (fd == input_get_wake_fd()) {
+    trace_instant_arg("key wake", (int64_t)val);
+    if (val > 1) {
+      metrics_add(METRIC_KEY_PRESSES_COALESCED, val - 1);
+    }
+  }
+}
 
-void animation_invalidate_cache(void) {
-  for (int i = 0; i < NUM_FRAMES; i++) {
-    free(anim_cached_frames[i].data);
-    anim_cached_frames[i].data = NULL;
-    anim_cached_frames[i].width = 0;
-    anim_cached_frames[i].height = 0;
+// Arm timer_fd for an absolute monotonic deadline (0 disarms it)
+static void anim_arm_timer(int timer_fd, long deadline_us) {
+  struct itimerspec its = {0};
+  if (deadline_us > 0) {
+    its.it_value.tv_sec = deadline_us / 1000000L;
+    its.it_value.tv_nsec = (deadline_us % 1000000L) * 1000L;
   }
+  timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &its, NULL);
 }
 
-void animation_cache_frames(int target_w, int target_h, int mirror_x,
-                            int mirror_y, [[maybe_unused]] int enable_aa) {
-  animation_invalidate_cache();
+// Block until the input eventfd, the control eventfd or the deadline fires.
+// With a timerfd the deadline is absolute, so the wait is exact no matter
+// how long the current iteration took.
+static void anim_wait_until(int timer_fd, long deadline_us) {
+  struct pollfd pfds[3];
+  nfds_t nfds = 0;
+  int timeout_ms = -1;
+
+  int wfd = input_get_wake_fd();
+  if (wfd >= 0) {
+    pfds[nfds++] = (struct pollfd){.fd = wfd, .events = POLLIN};
+  }
+  if (anim_control_fd >= 0) {
+    pfds[nfds++] = (struct pollfd){.fd = anim_control_fd, .events = POLLIN};
+  }
 
-  if (!anim_rasterizer || target_w <= 0 || target_h <= 0) {
-    return;
+  if (timer_fd >= 0) {
+    anim_arm_timer(timer_fd, deadline_us);
+    pfds[nfds++] = (struct pollfd){.fd = timer_fd, .events = POLLIN};
+  } else if (deadline_us > 0) {
+    long remaining_us = deadline_us - anim_get_current_time_us();
+    timeout_ms = remaining_us > 0 ? (int)((remaining_us + 999) / 1000) : 0;
   }
 
-  for (int i = 0; i < NUM_FRAMES; i++) {
-    if (!anim_svgs[i]) {
-      continue;
+  if (nfds == 0) {
+    // No eventfds at all: the deadline always includes the frame-rate
+    // polling fallback, so just sleep until it
+    long remaining_us = deadline_us - anim_get_current_time_us();
+    if (remaining_us > 0) {
+      struct timespec delay = {remaining_us / 1000000L,
+                               (remaining_us % 1000000L) * 1000L};
+      int64_t span = trace_begin();
+      nanosleep(&delay, NULL);
+      trace_end("wait", span);
     }
+    metrics_count_wakeup(METRICS_THREAD_ANIMATION);
+    return;
+  }
 
-    float svg_w = anim_svgs[i]->width;
-    float svg_h = anim_svgs[i]->height;
-    if (svg_w <= 0 || svg_h <= 0) {
-      continue;
+  int64_t span = trace_begin();
+  int ready = poll(pfds, nfds, timeout_ms);
+  trace_end("wait", span);
+  metrics_count_wakeup(METRICS_THREAD_ANIMATION);
+  if (ready <= 0) {
+    return;
+  }
+  for (nfds_t i = 0; i < nfds; i++) {
+    if (pfds[i].revents & POLLIN) {
+      anim_drain_fd(pfds[i].fd);
     }
+  }
+}
 
-    // Rasterize SVG at exact target dimensions
-    float scale = (float)target_w / svg_w;
-    size_t buf_size = (size_t)target_w * (size_t)target_h * 4U;
-    uint8_t *rgba_buf = calloc(1, buf_size);
-    if (!rgba_buf) {
-      bongocat_log_error("Failed to allocate raster buffer for frame %d", i);
-      continue;
-    }
+// One pass of the state machine: apply pending config changes, pick the
+// frame, redraw if it changed. Returns the next deadline (0 = none).
+static long anim_run_once(void) {
+  // Settings are read from the published render snapshot, so a concurrent
+  // reload never blocks (or tears) this pass
+  render_snapshot_t *snap = render_state_acquire();
+  if (!snap) {
+    // Nothing to draw yet; publishing a snapshot requests a redraw
+    return 0;
+  }
+  current_config = &snap->config;
 
-    nsvgRasterize(anim_rasterizer, anim_svgs[i], 0, 0, scale, rgba_buf,
-                  target_w, target_h, target_w * 4);
-
-    // Apply horizontal mirror
-    if (mirror_x) {
-      for (int y = 0; y < target_h; y++) {
-        for (int left = 0, right = target_w - 1; left < right;
-             left++, right--) {
-          int li = (y * target_w + left) * 4;
-          int ri = (y * target_w + right) * 4;
-          uint8_t tmp[4];
-          memcpy(tmp, &rgba_buf[li], 4);
-          memcpy(&rgba_buf[li], &rgba_buf[ri], 4);
-          memcpy(&rgba_buf[ri], tmp, 4);
-        }
-      }
-    }
+  if (atomic_exchange(&anim_config_changed, false)) {
+    anim_apply_config_change(&anim_state);
+  }
+  if (atomic_exchange(&anim_redraw_requested, false)) {
+    anim_force_redraw = true;
+  }
 
-    // Apply vertical mirror
-    if (mirror_y) {
-      size_t row_bytes = (size_t)target_w * 4U;
-      uint8_t *tmp_row = malloc(row_bytes);
-      if (tmp_row) {
-        for (int top = 0, bot = target_h - 1; top < bot; top++, bot--) {
-          uint8_t *t = &rgba_buf[(size_t)top * row_bytes];
-          uint8_t *b = &rgba_buf[(size_t)bot * row_bytes];
-          memcpy(tmp_row, t, row_bytes);
-          memcpy(t, b, row_bytes);
-          memcpy(b, tmp_row, row_bytes);
-        }
-        free(tmp_row);
-      }
+  bool nothing_visible = render_snapshot_nothing_visible(snap);
+  if (nothing_visible != anim_suspended) {
+    anim_set_suspended(&anim_state, nothing_visible);
+  }
+  if (anim_suspended) {
+    // Redraw requests still get through: they unmap surfaces that were
+    // not configured yet when rendering was suspended
+    if (anim_force_redraw) {
+      draw_bar();
+      anim_force_redraw = false;
     }
+    latency_sample_abort();
+    current_config = NULL;
+    render_snapshot_release(snap);
+
+    // Without a control eventfd nothing would wake us to resume
+    return anim_control_fd >= 0 ? 0
+                                : anim_get_current_time_us() +
+                                      anim_state.frame_time_ns / 1000L;
+  }
 
-    // Convert RGBA -> premultiplied BGRA for Wayland (ARGB8888 is
-    // premultiplied)
-    for (size_t px = 0; px < buf_size; px += 4) {
-      uint8_t r = rgba_buf[px + 0];
-      uint8_t g = rgba_buf[px + 1];
-      uint8_t b = rgba_buf[px + 2];
-      uint8_t a = rgba_buf[px + 3];
-      rgba_buf[px + 0] = (uint8_t)((b * a) / 255);
-      rgba_buf[px + 1] = (uint8_t)((g * a) / 255);
-      rgba_buf[px + 2] = (uint8_t)((r * a) / 255);
-      rgba_buf[px + 3] = a;
-    }
+  int64_t span = trace_begin();
+  anim_update_state(&anim_state);
+  latency_sample_mark(LATENCY_STAGE_UPDATE);
 
-    anim_cached_frames[i].data = rgba_buf;
-    anim_cached_frames[i].width = target_w;
-    anim_cached_frames[i].height = target_h;
+  // Only redraw if the frame actually changed
+  int frame = atomic_load(&anim_index);
+  if (frame != anim_last_drawn_frame || anim_force_redraw) {
+    draw_bar();
+    anim_last_drawn_frame = frame;
+    anim_force_redraw = false;
   }
-
-  bongocat_log_debug("Cached %d animation frames at %dx%d", NUM_FRAMES,
-                     target_w, target_h);
+  // draw_bar() records completed samples; drop any that never reached a
+  // commit (frame unchanged or surface not ready)
+  latency_sample_abort();
+  trace_end_arg("update", span, frame);
+
+  long deadline = anim_next_deadline(&anim_state, anim_get_current_time_us());
+  current_config = NULL;
+  render_snapshot_release(snap);
+  return deadline;
 }
 
-void blit_cached_frame(uint8_t *dest, int dest_w, int dest_h,
-                       const uint8_t *src, int src_w, int src_h, int offset_x,
-                       int offset_y) {
-  for (int y = 0; y < src_h; y++) {
-    int dy = y + offset_y;
-    if (dy < 0 || dy >= dest_h)
-      continue;
-    for (int x = 0; x < src_w; x++) {
-      int dx = x + offset_x;
-      if (dx < 0 || dx >= dest_w)
-        continue;
-      int si = (y * src_w + x) * 4;
-      int di = (dy * dest_w + dx) * 4;
-      uint8_t sa = src[si + 3];
-      if (sa == 0)
-        continue;
-      if (sa == 255) {
-        memcpy(&dest[di], &src[si], 4);
-      } else {
-        // Premultiplied alpha "over" compositing
-        uint8_t inv_a = 255 - sa;
-        dest[di + 0] = src[si + 0] + (uint8_t)((dest[di + 0] * inv_a) / 255);
-        dest[di + 1] = src[si + 1] + (uint8_t)((dest[di + 1] * inv_a) / 255);
-        dest[di + 2] = src[si + 2] + (uint8_t)((dest[di + 2] * inv_a) / 255);
-        dest[di + 3] = sa + (uint8_t)((dest[di + 3] * inv_a) / 255);
-      }
-    }
+static void *anim_thread_main([[maybe_unused]] void *arg) {
+  int timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (timer_fd < 0) {
+    bongocat_log_warning("Failed to create animation timerfd: %s (falling "
+                         "back to poll timeouts)",
+                         strerror(errno));
   }
+
+  trace_set_thread_name("animation");
+  bongocat_log_debug("Animation thread main loop started");
+
+  while (animation_running) {
+    // Sleep until the next key press, config change or scheduled frame
+    // change. A fully idle cat has no deadline and no periodic wakeups.
+    anim_wait_until(timer_fd, anim_run_once());
+  }
+
+  if (timer_fd >= 0) {
+    close(timer_fd);
+  }
+
+  bongocat_log_debug("Animation thread main loop exited");
+  return NULL;
+}
+
+// Single-threaded runtime: the Wayland event loop calls this when the input
+// wake fd, the control fd or the frame timer becomes readable
+static void anim_handle_fd_ready(int fd, [[maybe_unused]] void *data) {
+  anim_drain_fd(fd);
+  anim_arm_timer(anim_timer_fd, anim_run_once());
 }
 
-// =============================================================================
 // PUBLIC API IMPLEMENTATION
 // =============================================================================
 
+bongocat_error_t animation_preload(const config_t *config) {
+  BONGOCAT_CHECK_NULL(config, BONGOCAT_ERROR_INVALID_PARAM);
+
+  bongocat_error_t result = frame_cache_load_assets();
+  if (result != BONGOCAT_SUCCESS) {
+    return result;
+  }
+
+  // cat_height is global, so every monitor uses this one size
+  int cat_h = config->cat_height;
+  int cat_w = (cat_h * CAT_IMAGE_WIDTH) / CAT_IMAGE_HEIGHT;
+  frame_cache_prepare(cat_w, cat_h, config->mirror_x, config->mirror_y);
+
+  bongocat_log_info("Preloaded SVG assets and %dx%d frame cache", cat_w,
+                    cat_h);
+  return BONGOCAT_SUCCESS;
+}
+
 bongocat_error_t animation_init(config_t *config) {
   BONGOCAT_CHECK_NULL(config, BONGOCAT_ERROR_INVALID_PARAM);
 
-  current_config = config;
   bongocat_log_info("Initializing animation system");
 
-  // Parse embedded SVG assets
-  init_embedded_svgs();
-
-  bongocat_error_t result = anim_parse_embedded_svgs();
-  if (result != BONGOCAT_SUCCESS) {
-    return result;
+  // Parse embedded SVG assets, unless a multi-monitor parent already did
+  // before forking this instance
+  if (frame_cache_assets_loaded()) {
+    bongocat_log_debug("Using SVG assets preloaded by the parent process");
+  } else {
+    bongocat_error_t result = frame_cache_load_assets();
+    if (result != BONGOCAT_SUCCESS) {
+      return result;
+    }
   }
 
   animation_initialized = true;
@@ -536,12 +613,26 @@ bongocat_error_t animation_start(void) {
 
   bongocat_log_info("Starting animation thread");
 
+  anim_init_state(&anim_state);
+  anim_last_drawn_frame = -1;
+  anim_force_redraw = true;
+
+  anim_control_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (anim_control_fd < 0) {
+    bongocat_log_warning("Failed to create animation control eventfd: %s",
+                         strerror(errno));
+  }
+
   animation_running = true;
   int result = pthread_create(&anim_thread, NULL, anim_thread_main, NULL);
   if (result != 0) {
     bongocat_log_error("Failed to create animation thread: %s",
                        strerror(result));
     animation_running = false;
+    if (anim_control_fd >= 0) {
+      close(anim_control_fd);
+      anim_control_fd = -1;
+    }
     return BONGOCAT_ERROR_THREAD;
   }
 
@@ -550,10 +641,54 @@ bongocat_error_t animation_start(void) {
   return BONGOCAT_SUCCESS;
 }
 
+bongocat_error_t animation_start_single_threaded(void) {
+  if (animation_thread_started || animation_single_threaded) {
+    bongocat_log_warning("Animation already running");
+    return BONGOCAT_SUCCESS;
+  }
+
+  bongocat_log_info("Running animation on the main event loop");
+
+  anim_init_state(&anim_state);
+  anim_last_drawn_frame = -1;
+  anim_force_redraw = true;
+
+  anim_control_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  anim_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (anim_control_fd < 0 || anim_timer_fd < 0) {
+    bongocat_log_error("Failed to create animation event fds: %s",
+                       strerror(errno));
+    animation_cleanup();
+    return BONGOCAT_ERROR_THREAD;
+  }
+
+  // The frame timer doubles as the polling fallback when there is no input
+  // eventfd (see anim_next_deadline)
+  int fds[] = {input_get_wake_fd(), anim_control_fd, anim_timer_fd};
+  for (size_t i = 0; i < sizeof(fds) / sizeof(fds[0]); i++) {
+    if (fds[i] < 0) {
+      continue;
+    }
+    bongocat_error_t result =
+        wayland_add_fd_source(fds[i], anim_handle_fd_ready, NULL);
+    if (result != BONGOCAT_SUCCESS) {
+      animation_cleanup();
+      return result;
+    }
+  }
+
+  animation_single_threaded = true;
+
+  // Draw the first frame and arm the first deadline
+  anim_arm_timer(anim_timer_fd, anim_run_once());
+  return BONGOCAT_SUCCESS;
+}
+
 void animation_cleanup(void) {
   if (animation_thread_started) {
     bongocat_log_debug("Stopping animation thread");
     animation_running = false;
+    anim_wake_thread();
 
     // Wait for thread to finish gracefully
     pthread_join(anim_thread, NULL);
@@ -561,18 +696,41 @@ void animation_cleanup(void) {
     bongocat_log_debug("Animation thread stopped");
   }
 
-  // Cleanup cached frames
-  animation_invalidate_cache();
+  // The fds are only registered with the event loop in single-threaded mode;
+  // removing unknown fds is a no-op
+  wayland_remove_fd_source(input_get_wake_fd());
+  wayland_remove_fd_source(anim_control_fd);
+  wayland_remove_fd_source(anim_timer_fd);
+  animation_single_threaded = false;
+  anim_suspended = false;
+
+  if (anim_timer_fd >= 0) {
+    close(anim_timer_fd);
+    anim_timer_fd = -1;
+  }
 
-  // Cleanup SVG resources
-  if (animation_initialized) {
-    anim_cleanup_svgs();
-    animation_initialized = false;
+  if (anim_control_fd >= 0) {
+    close(anim_control_fd);
+    anim_control_fd = -1;
   }
 
+  // Cleanup SVG resources (also loaded by animation_preload() alone)
+  frame_cache_cleanup();
+  animation_initialized = false;
+
   bongocat_log_debug("Animation cleanup complete");
 }
 
+void animation_notify_config_changed(void) {
+  atomic_store(&anim_config_changed, true);
+  anim_wake_thread();
+}
+
+void animation_request_redraw(void) {
+  atomic_store(&anim_redraw_requested, true);
+  anim_wake_thread();
+}
+
 void animation_trigger(void) {
   if (any_key_pressed) {
     atomic_store(any_key_pressed, 1);
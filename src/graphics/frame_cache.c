@@ -0,0 +1,334 @@
+#define NANOSVG_IMPLEMENTATION
+#define NANOSVGRAST_IMPLEMENTATION
+#include "graphics/frame_cache.h"
+
+#include "graphics/embedded_assets.h"
+#include "utils/memory.h"
+
+#if defined(__GNUC__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wshadow"
+#  pragma GCC diagnostic ignored "-Wdouble-promotion"
+#  pragma GCC diagnostic ignored "-Wmissing-prototypes"
+#  pragma GCC diagnostic ignored "-Wstrict-prototypes"
+#  pragma GCC diagnostic ignored "-Wold-style-definition"
+#endif
+#include <nanosvg.h>
+#include <nanosvgrast.h>
+#if defined(__GNUC__)
+#  pragma GCC diagnostic pop
+#endif
+#include <string.h>
+
+// =============================================================================
+// GLOBAL STATE
+// =============================================================================
+
+// SVG parsed data and rasterizer
+static NSVGimage *svgs[NUM_FRAMES];
+static size_t svg_bytes[NUM_FRAMES];  // Accounted under MEMORY_TAG_SVG
+static NSVGrasterizer *rasterizer;
+
+// The most recently rasterized frame set. Every render snapshot takes a
+// reference to it, so only a change of cat size or mirroring rasterizes
+// again. animation_preload() fills it before multi-monitor children are
+// forked; they share those pages copy-on-write.
+static frame_set_t *warm_set;
+
+// =============================================================================
+// SVG LOADING MODULE
+// =============================================================================
+
+typedef struct {
+  const unsigned char *data;
+  size_t size;
+  const char *name;
+} embedded_svg_t;
+
+static embedded_svg_t embedded_svgs[NUM_FRAMES];
+
+static void init_embedded_svgs(void) {
+  embedded_svgs[BONGOCAT_FRAME_BOTH_UP] = (embedded_svg_t){
+      bongo_both_up_svg, bongo_both_up_svg_size, "bongo-both-up.svg"};
+  embedded_svgs[BONGOCAT_FRAME_LEFT_DOWN] = (embedded_svg_t){
+      bongo_left_down_svg, bongo_left_down_svg_size, "bongo-left-down.svg"};
+  embedded_svgs[BONGOCAT_FRAME_RIGHT_DOWN] = (embedded_svg_t){
+      bongo_right_down_svg, bongo_right_down_svg_size, "bongo-right-down.svg"};
+  embedded_svgs[BONGOCAT_FRAME_BOTH_DOWN] = (embedded_svg_t){
+      bongo_both_down_svg, bongo_both_down_svg_size, "bongo-both-down.svg"};
+  embedded_svgs[BONGOCAT_FRAME_SLEEPING] = (embedded_svg_t){
+      bongo_sleeping_svg, bongo_sleeping_svg_size, "bongo-sleeping.svg"};
+}
+
+void frame_cache_drop_warm(void) {
+  // Snapshots still holding the set keep it alive
+  frame_set_release(warm_set);
+  warm_set = NULL;
+}
+
+// nanosvg allocates with plain malloc; its parsed trees are accounted by
+// walking them once
+static size_t svg_paint_bytes(const NSVGpaint *paint) {
+  if (paint->type != NSVG_PAINT_LINEAR_GRADIENT &&
+      paint->type != NSVG_PAINT_RADIAL_GRADIENT) {
+    return 0;
+  }
+  int stops = paint->gradient->nstops;
+  size_t extra_stops = stops > 1 ? (size_t)(stops - 1) : 0;
+  return sizeof(NSVGgradient) + extra_stops * sizeof(NSVGgradientStop);
+}
+
+static size_t svg_image_bytes(const NSVGimage *image) {
+  size_t bytes = sizeof(*image);
+  for (const NSVGshape *shape = image->shapes; shape; shape = shape->next) {
+    bytes += sizeof(*shape) + svg_paint_bytes(&shape->fill) +
+             svg_paint_bytes(&shape->stroke);
+    for (const NSVGpath *path = shape->paths; path; path = path->next) {
+      bytes += sizeof(*path) + (size_t)path->npts * 2U * sizeof(float);
+    }
+  }
+  return bytes;
+}
+
+static void cleanup_svgs(void) {
+  for (int i = 0; i < NUM_FRAMES; i++) {
+    if (svgs[i]) {
+      memory_untrack_external(MEMORY_TAG_SVG, svg_bytes[i]);
+      svg_bytes[i] = 0;
+      nsvgDelete(svgs[i]);
+      svgs[i] = NULL;
+    }
+  }
+  if (rasterizer) {
+    nsvgDeleteRasterizer(rasterizer);
+    rasterizer = NULL;
+  }
+}
+
+static bongocat_error_t parse_embedded_svgs(void) {
+  for (int i = 0; i < NUM_FRAMES; i++) {
+    const embedded_svg_t *svg = &embedded_svgs[i];
+
+    bongocat_log_debug("Parsing embedded SVG: %s", svg->name);
+
+    // nsvgParse modifies the string in-place, so make a mutable copy
+    char *svg_copy = bongocat_malloc_tagged(MEMORY_TAG_SVG, svg->size + 1);
+    if (!svg_copy) {
+      bongocat_log_error("Failed to allocate SVG copy for: %s", svg->name);
+      cleanup_svgs();
+      return BONGOCAT_ERROR_MEMORY;
+    }
+    memcpy(svg_copy, svg->data, svg->size);
+    svg_copy[svg->size] = '\0';
+
+    svgs[i] = nsvgParse(svg_copy, "px", 96.0f);
+    bongocat_free(svg_copy);
+
+    if (!svgs[i]) {
+      bongocat_log_error("Failed to parse embedded SVG: %s", svg->name);
+      cleanup_svgs();
+      return BONGOCAT_ERROR_FILE_IO;
+    }
+    svg_bytes[i] = svg_image_bytes(svgs[i]);
+    memory_track_external(MEMORY_TAG_SVG, svg_bytes[i]);
+
+    bongocat_log_debug("Parsed SVG %s: %.0fx%.0f", svg->name,
+                       (double)svgs[i]->width,
+                       (double)svgs[i]->height);
+  }
+
+  rasterizer = nsvgCreateRasterizer();
+  if (!rasterizer) {
+    bongocat_log_error("Failed to create SVG rasterizer");
+    cleanup_svgs();
+    return BONGOCAT_ERROR_MEMORY;
+  }
+
+  return BONGOCAT_SUCCESS;
+}
+
+bongocat_error_t frame_cache_load_assets(void) {
+  if (rasterizer) {
+    return BONGOCAT_SUCCESS;
+  }
+  init_embedded_svgs();
+  return parse_embedded_svgs();
+}
+
+bool frame_cache_assets_loaded(void) {
+  return rasterizer != NULL;
+}
+
+void frame_cache_cleanup(void) {
+  cleanup_svgs();
+  frame_cache_drop_warm();
+}
+
+// =============================================================================
+// FRAME CACHE MODULE
+// =============================================================================
+
+// True if the prepared set was rasterized for these parameters
+static bool warm_set_matches(int target_w, int target_h, int mirror_x,
+                             int mirror_y) {
+  if (!warm_set) {
+    return false;
+  }
+  const cached_frame_t *first = &warm_set->frames[0];
+  return first->data && first->width == target_w &&
+         first->height == target_h && warm_set->mirror_x == mirror_x &&
+         warm_set->mirror_y == mirror_y;
+}
+
+static void rasterize_frames(cached_frame_t frames[NUM_FRAMES], int target_w,
+                             int target_h, int mirror_x, int mirror_y) {
+  for (int i = 0; i < NUM_FRAMES; i++) {
+    if (!svgs[i]) {
+      continue;
+    }
+
+    float svg_w = svgs[i]->width;
+    float svg_h = svgs[i]->height;
+    if (svg_w <= 0 || svg_h <= 0) {
+      continue;
+    }
+
+    // Rasterize SVG at exact target dimensions
+    float scale = (float)target_w / svg_w;
+    size_t buf_size = (size_t)target_w * (size_t)target_h * 4U;
+    uint8_t *rgba_buf =
+        bongocat_calloc_tagged(MEMORY_TAG_FRAME_CACHE, 1, buf_size);
+    if (!rgba_buf) {
+      bongocat_log_error("Failed to allocate raster buffer for frame %d", i);
+      continue;
+    }
+
+    nsvgRasterize(rasterizer, svgs[i], 0, 0, scale, rgba_buf, target_w,
+                  target_h, target_w * 4);
+
+    // Apply horizontal mirror
+    if (mirror_x) {
+      for (int y = 0; y < target_h; y++) {
+        for (int left = 0, right = target_w - 1; left < right;
+             left++, right--) {
+          int li = (y * target_w + left) * 4;
+          int ri = (y * target_w + right) * 4;
+          uint8_t tmp[4];
+          memcpy(tmp, &rgba_buf[li], 4);
+          memcpy(&rgba_buf[li], &rgba_buf[ri], 4);
+          memcpy(&rgba_buf[ri], tmp, 4);
+        }
+      }
+    }
+
+    // Apply vertical mirror
+    if (mirror_y) {
+      size_t row_bytes = (size_t)target_w * 4U;
+      uint8_t *tmp_row = malloc(row_bytes);
+      if (tmp_row) {
+        for (int top = 0, bot = target_h - 1; top < bot; top++, bot--) {
+          uint8_t *t = &rgba_buf[(size_t)top * row_bytes];
+          uint8_t *b = &rgba_buf[(size_t)bot * row_bytes];
+          memcpy(tmp_row, t, row_bytes);
+          memcpy(t, b, row_bytes);
+          memcpy(b, tmp_row, row_bytes);
+        }
+        free(tmp_row);
+      }
+    }
+
+    // Convert RGBA -> premultiplied BGRA for Wayland (ARGB8888 is
+    // premultiplied)
+    for (size_t px = 0; px < buf_size; px += 4) {
+      uint8_t r = rgba_buf[px + 0];
+      uint8_t g = rgba_buf[px + 1];
+      uint8_t b = rgba_buf[px + 2];
+      uint8_t a = rgba_buf[px + 3];
+      rgba_buf[px + 0] = (uint8_t)((b * a) / 255);
+      rgba_buf[px + 1] = (uint8_t)((g * a) / 255);
+      rgba_buf[px + 2] = (uint8_t)((r * a) / 255);
+      rgba_buf[px + 3] = a;
+    }
+
+    frames[i].data = rgba_buf;
+    frames[i].width = target_w;
+    frames[i].height = target_h;
+  }
+
+  bongocat_log_debug("Rasterized %d animation frames at %dx%d", NUM_FRAMES,
+                     target_w, target_h);
+}
+
+void frame_cache_prepare(int target_w, int target_h, int mirror_x,
+                         int mirror_y) {
+  frame_cache_drop_warm();
+  if (!rasterizer || target_w <= 0 || target_h <= 0) {
+    return;
+  }
+  warm_set = frame_set_create();
+  if (!warm_set) {
+    return;
+  }
+  rasterize_frames(warm_set->frames, target_w, target_h, mirror_x, mirror_y);
+  warm_set->mirror_x = mirror_x;
+  warm_set->mirror_y = mirror_y;
+}
+
+frame_set_t *frame_cache_acquire(int target_w, int target_h, int mirror_x,
+                                 int mirror_y) {
+  if (!warm_set_matches(target_w, target_h, mirror_x, mirror_y)) {
+    frame_cache_prepare(target_w, target_h, mirror_x, mirror_y);
+  }
+  return frame_set_retain(warm_set);
+}
+
+// =============================================================================
+// RENDERING UTILITIES
+// =============================================================================
+
+void fill_bar_background(uint8_t *pixels, int width, int height,
+                         int opacity) {
+  // Write all pixels as 32-bit values: RGB=0, A=opacity
+  size_t buffer_size = (size_t)width * (size_t)height * 4U;
+  if (opacity > 0) {
+    uint32_t fill = (uint32_t)opacity << 24;
+    uint32_t *px = (uint32_t *)pixels;
+    size_t pixel_count = buffer_size / 4;
+    for (size_t i = 0; i < pixel_count; i++) {
+      px[i] = fill;
+    }
+  } else {
+    memset(pixels, 0, buffer_size);
+  }
+}
+
+void blit_cached_frame(uint8_t *dest, int dest_w, int dest_h,
+                       const uint8_t *src, int src_w, int src_h, int offset_x,
+                       int offset_y) {
+  for (int y = 0; y < src_h; y++) {
+    int dy = y + offset_y;
+    if (dy < 0 || dy >= dest_h)
+      continue;
+    for (int x = 0; x < src_w; x++) {
+      int dx = x + offset_x;
+      if (dx < 0 || dx >= dest_w)
+        continue;
+      int si = (y * src_w + x) * 4;
+      int di = (dy * dest_w + dx) * 4;
+      uint8_t sa = src[si + 3];
+      if (sa == 0)
+        continue;
+      if (sa == 255) {
+        memcpy(&dest[di], &src[si], 4);
+      } else {
+        // Premultiplied alpha "over" compositing
+        uint8_t inv_a = 255 - sa;
+        dest[di + 0] = src[si + 0] + (uint8_t)((dest[di + 0] * inv_a) / 255);
+        dest[di + 1] = src[si + 1] + (uint8_t)((dest[di + 1] * inv_a) / 255);
+        dest[di + 2] = src[si + 2] + (uint8_t)((dest[di + 2] * inv_a) / 255);
+        dest[di + 3] = sa + (uint8_t)((dest[di + 3] * inv_a) / 255);
+      }
+    }
+  }
+}
+
@@ -0,0 +1,187 @@
+#include "graphics/offscreen.h"
+
+#include "utils/memory.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+// =============================================================================
+// SURFACES
+// =============================================================================
+
+bongocat_error_t offscreen_surface_init(offscreen_surface_t *surface,
+                                        int width, int height) {
+  BONGOCAT_CHECK_NULL(surface, BONGOCAT_ERROR_INVALID_PARAM);
+  if (width <= 0 || height <= 0) {
+    return BONGOCAT_ERROR_INVALID_PARAM;
+  }
+
+  surface->pixels = bongocat_calloc((size_t)width * (size_t)height, 4);
+  if (!surface->pixels) {
+    bongocat_log_error("Failed to allocate %dx%d offscreen surface", width,
+                       height);
+    return BONGOCAT_ERROR_MEMORY;
+  }
+  surface->width = width;
+  surface->height = height;
+  atomic_init(&surface->configured, true);
+  atomic_init(&surface->fullscreen, false);
+  return BONGOCAT_SUCCESS;
+}
+
+void offscreen_surface_destroy(offscreen_surface_t *surface) {
+  if (!surface) {
+    return;
+  }
+  bongocat_free(surface->pixels);
+  surface->pixels = NULL;
+}
+
+bool offscreen_add_target(render_snapshot_t *snap,
+                          offscreen_surface_t *surface) {
+  if (!snap || !surface || !surface->pixels) {
+    return false;
+  }
+  if (surface->height != snap->config.overlay_height) {
+    bongocat_log_error("Offscreen surface is %d high, overlay_height is %d",
+                       surface->height, snap->config.overlay_height);
+    return false;
+  }
+
+  render_target_t target = {
+      .pixels = surface->pixels,
+      .width = surface->width,
+      .configured = &surface->configured,
+      .fullscreen = &surface->fullscreen,
+  };
+  return render_snapshot_add_target(snap, &target);
+}
+
+// =============================================================================
+// BACKEND
+// =============================================================================
+
+static bool offscreen_begin_target([[maybe_unused]] void *ctx,
+                                   const render_snapshot_t *snap,
+                                   const render_target_t *target,
+                                   [[maybe_unused]] bool *committed) {
+  return !render_target_is_hidden(snap, target) &&
+         !render_target_is_powered_off(target);
+}
+
+static void offscreen_present_target(void *ctx, const render_snapshot_t *snap,
+                                     size_t index,
+                                     [[maybe_unused]] bool first) {
+  offscreen_t *offscreen = ctx;
+  offscreen->presented++;
+  if (!offscreen->dump_dir) {
+    return;
+  }
+
+  const render_target_t *target = &snap->targets[index];
+  bool pam = offscreen->dump_format == OFFSCREEN_IMAGE_PAM;
+  char path[4096];
+  snprintf(path, sizeof(path), "%s/frame-%06llu-%zu.%s", offscreen->dump_dir,
+           (unsigned long long)offscreen->frames, index, pam ? "pam" : "ppm");
+  if (offscreen_write_image(path, target->pixels, target->width,
+                            target->height,
+                            offscreen->dump_format) != BONGOCAT_SUCCESS) {
+    // Stop dumping instead of failing every following frame the same way
+    offscreen->dump_dir = NULL;
+  }
+}
+
+static void offscreen_end_frame(void *ctx, size_t presented,
+                                [[maybe_unused]] bool committed) {
+  offscreen_t *offscreen = ctx;
+  if (presented > 0) {
+    offscreen->frames++;
+  }
+}
+
+render_backend_t offscreen_backend(offscreen_t *offscreen) {
+  return (render_backend_t){
+      .name = "offscreen",
+      .ctx = offscreen,
+      .begin_target = offscreen_begin_target,
+      .present_target = offscreen_present_target,
+      .end_frame = offscreen_end_frame,
+  };
+}
+
+// =============================================================================
+// IMAGE OUTPUT
+// =============================================================================
+
+// Premultiplied channel back to straight alpha, rounded
+static uint8_t unpremultiply(uint8_t c, uint8_t a) {
+  if (a == 0) {
+    return 0;
+  }
+  unsigned v = ((unsigned)c * 255U + a / 2U) / a;
+  return (uint8_t)(v > 255U ? 255U : v);
+}
+
+bongocat_error_t offscreen_write_image(const char *path,
+                                       const uint8_t *pixels, int width,
+                                       int height,
+                                       offscreen_image_format_t format) {
+  BONGOCAT_CHECK_NULL(path, BONGOCAT_ERROR_INVALID_PARAM);
+  BONGOCAT_CHECK_NULL(pixels, BONGOCAT_ERROR_INVALID_PARAM);
+  if (width <= 0 || height <= 0) {
+    return BONGOCAT_ERROR_INVALID_PARAM;
+  }
+
+  bool pam = format == OFFSCREEN_IMAGE_PAM;
+  size_t channels = pam ? 4 : 3;
+  uint8_t *row = bongocat_malloc((size_t)width * channels);
+  if (!row) {
+    return BONGOCAT_ERROR_MEMORY;
+  }
+
+  FILE *f = fopen(path, "wb");
+  if (!f) {
+    bongocat_log_error("Cannot write %s: %s", path, strerror(errno));
+    bongocat_free(row);
+    return BONGOCAT_ERROR_FILE_IO;
+  }
+
+  if (pam) {
+    fprintf(f,
+            "P7\nWIDTH %d\nHEIGHT %d\nDEPTH 4\nMAXVAL 255\n"
+            "TUPLTYPE RGB_ALPHA\nENDHDR\n",
+            width, height);
+  } else {
+    fprintf(f, "P6\n%d %d\n255\n", width, height);
+  }
+
+  bool ok = true;
+  for (int y = 0; y < height && ok; y++) {
+    const uint8_t *src = pixels + (size_t)y * (size_t)width * 4U;
+    uint8_t *out = row;
+    for (int x = 0; x < width; x++, src += 4) {
+      // ARGB8888 little-endian: B, G, R, A in memory
+      uint8_t a = src[3];
+      if (pam) {
+        *out++ = unpremultiply(src[2], a);
+        *out++ = unpremultiply(src[1], a);
+        *out++ = unpremultiply(src[0], a);
+        *out++ = a;
+      } else {
+        *out++ = src[2];
+        *out++ = src[1];
+        *out++ = src[0];
+      }
+    }
+    ok = fwrite(row, channels, (size_t)width, f) == (size_t)width;
+  }
+
+  ok = fclose(f) == 0 && ok;
+  bongocat_free(row);
+  if (!ok) {
+    bongocat_log_error("Failed writing %s", path);
+    return BONGOCAT_ERROR_FILE_IO;
+  }
+  return BONGOCAT_SUCCESS;
+}
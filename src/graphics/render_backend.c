@@ -0,0 +1,43 @@
+#include "graphics/render_backend.h"
+
+#include "graphics/frame_cache.h"
+
+bool render_compose_target(const render_snapshot_t *snap,
+                           const render_target_t *target, int frame_index) {
+  fill_bar_background(target->pixels, target->width, target->height,
+                      snap->config.overlay_opacity);
+
+  const cached_frame_t *frame = render_snapshot_frame(snap, frame_index);
+  if (!frame) {
+    return false;
+  }
+  if (!frame->data || frame->width <= 0 || frame->height <= 0) {
+    bongocat_log_debug("Frame %d cache not ready, skipping draw",
+                       frame_index);
+    return false;
+  }
+
+  // Blit pre-scaled cached frame (already BGRA, no channel swap)
+  blit_cached_frame(target->pixels, target->width, target->height,
+                    frame->data, frame->width, frame->height, target->cat_x,
+                    target->cat_y);
+  return true;
+}
+
+size_t render_frame(const render_backend_t *backend,
+                    const render_snapshot_t *snap, int frame_index) {
+  size_t presented = 0;
+  bool committed = false;
+  for (size_t i = 0; i < snap->num_targets; i++) {
+    const render_target_t *target = &snap->targets[i];
+    if (!target->pixels ||
+        !backend->begin_target(backend->ctx, snap, target, &committed)) {
+      continue;
+    }
+    render_compose_target(snap, target, frame_index);
+    backend->present_target(backend->ctx, snap, i, presented == 0);
+    presented++;
+  }
+  backend->end_frame(backend->ctx, presented, committed);
+  return presented;
+}
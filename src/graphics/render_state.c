@@ -0,0 +1,218 @@
+#define _POSIX_C_SOURCE 200809L
+#include "graphics/render_state.h"
+
+#include "utils/memory.h"
+
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// =============================================================================
+// PUBLISHED STATE
+// =============================================================================
+
+static _Atomic(render_snapshot_t *) published_snapshot = NULL;
+
+// Readers between loading published_snapshot and taking their reference.
+// The writer waits for this to drain before dropping the old snapshot, which
+// closes the load/increment race without any reader-side lock.
+static atomic_uint acquiring_readers = 0;
+
+static atomic_size_t live_snapshots = 0;
+
+// =============================================================================
+// SNAPSHOT LIFETIME
+// =============================================================================
+
+render_snapshot_t *render_snapshot_create(const config_t *config) {
+  if (!config) {
+    return NULL;
+  }
+
+  render_snapshot_t *snap = calloc(1, sizeof(*snap));
+  if (!snap) {
+    bongocat_log_error("Failed to allocate render snapshot");
+    return NULL;
+  }
+
+  atomic_init(&snap->refs, 1);
+
+  snap->config = *config;
+  snap->config.output_name = NULL;
+  snap->config.output_names = NULL;
+  snap->config.num_output_names = 0;
+  memset(snap->config.asset_paths, 0, sizeof(snap->config.asset_paths));
+  snap->config.keyboard_devices = NULL;
+  snap->config.num_keyboard_devices = 0;
+  snap->config.keyboard_names = NULL;
+  snap->config.num_names = 0;
+  snap->config.arena = (memory_arena_t){0};
+
+  atomic_fetch_add(&live_snapshots, 1);
+  return snap;
+}
+
+bool render_snapshot_add_target(render_snapshot_t *snap,
+                                const render_target_t *target) {
+  if (!snap || !target || snap->num_targets >= RENDER_MAX_TARGETS) {
+    return false;
+  }
+
+  const config_t *config = &snap->config;
+  render_target_t *t = &snap->targets[snap->num_targets++];
+  *t = *target;
+  t->height = config->overlay_height;
+
+  int cat_height = config->cat_height;
+  int cat_width = (cat_height * CAT_IMAGE_WIDTH) / CAT_IMAGE_HEIGHT;
+  t->cat_y = (t->height - cat_height) / 2 + config->cat_y_offset;
+  switch (config->cat_align) {
+  case ALIGN_CENTER:
+    t->cat_x = (t->width - cat_width) / 2 + config->cat_x_offset;
+    break;
+  case ALIGN_LEFT:
+    t->cat_x = config->cat_x_offset;
+    break;
+  case ALIGN_RIGHT:
+    t->cat_x = t->width - cat_width - config->cat_x_offset;
+    break;
+  }
+  return true;
+}
+
+void render_snapshot_release(render_snapshot_t *snap) {
+  if (!snap) {
+    return;
+  }
+
+  if (atomic_fetch_sub_explicit(&snap->refs, 1, memory_order_acq_rel) != 1) {
+    return;
+  }
+
+  frame_set_release(snap->frame_set);
+  free(snap);
+  atomic_fetch_sub(&live_snapshots, 1);
+}
+
+const cached_frame_t *render_snapshot_frame(const render_snapshot_t *snap,
+                                            int index) {
+  if (!snap || !snap->frame_set || index < 0 || index >= NUM_FRAMES) {
+    return NULL;
+  }
+  return &snap->frame_set->frames[index];
+}
+
+// =============================================================================
+// FRAME SETS
+// =============================================================================
+
+frame_set_t *frame_set_create(void) {
+  frame_set_t *set = calloc(1, sizeof(*set));
+  if (!set) {
+    bongocat_log_error("Failed to allocate frame set");
+    return NULL;
+  }
+  atomic_init(&set->refs, 1);
+  return set;
+}
+
+frame_set_t *frame_set_retain(frame_set_t *set) {
+  if (set) {
+    atomic_fetch_add_explicit(&set->refs, 1, memory_order_relaxed);
+  }
+  return set;
+}
+
+void frame_set_release(frame_set_t *set) {
+  if (!set ||
+      atomic_fetch_sub_explicit(&set->refs, 1, memory_order_acq_rel) != 1) {
+    return;
+  }
+  for (int i = 0; i < NUM_FRAMES; i++) {
+    bongocat_free(set->frames[i].data);
+  }
+  free(set);
+}
+
+// =============================================================================
+// VISIBILITY
+// =============================================================================
+
+bool render_target_is_hidden(const render_snapshot_t *snap,
+                             const render_target_t *target) {
+  if (!snap || !target || !target->fullscreen) {
+    return false;
+  }
+  // The overlay layer stays above fullscreen windows, so it always shows
+  const config_t *config = &snap->config;
+  return config->layer != LAYER_OVERLAY && !config->disable_fullscreen_hide &&
+         atomic_load(target->fullscreen);
+}
+
+bool render_target_is_powered_off(const render_target_t *target) {
+  return target && target->powered_off && atomic_load(target->powered_off);
+}
+
+bool render_snapshot_nothing_visible(const render_snapshot_t *snap) {
+  if (!snap || snap->num_targets == 0) {
+    return false;
+  }
+  for (size_t i = 0; i < snap->num_targets; i++) {
+    const render_target_t *target = &snap->targets[i];
+    if (!render_target_is_hidden(snap, target) &&
+        !render_target_is_powered_off(target)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// =============================================================================
+// PUBLICATION
+// =============================================================================
+
+render_snapshot_t *render_state_acquire(void) {
+  atomic_fetch_add(&acquiring_readers, 1);
+  render_snapshot_t *snap = atomic_load(&published_snapshot);
+  if (snap) {
+    atomic_fetch_add_explicit(&snap->refs, 1, memory_order_relaxed);
+  }
+  atomic_fetch_sub(&acquiring_readers, 1);
+  return snap;
+}
+
+// Swap in a new snapshot and return the old one with the published
+// reference transferred to the caller
+static render_snapshot_t *render_state_exchange(render_snapshot_t *snap) {
+  render_snapshot_t *old = atomic_exchange(&published_snapshot, snap);
+
+  // A reader may have loaded old but not yet taken its reference; the
+  // window is a couple of instructions long
+  while (atomic_load(&acquiring_readers) != 0) {
+    sched_yield();
+  }
+  return old;
+}
+
+void render_state_publish(render_snapshot_t *snap) {
+  render_snapshot_release(render_state_exchange(snap));
+}
+
+void render_state_retire(void) {
+  render_snapshot_t *old = render_state_exchange(NULL);
+  if (!old) {
+    return;
+  }
+
+  // Wait out draws that started before the swap
+  while (atomic_load_explicit(&old->refs, memory_order_acquire) > 1) {
+    struct timespec delay = {0, 50000L};  // 50us
+    nanosleep(&delay, NULL);
+  }
+  render_snapshot_release(old);
+}
+
+size_t render_state_live_snapshots(void) {
+  return atomic_load(&live_snapshots);
+}
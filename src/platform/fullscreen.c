@@ -12,11 +12,17 @@
 #endif
 
 #include "core/bongocat.h"
+#include "graphics/animation.h"
 #include "platform/hyprland.h"
+#include "platform/niri.h"
+#include "platform/output_bars.h"
+#include "platform/sway.h"
+#include "platform/toplevel_tracker.h"
 #include "platform/wayland.h"
 #include "utils/error.h"
 
 #include <stdatomic.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -29,24 +35,10 @@ typedef struct {
   bool has_fullscreen_toplevel;
 } fullscreen_detector_t;
 
-typedef struct {
-  struct zwlr_foreign_toplevel_handle_v1 *handle;
-  struct wl_output *output;
-  bool is_fullscreen;
-  bool is_activated;
-} tracked_toplevel_t;
-
-// Foreign toplevel protocol event handlers
-// Each toplevel tracks its fullscreen and activated state
-typedef struct {
-  bool is_fullscreen;
-  bool is_activated;  // Track if this toplevel is the currently focused one
-} toplevel_data_t;
-
 static fullscreen_detector_t fs_detector = {0};
 
-static tracked_toplevel_t track_toplevels[MAX_TOPLEVELS] = {0};
-static size_t track_toplevels_count = 0;
+// Every foreign toplevel, committed on its done event
+static toplevel_tracker_t fs_toplevels = {0};
 
 // Track the currently active toplevel's fullscreen state
 static bool active_toplevel_fullscreen = false;
@@ -57,6 +49,36 @@ static bool active_toplevel_fullscreen = false;
 // regardless of output_count.
 static bool compositor_sends_output_events = false;
 
+// Per-output fullscreen state pushed by a compositor IPC backend (sway,
+// niri). Once any output has been reported, these are authoritative and the
+// foreign-toplevel heuristics stop driving fs_update_state().
+typedef struct {
+  char name[128];
+  bool fullscreen;
+} ipc_output_state_t;
+
+static ipc_output_state_t ipc_outputs[MAX_OUTPUTS];
+static size_t ipc_output_count = 0;
+
+// Compositor IPC backends, tried in order; the first whose environment
+// variable is set and that connects is used.
+typedef struct {
+  const char *name;
+  const char *env;
+  void (*start)(void);
+  void (*stop)(void);
+  bool (*active)(void);
+} fs_ipc_backend_t;
+
+static const fs_ipc_backend_t fs_ipc_backends[] = {
+    {"Hyprland", "HYPRLAND_INSTANCE_SIGNATURE", hypr_events_start,
+     hypr_events_stop, hypr_events_active},
+    {"sway", "SWAYSOCK", sway_events_start, sway_events_stop,
+     sway_events_active},
+    {"niri", "NIRI_SOCKET", niri_events_start, niri_events_stop,
+     niri_events_active},
+};
+
 // =============================================================================
 // FULLSCREEN DETECTION IMPLEMENTATION
 // =============================================================================
@@ -69,110 +91,90 @@ static void fs_update_state(bool new_state) {
     bongocat_log_info("Fullscreen state changed: %s",
                       new_state ? "detected" : "cleared");
 
-    if (atomic_load(&configured)) {
-      draw_bar();
-    }
+    // Unconditional: a hidden surface is unmapped, and only a redraw maps
+    // it again
+    animation_request_redraw();
   }
 }
 
-static bool update_fullscreen_state_toplevel(tracked_toplevel_t *tracked,
-                                             bool is_fullscreen,
-                                             bool is_activated) {
-  bool state_changed = tracked->is_fullscreen != is_fullscreen ||
-                       tracked->is_activated != is_activated;
-  tracked->is_fullscreen = is_fullscreen;
-  tracked->is_activated = is_activated;
-
-  /// @NOTE: tracked.output can always be NULL when no output.enter/output.leave
-  /// event were triggered
-  // Only trigger overlay update if this fullscreen window is on our output
-  if (tracked->output == output && state_changed) {
-    fs_update_state(is_fullscreen);
-    return true;
+// Foreign-toplevel updates yield to an IPC backend's per-output state
+static void fs_toplevel_update_state(bool new_state) {
+  if (ipc_output_count > 0) {
+    return;
   }
-
-  return false;
+  fs_update_state(new_state);
 }
 
-static bool hypr_fs_update_state(toplevel_data_t *toplevel_data) {
-  window_info_t win;
-  if (hypr_get_active_window(&win)) {
-    bool found_output = false;
-    struct wl_output *found_wl_output = NULL;
-    for (size_t i = 0; i < output_count; i++) {
-      if (outputs[i].hypr_id == win.monitor_id) {
-        if (output == outputs[i].wl_output) {
-          found_wl_output = output;
-          found_output = true;
-          break;
-        }
-      }
+static ipc_output_state_t *ipc_output_find(const char *name) {
+  for (size_t i = 0; i < ipc_output_count; i++) {
+    if (strcmp(ipc_outputs[i].name, name) == 0) {
+      return &ipc_outputs[i];
     }
+  }
+  return NULL;
+}
 
-    if (found_output) {
-      toplevel_data->is_activated = true;
-      toplevel_data->is_fullscreen = win.fullscreen;
-
-      active_toplevel_fullscreen = win.fullscreen;
-      struct wl_output *current_wl_output = wayland_get_current_screen_output();
-      if (current_wl_output && current_wl_output == found_wl_output) {
-        fs_update_state(win.fullscreen);
-      }
+static const char *output_name_of(struct wl_output *wl_output) {
+  for (size_t i = 0; i < output_count; i++) {
+    if (outputs[i].wl_output == wl_output && outputs[i].name_received) {
+      return outputs[i].name_str;
     }
-
-    return found_output;
   }
-
-  return false;
+  return NULL;
 }
 
-static void
-fs_handle_toplevel_state(void *data,
-                         struct zwlr_foreign_toplevel_handle_v1 *handle,
-                         struct wl_array *state) {
-  toplevel_data_t *toplevel_data = (toplevel_data_t *)data;
-  if (!toplevel_data)
-    return;
-
-  bool is_fullscreen = false;
-  bool is_activated = false;
-  uint32_t *state_ptr;
+static bool hypr_fs_update_state(void) {
+  window_info_t win;
+  if (!hypr_get_active_window(&win)) {
+    return false;
+  }
 
-  wl_array_for_each(state_ptr, state) {
-    if (*state_ptr == ZWLR_FOREIGN_TOPLEVEL_HANDLE_V1_STATE_FULLSCREEN) {
-      is_fullscreen = true;
-    }
-    if (*state_ptr == ZWLR_FOREIGN_TOPLEVEL_HANDLE_V1_STATE_ACTIVATED) {
-      is_activated = true;
+  struct wl_output *found_wl_output = NULL;
+  for (size_t i = 0; i < output_count; i++) {
+    if (outputs[i].hypr_id == win.monitor_id &&
+        outputs[i].wl_output == output) {
+      found_wl_output = output;
+      break;
     }
   }
+  if (!found_wl_output) {
+    return false;
+  }
+
+  active_toplevel_fullscreen = win.fullscreen;
+  if (wayland_get_current_screen_output() == found_wl_output) {
+    fs_update_state(win.fullscreen);
+  }
+  return true;
+}
 
-  /// @NOTE: tracked.output can be NULL when no output.enter/output.leave
-  /// event were triggered
+// A committed change of a toplevel's fullscreen or activated state
+static void fs_apply_state_change(const toplevel_entry_t *entry,
+                                  const toplevel_change_t *change) {
+  // Only trigger overlay update if this toplevel is on our output
   bool output_found = false;
-  bool handle_tracked = false;
-  bool handle_has_output = false;
-  for (size_t i = 0; i < track_toplevels_count; i++) {
-    if (track_toplevels[i].handle == handle) {
-      handle_tracked = true;
-      if (track_toplevels[i].output != NULL) {
-        handle_has_output = true;
-      }
-      output_found |= update_fullscreen_state_toplevel(
-          &track_toplevels[i], is_fullscreen, is_activated);
-    }
+  if (entry->output && entry->output == output) {
+    fs_toplevel_update_state(entry->fullscreen);
+    output_found = true;
+  }
+
+  // A compositor IPC backend reports fullscreen per output already
+  if (ipc_output_count > 0) {
+    return;
   }
 
   // This toplevel is known to belong to a different output. Do not use
   // compositor-global fallbacks, otherwise fullscreen on monitor A can hide
   // overlay on monitor B.
-  if (handle_tracked && handle_has_output && !output_found) {
+  if (entry->output && !output_found) {
     return;
   }
 
-  // fallback: hyprland; when toplevel detection is not working
+  // fallback: hyprland; when toplevel detection is not working. With the
+  // event stream connected, fullscreen_handle_hypr_event() keeps the state
+  // current, so there is nothing to query here.
   if (!output_found) {
-    output_found |= hypr_fs_update_state(toplevel_data);
+    output_found = hypr_events_active() || hypr_fs_update_state();
   }
 
   // fallback: global fullscreen
@@ -183,69 +185,74 @@ fs_handle_toplevel_state(void *data,
   // any monitor will hide the overlay on all monitors — acceptable trade-off
   // vs never hiding at all.
   if (!output_found && (output_count <= 1 || !compositor_sends_output_events)) {
-    bool was_activated = toplevel_data->is_activated;
-    bool was_fullscreen = toplevel_data->is_fullscreen;
-
-    toplevel_data->is_fullscreen = is_fullscreen;
-    toplevel_data->is_activated = is_activated;
-
     // Case 1: Window becomes active - update state based on its fullscreen
     // status
-    if (is_activated) {
-      active_toplevel_fullscreen = is_fullscreen;
-      fs_update_state(is_fullscreen);
+    if (entry->activated) {
+      active_toplevel_fullscreen = entry->fullscreen;
+      fs_toplevel_update_state(entry->fullscreen);
     }
     // Case 2: Previously active fullscreen window loses activation
     // (e.g., switching to empty workspace) - show bongocat
-    else if (was_activated && was_fullscreen && !is_activated) {
+    else if (change->was_activated && change->was_fullscreen) {
       active_toplevel_fullscreen = false;
-      fs_update_state(false);
+      fs_toplevel_update_state(false);
     }
   }
 }
 
+// A committed move of a toplevel between outputs
+static void fs_apply_output_change(const toplevel_entry_t *entry,
+                                   const toplevel_change_t *change) {
+  if (change->old_output == output && change->was_fullscreen) {
+    fs_toplevel_update_state(false);
+  }
+  if (entry->output == output && entry->fullscreen) {
+    fs_toplevel_update_state(true);
+  }
+}
+
 static void
-fs_handle_toplevel_closed(void *data,
-                          struct zwlr_foreign_toplevel_handle_v1 *handle) {
-  toplevel_data_t *toplevel_data = (toplevel_data_t *)data;
-  if (!toplevel_data)
-    return;
+fs_handle_toplevel_state(void *data,
+                         struct zwlr_foreign_toplevel_handle_v1 *handle,
+                         struct wl_array *state) {
+  (void)handle;
+  bool is_fullscreen = false;
+  bool is_activated = false;
+  uint32_t *state_ptr;
 
-  bool closed_on_current_output = false;
-  bool closed_was_fullscreen = false;
-  for (size_t i = 0; i < track_toplevels_count; ++i) {
-    if (track_toplevels[i].handle == handle) {
-      closed_on_current_output = (track_toplevels[i].output == output);
-      closed_was_fullscreen = track_toplevels[i].is_fullscreen;
-      break;
+  wl_array_for_each(state_ptr, state) {
+    if (*state_ptr == ZWLR_FOREIGN_TOPLEVEL_HANDLE_V1_STATE_FULLSCREEN) {
+      is_fullscreen = true;
     }
-  }
-
-  if (toplevel_data) {
-    // Only clear fullscreen state when a fullscreen toplevel on this output
-    // is closed.
-    if (closed_on_current_output && closed_was_fullscreen &&
-        toplevel_data->is_activated && toplevel_data->is_fullscreen) {
-      active_toplevel_fullscreen = false;
-      fs_update_state(false);
+    if (*state_ptr == ZWLR_FOREIGN_TOPLEVEL_HANDLE_V1_STATE_ACTIVATED) {
+      is_activated = true;
     }
-    free(toplevel_data);
   }
+
+  // Applied on the done event that ends this batch
+  toplevel_entry_set_state(data, is_fullscreen, is_activated);
+}
+
+static void
+fs_handle_toplevel_closed(void *data,
+                          struct zwlr_foreign_toplevel_handle_v1 *handle) {
+  toplevel_entry_t *entry = data;
+
+  // Only clear fullscreen state when the focused fullscreen toplevel on
+  // this output is closed.
+  bool clears_fullscreen = entry && entry->output == output &&
+                           entry->fullscreen && entry->activated;
+  bool was_fullscreen = entry && entry->fullscreen;
+
+  toplevel_tracker_remove(&fs_toplevels, entry);
   zwlr_foreign_toplevel_handle_v1_destroy(handle);
 
-  // remove from track_toplevels if present
-  for (size_t i = 0; i < track_toplevels_count; ++i) {
-    if (track_toplevels[i].handle == handle) {
-      track_toplevels[i].handle = NULL;
-      track_toplevels[i].output = NULL;
-      track_toplevels[i].is_fullscreen = false;
-      // compact array to keep contiguous
-      for (size_t j = i; j + 1 < track_toplevels_count; ++j) {
-        track_toplevels[j] = track_toplevels[j + 1];
-      }
-      track_toplevels_count--;
-      break;
-    }
+  if (clears_fullscreen) {
+    active_toplevel_fullscreen = false;
+    fs_toplevel_update_state(false);
+  }
+  if (was_fullscreen) {
+    output_bars_refresh_fullscreen();
   }
 }
 
@@ -270,45 +277,40 @@ static void
 fs_handle_output_enter(void *data,
                        struct zwlr_foreign_toplevel_handle_v1 *handle,
                        struct wl_output *toplevel_output) {
-  (void)data;
-
+  (void)handle;
   compositor_sends_output_events = true;
-
-  for (size_t i = 0; i < track_toplevels_count; i++) {
-    if (track_toplevels[i].handle == handle) {
-      track_toplevels[i].output = toplevel_output;
-      if (track_toplevels[i].is_fullscreen) {
-        if (toplevel_output == output) {
-          fs_update_state(true);
-        }
-      }
-      break;
-    }
-  }
+  toplevel_entry_output_enter(data, toplevel_output);
 }
 
 static void
 fs_handle_output_leave(void *data,
                        struct zwlr_foreign_toplevel_handle_v1 *handle,
                        struct wl_output *toplevel_output) {
-  (void)data;
-
-  for (size_t i = 0; i < track_toplevels_count; i++) {
-    if (track_toplevels[i].handle == handle &&
-        track_toplevels[i].output == toplevel_output) {
-      if (track_toplevels[i].is_fullscreen && toplevel_output == output) {
-        fs_update_state(false);
-      }
-      track_toplevels[i].output = NULL;
-      break;
-    }
-  }
+  (void)handle;
+  toplevel_entry_output_leave(data, toplevel_output);
 }
 
+// Every batch of toplevel events ends with done: evaluate it once
 static void fs_handle_done(void *data,
                            struct zwlr_foreign_toplevel_handle_v1 *handle) {
-  (void)data;
   (void)handle;
+  toplevel_entry_t *entry = data;
+  toplevel_change_t change;
+  if (!toplevel_tracker_commit(&fs_toplevels, entry, &change)) {
+    return;
+  }
+
+  if (change.output_changed) {
+    fs_apply_output_change(entry, &change);
+  }
+  if (change.state_changed) {
+    fs_apply_state_change(entry, &change);
+  }
+
+  // Extra bars of shared multi-monitor mode follow their own output
+  if (change.output_changed || change.was_fullscreen != entry->fullscreen) {
+    output_bars_refresh_fullscreen();
+  }
 }
 
 static void fs_handle_parent(void *data,
@@ -338,43 +340,19 @@ fs_handle_manager_toplevel(void *data,
   (void)data;
   (void)manager;
 
-  // Allocate per-toplevel data to track its fullscreen state
-  toplevel_data_t *toplevel_data = malloc(sizeof(toplevel_data_t));
-  if (!toplevel_data) {
+  // The entry is the listener's user data, so events need no lookup
+  toplevel_entry_t *entry = toplevel_tracker_add(&fs_toplevels, toplevel);
+  if (!entry) {
     bongocat_log_error("Failed to allocate toplevel data");
+    zwlr_foreign_toplevel_handle_v1_destroy(toplevel);
     return;
   }
 
-  // Check tracker capacity before registering listener
-  if (track_toplevels_count >= MAX_TOPLEVELS) {
-    bongocat_log_error("toplevel tracker is full, %zu max: %d",
-                       track_toplevels_count, MAX_TOPLEVELS);
-    free(toplevel_data);
-    return;
-  }
-
-  // Initialize: toplevel starts as not fullscreen and not activated
-  toplevel_data->is_fullscreen = false;
-  toplevel_data->is_activated = false;
-
   zwlr_foreign_toplevel_handle_v1_add_listener(toplevel, &fs_toplevel_listener,
-                                               toplevel_data);
-
-  bool already_tracked = false;
-  for (size_t i = 0; i < track_toplevels_count; i++) {
-    if (track_toplevels[i].handle == toplevel) {
-      already_tracked = true;
-      break;
-    }
-  }
-  if (!already_tracked) {
-    track_toplevels[track_toplevels_count].handle = toplevel;
-    track_toplevels[track_toplevels_count].output = NULL;
-    track_toplevels[track_toplevels_count].is_fullscreen = false;
-    track_toplevels_count++;
-  }
-
-  bongocat_log_debug("New toplevel registered for fullscreen monitoring");
+                                               entry);
+  bongocat_log_debug("New toplevel registered for fullscreen monitoring "
+                     "(%zu tracked)",
+                     fs_toplevels.count);
 }
 
 static void
@@ -407,6 +385,85 @@ void fullscreen_init(struct zwlr_foreign_toplevel_manager_v1 *manager) {
                     "protocol for fullscreen detection");
 }
 
+void fullscreen_handle_hypr_event(void) {
+  // Per-toplevel output tracking is authoritative whenever it works
+  if (compositor_sends_output_events) {
+    return;
+  }
+  hypr_fs_update_state();
+}
+
+void fullscreen_set_output_state(const char *output_name, bool fullscreen) {
+  if (!output_name || !output_name[0]) {
+    return;
+  }
+
+  ipc_output_state_t *state = ipc_output_find(output_name);
+  if (!state) {
+    if (ipc_output_count >= MAX_OUTPUTS) {
+      return;
+    }
+    state = &ipc_outputs[ipc_output_count++];
+    snprintf(state->name, sizeof(state->name), "%s", output_name);
+    state->fullscreen = !fullscreen;  // Force the first update through
+  }
+  if (state->fullscreen == fullscreen) {
+    return;
+  }
+  state->fullscreen = fullscreen;
+  bongocat_log_debug("Fullscreen on '%s' (IPC): %s", output_name,
+                     fullscreen ? "detected" : "cleared");
+
+  const char *our_name = output_name_of(output);
+  if (our_name && strcmp(our_name, output_name) == 0) {
+    fs_update_state(fullscreen);
+  }
+  output_bars_refresh_fullscreen();
+}
+
+void fullscreen_clear_output_states(void) {
+  ipc_output_count = 0;
+  memset(ipc_outputs, 0, sizeof(ipc_outputs));
+}
+
+void fullscreen_backends_start(void) {
+  for (size_t i = 0;
+       i < sizeof(fs_ipc_backends) / sizeof(fs_ipc_backends[0]); i++) {
+    const fs_ipc_backend_t *backend = &fs_ipc_backends[i];
+    const char *env = getenv(backend->env);
+    if (!env || !env[0]) {
+      continue;
+    }
+    backend->start();
+    if (backend->active()) {
+      bongocat_log_info("Using %s IPC for fullscreen detection",
+                        backend->name);
+      return;
+    }
+  }
+}
+
+void fullscreen_backends_stop(void) {
+  for (size_t i = 0;
+       i < sizeof(fs_ipc_backends) / sizeof(fs_ipc_backends[0]); i++) {
+    fs_ipc_backends[i].stop();
+  }
+}
+
+bool fullscreen_output_has_fullscreen(struct wl_output *wl_output) {
+  if (!wl_output) {
+    return false;
+  }
+
+  if (ipc_output_count > 0) {
+    const char *name = output_name_of(wl_output);
+    const ipc_output_state_t *state = name ? ipc_output_find(name) : NULL;
+    return state && state->fullscreen;
+  }
+
+  return toplevel_tracker_output_has_fullscreen(&fs_toplevels, wl_output);
+}
+
 void fullscreen_cleanup(void) {
   if (fs_detector.manager) {
     zwlr_foreign_toplevel_manager_v1_destroy(fs_detector.manager);
@@ -414,10 +471,14 @@ void fullscreen_cleanup(void) {
   }
 
   memset(&fs_detector, 0, sizeof(fs_detector));
-  memset(track_toplevels, 0, sizeof(track_toplevels));
-  track_toplevels_count = 0;
+  for (toplevel_entry_t *entry = fs_toplevels.head; entry;
+       entry = entry->next) {
+    zwlr_foreign_toplevel_handle_v1_destroy(entry->handle);
+  }
+  toplevel_tracker_clear(&fs_toplevels);
   active_toplevel_fullscreen = false;
   compositor_sends_output_events = false;
+  fullscreen_clear_output_states();
 }
 
 bool fullscreen_is_detected(void) {
@@ -3,133 +3,144 @@
 #include "platform/hyprland.h"
 
 #include "core/bongocat.h"
+#include "platform/fullscreen.h"
 #include "platform/wayland.h"
 #include "utils/error.h"
 
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/wait.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 // =============================================================================
-// HYPRLAND HELPER FUNCTIONS
+// HYPRLAND IPC STATE
 // =============================================================================
 
-ssize_t safe_exec_read(const char *const argv[], char *buf, size_t buf_size) {
-  if (!argv || !argv[0] || !buf || buf_size == 0)
-    return -1;
+// Request socket path, resolved once (empty outside Hyprland)
+static char hypr_request_path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+static bool hypr_path_resolved = false;
 
-  int pipefd[2];
-  if (pipe(pipefd) < 0)
-    return -1;
+static hypr_event_reader_t hypr_events = {.fd = -1};
 
-  pid_t pid = fork();
-  if (pid < 0) {
-    close(pipefd[0]);
-    close(pipefd[1]);
-    return -1;
-  }
-
-  if (pid == 0) {
-    // Child: redirect stdout to pipe, suppress stderr
-    close(pipefd[0]);
-    dup2(pipefd[1], STDOUT_FILENO);
-    close(pipefd[1]);
-    int devnull = open("/dev/null", O_WRONLY);
-    if (devnull >= 0) {
-      dup2(devnull, STDERR_FILENO);
-      close(devnull);
+static const char *hypr_get_request_path(void) {
+  if (!hypr_path_resolved) {
+    hypr_path_resolved = true;
+    if (!hypr_ipc_socket_path(".socket.sock", hypr_request_path,
+                              sizeof(hypr_request_path))) {
+      hypr_request_path[0] = '\0';
     }
-    execvp(argv[0], (char *const *)argv);
-    _exit(127);
-  }
-
-  // Parent: read output from pipe
-  close(pipefd[1]);
-  size_t total = 0;
-  while (total < buf_size - 1) {
-    ssize_t n = read(pipefd[0], buf + total, buf_size - 1 - total);
-    if (n <= 0)
-      break;
-    total += (size_t)n;
   }
-  buf[total] = '\0';
-  close(pipefd[0]);
-
-  int status;
-  waitpid(pid, &status, 0);
-  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
-    return -1;
-
-  return (ssize_t)total;
+  return hypr_request_path[0] ? hypr_request_path : NULL;
 }
 
+// =============================================================================
+// HYPRLAND QUERIES
+// =============================================================================
+
 void hypr_update_outputs_with_monitor_ids(void) {
+  const char *path = hypr_get_request_path();
+  if (!path) {
+    return;
+  }
+
   char buf[8192];
-  const char *argv[] = {"hyprctl", "monitors", NULL};
-  if (safe_exec_read(argv, buf, sizeof(buf)) < 0)
+  if (hypr_ipc_request(path, "j/monitors", buf, sizeof(buf)) < 0) {
     return;
+  }
 
-  char *saveptr = NULL;
-  char *line = strtok_r(buf, "\n", &saveptr);
-  while (line) {
-    int id = -1;
-    char name[256];
-    int result = sscanf(line, "Monitor %d \"%255[^\"]\"", &id, name);
-    if (result < 2) {
-      result = sscanf(line, "Monitor %255s (ID %d)", name, &id);
-    }
-    if (result == 2) {
-      for (size_t i = 0; i < output_count; i++) {
-        if (outputs[i].name_received &&
-            strcmp(outputs[i].name_str, name) == 0) {
-          outputs[i].hypr_id = id;
-          bongocat_log_debug("Mapped xdg-output '%s' to Hyprland ID %d\n", name,
-                             id);
-          break;
-        }
+  hypr_monitor_t monitors[MAX_OUTPUTS];
+  size_t count = hypr_parse_monitors(buf, monitors, MAX_OUTPUTS);
+  for (size_t m = 0; m < count; m++) {
+    for (size_t i = 0; i < output_count; i++) {
+      if (outputs[i].name_received &&
+          strcmp(outputs[i].name_str, monitors[m].name) == 0) {
+        outputs[i].hypr_id = monitors[m].id;
+        bongocat_log_debug("Mapped xdg-output '%s' to Hyprland ID %d",
+                           monitors[m].name, monitors[m].id);
+        break;
       }
     }
-    line = strtok_r(NULL, "\n", &saveptr);
   }
 }
 
 bool hypr_get_active_window(window_info_t *win) {
+  const char *path = hypr_get_request_path();
+  if (!path || !win) {
+    return false;
+  }
+
   char buf[4096];
-  const char *argv[] = {"hyprctl", "activewindow", NULL};
-  if (safe_exec_read(argv, buf, sizeof(buf)) < 0)
+  if (hypr_ipc_request(path, "j/activewindow", buf, sizeof(buf)) < 0) {
     return false;
+  }
+  return hypr_parse_active_window(buf, win);
+}
 
-  bool has_window = false;
-  win->monitor_id = -1;
-  win->fullscreen = false;
+// =============================================================================
+// EVENT STREAM
+// =============================================================================
 
-  char *saveptr = NULL;
-  char *line = strtok_r(buf, "\n", &saveptr);
-  while (line) {
-    if (strstr(line, "monitor:")) {
-      sscanf(line, "%*[\t ]monitor: %d", &win->monitor_id);
-      has_window = true;
-    }
-    if (strstr(line, "fullscreen:")) {
-      int val;
-      if (sscanf(line, "%*[\t ]fullscreen: %d", &val) == 1) {
-        win->fullscreen = (val != 0);
-      }
-    }
-    if (strstr(line, "at:")) {
-      if (sscanf(line, "%*[\t ]at: [%d, %d]", &win->x, &win->y) < 2) {
-        sscanf(line, "%*[\t ]at: %d,%d", &win->x, &win->y);
-      }
-    }
-    if (strstr(line, "size:")) {
-      if (sscanf(line, "%*[\t ]size: [%d, %d]", &win->width, &win->height) <
-          2) {
-        sscanf(line, "%*[\t ]size: %d,%d", &win->width, &win->height);
-      }
-    }
-    line = strtok_r(NULL, "\n", &saveptr);
+static void hypr_handle_event(const hypr_event_t *event,
+                              [[maybe_unused]] void *data) {
+  switch (event->type) {
+  case HYPR_EVENT_FULLSCREEN:
+  case HYPR_EVENT_ACTIVE_WINDOW:
+    fullscreen_handle_hypr_event();
+    break;
+  case HYPR_EVENT_MONITOR_ADDED:
+    bongocat_log_debug("Hyprland monitor added: %s", event->monitor_name);
+    hypr_update_outputs_with_monitor_ids();
+    break;
+  case HYPR_EVENT_OTHER:
+    break;
+  }
+}
+
+static void hypr_events_fd_ready([[maybe_unused]] int fd,
+                                 [[maybe_unused]] void *data) {
+  if (hypr_event_reader_dispatch(&hypr_events, hypr_handle_event, NULL) < 0) {
+    bongocat_log_warning("Hyprland event stream closed");
+    hypr_events_stop();
+  }
+}
+
+void hypr_events_start(void) {
+  if (hypr_events.fd >= 0) {
+    return;
+  }
+
+  char path[sizeof(hypr_request_path)];
+  if (!hypr_ipc_socket_path(".socket2.sock", path, sizeof(path))) {
+    return;
+  }
+
+  int fd = hypr_ipc_connect_events(path);
+  if (fd < 0) {
+    bongocat_log_debug("Hyprland event socket unavailable: %s", path);
+    return;
+  }
+
+  hypr_event_reader_init(&hypr_events, fd);
+  if (wayland_add_fd_source(fd, hypr_events_fd_ready, NULL) !=
+      BONGOCAT_SUCCESS) {
+    close(fd);
+    hypr_events.fd = -1;
+    return;
+  }
+  bongocat_log_info("Subscribed to Hyprland events");
+}
+
+void hypr_events_stop(void) {
+  if (hypr_events.fd < 0) {
+    return;
   }
+  wayland_remove_fd_source(hypr_events.fd);
+  close(hypr_events.fd);
+  hypr_events.fd = -1;
+}
 
-  return has_window;
+bool hypr_events_active(void) {
+  return hypr_events.fd >= 0;
 }
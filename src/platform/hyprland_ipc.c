@@ -0,0 +1,256 @@
+#define _POSIX_C_SOURCE 200809L
+#include "platform/hyprland_ipc.h"
+
+#include "utils/error.h"
+#include "utils/json_scan.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define HYPR_IPC_TIMEOUT_MS 500
+
+// =============================================================================
+// SOCKET CLIENT
+// =============================================================================
+
+bool hypr_ipc_socket_path(const char *socket_name, char *out, size_t size) {
+  const char *signature = getenv("HYPRLAND_INSTANCE_SIGNATURE");
+  if (!socket_name || !out || size == 0 || !signature || !signature[0] ||
+      strchr(signature, '/')) {
+    return false;
+  }
+
+  const char *runtime_dir = getenv("XDG_RUNTIME_DIR");
+  if (runtime_dir && runtime_dir[0]) {
+    int n = snprintf(out, size, "%s/hypr/%s/%s", runtime_dir, signature,
+                     socket_name);
+    if (n > 0 && (size_t)n < size && access(out, F_OK) == 0) {
+      return true;
+    }
+  }
+
+  int n = snprintf(out, size, "/tmp/hypr/%s/%s", signature, socket_name);
+  return n > 0 && (size_t)n < size;
+}
+
+static int hypr_ipc_connect(const char *path) {
+  struct sockaddr_un addr = {.sun_family = AF_UNIX};
+  if (!path || strlen(path) >= sizeof(addr.sun_path)) {
+    return -1;
+  }
+  memcpy(addr.sun_path, path, strlen(path) + 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    return -1;
+  }
+  if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+ssize_t hypr_ipc_request(const char *path, const char *request, char *buf,
+                         size_t buf_size) {
+  if (!request || !buf || buf_size == 0) {
+    return -1;
+  }
+
+  int fd = hypr_ipc_connect(path);
+  if (fd < 0) {
+    return -1;
+  }
+
+  struct timeval timeout = {.tv_sec = 0,
+                            .tv_usec = HYPR_IPC_TIMEOUT_MS * 1000L};
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  size_t request_len = strlen(request);
+  if (write(fd, request, request_len) != (ssize_t)request_len) {
+    close(fd);
+    return -1;
+  }
+
+  // Hyprland writes the reply and closes the connection
+  size_t total = 0;
+  while (total < buf_size - 1) {
+    ssize_t n = read(fd, buf + total, buf_size - 1 - total);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      break;
+    }
+    total += (size_t)n;
+  }
+  buf[total] = '\0';
+  close(fd);
+
+  return total > 0 ? (ssize_t)total : -1;
+}
+
+int hypr_ipc_connect_events(const char *path) {
+  int fd = hypr_ipc_connect(path);
+  if (fd < 0) {
+    return -1;
+  }
+
+  int flags = fcntl(fd, F_GETFL);
+  if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// =============================================================================
+// REPLY PARSERS
+// =============================================================================
+
+bool hypr_parse_active_window(const char *json, window_info_t *win) {
+  if (!json || !win) {
+    return false;
+  }
+
+  *win = (window_info_t){.monitor_id = -1};
+  if (!json_get_int(json_object_get(json, "monitor"), &win->monitor_id)) {
+    return false;
+  }
+
+  // Hyprland >= 0.42 reports a 0-3 fullscreen mode, older versions a bool
+  int fullscreen = 0;
+  if (json_get_int(json_object_get(json, "fullscreen"), &fullscreen)) {
+    win->fullscreen = fullscreen != 0;
+  }
+  json_get_pair(json_object_get(json, "at"), &win->x, &win->y);
+  json_get_pair(json_object_get(json, "size"), &win->width, &win->height);
+  return true;
+}
+
+size_t hypr_parse_monitors(const char *json, hypr_monitor_t *out, size_t max) {
+  if (!json || !out) {
+    return 0;
+  }
+
+  size_t count = 0;
+  for (const char *elem = json_array_first(json);
+       elem && count < max; elem = json_array_next(elem)) {
+    hypr_monitor_t *monitor = &out[count];
+    if (json_get_int(json_object_get(elem, "id"), &monitor->id) &&
+        json_get_string(json_object_get(elem, "name"), monitor->name,
+                        sizeof(monitor->name))) {
+      count++;
+    }
+  }
+  return count;
+}
+
+// =============================================================================
+// EVENT STREAM
+// =============================================================================
+
+bool hypr_parse_event(const char *line, size_t len, hypr_event_t *event) {
+  if (!line || !event) {
+    return false;
+  }
+
+  const char *sep = NULL;
+  for (size_t i = 0; i + 1 < len; i++) {
+    if (line[i] == '>' && line[i + 1] == '>') {
+      sep = &line[i];
+      break;
+    }
+  }
+  if (!sep) {
+    return false;
+  }
+
+  size_t name_len = (size_t)(sep - line);
+  const char *data = sep + 2;
+  size_t data_len = len - name_len - 2;
+
+  *event = (hypr_event_t){.type = HYPR_EVENT_OTHER};
+  if (name_len == 10 && memcmp(line, "fullscreen", 10) == 0) {
+    event->type = HYPR_EVENT_FULLSCREEN;
+    event->fullscreen = data_len > 0 && data[0] != '0';
+  } else if (name_len == 12 && memcmp(line, "activewindow", 12) == 0) {
+    event->type = HYPR_EVENT_ACTIVE_WINDOW;
+  } else if (name_len == 12 && memcmp(line, "monitoradded", 12) == 0) {
+    event->type = HYPR_EVENT_MONITOR_ADDED;
+    size_t copy = data_len < sizeof(event->monitor_name) - 1
+                      ? data_len
+                      : sizeof(event->monitor_name) - 1;
+    memcpy(event->monitor_name, data, copy);
+    event->monitor_name[copy] = '\0';
+  }
+  return true;
+}
+
+void hypr_event_reader_init(hypr_event_reader_t *reader, int fd) {
+  if (!reader) {
+    return;
+  }
+  reader->fd = fd;
+  reader->len = 0;
+  reader->discarding = false;
+}
+
+int hypr_event_reader_dispatch(hypr_event_reader_t *reader,
+                               hypr_event_handler_t handler, void *data) {
+  if (!reader || reader->fd < 0) {
+    return -1;
+  }
+
+  int dispatched = 0;
+  for (;;) {
+    ssize_t n = read(reader->fd, reader->buf + reader->len,
+                     sizeof(reader->buf) - reader->len);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0 && errno == EAGAIN) {
+      return dispatched;
+    }
+    if (n <= 0) {
+      return -1;
+    }
+    reader->len += (size_t)n;
+
+    // Dispatch every complete line, then keep the partial tail
+    size_t start = 0;
+    for (size_t i = 0; i < reader->len; i++) {
+      if (reader->buf[i] != '\n') {
+        continue;
+      }
+      hypr_event_t event;
+      if (!reader->discarding &&
+          hypr_parse_event(reader->buf + start, i - start, &event)) {
+        if (handler) {
+          handler(&event, data);
+        }
+        dispatched++;
+      }
+      reader->discarding = false;
+      start = i + 1;
+    }
+
+    if (start > 0) {
+      memmove(reader->buf, reader->buf + start, reader->len - start);
+      reader->len -= start;
+    } else if (reader->len == sizeof(reader->buf)) {
+      // A line longer than the buffer: none of its events are of interest
+      bongocat_log_debug("Dropping overlong Hyprland event line");
+      reader->discarding = true;
+      reader->len = 0;
+    }
+  }
+}
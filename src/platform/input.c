@@ -3,7 +3,11 @@
 #include "platform/input.h"
 
 #include "graphics/animation.h"
+#include "platform/input_record.h"
+#include "utils/latency.h"
 #include "utils/memory.h"
+#include "utils/metrics.h"
+#include "utils/trace.h"
 
 #include <dirent.h>
 #include <fcntl.h>
@@ -25,9 +29,22 @@
 
 atomic_int *any_key_pressed;
 atomic_int *last_key_code;
+input_key_timing_t *last_key_timing;
 static pid_t input_child_pid = -1;
 static int wake_fd = -1;
 
+// Set while every bar is hidden behind a fullscreen window: the child keeps
+// recording key timing but neither raises any_key_pressed nor writes
+// wake_fd, so typing over a fullscreen game wakes nothing in this process
+static atomic_int *wake_suspended;
+
+// --record / --replay. The recorder is opened by the parent so a restarted
+// child keeps appending to the same file.
+static const char *record_path;
+static input_recorder_t recorder = {.fd = -1};
+static const char *replay_path;
+static double replay_speed = 1.0;
+
 static void wait_child_exit(pid_t pid, int max_attempts) {
   int status;
   for (int i = 0; i < max_attempts; i++) {
@@ -49,6 +66,35 @@ static atomic_int *alloc_shared_atomic(void) {
   return ptr;
 }
 
+static input_key_timing_t *alloc_shared_timing(void) {
+  input_key_timing_t *ptr =
+      mmap(NULL, sizeof(input_key_timing_t), PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED)
+    return NULL;
+  atomic_store(&ptr->event_us, 0);
+  atomic_store(&ptr->read_us, 0);
+  return ptr;
+}
+
+// Convert an evdev timestamp to CLOCK_MONOTONIC microseconds. Devices that
+// rejected EVIOCSCLOCKID still report CLOCK_REALTIME, which is shifted by
+// the current realtime/monotonic offset.
+static int64_t input_event_time_us(const struct input_event *ev,
+                                   bool monotonic_clock) {
+  int64_t event_us = (int64_t)ev->input_event_sec * 1000000LL +
+                     (int64_t)ev->input_event_usec;
+  if (monotonic_clock) {
+    return event_us;
+  }
+
+  struct timespec real_ts;
+  clock_gettime(CLOCK_REALTIME, &real_ts);
+  int64_t real_us =
+      (int64_t)real_ts.tv_sec * 1000000LL + real_ts.tv_nsec / 1000L;
+  return event_us - (real_us - latency_now_us());
+}
+
 pid_t input_get_child_pid(void) {
   return input_child_pid;
 }
@@ -57,6 +103,21 @@ int input_get_wake_fd(void) {
   return wake_fd;
 }
 
+void input_set_wake_suspended(bool suspended) {
+  if (wake_suspended) {
+    atomic_store(wake_suspended, suspended ? 1 : 0);
+  }
+}
+
+void input_set_record_file(const char *path) {
+  record_path = path;
+}
+
+void input_set_replay(const char *path, double speed) {
+  replay_path = path;
+  replay_speed = speed;
+}
+
 // Child process signal handler - exits quietly without logging
 static void child_signal_handler(int sig) {
   (void)sig;
@@ -84,6 +145,121 @@ static bool device_matches_name(int fd, char **names, int num_names) {
   return false;
 }
 
+// Publish the key presses among num_events events read at read_us
+static void input_process_events(const struct input_event *ev, int num_events,
+                                 bool monotonic_clock, int64_t read_us,
+                                 const char *source, int enable_debug) {
+  uint64_t presses = 0;
+  int code = 0;
+  const struct input_event *key_ev = NULL;
+
+  for (int k = 0; k < num_events; k++) {
+    if (ev[k].type == EV_KEY && ev[k].value == 1) {
+      presses++;
+      code = ev[k].code;
+      key_ev = &ev[k];
+      if (enable_debug) {
+        bongocat_log_debug("Key: %d from %s", code, source);
+      }
+    }
+  }
+
+  if (presses == 0) {
+    return;
+  }
+  // The count only: key codes never reach the trace
+  trace_instant_arg("key press", (int64_t)presses);
+  metrics_add(METRIC_KEY_PRESSES, presses);
+  if (last_key_timing && key_ev) {
+    atomic_store(&last_key_timing->event_us,
+                 input_event_time_us(key_ev, monotonic_clock));
+    atomic_store(&last_key_timing->read_us, read_us);
+  }
+  atomic_store(last_key_code, code);
+  if (wake_suspended && atomic_load(wake_suspended)) {
+    metrics_add(METRIC_KEY_PRESSES_SUPPRESSED, presses);
+    return;
+  }
+  // Presses read together share one wake
+  metrics_add(METRIC_KEY_PRESSES_COALESCED, presses - 1);
+  animation_trigger();
+  if (wake_fd >= 0) {
+    uint64_t val = 1;
+    if (write(wake_fd, &val, sizeof(val)) < 0) {
+      // Best-effort wake; ignore errors
+    }
+  }
+}
+
+// =============================================================================
+// RECORDED INPUT REPLAY (runs in child process)
+// =============================================================================
+
+static void sleep_until_us(int64_t due_us) {
+  struct timespec ts = {.tv_sec = due_us / 1000000LL,
+                        .tv_nsec = (due_us % 1000000LL) * 1000L};
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+  }
+}
+
+// Feed a recording through input_process_events() instead of /dev/input,
+// batch by batch as the devices delivered it. Event timestamps are the
+// scheduled replay times, so the latency report covers the replay as well.
+static void replay_recording(int enable_debug) {
+  input_recording_t rec;
+  if (input_recording_load(&rec, replay_path) != BONGOCAT_SUCCESS) {
+    return;
+  }
+  bongocat_log_info("Replaying %zu events (%.1f s recorded) from %s at %s",
+                    rec.count, (double)rec.duration_us / 1e6, replay_path,
+                    replay_speed > 0.0 ? "recorded speed" : "full speed");
+  if (replay_speed > 0.0 && replay_speed != 1.0) {
+    bongocat_log_info("Replay speed: %.2fx", replay_speed);
+  }
+
+  struct input_event ev[64];
+  uint64_t key_presses = 0;
+  int64_t recorded_us = 0;
+  int64_t start_us = latency_now_us();
+
+  for (size_t i = 0; i < rec.count;) {
+    if (getppid() == 1) {
+      break;
+    }
+    size_t end = input_recording_next_batch(&rec, i, 64);
+    recorded_us += rec.records[i].delta_us;
+    int64_t due_us = start_us;
+    if (replay_speed > 0.0) {
+      due_us += (int64_t)((double)recorded_us / replay_speed);
+      sleep_until_us(due_us);
+    } else {
+      due_us = latency_now_us();
+    }
+
+    int n = 0;
+    for (size_t k = i; k < end; k++, n++) {
+      const input_record_t *r = &rec.records[k];
+      ev[n] = (struct input_event){.type = r->type,
+                                   .code = r->code,
+                                   .value = r->value};
+      ev[n].input_event_sec = due_us / 1000000LL;
+      ev[n].input_event_usec = due_us % 1000000LL;
+      key_presses += r->type == EV_KEY && r->value == 1;
+    }
+    input_process_events(ev, n, true, latency_now_us(), "replay",
+                         enable_debug);
+    i = end;
+  }
+
+  int64_t elapsed_us = latency_now_us() - start_us;
+  bongocat_log_info(
+      "Replay finished: %zu events, %llu key presses in %.1f ms (%.0f "
+      "events/s)",
+      rec.count, (unsigned long long)key_presses, (double)elapsed_us / 1e3,
+      elapsed_us > 0 ? (double)rec.count * 1e6 / (double)elapsed_us : 0.0);
+  input_recording_free(&rec);
+}
+
 // =============================================================================
 // HOTPLUG INPUT CAPTURE (runs in child process)
 // =============================================================================
@@ -109,16 +285,30 @@ static void capture_input_hotplug(char **static_paths, int num_static,
   sigaction(SIGTERM, &sa, NULL);
   sigaction(SIGINT, &sa, NULL);
 
+  trace_set_thread_name("input");
+
+  if (replay_path) {
+    replay_recording(enable_debug);
+    // Stay up like a reader whose keyboards went quiet until the parent
+    // stops us, so the process shuts down as usual
+    while (getppid() != 1) {
+      pause();
+    }
+    return;
+  }
+
   bongocat_log_debug("Starting input hotplug monitor (interval: %ds)",
                      scan_interval);
 
   struct {
     int fd;
+    bool monotonic_clock;  // Event timestamps use CLOCK_MONOTONIC
     char path[256];
   } active_devices[MAX_ACTIVE_DEVICES];
 
   for (int i = 0; i < MAX_ACTIVE_DEVICES; i++) {
     active_devices[i].fd = -1;
+    active_devices[i].monotonic_clock = false;
     memset(active_devices[i].path, 0, sizeof(active_devices[i].path));
   }
 
@@ -206,6 +396,11 @@ static void capture_input_hotplug(char **static_paths, int num_static,
             }
 
             if (slot >= 0) {
+              // Ask for monotonic event timestamps so latency can be
+              // measured against the animation thread's clock
+              int clock_id = CLOCK_MONOTONIC;
+              active_devices[slot].monotonic_clock =
+                  ioctl(fd, EVIOCSCLOCKID, &clock_id) == 0;
               active_devices[slot].fd = fd;
               snprintf(active_devices[slot].path,
                        sizeof(active_devices[slot].path), "%s", path);
@@ -258,13 +453,18 @@ static void capture_input_hotplug(char **static_paths, int num_static,
       }
     }
 
+    metrics_set_input_devices((int)nfds);
     if (nfds == 0) {
       // No devices open, sleep briefly before next scan
       usleep(500000);
+      metrics_count_wakeup(METRICS_THREAD_INPUT);
       continue;
     }
 
+    int64_t span = trace_begin();
     int ret = poll(pfds, nfds, 1000);
+    trace_end("poll", span);
+    metrics_count_wakeup(METRICS_THREAD_INPUT);
 
     if (ret < 0) {
       if (errno != EINTR) {
@@ -282,6 +482,7 @@ static void capture_input_hotplug(char **static_paths, int num_static,
     for (nfds_t j = 0; j < nfds; j++) {
       if (pfds[j].revents & POLLIN) {
         int i = pfd_to_dev[j];
+        span = trace_begin();
         int rd = read(active_devices[i].fd, ev, sizeof(ev));
 
         if (rd < 0) {
@@ -306,31 +507,21 @@ static void capture_input_hotplug(char **static_paths, int num_static,
           continue;
         }
 
+        int64_t read_us = latency_now_us();
         int num_events = rd / sizeof(struct input_event);
-        bool key_pressed = false;
-        int code = 0;
-
-        for (int k = 0; k < num_events; k++) {
-          if (ev[k].type == EV_KEY && ev[k].value == 1) {
-            key_pressed = true;
-            code = ev[k].code;
-            if (enable_debug) {
-              bongocat_log_debug("Key: %d from %s", code,
-                                 active_devices[i].path);
-            }
-          }
-        }
-
-        if (key_pressed) {
-          atomic_store(last_key_code, code);
-          animation_trigger();
-          if (wake_fd >= 0) {
-            uint64_t val = 1;
-            if (write(wake_fd, &val, sizeof(val)) < 0) {
-              // Best-effort wake; ignore errors
-            }
-          }
+        if (recorder.fd >= 0 && num_events > 0) {
+          int64_t raw_us = (int64_t)ev[0].input_event_sec * 1000000LL +
+                           (int64_t)ev[0].input_event_usec;
+          int64_t offset_us =
+              input_event_time_us(&ev[0], active_devices[i].monotonic_clock) -
+              raw_us;
+          input_recorder_write(&recorder, (uint8_t)i, ev, (size_t)num_events,
+                               offset_us);
         }
+        input_process_events(ev, num_events,
+                             active_devices[i].monotonic_clock, read_us,
+                             active_devices[i].path, enable_debug);
+        trace_end_arg("read", span, num_events);
       }
     }
   }
@@ -370,6 +561,15 @@ bongocat_error_t input_start_monitoring(char **device_paths, int num_devices,
     return BONGOCAT_ERROR_MEMORY;
   }
 
+  // Shared memory for key event timestamps (latency instrumentation)
+  last_key_timing = alloc_shared_timing();
+  if (!last_key_timing) {
+    bongocat_log_warning(
+        "Failed to create shared memory for key timing: %s (latency "
+        "instrumentation disabled)",
+        strerror(errno));
+  }
+
   wake_fd = eventfd(0, EFD_NONBLOCK);
   if (wake_fd < 0) {
     bongocat_log_warning(
@@ -377,6 +577,15 @@ bongocat_error_t input_start_monitoring(char **device_paths, int num_devices,
         strerror(errno));
   }
 
+  // Optional: without it key presses keep waking a suspended renderer
+  wake_suspended = alloc_shared_atomic();
+
+  // Opened once here: children restarted on reload append to the same file
+  if (record_path && recorder.fd < 0 &&
+      input_recorder_open(&recorder, record_path) == BONGOCAT_SUCCESS) {
+    bongocat_log_warning("Recording every input event to %s", record_path);
+  }
+
   input_child_pid = fork();
   if (input_child_pid < 0) {
     bongocat_log_error("Failed to fork input monitoring process: %s",
@@ -385,10 +594,18 @@ bongocat_error_t input_start_monitoring(char **device_paths, int num_devices,
     munmap(last_key_code, sizeof(atomic_int));
     any_key_pressed = NULL;
     last_key_code = NULL;
+    if (last_key_timing) {
+      munmap(last_key_timing, sizeof(input_key_timing_t));
+      last_key_timing = NULL;
+    }
     if (wake_fd >= 0) {
       close(wake_fd);
       wake_fd = -1;
     }
+    if (wake_suspended) {
+      munmap(wake_suspended, sizeof(atomic_int));
+      wake_suspended = NULL;
+    }
     return BONGOCAT_ERROR_THREAD;
   }
 
@@ -446,13 +663,20 @@ bongocat_error_t input_restart_monitoring(char **device_paths, int num_devices,
     }
   }
 
-  // Recreate eventfd for the new child process
-  if (wake_fd >= 0) {
-    close(wake_fd);
+  if (!last_key_timing) {
+    last_key_timing = alloc_shared_timing();
   }
-  wake_fd = eventfd(0, EFD_NONBLOCK);
+  if (!wake_suspended) {
+    wake_suspended = alloc_shared_atomic();
+  }
+
+  // Keep the existing eventfd: the animation thread may be blocked on it
+  // with no timeout, and the new child inherits it across fork()
   if (wake_fd < 0) {
-    bongocat_log_warning("Failed to recreate eventfd: %s", strerror(errno));
+    wake_fd = eventfd(0, EFD_NONBLOCK);
+    if (wake_fd < 0) {
+      bongocat_log_warning("Failed to recreate eventfd: %s", strerror(errno));
+    }
   }
 
   // Fork new process
@@ -493,6 +717,11 @@ void input_cleanup(void) {
     input_child_pid = -1;
   }
 
+  if (recorder.fd >= 0) {
+    input_recorder_close(&recorder);
+    bongocat_log_info("Input recording saved to %s", record_path);
+  }
+
   // Cleanup eventfd
   if (wake_fd >= 0) {
     close(wake_fd);
@@ -508,6 +737,14 @@ void input_cleanup(void) {
     munmap(last_key_code, sizeof(atomic_int));
     last_key_code = NULL;
   }
+  if (last_key_timing) {
+    munmap(last_key_timing, sizeof(input_key_timing_t));
+    last_key_timing = NULL;
+  }
+  if (wake_suspended) {
+    munmap(wake_suspended, sizeof(atomic_int));
+    wake_suspended = NULL;
+  }
 
   bongocat_log_debug("Input monitoring cleanup complete");
 }
@@ -0,0 +1,237 @@
+#define _POSIX_C_SOURCE 200809L
+#include "platform/input_record.h"
+
+#include "utils/memory.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// =============================================================================
+// ENCODING
+// =============================================================================
+
+static void put_u16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+  put_u16(p, (uint16_t)v);
+  put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+  return (uint32_t)get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+static bool write_all(int fd, const uint8_t *data, size_t len) {
+  while (len > 0) {
+    ssize_t n = write(fd, data, len);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += n;
+    len -= (size_t)n;
+  }
+  return true;
+}
+
+// =============================================================================
+// RECORDER
+// =============================================================================
+
+bongocat_error_t input_recorder_open(input_recorder_t *rec, const char *path) {
+  BONGOCAT_CHECK_NULL(rec, BONGOCAT_ERROR_INVALID_PARAM);
+  BONGOCAT_CHECK_NULL(path, BONGOCAT_ERROR_INVALID_PARAM);
+  *rec = (input_recorder_t){.fd = -1};
+
+  // Every keystroke ends up in this file: keep it private
+  int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC,
+                S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    bongocat_log_error("Cannot create recording %s: %s", path,
+                       strerror(errno));
+    return BONGOCAT_ERROR_FILE_IO;
+  }
+
+  uint8_t header[INPUT_RECORD_HEADER_SIZE];
+  memcpy(header, INPUT_RECORD_MAGIC, 4);
+  put_u16(header + 4, INPUT_RECORD_VERSION);
+  put_u16(header + 6, INPUT_RECORD_SIZE);
+  if (!write_all(fd, header, sizeof(header))) {
+    bongocat_log_error("Cannot write recording %s: %s", path,
+                       strerror(errno));
+    close(fd);
+    return BONGOCAT_ERROR_FILE_IO;
+  }
+
+  rec->fd = fd;
+  return BONGOCAT_SUCCESS;
+}
+
+bool input_recorder_write(input_recorder_t *rec, uint8_t device,
+                          const struct input_event *ev, size_t count,
+                          int64_t offset_us) {
+  if (!rec || rec->fd < 0) {
+    return false;
+  }
+
+  // One write() per read() batch: O_APPEND keeps it whole
+  uint8_t buf[64 * INPUT_RECORD_SIZE];
+  while (count > 0) {
+    size_t n = count < 64 ? count : 64;
+    uint8_t *p = buf;
+    for (size_t i = 0; i < n; i++, p += INPUT_RECORD_SIZE) {
+      int64_t t = (int64_t)ev[i].input_event_sec * 1000000LL +
+                  (int64_t)ev[i].input_event_usec + offset_us;
+      // Devices on different clocks can step back; long idle gaps are
+      // clamped to ~71 minutes
+      int64_t delta = rec->has_last ? t - rec->last_us : 0;
+      delta = delta < 0 ? 0 : delta;
+      delta = delta > UINT32_MAX ? UINT32_MAX : delta;
+      if (!rec->has_last || t > rec->last_us) {
+        rec->last_us = t;
+        rec->has_last = true;
+      }
+
+      put_u32(p, (uint32_t)delta);
+      p[4] = device;
+      p[5] = (uint8_t)ev[i].type;
+      put_u16(p + 6, ev[i].code);
+      put_u32(p + 8, (uint32_t)ev[i].value);
+    }
+
+    if (!write_all(rec->fd, buf, n * INPUT_RECORD_SIZE)) {
+      bongocat_log_error("Recording stopped: %s", strerror(errno));
+      input_recorder_close(rec);
+      return false;
+    }
+    rec->records += n;
+    ev += n;
+    count -= n;
+  }
+  return true;
+}
+
+void input_recorder_close(input_recorder_t *rec) {
+  if (rec && rec->fd >= 0) {
+    close(rec->fd);
+    rec->fd = -1;
+  }
+}
+
+// =============================================================================
+// RECORDINGS
+// =============================================================================
+
+bongocat_error_t input_recording_load(input_recording_t *out,
+                                      const char *path) {
+  BONGOCAT_CHECK_NULL(out, BONGOCAT_ERROR_INVALID_PARAM);
+  BONGOCAT_CHECK_NULL(path, BONGOCAT_ERROR_INVALID_PARAM);
+  *out = (input_recording_t){0};
+
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) < 0) {
+    bongocat_log_error("Cannot open recording %s: %s", path, strerror(errno));
+    if (fd >= 0) {
+      close(fd);
+    }
+    return BONGOCAT_ERROR_FILE_IO;
+  }
+
+  size_t size = (size_t)st.st_size;
+  uint8_t *data = size > 0 ? bongocat_malloc(size) : NULL;
+  size_t got = 0;
+  while (data && got < size) {
+    ssize_t n = read(fd, data + got, size - got);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      break;
+    }
+    got += (size_t)n;
+  }
+  close(fd);
+
+  if (got < INPUT_RECORD_HEADER_SIZE ||
+      memcmp(data, INPUT_RECORD_MAGIC, 4) != 0 ||
+      get_u16(data + 4) != INPUT_RECORD_VERSION ||
+      get_u16(data + 6) != INPUT_RECORD_SIZE) {
+    bongocat_log_error("%s is not a version %d input recording", path,
+                       INPUT_RECORD_VERSION);
+    bongocat_free(data);
+    return BONGOCAT_ERROR_INPUT;
+  }
+
+  size_t body = got - INPUT_RECORD_HEADER_SIZE;
+  size_t count = body / INPUT_RECORD_SIZE;
+  if (body % INPUT_RECORD_SIZE != 0) {
+    bongocat_log_warning("%s: dropping a truncated last record", path);
+  }
+
+  input_record_t *records =
+      count > 0 ? bongocat_malloc(count * sizeof(*records)) : NULL;
+  if (count > 0 && !records) {
+    bongocat_free(data);
+    return BONGOCAT_ERROR_MEMORY;
+  }
+
+  const uint8_t *p = data + INPUT_RECORD_HEADER_SIZE;
+  uint64_t duration = 0;
+  for (size_t i = 0; i < count; i++, p += INPUT_RECORD_SIZE) {
+    records[i] = (input_record_t){
+        .delta_us = get_u32(p),
+        .device = p[4],
+        .type = p[5],
+        .code = get_u16(p + 6),
+        .value = (int32_t)get_u32(p + 8),
+    };
+    duration += records[i].delta_us;
+  }
+  bongocat_free(data);
+
+  out->records = records;
+  out->count = count;
+  out->duration_us = duration;
+  return BONGOCAT_SUCCESS;
+}
+
+void input_recording_free(input_recording_t *rec) {
+  if (!rec) {
+    return;
+  }
+  bongocat_free(rec->records);
+  *rec = (input_recording_t){0};
+}
+
+size_t input_recording_next_batch(const input_recording_t *rec, size_t start,
+                                  size_t max) {
+  if (!rec || start >= rec->count || max == 0) {
+    return start;
+  }
+
+  size_t end = start + 1;
+  const input_record_t *first = &rec->records[start];
+  bool syn = first->type == EV_SYN && first->code == SYN_REPORT;
+  while (!syn && end < rec->count && end - start < max) {
+    const input_record_t *r = &rec->records[end];
+    if (r->delta_us != 0 || r->device != first->device) {
+      break;
+    }
+    end++;
+    syn = r->type == EV_SYN && r->code == SYN_REPORT;
+  }
+  return end;
+}
@@ -0,0 +1,66 @@
+#define _POSIX_C_SOURCE 200809L
+#include "platform/niri.h"
+
+#include "platform/fullscreen.h"
+#include "platform/wayland.h"
+#include "utils/error.h"
+
+#include <sys/un.h>
+
+// =============================================================================
+// NIRI IPC STATE
+// =============================================================================
+
+static niri_session_t niri_session = {.fd = -1};
+
+// =============================================================================
+// EVENT STREAM
+// =============================================================================
+
+static void niri_handle_output(const char *output_name, bool fullscreen,
+                               [[maybe_unused]] void *data) {
+  fullscreen_set_output_state(output_name, fullscreen);
+}
+
+static void niri_fd_ready([[maybe_unused]] int fd,
+                          [[maybe_unused]] void *data) {
+  if (niri_session_dispatch(&niri_session) < 0) {
+    bongocat_log_warning("niri event stream closed");
+    niri_events_stop();
+  }
+}
+
+void niri_events_start(void) {
+  if (niri_session.fd >= 0) {
+    return;
+  }
+
+  char path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+  if (!niri_ipc_socket_path(path, sizeof(path))) {
+    return;
+  }
+  if (!niri_session_open(&niri_session, path, niri_handle_output, NULL)) {
+    bongocat_log_debug("niri IPC socket unavailable: %s", path);
+    return;
+  }
+
+  if (wayland_add_fd_source(niri_session.fd, niri_fd_ready, NULL) !=
+      BONGOCAT_SUCCESS) {
+    niri_session_close(&niri_session);
+    return;
+  }
+  bongocat_log_info("Subscribed to niri event stream");
+}
+
+void niri_events_stop(void) {
+  if (niri_session.fd < 0) {
+    return;
+  }
+  wayland_remove_fd_source(niri_session.fd);
+  niri_session_close(&niri_session);
+  fullscreen_clear_output_states();
+}
+
+bool niri_events_active(void) {
+  return niri_session.fd >= 0;
+}
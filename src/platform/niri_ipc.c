@@ -0,0 +1,520 @@
+#define _POSIX_C_SOURCE 200809L
+#include "platform/niri_ipc.h"
+
+#include "utils/error.h"
+#include "utils/json_scan.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define NIRI_IPC_TIMEOUT_MS 500
+#define NIRI_READ_CHUNK     4096
+
+// =============================================================================
+// SOCKET CLIENT
+// =============================================================================
+
+bool niri_ipc_socket_path(char *out, size_t size) {
+  const char *path = getenv("NIRI_SOCKET");
+  if (!out || size == 0 || !path || !path[0]) {
+    return false;
+  }
+  int n = snprintf(out, size, "%s", path);
+  return n > 0 && (size_t)n < size;
+}
+
+static int niri_ipc_connect(const char *path) {
+  struct sockaddr_un addr = {.sun_family = AF_UNIX};
+  if (!path || strlen(path) >= sizeof(addr.sun_path)) {
+    return -1;
+  }
+  memcpy(addr.sun_path, path, strlen(path) + 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    return -1;
+  }
+  struct timeval timeout = {.tv_sec = 0,
+                            .tv_usec = NIRI_IPC_TIMEOUT_MS * 1000L};
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+static bool niri_send_line(int fd, const char *request) {
+  char line[128];
+  int len = snprintf(line, sizeof(line), "%s\n", request);
+  if (len <= 0 || (size_t)len >= sizeof(line)) {
+    return false;
+  }
+  return send(fd, line, (size_t)len, MSG_NOSIGNAL) == len;
+}
+
+ssize_t niri_ipc_request(const char *path, const char *request, char *buf,
+                         size_t buf_size) {
+  if (!request || !buf || buf_size == 0) {
+    return -1;
+  }
+
+  int fd = niri_ipc_connect(path);
+  if (fd < 0) {
+    return -1;
+  }
+  if (!niri_send_line(fd, request)) {
+    close(fd);
+    return -1;
+  }
+
+  // The reply is a single line
+  size_t total = 0;
+  while (total < buf_size - 1) {
+    ssize_t n = read(fd, buf + total, buf_size - 1 - total);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      break;
+    }
+    total += (size_t)n;
+    if (memchr(buf + total - (size_t)n, '\n', (size_t)n)) {
+      break;
+    }
+  }
+  buf[total] = '\0';
+  close(fd);
+
+  return total > 0 ? (ssize_t)total : -1;
+}
+
+// =============================================================================
+// REPLY AND EVENT PARSERS
+// =============================================================================
+
+size_t niri_parse_outputs(const char *json, niri_output_t *out, size_t max) {
+  const char *outputs =
+      json_object_get(json_object_get(json, "Ok"), "Outputs");
+  if (!outputs || !out) {
+    return 0;
+  }
+
+  size_t count = 0;
+  json_member_t member;
+  for (const char *it = json_object_first(outputs, &member);
+       it && count < max; it = json_object_next(it, &member)) {
+    niri_output_t *output = &out[count];
+    *output = (niri_output_t){0};
+    if (!json_get_string(json_object_get(member.value, "name"), output->name,
+                         sizeof(output->name))) {
+      continue;
+    }
+    // Disabled outputs have no logical geometry
+    const char *logical = json_object_get(member.value, "logical");
+    json_get_int(json_object_get(logical, "width"), &output->width);
+    json_get_int(json_object_get(logical, "height"), &output->height);
+    count++;
+  }
+  return count;
+}
+
+static bool niri_parse_workspace(const char *json, niri_workspace_t *ws) {
+  *ws = (niri_workspace_t){0};
+  if (!json_get_u64(json_object_get(json, "id"), &ws->id)) {
+    return false;
+  }
+  json_get_string(json_object_get(json, "output"), ws->output,
+                  sizeof(ws->output));
+  int active = 0;
+  json_get_int(json_object_get(json, "is_active"), &active);
+  ws->is_active = active != 0;
+  ws->has_active_window = json_get_u64(
+      json_object_get(json, "active_window_id"), &ws->active_window_id);
+  return true;
+}
+
+static void niri_parse_layout(const char *layout, niri_window_t *win) {
+  json_get_pair(json_object_get(layout, "window_size"), &win->width,
+                &win->height);
+}
+
+static bool niri_parse_window(const char *json, niri_window_t *win) {
+  *win = (niri_window_t){.fullscreen = -1};
+  if (!json_get_u64(json_object_get(json, "id"), &win->id)) {
+    return false;
+  }
+  win->has_workspace = json_get_u64(json_object_get(json, "workspace_id"),
+                                    &win->workspace_id);
+  int fullscreen = 0;
+  if (json_get_int(json_object_get(json, "is_fullscreen"), &fullscreen)) {
+    win->fullscreen = fullscreen != 0;
+  }
+  niri_parse_layout(json_object_get(json, "layout"), win);
+  return true;
+}
+
+// =============================================================================
+// SESSION STATE
+// =============================================================================
+
+static niri_workspace_t *niri_find_workspace(niri_session_t *session,
+                                             uint64_t id) {
+  for (size_t i = 0; i < session->workspace_count; i++) {
+    if (session->workspaces[i].id == id) {
+      return &session->workspaces[i];
+    }
+  }
+  return NULL;
+}
+
+static niri_window_t *niri_find_window(niri_session_t *session, uint64_t id) {
+  for (size_t i = 0; i < session->window_count; i++) {
+    if (session->windows[i].id == id) {
+      return &session->windows[i];
+    }
+  }
+  return NULL;
+}
+
+static niri_output_t *niri_find_output(niri_session_t *session,
+                                       const char *name) {
+  for (size_t i = 0; i < session->output_count; i++) {
+    if (strcmp(session->outputs[i].name, name) == 0) {
+      return &session->outputs[i];
+    }
+  }
+  return NULL;
+}
+
+// Re-read output sizes, keeping what was already reported
+static void niri_refresh_outputs(niri_session_t *session) {
+  char buf[16384];
+  niri_output_t fresh[NIRI_MAX_OUTPUTS];
+  if (niri_ipc_request(session->path, "\"Outputs\"", buf, sizeof(buf)) < 0) {
+    bongocat_log_debug("niri Outputs request failed");
+    return;
+  }
+
+  size_t count = niri_parse_outputs(buf, fresh, NIRI_MAX_OUTPUTS);
+  for (size_t i = 0; i < count; i++) {
+    const niri_output_t *old = niri_find_output(session, fresh[i].name);
+    if (old) {
+      fresh[i].reported = old->reported;
+      fresh[i].fullscreen = old->fullscreen;
+    }
+  }
+  memcpy(session->outputs, fresh, count * sizeof(fresh[0]));
+  session->output_count = count;
+}
+
+// Make sure every output named by a workspace is tracked (hotplug)
+static void niri_sync_outputs(niri_session_t *session) {
+  for (size_t i = 0; i < session->workspace_count; i++) {
+    const char *name = session->workspaces[i].output;
+    if (name[0] && !niri_find_output(session, name)) {
+      niri_refresh_outputs(session);
+      break;
+    }
+  }
+
+  for (size_t i = 0; i < session->workspace_count; i++) {
+    const char *name = session->workspaces[i].output;
+    if (name[0] && !niri_find_output(session, name) &&
+        session->output_count < NIRI_MAX_OUTPUTS) {
+      niri_output_t *output = &session->outputs[session->output_count++];
+      *output = (niri_output_t){0};
+      snprintf(output->name, sizeof(output->name), "%s", name);
+    }
+  }
+}
+
+static bool niri_window_is_fullscreen(const niri_window_t *win,
+                                      const niri_output_t *output) {
+  if (win->fullscreen >= 0) {
+    return win->fullscreen != 0;
+  }
+  // Without an explicit flag, a window covering the whole logical output
+  // is fullscreen
+  return output->width > 0 && output->height > 0 &&
+         win->width >= output->width && win->height >= output->height;
+}
+
+static void niri_report_outputs(niri_session_t *session) {
+  for (size_t o = 0; o < session->output_count; o++) {
+    niri_output_t *output = &session->outputs[o];
+    bool fullscreen = false;
+
+    for (size_t w = 0; w < session->workspace_count; w++) {
+      const niri_workspace_t *ws = &session->workspaces[w];
+      if (!ws->is_active || !ws->has_active_window ||
+          strcmp(ws->output, output->name) != 0) {
+        continue;
+      }
+      const niri_window_t *win = niri_find_window(session,
+                                                  ws->active_window_id);
+      fullscreen = win && niri_window_is_fullscreen(win, output);
+      break;
+    }
+
+    if (!output->reported || output->fullscreen != fullscreen) {
+      output->reported = true;
+      output->fullscreen = fullscreen;
+      if (session->handler) {
+        session->handler(output->name, fullscreen, session->data);
+      }
+    }
+  }
+}
+
+static void niri_upsert_window(niri_session_t *session, const char *json) {
+  niri_window_t win;
+  if (!niri_parse_window(json, &win)) {
+    return;
+  }
+  niri_window_t *existing = niri_find_window(session, win.id);
+  if (existing) {
+    *existing = win;
+  } else if (session->window_count < NIRI_MAX_WINDOWS) {
+    session->windows[session->window_count++] = win;
+  }
+}
+
+static void niri_remove_window(niri_session_t *session, uint64_t id) {
+  for (size_t i = 0; i < session->window_count; i++) {
+    if (session->windows[i].id == id) {
+      session->windows[i] = session->windows[--session->window_count];
+      return;
+    }
+  }
+}
+
+bool niri_session_handle_line(niri_session_t *session, const char *line) {
+  if (!session || !line) {
+    return false;
+  }
+
+  // The stream starts with the reply to the EventStream request
+  if (!session->handled_first_reply) {
+    session->handled_first_reply = true;
+    if (json_object_get(line, "Err")) {
+      bongocat_log_warning("niri refused the event stream");
+      return false;
+    }
+    if (json_object_get(line, "Ok")) {
+      return true;
+    }
+  }
+
+  json_member_t event;
+  if (!json_object_first(line, &event)) {
+    return true;
+  }
+#define NIRI_EVENT_IS(name)                                                    \
+  (event.key_len == sizeof(name) - 1 &&                                        \
+   memcmp(event.key, name, sizeof(name) - 1) == 0)
+
+  if (NIRI_EVENT_IS("WorkspacesChanged")) {
+    session->workspace_count = 0;
+    for (const char *ws = json_array_first(
+             json_object_get(event.value, "workspaces"));
+         ws && session->workspace_count < NIRI_MAX_WORKSPACES;
+         ws = json_array_next(ws)) {
+      if (niri_parse_workspace(
+              ws, &session->workspaces[session->workspace_count])) {
+        session->workspace_count++;
+      }
+    }
+    niri_sync_outputs(session);
+  } else if (NIRI_EVENT_IS("WorkspaceActivated")) {
+    uint64_t id = 0;
+    niri_workspace_t *activated = NULL;
+    if (json_get_u64(json_object_get(event.value, "id"), &id)) {
+      activated = niri_find_workspace(session, id);
+    }
+    if (activated) {
+      for (size_t i = 0; i < session->workspace_count; i++) {
+        niri_workspace_t *ws = &session->workspaces[i];
+        if (strcmp(ws->output, activated->output) == 0) {
+          ws->is_active = ws == activated;
+        }
+      }
+    }
+  } else if (NIRI_EVENT_IS("WorkspaceActiveWindowChanged")) {
+    uint64_t id = 0;
+    niri_workspace_t *ws = NULL;
+    if (json_get_u64(json_object_get(event.value, "workspace_id"), &id)) {
+      ws = niri_find_workspace(session, id);
+    }
+    if (ws) {
+      ws->has_active_window =
+          json_get_u64(json_object_get(event.value, "active_window_id"),
+                       &ws->active_window_id);
+    }
+  } else if (NIRI_EVENT_IS("WindowsChanged")) {
+    session->window_count = 0;
+    for (const char *win =
+             json_array_first(json_object_get(event.value, "windows"));
+         win; win = json_array_next(win)) {
+      niri_upsert_window(session, win);
+    }
+  } else if (NIRI_EVENT_IS("WindowOpenedOrChanged")) {
+    niri_upsert_window(session, json_object_get(event.value, "window"));
+  } else if (NIRI_EVENT_IS("WindowClosed")) {
+    uint64_t id = 0;
+    if (json_get_u64(json_object_get(event.value, "id"), &id)) {
+      niri_remove_window(session, id);
+    }
+  } else if (NIRI_EVENT_IS("WindowLayoutsChanged")) {
+    // "changes": [[id, layout], ...]
+    for (const char *change =
+             json_array_first(json_object_get(event.value, "changes"));
+         change; change = json_array_next(change)) {
+      const char *id_value = json_array_first(change);
+      uint64_t id = 0;
+      niri_window_t *win = NULL;
+      if (json_get_u64(id_value, &id)) {
+        win = niri_find_window(session, id);
+      }
+      if (win) {
+        niri_parse_layout(json_array_next(id_value), win);
+      }
+    }
+  } else {
+    return true;
+  }
+#undef NIRI_EVENT_IS
+
+  niri_report_outputs(session);
+  return true;
+}
+
+// =============================================================================
+// SESSION
+// =============================================================================
+
+bool niri_session_open(niri_session_t *session, const char *path,
+                       niri_output_handler_t handler, void *data) {
+  if (!session || !path) {
+    return false;
+  }
+  memset(session, 0, sizeof(*session));
+  session->fd = -1;
+  session->handler = handler;
+  session->data = data;
+  int n = snprintf(session->path, sizeof(session->path), "%s", path);
+  if (n <= 0 || (size_t)n >= sizeof(session->path)) {
+    return false;
+  }
+
+  niri_refresh_outputs(session);
+
+  int fd = niri_ipc_connect(path);
+  if (fd < 0) {
+    return false;
+  }
+  int flags = -1;
+  if (!niri_send_line(fd, "\"EventStream\"") ||
+      (flags = fcntl(fd, F_GETFL)) < 0 ||
+      fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+    close(fd);
+    return false;
+  }
+  session->fd = fd;
+  return true;
+}
+
+// Make room for at least NIRI_READ_CHUNK more bytes (plus the terminator)
+static bool niri_reserve(niri_session_t *session) {
+  if (session->cap - session->len > NIRI_READ_CHUNK) {
+    return true;
+  }
+  size_t cap = session->cap ? session->cap * 2 : 4 * NIRI_READ_CHUNK;
+  if (cap > NIRI_MAX_LINE + 1) {
+    cap = NIRI_MAX_LINE + 1;
+  }
+  if (cap <= session->len + 1) {
+    return false;
+  }
+  char *buf = realloc(session->buf, cap);
+  if (!buf) {
+    return false;
+  }
+  session->buf = buf;
+  session->cap = cap;
+  return true;
+}
+
+int niri_session_dispatch(niri_session_t *session) {
+  if (!session || session->fd < 0) {
+    return -1;
+  }
+
+  int handled = 0;
+  for (;;) {
+    if (!niri_reserve(session)) {
+      // A line longer than NIRI_MAX_LINE: drop it and resync at the next
+      bongocat_log_warning("Dropping overlong niri event line");
+      session->discarding = true;
+      session->len = 0;
+      if (!niri_reserve(session)) {
+        return -1;
+      }
+    }
+    ssize_t n = read(session->fd, session->buf + session->len,
+                     session->cap - session->len - 1);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0 && errno == EAGAIN) {
+      return handled;
+    }
+    if (n <= 0) {
+      return -1;
+    }
+    size_t scan_from = session->len;
+    session->len += (size_t)n;
+
+    size_t start = 0;
+    for (size_t i = scan_from; i < session->len; i++) {
+      if (session->buf[i] != '\n') {
+        continue;
+      }
+      session->buf[i] = '\0';
+      if (!session->discarding) {
+        if (!niri_session_handle_line(session, session->buf + start)) {
+          return -1;
+        }
+        handled++;
+      }
+      session->discarding = false;
+      start = i + 1;
+    }
+
+    if (start > 0) {
+      memmove(session->buf, session->buf + start, session->len - start);
+      session->len -= start;
+    }
+  }
+}
+
+void niri_session_close(niri_session_t *session) {
+  if (!session) {
+    return;
+  }
+  if (session->fd >= 0) {
+    close(session->fd);
+  }
+  free(session->buf);
+  session->buf = NULL;
+  session->len = session->cap = 0;
+  session->fd = -1;
+}
@@ -0,0 +1,299 @@
+#define _POSIX_C_SOURCE 200809L
+#include "platform/output_bars.h"
+
+#include "graphics/animation.h"
+#include "platform/fullscreen.h"
+#include "platform/power.h"
+#include "platform/wayland.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+// =============================================================================
+// BAR STATE
+// =============================================================================
+
+typedef struct {
+  char name[128];                // Configured monitor name
+  struct wl_output *wl_output;   // NULL while the monitor is disconnected
+  struct wl_surface *surface;
+  struct zwlr_layer_surface_v1 *layer_surface;
+  struct wl_buffer *buffer;
+  uint8_t *pixels;
+  size_t pixel_buffer_size;
+  int width;
+  atomic_bool configured;
+  atomic_bool fullscreen;
+  atomic_bool unmapped;
+} output_bar_t;
+
+static output_bar_t bars[OUTPUT_BARS_MAX];
+static size_t bar_count = 0;
+
+// Surface settings the bars were created with: the layer, anchor and height
+// fields only (the other members stay zero)
+static config_t bars_config;
+
+// =============================================================================
+// LAYER SURFACE EVENTS
+// =============================================================================
+
+static void bar_surface_configure(void *data, struct zwlr_layer_surface_v1 *ls,
+                                  uint32_t serial, uint32_t w, uint32_t h) {
+  output_bar_t *bar = data;
+  bongocat_log_debug("Bar on '%s' configured: %ux%u", bar->name, w, h);
+  zwlr_layer_surface_v1_ack_configure(ls, serial);
+  atomic_store(&bar->configured, true);
+  animation_request_redraw();
+}
+
+static void
+bar_surface_closed(void *data,
+                   [[maybe_unused]] struct zwlr_layer_surface_v1 *ls) {
+  output_bar_t *bar = data;
+  bongocat_log_info("Bar on '%s' closed by compositor", bar->name);
+  atomic_store(&bar->configured, false);
+}
+
+static const struct zwlr_layer_surface_v1_listener bar_listener = {
+    .configure = bar_surface_configure,
+    .closed = bar_surface_closed,
+};
+
+// =============================================================================
+// BAR LIFETIME (render state must be retired before detaching)
+// =============================================================================
+
+static void bar_detach(output_bar_t *bar) {
+  if (bar->buffer) {
+    wl_buffer_destroy(bar->buffer);
+    bar->buffer = NULL;
+  }
+  if (bar->pixels && bar->pixel_buffer_size > 0) {
+    wayland_unmap_shm_buffer(bar->pixels, bar->pixel_buffer_size);
+  }
+  bar->pixels = NULL;
+  bar->pixel_buffer_size = 0;
+  if (bar->layer_surface) {
+    zwlr_layer_surface_v1_destroy(bar->layer_surface);
+    bar->layer_surface = NULL;
+  }
+  if (bar->surface) {
+    wl_surface_destroy(bar->surface);
+    bar->surface = NULL;
+  }
+  bar->wl_output = NULL;
+  bar->width = 0;
+  atomic_store(&bar->configured, false);
+  atomic_store(&bar->fullscreen, false);
+  atomic_store(&bar->unmapped, false);
+}
+
+static void bar_attach(output_bar_t *bar, const output_ref_t *oref) {
+  int width = oref->screen_width > 0 && oref->screen_width <= 32768
+                  ? oref->screen_width
+                  : DEFAULT_SCREEN_WIDTH;
+
+  if (wayland_create_layer_surface(oref->wl_output, &bars_config,
+                                   &bar_listener, bar, &bar->surface,
+                                   &bar->layer_surface) != BONGOCAT_SUCCESS ||
+      wayland_create_shm_buffer(width, bars_config.overlay_height,
+                                &bar->buffer, &bar->pixels,
+                                &bar->pixel_buffer_size) != BONGOCAT_SUCCESS) {
+    bongocat_log_error("Failed to create bar on '%s'", bar->name);
+    bar_detach(bar);
+    return;
+  }
+
+  bar->wl_output = oref->wl_output;
+  bar->width = width;
+  atomic_store(&bar->fullscreen,
+               fullscreen_output_has_fullscreen(oref->wl_output));
+  bongocat_log_info("Bar added on '%s' (%dx%d)", bar->name, width,
+                    bars_config.overlay_height);
+}
+
+BONGOCAT_NODISCARD static const output_ref_t *find_output(const char *name) {
+  for (size_t i = 0; i < output_count; i++) {
+    if (outputs[i].wl_output && outputs[i].name_received &&
+        strcmp(outputs[i].name_str, name) == 0) {
+      return &outputs[i];
+    }
+  }
+  return NULL;
+}
+
+static void bars_destroy_all(void) {
+  for (size_t i = 0; i < bar_count; i++) {
+    bar_detach(&bars[i]);
+    bars[i].name[0] = '\0';
+  }
+  bar_count = 0;
+}
+
+// True if config asks for exactly the bars that exist now
+BONGOCAT_NODISCARD static bool bars_match(const config_t *config,
+                                          size_t wanted) {
+  if (wanted != bar_count ||
+      config->overlay_height != bars_config.overlay_height ||
+      config->layer != bars_config.layer ||
+      config->overlay_position != bars_config.overlay_position) {
+    return false;
+  }
+
+  for (size_t i = 0; i < bar_count; i++) {
+    if (strcmp(bars[i].name, config->output_names[i + 1]) != 0) {
+      return false;
+    }
+    // A mode change since the bar was created needs a new buffer
+    const output_ref_t *oref = find_output(bars[i].name);
+    if (oref && bars[i].wl_output && oref->screen_width > 0 &&
+        oref->screen_width != bars[i].width) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+void output_bars_sync(const config_t *config) {
+  if (!config) {
+    return;
+  }
+
+  size_t wanted = 0;
+  if (config->multi_monitor_mode == MULTI_MONITOR_SHARED &&
+      config->num_output_names > 1) {
+    wanted = (size_t)config->num_output_names - 1;
+    if (wanted > OUTPUT_BARS_MAX) {
+      bongocat_log_warning("Too many monitors for shared mode (%d), using "
+                           "the first %d",
+                           config->num_output_names, OUTPUT_BARS_MAX + 1);
+      wanted = OUTPUT_BARS_MAX;
+    }
+  }
+
+  if (bars_match(config, wanted)) {
+    return;
+  }
+
+  // Wait out draws that may still reference the old surfaces
+  render_state_retire();
+  bars_destroy_all();
+
+  memset(&bars_config, 0, sizeof(bars_config));
+  bars_config.overlay_height = config->overlay_height;
+  bars_config.layer = config->layer;
+  bars_config.overlay_position = config->overlay_position;
+
+  for (size_t i = 0; i < wanted; i++) {
+    output_bar_t *bar = &bars[bar_count++];
+    snprintf(bar->name, sizeof(bar->name), "%s", config->output_names[i + 1]);
+
+    const output_ref_t *oref = find_output(bar->name);
+    if (oref) {
+      bar_attach(bar, oref);
+    } else {
+      bongocat_log_warning("Monitor '%s' not connected, waiting for it",
+                           bar->name);
+    }
+  }
+}
+
+void output_bars_cleanup(void) {
+  if (bar_count == 0) {
+    return;
+  }
+  render_state_retire();
+  bars_destroy_all();
+}
+
+bool output_bars_active(void) {
+  return bar_count > 0;
+}
+
+void output_bars_add_targets(render_snapshot_t *snap) {
+  if (!snap) {
+    return;
+  }
+
+  for (size_t i = 0; i < bar_count; i++) {
+    output_bar_t *bar = &bars[i];
+    if (!bar->surface || !bar->buffer || !bar->pixels) {
+      continue;
+    }
+
+    render_target_t target = {
+        .surface = bar->surface,
+        .buffer = bar->buffer,
+        .pixels = bar->pixels,
+        .width = bar->width,
+        .configured = &bar->configured,
+        .fullscreen = &bar->fullscreen,
+        .unmapped = &bar->unmapped,
+        .powered_off = power_output_off_flag(bar->wl_output),
+    };
+    if (!render_snapshot_add_target(snap, &target)) {
+      bongocat_log_warning("Render target table full, '%s' not drawn",
+                           bar->name);
+    }
+  }
+}
+
+void output_bars_output_named(const output_ref_t *oref) {
+  if (!oref || !oref->wl_output) {
+    return;
+  }
+
+  for (size_t i = 0; i < bar_count; i++) {
+    output_bar_t *bar = &bars[i];
+    if (bar->wl_output || strcmp(bar->name, oref->name_str) != 0) {
+      continue;
+    }
+
+    bongocat_log_info("Monitor '%s' connected", bar->name);
+    render_state_retire();
+    bar_attach(bar, oref);
+    wayland_publish_render_state();
+    return;
+  }
+}
+
+void output_bars_output_removed(struct wl_output *wl_output) {
+  if (!wl_output) {
+    return;
+  }
+
+  for (size_t i = 0; i < bar_count; i++) {
+    output_bar_t *bar = &bars[i];
+    if (bar->wl_output != wl_output) {
+      continue;
+    }
+
+    bongocat_log_warning("Monitor '%s' disconnected", bar->name);
+    render_state_retire();
+    bar_detach(bar);
+    wayland_publish_render_state();
+    return;
+  }
+}
+
+void output_bars_refresh_fullscreen(void) {
+  for (size_t i = 0; i < bar_count; i++) {
+    output_bar_t *bar = &bars[i];
+    if (!bar->wl_output) {
+      continue;
+    }
+
+    bool is_fullscreen = fullscreen_output_has_fullscreen(bar->wl_output);
+    if (atomic_exchange(&bar->fullscreen, is_fullscreen) != is_fullscreen) {
+      bongocat_log_debug("Fullscreen on '%s': %s", bar->name,
+                         is_fullscreen ? "detected" : "cleared");
+      animation_request_redraw();
+    }
+  }
+}
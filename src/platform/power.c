@@ -0,0 +1,276 @@
+#define _POSIX_C_SOURCE 200809L
+#include "platform/power.h"
+
+#include "../protocols/ext-idle-notify-v1-client-protocol.h"
+#include "../protocols/wlr-output-power-management-v1-client-protocol.h"
+#include "core/bongocat.h"
+#include "graphics/animation.h"
+
+// =============================================================================
+// POWER STATE
+// =============================================================================
+
+// Slots are never compacted: render snapshots keep pointers to the flags
+typedef struct {
+  struct wl_output *wl_output;  // NULL for a free slot
+  struct zwlr_output_power_v1 *power;
+  atomic_bool off;
+} output_power_t;
+
+static struct ext_idle_notifier_v1 *idle_notifier = NULL;
+static struct wl_seat *idle_seat = NULL;
+static struct ext_idle_notification_v1 *idle_notification = NULL;
+static uint32_t idle_timeout_ms = 0;
+static atomic_bool idle_tracked = false;
+static atomic_bool user_idle = false;
+
+static struct zwlr_output_power_manager_v1 *power_manager = NULL;
+static bool output_power_enabled = false;
+static output_power_t output_powers[MAX_OUTPUTS];
+
+// =============================================================================
+// PROTOCOL EVENT HANDLERS
+// =============================================================================
+
+static void seat_capabilities([[maybe_unused]] void *data,
+                              [[maybe_unused]] struct wl_seat *seat,
+                              [[maybe_unused]] uint32_t caps) {
+  // Only used to scope the idle notification
+}
+
+static void seat_name([[maybe_unused]] void *data,
+                      [[maybe_unused]] struct wl_seat *seat,
+                      [[maybe_unused]] const char *name) {}
+
+static const struct wl_seat_listener seat_listener = {
+    .capabilities = seat_capabilities,
+    .name = seat_name,
+};
+
+static void
+idle_idled([[maybe_unused]] void *data,
+           [[maybe_unused]] struct ext_idle_notification_v1 *notification) {
+  bongocat_log_debug("Seat idle");
+  atomic_store(&user_idle, true);
+  animation_request_redraw();
+}
+
+static void
+idle_resumed([[maybe_unused]] void *data,
+             [[maybe_unused]] struct ext_idle_notification_v1 *notification) {
+  bongocat_log_debug("Seat active again");
+  atomic_store(&user_idle, false);
+  animation_request_redraw();
+}
+
+static const struct ext_idle_notification_v1_listener idle_listener = {
+    .idled = idle_idled,
+    .resumed = idle_resumed,
+};
+
+static void output_power_mode(void *data,
+                              [[maybe_unused]] struct zwlr_output_power_v1 *p,
+                              uint32_t mode) {
+  output_power_t *slot = data;
+  bool off = mode == ZWLR_OUTPUT_POWER_V1_MODE_OFF;
+  if (atomic_exchange(&slot->off, off) != off) {
+    bongocat_log_info("Output powered %s", off ? "off" : "on");
+    animation_request_redraw();
+  }
+}
+
+// Unsupported output, or another client already controls its power. The
+// output counts as on from now on.
+static void
+output_power_failed(void *data,
+                    [[maybe_unused]] struct zwlr_output_power_v1 *p) {
+  output_power_t *slot = data;
+  bongocat_log_debug("Output power tracking unavailable for an output");
+  if (slot->power) {
+    zwlr_output_power_v1_destroy(slot->power);
+    slot->power = NULL;
+  }
+  if (atomic_exchange(&slot->off, false)) {
+    animation_request_redraw();
+  }
+}
+
+static const struct zwlr_output_power_v1_listener output_power_listener = {
+    .mode = output_power_mode,
+    .failed = output_power_failed,
+};
+
+// =============================================================================
+// IDLE NOTIFICATION
+// =============================================================================
+
+static void idle_destroy_notification(void) {
+  if (idle_notification) {
+    ext_idle_notification_v1_destroy(idle_notification);
+    idle_notification = NULL;
+  }
+  idle_timeout_ms = 0;
+  atomic_store(&idle_tracked, false);
+  atomic_store(&user_idle, false);
+}
+
+static void idle_apply_config(const config_t *config) {
+  uint32_t timeout_ms = config->idle_sleep_timeout_sec > 0
+                            ? (uint32_t)config->idle_sleep_timeout_sec * 1000U
+                            : 0;
+  if (idle_notification && timeout_ms == idle_timeout_ms) {
+    return;
+  }
+
+  // A new notification starts counting from its creation, which is what a
+  // changed timeout means anyway
+  idle_destroy_notification();
+  if (timeout_ms == 0 || !idle_notifier || !idle_seat) {
+    return;
+  }
+
+  idle_notification = ext_idle_notifier_v1_get_idle_notification(
+      idle_notifier, timeout_ms, idle_seat);
+  if (!idle_notification) {
+    bongocat_log_warning("Failed to create idle notification, using the "
+                         "idle_sleep_timeout timer");
+    return;
+  }
+  ext_idle_notification_v1_add_listener(idle_notification, &idle_listener,
+                                        NULL);
+  idle_timeout_ms = timeout_ms;
+  atomic_store(&idle_tracked, true);
+  bongocat_log_info("Idle sleep driven by ext-idle-notify (%d s)",
+                    config->idle_sleep_timeout_sec);
+}
+
+// =============================================================================
+// OUTPUT POWER
+// =============================================================================
+
+static void output_power_release(output_power_t *slot) {
+  if (slot->power) {
+    zwlr_output_power_v1_destroy(slot->power);
+    slot->power = NULL;
+  }
+  slot->wl_output = NULL;
+  atomic_store(&slot->off, false);
+}
+
+static void output_power_release_all(void) {
+  for (size_t i = 0; i < MAX_OUTPUTS; i++) {
+    output_power_release(&output_powers[i]);
+  }
+}
+
+const atomic_bool *power_output_off_flag(struct wl_output *output) {
+  if (!output || !power_manager || !output_power_enabled) {
+    return NULL;
+  }
+
+  output_power_t *free_slot = NULL;
+  for (size_t i = 0; i < MAX_OUTPUTS; i++) {
+    if (output_powers[i].wl_output == output) {
+      return &output_powers[i].off;
+    }
+    if (!free_slot && !output_powers[i].wl_output) {
+      free_slot = &output_powers[i];
+    }
+  }
+  if (!free_slot) {
+    return NULL;
+  }
+
+  // The mode event follows right away; until then the output counts as on
+  free_slot->power =
+      zwlr_output_power_manager_v1_get_output_power(power_manager, output);
+  if (!free_slot->power) {
+    return NULL;
+  }
+  free_slot->wl_output = output;
+  atomic_store(&free_slot->off, false);
+  zwlr_output_power_v1_add_listener(free_slot->power, &output_power_listener,
+                                    free_slot);
+  return &free_slot->off;
+}
+
+void power_output_removed(struct wl_output *output) {
+  if (!output) {
+    return;
+  }
+  for (size_t i = 0; i < MAX_OUTPUTS; i++) {
+    if (output_powers[i].wl_output == output) {
+      output_power_release(&output_powers[i]);
+    }
+  }
+}
+
+// =============================================================================
+// PUBLIC API
+// =============================================================================
+
+void power_bind_idle_notifier(struct ext_idle_notifier_v1 *notifier) {
+  idle_notifier = notifier;
+}
+
+void power_bind_seat(struct wl_seat *seat) {
+  // One seat is enough: idle state is per seat and desktops have one
+  if (idle_seat || !seat) {
+    if (seat) {
+      wl_seat_destroy(seat);
+    }
+    return;
+  }
+  idle_seat = seat;
+  wl_seat_add_listener(idle_seat, &seat_listener, NULL);
+}
+
+void power_bind_output_power_manager(
+    struct zwlr_output_power_manager_v1 *manager) {
+  power_manager = manager;
+}
+
+void power_apply_config(const config_t *config) {
+  if (!config) {
+    return;
+  }
+
+  idle_apply_config(config);
+
+  bool enable = config->enable_output_power_tracking && power_manager;
+  if (output_power_enabled && !enable) {
+    output_power_release_all();
+    animation_request_redraw();
+  }
+  if (enable && !output_power_enabled) {
+    bongocat_log_info("Tracking output power (wlr-output-power-management)");
+  }
+  output_power_enabled = enable;
+}
+
+bool power_idle_tracked(void) {
+  return atomic_load(&idle_tracked);
+}
+
+bool power_user_idle(void) {
+  return atomic_load(&user_idle);
+}
+
+void power_cleanup(void) {
+  idle_destroy_notification();
+  output_power_release_all();
+  output_power_enabled = false;
+
+  if (idle_notifier) {
+    ext_idle_notifier_v1_destroy(idle_notifier);
+    idle_notifier = NULL;
+  }
+  if (idle_seat) {
+    wl_seat_destroy(idle_seat);
+    idle_seat = NULL;
+  }
+  if (power_manager) {
+    zwlr_output_power_manager_v1_destroy(power_manager);
+    power_manager = NULL;
+  }
+}
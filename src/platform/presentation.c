@@ -0,0 +1,249 @@
+#define _POSIX_C_SOURCE 200809L
+#include "platform/presentation.h"
+
+#include "../protocols/presentation-time-client-protocol.h"
+#include "utils/error.h"
+
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+
+// =============================================================================
+// PRESENTATION FEEDBACK MODULE
+// =============================================================================
+
+// Feedback objects normally resolve within a refresh or two, so a small
+// fixed pool covers every commit without allocating on the draw path.
+#define PRESENTATION_MAX_PENDING 16
+
+typedef struct {
+  struct wp_presentation_feedback *feedback;
+  int64_t key_event_us;  // evdev time of the triggering key press, or 0
+  int64_t commit_us;     // CLOCK_MONOTONIC time of wl_surface_commit()
+  atomic_bool in_use;    // Claimed by draw_bar(), released on the main thread
+} feedback_slot_t;
+
+static struct wp_presentation *wp_presentation_global = NULL;
+static clockid_t presentation_clock = CLOCK_MONOTONIC;
+static feedback_slot_t feedback_slots[PRESENTATION_MAX_PENDING];
+
+static atomic_uint_fast64_t frames_presented = 0;
+static atomic_uint_fast64_t frames_discarded = 0;
+static atomic_uint_fast64_t frames_untracked = 0;
+static atomic_uint_fast64_t frames_late = 0;
+static atomic_uint_fast32_t last_refresh_ns = 0;
+static latency_histogram_t commit_to_present_hist;
+static latency_histogram_t key_to_present_hist;
+
+static int64_t clock_now_us(clockid_t clock) {
+  struct timespec ts;
+  clock_gettime(clock, &ts);
+  return (int64_t)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000L;
+}
+
+static void slot_release(feedback_slot_t *slot) {
+  if (slot->feedback) {
+    wp_presentation_feedback_destroy(slot->feedback);
+    slot->feedback = NULL;
+  }
+  atomic_store(&slot->in_use, false);
+}
+
+// =============================================================================
+// PROTOCOL EVENT HANDLERS
+// =============================================================================
+
+static void handle_clock_id([[maybe_unused]] void *data,
+                            [[maybe_unused]] struct wp_presentation *pres,
+                            uint32_t clk_id) {
+  presentation_clock = (clockid_t)clk_id;
+  bongocat_log_debug("Presentation clock id: %u", clk_id);
+}
+
+static const struct wp_presentation_listener presentation_listener = {
+    .clock_id = handle_clock_id,
+};
+
+static void
+handle_sync_output([[maybe_unused]] void *data,
+                   [[maybe_unused]] struct wp_presentation_feedback *feedback,
+                   [[maybe_unused]] struct wl_output *wl_output) {
+  // Single surface on a single output; nothing to correlate
+}
+
+static void
+handle_presented(void *data,
+                 [[maybe_unused]] struct wp_presentation_feedback *feedback,
+                 uint32_t tv_sec_hi, uint32_t tv_sec_lo, uint32_t tv_nsec,
+                 uint32_t refresh, [[maybe_unused]] uint32_t seq_hi,
+                 [[maybe_unused]] uint32_t seq_lo,
+                 [[maybe_unused]] uint32_t flags) {
+  feedback_slot_t *slot = data;
+
+  uint64_t sec = ((uint64_t)tv_sec_hi << 32) | tv_sec_lo;
+  int64_t present_us = (int64_t)sec * 1000000LL + tv_nsec / 1000U;
+  if (presentation_clock != CLOCK_MONOTONIC) {
+    present_us -=
+        clock_now_us(presentation_clock) - clock_now_us(CLOCK_MONOTONIC);
+  }
+
+  int64_t commit_delta = present_us - slot->commit_us;
+  if (commit_delta < 0) {
+    commit_delta = 0;
+  }
+  latency_histogram_record(&commit_to_present_hist, (uint64_t)commit_delta);
+
+  // A commit is late when at least one whole refresh passed between it and
+  // the vblank that finally showed it
+  if (refresh > 0) {
+    atomic_store_explicit(&last_refresh_ns, refresh, memory_order_relaxed);
+    if ((uint64_t)commit_delta * 1000U >= refresh) {
+      atomic_fetch_add_explicit(&frames_late, 1, memory_order_relaxed);
+    }
+  }
+
+  if (slot->key_event_us > 0) {
+    int64_t key_delta = present_us - slot->key_event_us;
+    latency_histogram_record(&key_to_present_hist,
+                             key_delta > 0 ? (uint64_t)key_delta : 0);
+  }
+
+  atomic_fetch_add_explicit(&frames_presented, 1, memory_order_relaxed);
+  slot_release(slot);
+}
+
+static void
+handle_discarded(void *data,
+                 [[maybe_unused]] struct wp_presentation_feedback *feedback) {
+  atomic_fetch_add_explicit(&frames_discarded, 1, memory_order_relaxed);
+  slot_release((feedback_slot_t *)data);
+}
+
+static const struct wp_presentation_feedback_listener feedback_listener = {
+    .sync_output = handle_sync_output,
+    .presented = handle_presented,
+    .discarded = handle_discarded,
+};
+
+// =============================================================================
+// PUBLIC API IMPLEMENTATION
+// =============================================================================
+
+void presentation_init(struct wp_presentation *presentation) {
+  if (!presentation) {
+    return;
+  }
+
+  wp_presentation_global = presentation;
+  wp_presentation_add_listener(presentation, &presentation_listener, NULL);
+  bongocat_log_debug("Presentation feedback enabled");
+}
+
+void presentation_cleanup(void) {
+  for (size_t i = 0; i < PRESENTATION_MAX_PENDING; i++) {
+    slot_release(&feedback_slots[i]);
+  }
+
+  if (wp_presentation_global) {
+    wp_presentation_destroy(wp_presentation_global);
+    wp_presentation_global = NULL;
+  }
+  presentation_clock = CLOCK_MONOTONIC;
+}
+
+bool presentation_available(void) {
+  return wp_presentation_global != NULL;
+}
+
+void presentation_request_feedback(struct wl_surface *surface,
+                                   int64_t key_event_us) {
+  if (!wp_presentation_global || !surface) {
+    return;
+  }
+
+  feedback_slot_t *slot = NULL;
+  for (size_t i = 0; i < PRESENTATION_MAX_PENDING; i++) {
+    if (!atomic_load(&feedback_slots[i].in_use)) {
+      slot = &feedback_slots[i];
+      break;
+    }
+  }
+  if (!slot) {
+    atomic_fetch_add_explicit(&frames_untracked, 1, memory_order_relaxed);
+    return;
+  }
+
+  // The compositor cannot answer before it receives the commit that follows,
+  // so attaching the listener here on the drawing thread is race-free.
+  slot->feedback = wp_presentation_feedback(wp_presentation_global, surface);
+  if (!slot->feedback) {
+    return;
+  }
+  slot->key_event_us = key_event_us;
+  slot->commit_us = latency_now_us();
+  atomic_store(&slot->in_use, true);
+  wp_presentation_feedback_add_listener(slot->feedback, &feedback_listener,
+                                        slot);
+}
+
+void presentation_get_stats(presentation_stats_t *out) {
+  if (!out) {
+    return;
+  }
+
+  memset(out, 0, sizeof(*out));
+  out->presented =
+      atomic_load_explicit(&frames_presented, memory_order_relaxed);
+  out->discarded =
+      atomic_load_explicit(&frames_discarded, memory_order_relaxed);
+  out->untracked =
+      atomic_load_explicit(&frames_untracked, memory_order_relaxed);
+  out->late = atomic_load_explicit(&frames_late, memory_order_relaxed);
+  out->refresh_ns = (uint32_t)atomic_load_explicit(&last_refresh_ns,
+                                                   memory_order_relaxed);
+  latency_histogram_summarize(&commit_to_present_hist,
+                              &out->commit_to_present);
+  latency_histogram_summarize(&key_to_present_hist, &out->key_to_present);
+}
+
+// Latency expressed in refresh periods, or 0 on variable refresh outputs
+static double to_refresh_cycles(uint64_t value_us, uint32_t refresh_ns) {
+  return refresh_ns > 0 ? (double)value_us * 1000.0 / (double)refresh_ns
+                        : 0.0;
+}
+
+void presentation_report(void) {
+  if (!wp_presentation_global) {
+    bongocat_log_info("Presentation feedback: not supported by compositor");
+    return;
+  }
+
+  presentation_stats_t s;
+  presentation_get_stats(&s);
+
+  uint64_t resolved = s.presented + s.discarded;
+  double late_pct =
+      s.presented > 0 ? 100.0 * (double)s.late / (double)s.presented : 0.0;
+  double refresh_hz =
+      s.refresh_ns > 0 ? 1000000000.0 / (double)s.refresh_ns : 0.0;
+
+  bongocat_log_info("Presentation: %llu of %llu commits presented, %llu "
+                    "discarded, %llu late (%.1f%%), %llu untracked, "
+                    "refresh %.2f Hz",
+                    (unsigned long long)s.presented,
+                    (unsigned long long)resolved,
+                    (unsigned long long)s.discarded,
+                    (unsigned long long)s.late, late_pct,
+                    (unsigned long long)s.untracked, refresh_hz);
+  bongocat_log_info("  commit->present p50=%6lluus p99=%6lluus max=%6lluus",
+                    (unsigned long long)s.commit_to_present.p50_us,
+                    (unsigned long long)s.commit_to_present.p99_us,
+                    (unsigned long long)s.commit_to_present.max_us);
+  bongocat_log_info("  key->present    p50=%6lluus (%.1f refreshes) "
+                    "p99=%6lluus (%.1f refreshes) max=%6lluus",
+                    (unsigned long long)s.key_to_present.p50_us,
+                    to_refresh_cycles(s.key_to_present.p50_us, s.refresh_ns),
+                    (unsigned long long)s.key_to_present.p99_us,
+                    to_refresh_cycles(s.key_to_present.p99_us, s.refresh_ns),
+                    (unsigned long long)s.key_to_present.max_us);
+}
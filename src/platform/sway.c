@@ -0,0 +1,66 @@
+#define _POSIX_C_SOURCE 200809L
+#include "platform/sway.h"
+
+#include "platform/fullscreen.h"
+#include "platform/wayland.h"
+#include "utils/error.h"
+
+#include <sys/un.h>
+
+// =============================================================================
+// SWAY IPC STATE
+// =============================================================================
+
+static sway_session_t sway_session = {.fd = -1};
+
+// =============================================================================
+// EVENT STREAM
+// =============================================================================
+
+static void sway_handle_output(const char *output_name, bool fullscreen,
+                               [[maybe_unused]] void *data) {
+  fullscreen_set_output_state(output_name, fullscreen);
+}
+
+static void sway_fd_ready([[maybe_unused]] int fd,
+                          [[maybe_unused]] void *data) {
+  if (sway_session_dispatch(&sway_session) < 0) {
+    bongocat_log_warning("sway IPC connection closed");
+    sway_events_stop();
+  }
+}
+
+void sway_events_start(void) {
+  if (sway_session.fd >= 0) {
+    return;
+  }
+
+  char path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+  if (!sway_ipc_socket_path(path, sizeof(path))) {
+    return;
+  }
+  if (!sway_session_open(&sway_session, path, sway_handle_output, NULL)) {
+    bongocat_log_debug("sway IPC socket unavailable: %s", path);
+    return;
+  }
+
+  if (wayland_add_fd_source(sway_session.fd, sway_fd_ready, NULL) !=
+      BONGOCAT_SUCCESS) {
+    sway_session_close(&sway_session);
+    return;
+  }
+  bongocat_log_info("Subscribed to sway window and workspace events");
+}
+
+void sway_events_stop(void) {
+  if (sway_session.fd < 0) {
+    return;
+  }
+  wayland_remove_fd_source(sway_session.fd);
+  sway_session_close(&sway_session);
+  fullscreen_clear_output_states();
+}
+
+bool sway_events_active(void) {
+  return sway_session.fd >= 0;
+}
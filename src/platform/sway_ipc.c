@@ -0,0 +1,336 @@
+#define _POSIX_C_SOURCE 200809L
+#include "platform/sway_ipc.h"
+
+#include "utils/error.h"
+#include "utils/json_scan.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define SWAY_MAX_OUTPUTS    16
+#define SWAY_TREE_MAX_DEPTH 64
+#define SWAY_READ_CHUNK     4096
+
+static const char sway_subscription[] = "[\"window\",\"workspace\"]";
+
+// =============================================================================
+// PROTOCOL HELPERS
+// =============================================================================
+
+bool sway_ipc_socket_path(char *out, size_t size) {
+  const char *path = getenv("SWAYSOCK");
+  if (!path || !path[0]) {
+    path = getenv("I3SOCK");
+  }
+  if (!out || size == 0 || !path || !path[0]) {
+    return false;
+  }
+  int n = snprintf(out, size, "%s", path);
+  return n > 0 && (size_t)n < size;
+}
+
+void sway_ipc_encode_header(uint8_t *header, uint32_t type,
+                            uint32_t payload_len) {
+  memcpy(header, SWAY_IPC_MAGIC, SWAY_IPC_MAGIC_LEN);
+  memcpy(header + SWAY_IPC_MAGIC_LEN, &payload_len, sizeof(payload_len));
+  memcpy(header + SWAY_IPC_MAGIC_LEN + 4, &type, sizeof(type));
+}
+
+static bool sway_send(int fd, uint32_t type, const char *payload) {
+  uint8_t msg[SWAY_IPC_HEADER_SIZE + 64];
+  size_t payload_len = payload ? strlen(payload) : 0;
+  if (payload_len > sizeof(msg) - SWAY_IPC_HEADER_SIZE) {
+    return false;
+  }
+
+  sway_ipc_encode_header(msg, type, (uint32_t)payload_len);
+  if (payload_len > 0) {
+    memcpy(msg + SWAY_IPC_HEADER_SIZE, payload, payload_len);
+  }
+
+  // Requests are tiny, so a short write only happens on a broken socket
+  size_t total = SWAY_IPC_HEADER_SIZE + payload_len;
+  ssize_t n;
+  do {
+    n = send(fd, msg, total, MSG_NOSIGNAL | MSG_DONTWAIT);
+  } while (n < 0 && errno == EINTR);
+  return n == (ssize_t)total;
+}
+
+// =============================================================================
+// TREE PARSING
+// =============================================================================
+
+// True if any container below node is fullscreen (and visible, when the
+// visible workspace is not known)
+static bool sway_node_has_fullscreen(const char *node, bool require_visible,
+                                     int depth) {
+  if (depth > SWAY_TREE_MAX_DEPTH) {
+    return false;
+  }
+
+  static const char *const child_keys[] = {"nodes", "floating_nodes"};
+  for (size_t k = 0; k < 2; k++) {
+    for (const char *child =
+             json_array_first(json_object_get(node, child_keys[k]));
+         child; child = json_array_next(child)) {
+      int mode = 0;
+      int visible = 1;
+      if (require_visible) {
+        json_get_int(json_object_get(child, "visible"), &visible);
+      }
+      if (json_get_int(json_object_get(child, "fullscreen_mode"), &mode) &&
+          mode > 0 && visible) {
+        return true;
+      }
+      if (sway_node_has_fullscreen(child, require_visible, depth + 1)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+static bool sway_output_has_fullscreen(const char *output_node) {
+  char current[128];
+  bool current_known = json_get_string(
+      json_object_get(output_node, "current_workspace"), current,
+      sizeof(current));
+
+  for (const char *ws = json_array_first(json_object_get(output_node, "nodes"));
+       ws; ws = json_array_next(ws)) {
+    if (current_known &&
+        !json_string_equals(json_object_get(ws, "name"), current)) {
+      continue;
+    }
+    if (sway_node_has_fullscreen(ws, !current_known, 0)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t sway_parse_tree(const char *json, sway_output_state_t *out,
+                       size_t max) {
+  if (!json || !out) {
+    return 0;
+  }
+
+  size_t count = 0;
+  for (const char *node = json_array_first(json_object_get(json, "nodes"));
+       node && count < max; node = json_array_next(node)) {
+    sway_output_state_t *state = &out[count];
+    if (!json_string_equals(json_object_get(node, "type"), "output") ||
+        !json_get_string(json_object_get(node, "name"), state->name,
+                         sizeof(state->name)) ||
+        strncmp(state->name, "__", 2) == 0) {
+      continue;
+    }
+    state->fullscreen = sway_output_has_fullscreen(node);
+    count++;
+  }
+  return count;
+}
+
+bool sway_event_is_relevant(uint32_t type, const char *json) {
+  const char *change = json_object_get(json, "change");
+  if (type == SWAY_IPC_EVENT_WINDOW) {
+    static const char *const changes[] = {"fullscreen_mode", "focus", "close",
+                                          "move", "new", "floating"};
+    for (size_t i = 0; i < sizeof(changes) / sizeof(changes[0]); i++) {
+      if (json_string_equals(change, changes[i])) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (type == SWAY_IPC_EVENT_WORKSPACE) {
+    return !json_string_equals(change, "rename") &&
+           !json_string_equals(change, "urgent");
+  }
+  return false;
+}
+
+// =============================================================================
+// SESSION
+// =============================================================================
+
+static bool sway_request_tree(sway_session_t *session) {
+  if (session->tree_pending) {
+    session->tree_dirty = true;
+    return true;
+  }
+  if (!sway_send(session->fd, SWAY_IPC_GET_TREE, NULL)) {
+    return false;
+  }
+  session->tree_pending = true;
+  session->tree_dirty = false;
+  return true;
+}
+
+bool sway_session_open(sway_session_t *session, const char *path,
+                       sway_output_handler_t handler, void *data) {
+  if (!session || !path) {
+    return false;
+  }
+  *session = (sway_session_t){.fd = -1, .handler = handler, .data = data};
+
+  struct sockaddr_un addr = {.sun_family = AF_UNIX};
+  if (strlen(path) >= sizeof(addr.sun_path)) {
+    return false;
+  }
+  memcpy(addr.sun_path, path, strlen(path) + 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    return false;
+  }
+  int flags = -1;
+  if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+      (flags = fcntl(fd, F_GETFL)) < 0 ||
+      fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+    close(fd);
+    return false;
+  }
+
+  session->fd = fd;
+  if (!sway_send(fd, SWAY_IPC_SUBSCRIBE, sway_subscription) ||
+      !sway_request_tree(session)) {
+    sway_session_close(session);
+    return false;
+  }
+  return true;
+}
+
+static bool sway_handle_message(sway_session_t *session, uint32_t type,
+                                const char *payload) {
+  switch (type) {
+  case SWAY_IPC_SUBSCRIBE: {
+    int success = 0;
+    if (!json_get_int(json_object_get(payload, "success"), &success) ||
+        !success) {
+      bongocat_log_warning("sway IPC subscription refused");
+      return false;
+    }
+    return true;
+  }
+  case SWAY_IPC_GET_TREE: {
+    sway_output_state_t outputs[SWAY_MAX_OUTPUTS];
+    size_t count = sway_parse_tree(payload, outputs, SWAY_MAX_OUTPUTS);
+    for (size_t i = 0; i < count && session->handler; i++) {
+      session->handler(outputs[i].name, outputs[i].fullscreen,
+                       session->data);
+    }
+    session->tree_pending = false;
+    return !session->tree_dirty || sway_request_tree(session);
+  }
+  case SWAY_IPC_EVENT_SHUTDOWN:
+    return false;
+  default:
+    if (sway_event_is_relevant(type, payload)) {
+      return sway_request_tree(session);
+    }
+    return true;
+  }
+}
+
+// Make room for at least SWAY_READ_CHUNK more bytes (plus the terminator)
+static bool sway_reserve(sway_session_t *session) {
+  if (session->cap - session->len > SWAY_READ_CHUNK) {
+    return true;
+  }
+  size_t limit = SWAY_IPC_HEADER_SIZE + SWAY_IPC_MAX_PAYLOAD + 1;
+  size_t cap = session->cap ? session->cap * 2 : 2 * SWAY_READ_CHUNK;
+  if (cap > limit) {
+    cap = limit;
+  }
+  if (cap <= session->len + 1) {
+    return false;
+  }
+  uint8_t *buf = realloc(session->buf, cap);
+  if (!buf) {
+    return false;
+  }
+  session->buf = buf;
+  session->cap = cap;
+  return true;
+}
+
+int sway_session_dispatch(sway_session_t *session) {
+  if (!session || session->fd < 0) {
+    return -1;
+  }
+
+  int handled = 0;
+  for (;;) {
+    if (!sway_reserve(session)) {
+      bongocat_log_warning("sway IPC message too large");
+      return -1;
+    }
+    ssize_t n = read(session->fd, session->buf + session->len,
+                     session->cap - session->len - 1);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0 && errno == EAGAIN) {
+      return handled;
+    }
+    if (n <= 0) {
+      return -1;
+    }
+    session->len += (size_t)n;
+
+    size_t start = 0;
+    while (session->len - start >= SWAY_IPC_HEADER_SIZE) {
+      const uint8_t *header = session->buf + start;
+      uint32_t payload_len;
+      uint32_t type;
+      memcpy(&payload_len, header + SWAY_IPC_MAGIC_LEN, sizeof(payload_len));
+      memcpy(&type, header + SWAY_IPC_MAGIC_LEN + 4, sizeof(type));
+      if (memcmp(header, SWAY_IPC_MAGIC, SWAY_IPC_MAGIC_LEN) != 0 ||
+          payload_len > SWAY_IPC_MAX_PAYLOAD) {
+        bongocat_log_warning("Corrupt sway IPC stream");
+        return -1;
+      }
+      size_t total = SWAY_IPC_HEADER_SIZE + payload_len;
+      if (session->len - start < total) {
+        break;
+      }
+
+      // Terminate the payload in place for the JSON scanner
+      uint8_t *end = session->buf + start + total;
+      uint8_t saved = *end;
+      *end = '\0';
+      bool ok = sway_handle_message(
+          session, type, (const char *)header + SWAY_IPC_HEADER_SIZE);
+      *end = saved;
+      if (!ok) {
+        return -1;
+      }
+      handled++;
+      start += total;
+    }
+
+    if (start > 0) {
+      memmove(session->buf, session->buf + start, session->len - start);
+      session->len -= start;
+    }
+  }
+}
+
+void sway_session_close(sway_session_t *session) {
+  if (!session) {
+    return;
+  }
+  if (session->fd >= 0) {
+    close(session->fd);
+  }
+  free(session->buf);
+  *session = (sway_session_t){.fd = -1};
+}
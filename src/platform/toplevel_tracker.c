@@ -0,0 +1,135 @@
+#define _POSIX_C_SOURCE 200809L
+#include "platform/toplevel_tracker.h"
+
+#include <stdlib.h>
+
+// =============================================================================
+// ENTRY LIFETIME
+// =============================================================================
+
+toplevel_entry_t *toplevel_tracker_add(toplevel_tracker_t *tracker,
+                                       void *handle) {
+  if (!tracker) {
+    return NULL;
+  }
+
+  toplevel_entry_t *entry = calloc(1, sizeof(*entry));
+  if (!entry) {
+    return NULL;
+  }
+  entry->handle = handle;
+  entry->next = tracker->head;
+  if (tracker->head) {
+    tracker->head->prev = entry;
+  }
+  tracker->head = entry;
+  tracker->count++;
+  return entry;
+}
+
+void toplevel_tracker_remove(toplevel_tracker_t *tracker,
+                             toplevel_entry_t *entry) {
+  if (!tracker || !entry) {
+    return;
+  }
+
+  if (entry->prev) {
+    entry->prev->next = entry->next;
+  } else {
+    tracker->head = entry->next;
+  }
+  if (entry->next) {
+    entry->next->prev = entry->prev;
+  }
+  if (entry->fullscreen) {
+    tracker->fullscreen_count--;
+  }
+  tracker->count--;
+  free(entry);
+}
+
+void toplevel_tracker_clear(toplevel_tracker_t *tracker) {
+  if (!tracker) {
+    return;
+  }
+  toplevel_entry_t *entry = tracker->head;
+  while (entry) {
+    toplevel_entry_t *next = entry->next;
+    free(entry);
+    entry = next;
+  }
+  *tracker = (toplevel_tracker_t){0};
+}
+
+// =============================================================================
+// DOUBLE-BUFFERED STATE
+// =============================================================================
+
+void toplevel_entry_set_state(toplevel_entry_t *entry, bool fullscreen,
+                              bool activated) {
+  if (!entry) {
+    return;
+  }
+  entry->pending_fullscreen = fullscreen;
+  entry->pending_activated = activated;
+}
+
+void toplevel_entry_output_enter(toplevel_entry_t *entry, void *output) {
+  if (!entry) {
+    return;
+  }
+  entry->pending_output = output;
+}
+
+void toplevel_entry_output_leave(toplevel_entry_t *entry, void *output) {
+  if (!entry || entry->pending_output != output) {
+    return;
+  }
+  entry->pending_output = NULL;
+}
+
+bool toplevel_tracker_commit(toplevel_tracker_t *tracker,
+                             toplevel_entry_t *entry,
+                             toplevel_change_t *change) {
+  if (!tracker || !entry || !change) {
+    return false;
+  }
+
+  *change = (toplevel_change_t){
+      .state_changed = entry->fullscreen != entry->pending_fullscreen ||
+                       entry->activated != entry->pending_activated,
+      .output_changed = entry->output != entry->pending_output,
+      .was_fullscreen = entry->fullscreen,
+      .was_activated = entry->activated,
+      .old_output = entry->output,
+  };
+  if (!change->state_changed && !change->output_changed) {
+    return false;
+  }
+
+  if (entry->fullscreen != entry->pending_fullscreen) {
+    if (entry->pending_fullscreen) {
+      tracker->fullscreen_count++;
+    } else {
+      tracker->fullscreen_count--;
+    }
+  }
+  entry->fullscreen = entry->pending_fullscreen;
+  entry->activated = entry->pending_activated;
+  entry->output = entry->pending_output;
+  return true;
+}
+
+bool toplevel_tracker_output_has_fullscreen(const toplevel_tracker_t *tracker,
+                                            const void *output) {
+  if (!tracker || !output || tracker->fullscreen_count == 0) {
+    return false;
+  }
+  for (const toplevel_entry_t *entry = tracker->head; entry;
+       entry = entry->next) {
+    if (entry->output == output && entry->fullscreen) {
+      return true;
+    }
+  }
+  return false;
+}
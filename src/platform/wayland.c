@@ -6,18 +6,32 @@
 #  pragma GCC diagnostic push
 #  pragma GCC diagnostic ignored "-Wshadow"
 #endif
+#include "../protocols/ext-idle-notify-v1-client-protocol.h"
+#include "../protocols/presentation-time-client-protocol.h"
 #include "../protocols/wlr-foreign-toplevel-management-v1-client-protocol.h"
+#include "../protocols/wlr-output-power-management-v1-client-protocol.h"
 #include "../protocols/xdg-output-unstable-v1-client-protocol.h"
 #if defined(__GNUC__)
 #  pragma GCC diagnostic pop
 #endif
 #include "graphics/animation.h"
+#include "graphics/render_backend.h"
+#include "graphics/render_state.h"
 #include "platform/fullscreen.h"
 #include "platform/hyprland.h"
+#include "platform/output_bars.h"
+#include "platform/power.h"
+#include "platform/presentation.h"
+#include "utils/latency.h"
+#include "utils/memory.h"
+#include "utils/metrics.h"
+#include "utils/trace.h"
 
 #include <poll.h>
 #include <signal.h>
 #include <stdatomic.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/time.h>
 
 // =============================================================================
@@ -27,6 +41,7 @@
 // Wayland globals
 atomic_bool configured = false;
 atomic_bool fullscreen_detected = false;
+static atomic_bool primary_unmapped = false;
 struct wl_display *display;
 struct wl_compositor *compositor;
 struct wl_shm *shm;
@@ -41,6 +56,23 @@ static size_t pixel_buffer_size = 0;
 
 static config_t *current_config;
 static void (*tick_callback_fn)(void) = NULL;
+// Wakes the event loop for reloads, signals and shutdown (no poll timeout)
+static atomic_int loop_wake_fd = -1;
+
+// Event loop: one epoll set holding the display fd, the wake eventfd and any
+// extra fd sources registered by other modules
+#define MAX_FD_SOURCES 8
+typedef struct {
+  int fd;
+  wayland_fd_handler_t handler;
+  void *data;
+} fd_source_t;
+static int loop_epoll_fd = -1;
+static fd_source_t fd_sources[MAX_FD_SOURCES];
+static bool loop_display_wants_write = false;
+// Distinct addresses tag the display and wake fds in epoll_event.data.ptr
+static char loop_display_tag;
+static char loop_wake_tag;
 static int applied_width = 0;
 static int applied_height = 0;
 static layer_type_t applied_layer = LAYER_TOP;
@@ -138,6 +170,9 @@ handle_xdg_output_name(void *data,
   oref->name_received = true;
   bongocat_log_debug("xdg-output name received: %s", name);
 
+  // A monitor served by an extra bar (shared multi-monitor mode)
+  output_bars_output_named(oref);
+
   // Check if this is the output we're waiting for (reconnection case)
   if (!atomic_load(&output_lost) || !current_config) {
     return;
@@ -158,6 +193,9 @@ handle_xdg_output_name(void *data,
   if (should_reconnect) {
     bongocat_log_info("Target output '%s' reconnected!", name);
 
+    // Wait out in-flight draws before the surface goes away
+    render_state_retire();
+
     // Clean up old surface if it exists
     if (layer_surface) {
       zwlr_layer_surface_v1_destroy(layer_surface);
@@ -176,9 +214,10 @@ handle_xdg_output_name(void *data,
 
     // Recreate surface on new output
     // Note: wayland_setup_surface already commits, triggering a configure
-    // event. The layer_surface_configure callback will ack and call draw_bar()
-    // to render.
+    // event. The layer_surface_configure callback will ack and request a
+    // redraw.
     if (wayland_setup_surface() == BONGOCAT_SUCCESS) {
+      wayland_publish_render_state();
       // Wait for configure event to be processed
       wl_display_roundtrip(display);
       wayland_update_current_output_info();
@@ -289,86 +328,171 @@ int create_shm(int size) {
   return fd;
 }
 
-void draw_bar(void) {
-  if (!atomic_load(&configured)) {
-    bongocat_log_debug("Surface not configured yet, skipping draw");
+void wayland_publish_render_state(void) {
+  if (!current_config) {
     return;
   }
 
-  pthread_mutex_lock(&anim_lock);
-
-  // Critical null checks - prevent crash during buffer recreation
-  if (!current_config || !pixels || !surface || !buffer) {
-    bongocat_log_debug("Config or pixels not ready, skipping draw");
-    pthread_mutex_unlock(&anim_lock);
+  int64_t span = trace_begin();
+  render_snapshot_t *snap = render_snapshot_create(current_config);
+  if (!snap) {
+    // Keep drawing with the previous snapshot
     return;
   }
 
-  // Skip fullscreen hiding when layer is LAYER_OVERLAY (always visible)
-  bool is_overlay_layer = current_config->layer == LAYER_OVERLAY;
-  bool is_fullscreen = !is_overlay_layer &&
-                       !current_config->disable_fullscreen_hide &&
-                       atomic_load(&fullscreen_detected);
-  int effective_opacity = is_fullscreen ? 0 : current_config->overlay_opacity;
-
-  // Clear buffer with transparency - OPTIMIZED
-  // Write all pixels as 32-bit values: RGB=0, A=opacity
-  size_t buffer_size = (size_t)current_config->screen_width *
-                       (size_t)current_config->overlay_height * 4U;
-  memset(pixels, 0, buffer_size);
-
-  if (effective_opacity > 0) {
-    uint32_t fill = (uint32_t)effective_opacity << 24;
-    uint32_t *px = (uint32_t *)pixels;
-    size_t pixel_count = buffer_size / 4;
-    for (size_t i = 0; i < pixel_count; i++) {
-      px[i] = fill;
-    }
+  // One frame cache serves every output: the cat is the same size on all
+  int cat_h = current_config->cat_height;
+  int cat_w = (cat_h * CAT_IMAGE_WIDTH) / CAT_IMAGE_HEIGHT;
+  snap->frame_set = frame_cache_acquire(cat_w, cat_h, current_config->mirror_x,
+                                        current_config->mirror_y);
+
+  if (surface && buffer && pixels) {
+    render_target_t primary = {
+        .surface = surface,
+        .buffer = buffer,
+        .pixels = pixels,
+        .width = current_config->screen_width,
+        .configured = &configured,
+        .fullscreen = &fullscreen_detected,
+        .unmapped = &primary_unmapped,
+        .powered_off = power_output_off_flag(output),
+    };
+    render_snapshot_add_target(snap, &primary);
   }
+  output_bars_add_targets(snap);
 
-  // Draw cat if visible
-  if (!is_fullscreen) {
-    int cat_height = current_config->cat_height;
-    int cat_width = (cat_height * CAT_IMAGE_WIDTH) / CAT_IMAGE_HEIGHT;
-    int cat_y = (current_config->overlay_height - cat_height) / 2 +
-                current_config->cat_y_offset;
+  render_state_publish(snap);
+  animation_request_redraw();
+  trace_end("publish snapshot", span);
+}
 
-    int cat_x = 0;
-    switch (current_config->cat_align) {
-    case ALIGN_CENTER:
-      cat_x = (current_config->screen_width - cat_width) / 2 +
-              current_config->cat_x_offset;
-      break;
-    case ALIGN_LEFT:
-      cat_x = current_config->cat_x_offset;
-      break;
-    case ALIGN_RIGHT:
-      cat_x = current_config->screen_width - cat_width -
-              current_config->cat_x_offset;
-      break;
+// Unmap a target hidden by a fullscreen window, or map it again once the
+// window is gone. Returns true if the target is (or stays) out of the draw:
+// hidden, or waiting for the configure that follows remapping. Sets
+// *committed when it committed the surface.
+static bool update_target_mapping(const render_snapshot_t *snap,
+                                  const render_target_t *target,
+                                  bool *committed) {
+  if (!target->surface || !target->unmapped) {
+    return false;
+  }
+
+  bool hidden = render_target_is_hidden(snap, target);
+  bool unmapped = atomic_load(target->unmapped);
+  if (hidden == unmapped) {
+    return hidden;
+  }
+
+  if (hidden) {
+    // Attaching NULL unmaps the layer surface: the compositor stops
+    // compositing it and no buffer is redrawn until it is shown again.
+    // Before the first configure there is nothing to unmap yet.
+    if (!atomic_load(target->configured)) {
+      return true;
     }
+    bongocat_log_debug("Cat hidden due to fullscreen detection");
+    wl_surface_attach(target->surface, NULL, 0, 0);
+    wl_surface_commit(target->surface);
+    atomic_store(target->unmapped, true);
+    *committed = true;
+    return true;
+  }
+
+  // An unmapped layer surface is back in its initial state: commit without
+  // a buffer and wait for the configure, which requests the next redraw
+  bongocat_log_debug("Fullscreen cleared, mapping surface again");
+  atomic_store(target->configured, false);
+  atomic_store(target->unmapped, false);
+  wl_surface_commit(target->surface);
+  *committed = true;
+  return true;
+}
 
-    cached_frame_t *frame = &anim_cached_frames[anim_index];
-    if (frame->data && frame->width > 0 && frame->height > 0) {
-      // Blit pre-scaled cached frame (already BGRA, no channel swap)
-      blit_cached_frame(pixels, current_config->screen_width,
-                        current_config->overlay_height, frame->data,
-                        frame->width, frame->height, cat_x, cat_y);
+// =============================================================================
+// WAYLAND RENDER BACKEND
+// =============================================================================
+
+static bool wayland_begin_target([[maybe_unused]] void *ctx,
+                                 const render_snapshot_t *snap,
+                                 const render_target_t *target,
+                                 bool *committed) {
+  if (update_target_mapping(snap, target, committed) ||
+      render_target_is_powered_off(target)) {
+    return false;
+  }
+  return atomic_load(target->configured) && target->surface &&
+         target->buffer;
+}
+
+static void wayland_present_target([[maybe_unused]] void *ctx,
+                                   const render_snapshot_t *snap,
+                                   size_t index, bool first) {
+  const render_target_t *target = &snap->targets[index];
+  latency_sample_mark(LATENCY_STAGE_BLIT);
+
+  wl_surface_attach(target->surface, target->buffer, 0, 0);
+  wl_surface_damage_buffer(target->surface, 0, 0, target->width,
+                           target->height);
+  // Presentation feedback is requested for the first committed surface
+  // only, so there is one latency sample per redraw however many outputs
+  // are drawn
+  if (first) {
+    presentation_request_feedback(target->surface, latency_sample_event_us());
+  }
+  wl_surface_commit(target->surface);
+}
+
+static void wayland_end_frame([[maybe_unused]] void *ctx, size_t presented,
+                              bool committed) {
+  if (presented == 0) {
+    if (committed) {
+      wl_display_flush(display);
     } else {
-      bongocat_log_debug("Frame %d cache not ready, skipping draw", anim_index);
+      bongocat_log_debug("Surface not configured yet, skipping draw");
     }
-  } else {
-    bongocat_log_debug("Cat hidden due to fullscreen detection");
+    return;
   }
+  latency_sample_mark(LATENCY_STAGE_COMMIT);
 
-  wl_surface_attach(surface, buffer, 0, 0);
-  wl_surface_damage_buffer(surface, 0, 0, current_config->screen_width,
-                           current_config->overlay_height);
-  wl_surface_commit(surface);
-  pthread_mutex_unlock(&anim_lock);
-
-  // Flush outside the lock -- may block on write() syscall
+  // May block on write() syscall
+  int64_t span = trace_begin();
   wl_display_flush(display);
+  trace_end("wl_display_flush", span);
+  latency_sample_mark(LATENCY_STAGE_FLUSH);
+  latency_sample_finish();
+}
+
+static const render_backend_t wayland_backend = {
+    .name = "wayland",
+    .begin_target = wayland_begin_target,
+    .present_target = wayland_present_target,
+    .end_frame = wayland_end_frame,
+};
+
+void draw_bar(void) {
+  // Everything below reads the snapshot only: no lock, and a reload
+  // publishing a new snapshot meanwhile cannot change it under us
+  render_snapshot_t *snap = render_state_acquire();
+  if (!snap || snap->num_targets == 0) {
+    bongocat_log_debug("Render state not ready, skipping draw");
+    render_snapshot_release(snap);
+    metrics_add(METRIC_FRAMES_SKIPPED, 1);
+    return;
+  }
+
+  // All outputs show the same frame
+  int64_t start_us = latency_now_us();
+  int64_t span = trace_begin();
+  size_t presented =
+      render_frame(&wayland_backend, snap, atomic_load(&anim_index));
+  render_snapshot_release(snap);
+  trace_end_arg("draw", span, (int64_t)presented);
+  if (presented > 0) {
+    metrics_add(METRIC_FRAMES_DRAWN, 1);
+    metrics_record_draw((uint64_t)(latency_now_us() - start_us));
+  } else {
+    metrics_add(METRIC_FRAMES_SKIPPED, 1);
+  }
 }
 
 // =============================================================================
@@ -381,7 +505,7 @@ static void layer_surface_configure([[maybe_unused]] void *data,
   bongocat_log_debug("Layer surface configured: %dx%d", w, h);
   zwlr_layer_surface_v1_ack_configure(ls, serial);
   atomic_store(&configured, true);
-  draw_bar();
+  animation_request_redraw();
 }
 
 // Handle compositor-requested surface closure
@@ -502,9 +626,10 @@ static void registry_global([[maybe_unused]] void *data,
       wl_output_add_listener(outputs[output_count].wl_output, &output_listener,
                              NULL);
 
-      // If we lost our output, get xdg_output to check if this is the one
-      // reconnecting
-      if (atomic_load(&output_lost) && xdg_output_manager) {
+      // If we lost our output or extra bars wait for theirs, get xdg_output
+      // to check if this is one reconnecting
+      if ((atomic_load(&output_lost) || output_bars_active()) &&
+          xdg_output_manager) {
         outputs[output_count].xdg_output =
             zxdg_output_manager_v1_get_xdg_output(
                 xdg_output_manager, outputs[output_count].wl_output);
@@ -512,8 +637,7 @@ static void registry_global([[maybe_unused]] void *data,
         zxdg_output_v1_add_listener(outputs[output_count].xdg_output,
                                     &xdg_output_listener,
                                     &outputs[output_count]);
-        bongocat_log_debug(
-            "New output appeared while output_lost, checking name...");
+        bongocat_log_debug("New output appeared, checking name...");
       }
 
       output_count++;
@@ -525,6 +649,21 @@ static void registry_global([[maybe_unused]] void *data,
             reg, name, &zwlr_foreign_toplevel_manager_v1_interface,
             BIND_MIN_VER(ver, 3));
     fullscreen_init(fs_manager);
+  } else if (strcmp(iface, wp_presentation_interface.name) == 0) {
+    presentation_init((struct wp_presentation *)wl_registry_bind(
+        reg, name, &wp_presentation_interface, BIND_MIN_VER(ver, 1)));
+  } else if (strcmp(iface, ext_idle_notifier_v1_interface.name) == 0) {
+    power_bind_idle_notifier((struct ext_idle_notifier_v1 *)wl_registry_bind(
+        reg, name, &ext_idle_notifier_v1_interface, BIND_MIN_VER(ver, 1)));
+  } else if (strcmp(iface, wl_seat_interface.name) == 0) {
+    power_bind_seat((struct wl_seat *)wl_registry_bind(
+        reg, name, &wl_seat_interface, BIND_MIN_VER(ver, 1)));
+  } else if (strcmp(iface, zwlr_output_power_manager_v1_interface.name) ==
+             0) {
+    power_bind_output_power_manager(
+        (struct zwlr_output_power_manager_v1 *)wl_registry_bind(
+            reg, name, &zwlr_output_power_manager_v1_interface,
+            BIND_MIN_VER(ver, 1)));
   }
 
 #undef BIND_MIN_VER
@@ -556,6 +695,10 @@ static void registry_remove([[maybe_unused]] void *data,
     current_output_info = NULL;
   }
 
+  // Drop an extra bar on this output before the wl_output goes away
+  output_bars_output_removed(outputs[removed_index].wl_output);
+  power_output_removed(outputs[removed_index].wl_output);
+
   if (outputs[removed_index].xdg_output) {
     zxdg_output_v1_destroy(outputs[removed_index].xdg_output);
     outputs[removed_index].xdg_output = NULL;
@@ -671,6 +814,8 @@ static bongocat_error_t wayland_setup_protocols(void) {
 
     hypr_update_outputs_with_monitor_ids();
   }
+  fullscreen_backends_start();
+  power_apply_config(current_config);
 
   wayland_update_output();
 
@@ -704,63 +849,86 @@ static bongocat_error_t wayland_setup_protocols(void) {
   return BONGOCAT_SUCCESS;
 }
 
-static bongocat_error_t wayland_setup_surface(void) {
-  if (!current_config) {
-    bongocat_log_error("Cannot setup surface: config is NULL");
-    return BONGOCAT_ERROR_INVALID_PARAM;
-  }
+bongocat_error_t wayland_create_layer_surface(
+    struct wl_output *wl_output, const config_t *config,
+    const struct zwlr_layer_surface_v1_listener *listener, void *data,
+    struct wl_surface **out_surface,
+    struct zwlr_layer_surface_v1 **out_layer_surface) {
+  BONGOCAT_CHECK_NULL(config, BONGOCAT_ERROR_INVALID_PARAM);
+  BONGOCAT_CHECK_NULL(out_surface, BONGOCAT_ERROR_INVALID_PARAM);
+  BONGOCAT_CHECK_NULL(out_layer_surface, BONGOCAT_ERROR_INVALID_PARAM);
 
   uint32_t wl_layer = ZWLR_LAYER_SHELL_V1_LAYER_TOP;
-  if (current_config && current_config->layer == LAYER_OVERLAY) {
+  if (config->layer == LAYER_OVERLAY) {
     wl_layer = ZWLR_LAYER_SHELL_V1_LAYER_OVERLAY;
   }
 
-  surface = wl_compositor_create_surface(compositor);
-  if (!surface) {
+  struct wl_surface *new_surface = wl_compositor_create_surface(compositor);
+  if (!new_surface) {
     bongocat_log_error("Failed to create surface");
     return BONGOCAT_ERROR_WAYLAND;
   }
 
-  layer_surface = zwlr_layer_shell_v1_get_layer_surface(
-      layer_shell, surface, output, wl_layer, "bongocat-overlay");
-
-  if (!layer_surface) {
+  struct zwlr_layer_surface_v1 *new_layer_surface =
+      zwlr_layer_shell_v1_get_layer_surface(layer_shell, new_surface,
+                                            wl_output, wl_layer,
+                                            "bongocat-overlay");
+  if (!new_layer_surface) {
     bongocat_log_error("Failed to create layer surface");
+    wl_surface_destroy(new_surface);
     return BONGOCAT_ERROR_WAYLAND;
   }
 
   // Configure layer surface
   uint32_t anchor =
       ZWLR_LAYER_SURFACE_V1_ANCHOR_LEFT | ZWLR_LAYER_SURFACE_V1_ANCHOR_RIGHT;
-  if (current_config->overlay_position == POSITION_TOP) {
+  if (config->overlay_position == POSITION_TOP) {
     anchor |= ZWLR_LAYER_SURFACE_V1_ANCHOR_TOP;
   } else {
     anchor |= ZWLR_LAYER_SURFACE_V1_ANCHOR_BOTTOM;
   }
 
-  zwlr_layer_surface_v1_set_anchor(layer_surface, anchor);
-  zwlr_layer_surface_v1_set_size(layer_surface, 0,
-                                 current_config->overlay_height);
-  zwlr_layer_surface_v1_set_exclusive_zone(layer_surface, -1);
+  zwlr_layer_surface_v1_set_anchor(new_layer_surface, anchor);
+  zwlr_layer_surface_v1_set_size(new_layer_surface, 0,
+                                 (uint32_t)config->overlay_height);
+  zwlr_layer_surface_v1_set_exclusive_zone(new_layer_surface, -1);
   zwlr_layer_surface_v1_set_keyboard_interactivity(
-      layer_surface, ZWLR_LAYER_SURFACE_V1_KEYBOARD_INTERACTIVITY_NONE);
-  zwlr_layer_surface_v1_add_listener(layer_surface, &layer_listener, NULL);
+      new_layer_surface, ZWLR_LAYER_SURFACE_V1_KEYBOARD_INTERACTIVITY_NONE);
+  zwlr_layer_surface_v1_add_listener(new_layer_surface, listener, data);
 
   // Make surface click-through
   struct wl_region *input_region = wl_compositor_create_region(compositor);
   if (input_region) {
-    wl_surface_set_input_region(surface, input_region);
+    wl_surface_set_input_region(new_surface, input_region);
     wl_region_destroy(input_region);
   }
 
-  wl_surface_commit(surface);
+  wl_surface_commit(new_surface);
+  *out_surface = new_surface;
+  *out_layer_surface = new_layer_surface;
   return BONGOCAT_SUCCESS;
 }
 
-static bongocat_error_t wayland_setup_buffer(void) {
-  size_t size = (size_t)current_config->screen_width *
-                (size_t)current_config->overlay_height * 4U;
-  if (size == 0 || size > (size_t)INT32_MAX) {
+static bongocat_error_t wayland_setup_surface(void) {
+  if (!current_config) {
+    bongocat_log_error("Cannot setup surface: config is NULL");
+    return BONGOCAT_ERROR_INVALID_PARAM;
+  }
+
+  return wayland_create_layer_surface(output, current_config, &layer_listener,
+                                      NULL, &surface, &layer_surface);
+}
+
+bongocat_error_t wayland_create_shm_buffer(int width, int height,
+                                           struct wl_buffer **out_buffer,
+                                           uint8_t **out_pixels,
+                                           size_t *out_size) {
+  BONGOCAT_CHECK_NULL(out_buffer, BONGOCAT_ERROR_INVALID_PARAM);
+  BONGOCAT_CHECK_NULL(out_pixels, BONGOCAT_ERROR_INVALID_PARAM);
+  BONGOCAT_CHECK_NULL(out_size, BONGOCAT_ERROR_INVALID_PARAM);
+
+  size_t size = (size_t)width * (size_t)height * 4U;
+  if (width <= 0 || height <= 0 || size > (size_t)INT32_MAX) {
     bongocat_log_error("Invalid buffer size: %zu", size);
     return BONGOCAT_ERROR_WAYLAND;
   }
@@ -770,50 +938,87 @@ static bongocat_error_t wayland_setup_buffer(void) {
     return BONGOCAT_ERROR_WAYLAND;
   }
 
-  pixels =
+  uint8_t *map =
       (uint8_t *)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
-  if (pixels == MAP_FAILED) {
+  if (map == MAP_FAILED) {
     bongocat_log_error("Failed to map shared memory: %s", strerror(errno));
     close(fd);
     return BONGOCAT_ERROR_MEMORY;
   }
-  pixel_buffer_size = size;
 
   struct wl_shm_pool *pool = wl_shm_create_pool(shm, fd, (int)size);
   if (!pool) {
     bongocat_log_error("Failed to create shared memory pool");
-    munmap(pixels, size);
-    pixels = NULL;
+    munmap(map, size);
     close(fd);
     return BONGOCAT_ERROR_WAYLAND;
   }
 
-  buffer = wl_shm_pool_create_buffer(
-      pool, 0, current_config->screen_width, current_config->overlay_height,
-      current_config->screen_width * 4, WL_SHM_FORMAT_ARGB8888);
-  if (!buffer) {
+  struct wl_buffer *new_buffer = wl_shm_pool_create_buffer(
+      pool, 0, width, height, width * 4, WL_SHM_FORMAT_ARGB8888);
+  wl_shm_pool_destroy(pool);
+  close(fd);
+  if (!new_buffer) {
     bongocat_log_error("Failed to create buffer");
-    wl_shm_pool_destroy(pool);
-    munmap(pixels, size);
-    pixels = NULL;
-    close(fd);
+    munmap(map, size);
     return BONGOCAT_ERROR_WAYLAND;
   }
 
-  wl_shm_pool_destroy(pool);
-  close(fd);
+  *out_buffer = new_buffer;
+  *out_pixels = map;
+  *out_size = size;
+  memory_track_external(MEMORY_TAG_WAYLAND, size);
   return BONGOCAT_SUCCESS;
 }
 
+void wayland_unmap_shm_buffer(uint8_t *map, size_t size) {
+  if (!map || size == 0) {
+    return;
+  }
+  munmap(map, size);
+  memory_untrack_external(MEMORY_TAG_WAYLAND, size);
+}
+
+static bongocat_error_t wayland_setup_buffer(void) {
+  return wayland_create_shm_buffer(current_config->screen_width,
+                                   current_config->overlay_height, &buffer,
+                                   &pixels, &pixel_buffer_size);
+}
+
 bongocat_error_t wayland_init(config_t *config) {
   BONGOCAT_CHECK_NULL(config, BONGOCAT_ERROR_INVALID_PARAM);
 
   current_config = config;
   bongocat_log_info("Initializing Wayland connection");
 
+  int wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wake_fd < 0) {
+    bongocat_log_error("Failed to create event loop eventfd: %s",
+                       strerror(errno));
+    return BONGOCAT_ERROR_WAYLAND;
+  }
+  atomic_store(&loop_wake_fd, wake_fd);
+
   display = wl_display_connect(NULL);
   if (!display) {
     bongocat_log_error("Failed to connect to Wayland display");
+    wayland_cleanup();
+    return BONGOCAT_ERROR_WAYLAND;
+  }
+
+  for (size_t i = 0; i < MAX_FD_SOURCES; i++) {
+    fd_sources[i].fd = -1;
+  }
+  loop_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  struct epoll_event display_ev = {.events = EPOLLIN,
+                                   .data.ptr = &loop_display_tag};
+  struct epoll_event wake_ev = {.events = EPOLLIN, .data.ptr = &loop_wake_tag};
+  if (loop_epoll_fd < 0 ||
+      epoll_ctl(loop_epoll_fd, EPOLL_CTL_ADD, wl_display_get_fd(display),
+                &display_ev) < 0 ||
+      epoll_ctl(loop_epoll_fd, EPOLL_CTL_ADD, wake_fd, &wake_ev) < 0) {
+    bongocat_log_error("Failed to set up event loop: %s", strerror(errno));
+    wayland_cleanup();
     return BONGOCAT_ERROR_WAYLAND;
   }
 
@@ -825,6 +1030,9 @@ bongocat_error_t wayland_init(config_t *config) {
     return result;
   }
 
+  // Extra bars for multi_monitor_mode=shared
+  output_bars_sync(current_config);
+
   applied_width = current_config->screen_width;
   applied_height = current_config->overlay_height;
   applied_layer = current_config->layer;
@@ -843,6 +1051,21 @@ bongocat_error_t wayland_init(config_t *config) {
   return BONGOCAT_SUCCESS;
 }
 
+// Only wait for the display fd to become writable while a flush is pending
+static void loop_flush_display(void) {
+  bool wants_write = wl_display_flush(display) < 0 && errno == EAGAIN;
+  if (wants_write == loop_display_wants_write) {
+    return;
+  }
+
+  struct epoll_event ev = {.events = EPOLLIN | (wants_write ? EPOLLOUT : 0),
+                           .data.ptr = &loop_display_tag};
+  if (epoll_ctl(loop_epoll_fd, EPOLL_CTL_MOD, wl_display_get_fd(display),
+                &ev) == 0) {
+    loop_display_wants_write = wants_write;
+  }
+}
+
 bongocat_error_t wayland_run(volatile sig_atomic_t *running) {
   BONGOCAT_CHECK_NULL(running, BONGOCAT_ERROR_INVALID_PARAM);
 
@@ -853,12 +1076,6 @@ bongocat_error_t wayland_run(volatile sig_atomic_t *running) {
       tick_callback_fn();
     }
 
-    // Handle Wayland events
-    struct pollfd pfd = {
-        .fd = wl_display_get_fd(display),
-        .events = POLLIN,
-    };
-
     while (wl_display_prepare_read(display) != 0) {
       if (wl_display_dispatch_pending(display) == -1) {
         bongocat_log_error("Failed to dispatch pending events");
@@ -866,31 +1083,135 @@ bongocat_error_t wayland_run(volatile sig_atomic_t *running) {
       }
     }
 
-    int poll_result = poll(&pfd, 1, 100);
+    // Flush requests queued by the dispatch above before going to sleep
+    loop_flush_display();
 
-    if (poll_result > 0) {
+    // Re-check after the flush: a signal may have arrived in the meantime and
+    // its wake is only guaranteed to be seen by the wait below
+    if (!*running) {
+      wl_display_cancel_read(display);
+      break;
+    }
+
+    // Block until the compositor sends events, an fd source is readable or
+    // someone calls wayland_wake(); an idle loop never wakes.
+    struct epoll_event events[MAX_FD_SOURCES + 2];
+    int64_t span = trace_begin();
+    int n = epoll_wait(loop_epoll_fd, events, MAX_FD_SOURCES + 2, -1);
+    trace_end("epoll_wait", span);
+    metrics_count_wakeup(METRICS_THREAD_MAIN);
+    if (n < 0) {
+      wl_display_cancel_read(display);
+      if (errno == EINTR) {
+        continue;
+      }
+      bongocat_log_error("Event loop wait failed: %s", strerror(errno));
+      return BONGOCAT_ERROR_WAYLAND;
+    }
+
+    bool display_readable = false;
+    bool display_closed = false;
+    for (int i = 0; i < n; i++) {
+      if (events[i].data.ptr == &loop_display_tag) {
+        display_readable = events[i].events & EPOLLIN;
+        display_closed = events[i].events & (EPOLLERR | EPOLLHUP);
+      } else if (events[i].data.ptr == &loop_wake_tag) {
+        uint64_t val;
+        if (read(atomic_load(&loop_wake_fd), &val, sizeof(val)) < 0) {
+          // Best-effort drain; ignore errors
+        }
+      }
+    }
+
+    // Finish the prepared read before running other handlers, which may
+    // issue requests of their own
+    if (display_readable) {
+      span = trace_begin();
       if (wl_display_read_events(display) == -1 ||
           wl_display_dispatch_pending(display) == -1) {
         bongocat_log_error("Failed to handle Wayland events");
         return BONGOCAT_ERROR_WAYLAND;
       }
-    } else if (poll_result == 0) {
-      wl_display_cancel_read(display);
+      trace_end("dispatch", span);
     } else {
       wl_display_cancel_read(display);
-      if (errno != EINTR) {
-        bongocat_log_error("Poll error: %s", strerror(errno));
-        return BONGOCAT_ERROR_WAYLAND;
+    }
+
+    if (display_closed) {
+      bongocat_log_error("Wayland display connection closed");
+      return BONGOCAT_ERROR_WAYLAND;
+    }
+
+    for (int i = 0; i < n; i++) {
+      fd_source_t *source = events[i].data.ptr;
+      if (events[i].data.ptr == &loop_display_tag ||
+          events[i].data.ptr == &loop_wake_tag) {
+        continue;
+      }
+      // The handler of an earlier event may have removed this source
+      if (source->handler) {
+        span = trace_begin();
+        source->handler(source->fd, source->data);
+        trace_end("fd handler", span);
       }
     }
 
-    wl_display_flush(display);
+    loop_flush_display();
   }
 
   bongocat_log_info("Wayland event loop exited");
   return BONGOCAT_SUCCESS;
 }
 
+bongocat_error_t wayland_add_fd_source(int fd, wayland_fd_handler_t handler,
+                                       void *data) {
+  BONGOCAT_CHECK_NULL(handler, BONGOCAT_ERROR_INVALID_PARAM);
+  if (fd < 0 || loop_epoll_fd < 0) {
+    return BONGOCAT_ERROR_INVALID_PARAM;
+  }
+
+  for (size_t i = 0; i < MAX_FD_SOURCES; i++) {
+    if (fd_sources[i].fd >= 0) {
+      continue;
+    }
+
+    struct epoll_event ev = {.events = EPOLLIN, .data.ptr = &fd_sources[i]};
+    if (epoll_ctl(loop_epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+      bongocat_log_error("Failed to add fd %d to event loop: %s", fd,
+                         strerror(errno));
+      return BONGOCAT_ERROR_WAYLAND;
+    }
+    fd_sources[i] = (fd_source_t){.fd = fd, .handler = handler, .data = data};
+    return BONGOCAT_SUCCESS;
+  }
+
+  bongocat_log_error("Too many event loop fd sources (max %d)",
+                     MAX_FD_SOURCES);
+  return BONGOCAT_ERROR_WAYLAND;
+}
+
+void wayland_remove_fd_source(int fd) {
+  for (size_t i = 0; i < MAX_FD_SOURCES; i++) {
+    if (fd_sources[i].fd == fd && fd >= 0) {
+      if (loop_epoll_fd >= 0) {
+        epoll_ctl(loop_epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+      }
+      fd_sources[i] = (fd_source_t){.fd = -1, .handler = NULL, .data = NULL};
+    }
+  }
+}
+
+void wayland_wake(void) {
+  // Async-signal-safe: called from signal handlers and other threads
+  int fd = atomic_load(&loop_wake_fd);
+  if (fd >= 0) {
+    uint64_t val = 1;
+    if (write(fd, &val, sizeof(val)) < 0) {
+      // Counter already non-zero is enough to wake the loop
+    }
+  }
+}
+
 // =============================================================================
 // PUBLIC API IMPLEMENTATION
 // =============================================================================
@@ -945,11 +1266,13 @@ void wayland_update_config(config_t *config) {
 
   current_config = config;
 
+  // Extra bars first: every path below publishes a new snapshot
+  power_apply_config(config);
+  output_bars_sync(config);
+
   int old_height = applied_height;
   int old_width = applied_width;
   layer_type_t old_layer = applied_layer;
-  char *old_output_name =
-      applied_output_name ? strdup(applied_output_name) : NULL;
   int new_width = wayland_get_new_screen_width();
 
   bool dimensions_changed = (old_height != config->overlay_height) ||
@@ -961,9 +1284,9 @@ void wayland_update_config(config_t *config) {
   bool layer_changed = (old_layer != config->layer);
   bool position_changed = (applied_position != config->overlay_position);
   bool output_name_changed =
-      ((old_output_name == NULL) != (config->output_name == NULL)) ||
-      (old_output_name && config->output_name &&
-       strcmp(old_output_name, config->output_name) != 0);
+      ((applied_output_name == NULL) != (config->output_name == NULL)) ||
+      (applied_output_name && config->output_name &&
+       strcmp(applied_output_name, config->output_name) != 0);
   bool bound_output_changed =
       (bound_screen_name && config->output_name &&
        strcmp(bound_screen_name, config->output_name) != 0);
@@ -984,15 +1307,16 @@ void wayland_update_config(config_t *config) {
     // PATH 3: Output changed — full surface recreation required
     bongocat_log_info("Output changed, recreating surface");
 
-    pthread_mutex_lock(&anim_lock);
     atomic_store(&configured, false);
+    atomic_store(&primary_unmapped, false);
+    render_state_retire();
 
     if (buffer) {
       wl_buffer_destroy(buffer);
       buffer = NULL;
     }
     if (pixels && pixel_buffer_size > 0) {
-      munmap(pixels, pixel_buffer_size);
+      wayland_unmap_shm_buffer(pixels, pixel_buffer_size);
       pixels = NULL;
       pixel_buffer_size = 0;
     }
@@ -1010,8 +1334,6 @@ void wayland_update_config(config_t *config) {
 
     if (wayland_setup_surface() != BONGOCAT_SUCCESS) {
       bongocat_log_error("Failed to recreate surface after output change");
-      pthread_mutex_unlock(&anim_lock);
-      free(old_output_name);
       return;
     }
 
@@ -1020,18 +1342,10 @@ void wayland_update_config(config_t *config) {
 
     if (wayland_setup_buffer() != BONGOCAT_SUCCESS) {
       bongocat_log_error("Failed to recreate buffer after output change");
-      pthread_mutex_unlock(&anim_lock);
-      free(old_output_name);
       return;
     }
 
-    animation_invalidate_cache();
-    int cat_h = config->cat_height;
-    int cat_w = (cat_h * CAT_IMAGE_WIDTH) / CAT_IMAGE_HEIGHT;
-    animation_cache_frames(cat_w, cat_h, config->mirror_x, config->mirror_y,
-                           config->enable_antialiasing);
-
-    pthread_mutex_unlock(&anim_lock);
+    wayland_publish_render_state();
     wl_display_roundtrip(display);
     wayland_update_current_output_info();
 
@@ -1043,68 +1357,56 @@ void wayland_update_config(config_t *config) {
     bongocat_log_info("Overlay dimensions changed (%dx%d -> %dx%d)", old_width,
                       old_height, config->screen_width, config->overlay_height);
 
+    // Unpublish the old buffer and wait out in-flight draws before the
+    // surface is committed from this thread or the buffer is freed
+    atomic_store(&configured, false);
+    render_state_retire();
+
     // Update double-buffered properties on existing layer surface
     zwlr_layer_surface_v1_set_size(layer_surface, 0, config->overlay_height);
     apply_layer_properties(config, position_changed, layer_changed);
     wl_surface_commit(surface);
 
-    // Recreate buffer under lock
-    pthread_mutex_lock(&anim_lock);
-    atomic_store(&configured, false);
-
     if (buffer) {
       wl_buffer_destroy(buffer);
       buffer = NULL;
     }
     if (pixels && pixel_buffer_size > 0) {
-      munmap(pixels, pixel_buffer_size);
+      wayland_unmap_shm_buffer(pixels, pixel_buffer_size);
       pixels = NULL;
       pixel_buffer_size = 0;
     }
 
     if (wayland_setup_buffer() != BONGOCAT_SUCCESS) {
       bongocat_log_error("Failed to recreate buffer after resize");
-      pthread_mutex_unlock(&anim_lock);
-      free(old_output_name);
       return;
     }
 
-    animation_invalidate_cache();
-    int cat_h = config->cat_height;
-    int cat_w = (cat_h * CAT_IMAGE_WIDTH) / CAT_IMAGE_HEIGHT;
-    animation_cache_frames(cat_w, cat_h, config->mirror_x, config->mirror_y,
-                           config->enable_antialiasing);
-
-    pthread_mutex_unlock(&anim_lock);
+    wayland_publish_render_state();
 
-    // Roundtrip triggers configure callback → configured=true → draw_bar()
+    // Roundtrip triggers configure callback → configured=true → redraw
     wl_display_roundtrip(display);
 
     bongocat_log_info("Buffer resized successfully (%dx%d)",
                       config->screen_width, config->overlay_height);
 
   } else if (needs_property_update) {
-    // PATH 1: Position/layer only — no buffer changes needed
+    // PATH 1: Position/layer only — no buffer changes needed. Draws stop
+    // until the snapshot below is published, so the render thread cannot
+    // commit alongside this one. The buffer stays valid and configured.
+    render_state_retire();
     apply_layer_properties(config, position_changed, layer_changed);
     wl_surface_commit(surface);
     wl_display_roundtrip(display);
   }
 
-  // Always rebuild cache for cat_height/mirror/etc changes (even if no
-  // surface changes). Skip if we already rebuilt above.
+  // Always publish a fresh snapshot for cat_height/mirror/opacity/etc
+  // changes (even if no surface changes). Draws in progress finish on the
+  // old one. Skip if we already published above.
   if (!needs_full_recreate && !needs_buffer_recreate) {
-    pthread_mutex_lock(&anim_lock);
-    animation_invalidate_cache();
-    int cat_h = config->cat_height;
-    int cat_w = (cat_h * CAT_IMAGE_WIDTH) / CAT_IMAGE_HEIGHT;
-    animation_cache_frames(cat_w, cat_h, config->mirror_x, config->mirror_y,
-                           config->enable_antialiasing);
-    pthread_mutex_unlock(&anim_lock);
+    wayland_publish_render_state();
   }
 
-  free(old_output_name);
-  old_output_name = NULL;
-
   applied_width = config->screen_width;
   applied_height = config->overlay_height;
   applied_layer = config->layer;
@@ -1114,13 +1416,16 @@ void wayland_update_config(config_t *config) {
       config->output_name ? strdup(config->output_name) : NULL;
 
   if (atomic_load(&configured)) {
-    draw_bar();
+    animation_request_redraw();
   }
 }
 
 void wayland_cleanup(void) {
   bongocat_log_info("Cleaning up Wayland resources");
 
+  // Extra bars reference outputs destroyed below
+  output_bars_cleanup();
+
   // First destroy xdg_output objects
   for (size_t i = 0; i < output_count; ++i) {
     if (outputs[i].xdg_output) {
@@ -1148,13 +1453,16 @@ void wayland_cleanup(void) {
 
   output_count = 0;
 
+  // Drop the last snapshot before the buffer and surface it references
+  render_state_retire();
+
   if (buffer) {
     wl_buffer_destroy(buffer);
     buffer = NULL;
   }
 
   if (pixels && pixel_buffer_size > 0) {
-    munmap(pixels, pixel_buffer_size);
+    wayland_unmap_shm_buffer(pixels, pixel_buffer_size);
     pixels = NULL;
     pixel_buffer_size = 0;
   }
@@ -1183,7 +1491,10 @@ void wayland_cleanup(void) {
     xdg_wm_base = NULL;
   }
 
+  fullscreen_backends_stop();
   fullscreen_cleanup();
+  presentation_cleanup();
+  power_cleanup();
 
   if (shm) {
     wl_shm_destroy(shm);
@@ -1200,9 +1511,24 @@ void wayland_cleanup(void) {
     display = NULL;
   }
 
+  int wake_fd = atomic_exchange(&loop_wake_fd, -1);
+  if (wake_fd >= 0) {
+    close(wake_fd);
+  }
+
+  if (loop_epoll_fd >= 0) {
+    close(loop_epoll_fd);
+    loop_epoll_fd = -1;
+  }
+  for (size_t i = 0; i < MAX_FD_SOURCES; i++) {
+    fd_sources[i] = (fd_source_t){.fd = -1, .handler = NULL, .data = NULL};
+  }
+  loop_display_wants_write = false;
+
   // Reset state
   atomic_store(&configured, false);
   atomic_store(&fullscreen_detected, false);
+  atomic_store(&primary_unmapped, false);
   atomic_store(&output_lost, false);
   bound_output_name = 0;
   using_named_output = false;
@@ -1,73 +1,462 @@
 #define _POSIX_C_SOURCE 200809L
 #include "utils/error.h"
 
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
 #include <stdarg.h>
-#include <stdatomic.h>
+#include <stdint.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
 #include <time.h>
+#include <unistd.h>
 
-static atomic_int debug_enabled = 1;
+atomic_int bongocat_log_debug_flag = 1;
 
 void bongocat_error_init(int enable_debug) {
-  atomic_store(&debug_enabled, enable_debug);
+  atomic_store(&bongocat_log_debug_flag, enable_debug);
 }
 
-static void log_timestamp(FILE *stream) {
+// =============================================================================
+// LOG RING
+// =============================================================================
+//
+// Bounded MPSC ring: each slot carries a sequence number that says whether it
+// is free for position `pos` (seq == pos) or holds the record for `pos`
+// (seq == pos + 1). Producers claim positions with a CAS on the head; the one
+// consumer at a time (writer thread, flush, or a synchronous write) holds
+// log_consumer.
+
+#define LOG_RING_SLOTS 256
+#define LOG_TEXT_MAX   1000  // Including the newline
+#define LOG_BATCH_MAX  64
+#define LOG_LINGER_MS  10  // Writer stays awake this long after a batch
+
+_Static_assert((LOG_RING_SLOTS & (LOG_RING_SLOTS - 1)) == 0,
+               "LOG_RING_SLOTS must be a power of two");
+
+typedef struct {
+  atomic_size_t seq;
   struct timespec ts;
-  clock_gettime(CLOCK_REALTIME, &ts);
-  time_t sec = ts.tv_sec;
-  struct tm *tm_info = localtime(&sec);
-  char time_str[32];
-  strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", tm_info);
-  fprintf(stream, "[%s.%03ld] ", time_str, ts.tv_nsec / 1000000L);
+  bongocat_log_level_t level;
+  size_t len;
+  char text[LOG_TEXT_MAX];
+} log_record_t;
+
+static log_record_t log_ring[LOG_RING_SLOTS];
+static atomic_size_t log_head = 0;
+static atomic_size_t log_tail = 0;  // Written only under log_consumer
+static atomic_flag log_consumer = ATOMIC_FLAG_INIT;
+static atomic_size_t log_dropped = 0;
+static size_t log_dropped_reported = 0;
+
+static atomic_bool log_async = false;
+static atomic_bool log_writer_starting = false;
+static atomic_bool log_writer_running = false;
+static atomic_bool log_writer_stopping = false;
+static atomic_bool log_writer_sleeping = false;
+static int log_wake_fd = -1;
+static pthread_t log_writer;
+
+static const char *const log_level_names[] = {"DEBUG", "INFO", "WARNING",
+                                              "ERROR"};
+
+static void log_ring_reset(void) {
+  for (size_t i = 0; i < LOG_RING_SLOTS; i++) {
+    atomic_store_explicit(&log_ring[i].seq, i, memory_order_relaxed);
+  }
+  atomic_store(&log_head, 0);
+  atomic_store(&log_tail, 0);
 }
 
-void bongocat_log_error(const char *format, ...) {
-  va_list args;
-  char message[1024];
-  va_start(args, format);
-  vsnprintf(message, sizeof(message), format, args);
-  va_end(args);
-  log_timestamp(stderr);
-  fprintf(stderr, "ERROR: %s\n", message);
-  fflush(stderr);
+static void log_consumer_lock(void) {
+  while (atomic_flag_test_and_set_explicit(&log_consumer,
+                                           memory_order_acquire)) {
+    sched_yield();
+  }
 }
 
-void bongocat_log_warning(const char *format, ...) {
-  va_list args;
-  char message[1024];
-  va_start(args, format);
-  vsnprintf(message, sizeof(message), format, args);
-  va_end(args);
-  log_timestamp(stderr);
-  fprintf(stderr, "WARNING: %s\n", message);
-  fflush(stderr);
+static void log_consumer_unlock(void) {
+  atomic_flag_clear_explicit(&log_consumer, memory_order_release);
 }
 
-void bongocat_log_info(const char *format, ...) {
-  va_list args;
-  char message[1024];
-  va_start(args, format);
-  vsnprintf(message, sizeof(message), format, args);
-  va_end(args);
-  log_timestamp(stdout);
-  fprintf(stdout, "INFO: %s\n", message);
-  fflush(stdout);
+// =============================================================================
+// LINE OUTPUT
+// =============================================================================
+
+static int log_level_fd(bongocat_log_level_t level) {
+  return level >= BONGOCAT_LOG_LEVEL_WARNING ? STDERR_FILENO : STDOUT_FILENO;
+}
+
+static void log_write_all(int fd, struct iovec *iov, int count) {
+  while (count > 0) {
+    ssize_t written = writev(fd, iov, count);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;  // Nowhere left to report it
+    }
+    while (count > 0 && (size_t)written >= iov->iov_len) {
+      written -= (ssize_t)iov->iov_len;
+      iov++;
+      count--;
+    }
+    if (count > 0) {
+      iov->iov_base = (char *)iov->iov_base + written;
+      iov->iov_len -= (size_t)written;
+    }
+  }
+}
+
+// Formats "[date time.ms] LEVEL: " and caches the date per second. Only
+// called by the consumer.
+static size_t log_format_prefix(const log_record_t *record, char *out,
+                                size_t size) {
+  static time_t cached_sec = -1;
+  static char cached_time[32];
+  if (record->ts.tv_sec != cached_sec) {
+    struct tm tm_info;
+    time_t sec = record->ts.tv_sec;
+    localtime_r(&sec, &tm_info);
+    strftime(cached_time, sizeof(cached_time), "%Y-%m-%d %H:%M:%S", &tm_info);
+    cached_sec = sec;
+  }
+  int len = snprintf(out, size, "[%s.%03ld] %s: ", cached_time,
+                     record->ts.tv_nsec / 1000000L,
+                     log_level_names[record->level]);
+  return len < 0 ? 0 : (size_t)len >= size ? size - 1 : (size_t)len;
 }
 
-void bongocat_log_debug(const char *format, ...) {
-  if (!atomic_load(&debug_enabled))
+// One writev() per run of records bound for the same stream
+static void log_emit(log_record_t *const *records, size_t count) {
+  char prefixes[LOG_BATCH_MAX][64];
+  struct iovec iov[LOG_BATCH_MAX * 2];
+
+  size_t i = 0;
+  while (i < count) {
+    int fd = log_level_fd(records[i]->level);
+    int iov_count = 0;
+    for (; i < count && log_level_fd(records[i]->level) == fd; i++) {
+      size_t slot = (size_t)iov_count / 2;
+      size_t len =
+          log_format_prefix(records[i], prefixes[slot], sizeof(prefixes[0]));
+      iov[iov_count++] = (struct iovec){prefixes[slot], len};
+      iov[iov_count++] =
+          (struct iovec){records[i]->text, records[i]->len};
+    }
+    log_write_all(fd, iov, iov_count);
+  }
+}
+
+static void log_record_format(log_record_t *record, bongocat_log_level_t level,
+                              const char *format, va_list args) {
+  clock_gettime(CLOCK_REALTIME, &record->ts);
+  record->level = level;
+  int len = vsnprintf(record->text, LOG_TEXT_MAX - 1, format, args);
+  if (len < 0) {
+    len = 0;
+  } else if (len > LOG_TEXT_MAX - 2) {
+    len = LOG_TEXT_MAX - 2;
+  }
+  record->text[len] = '\n';
+  record->len = (size_t)len + 1;
+}
+
+static void log_report_drops(void) {
+  size_t dropped = atomic_load(&log_dropped);
+  if (dropped == log_dropped_reported) {
     return;
+  }
+  log_record_t record;
+  clock_gettime(CLOCK_REALTIME, &record.ts);
+  record.level = BONGOCAT_LOG_LEVEL_WARNING;
+  int len = snprintf(record.text, sizeof(record.text),
+                     "%zu log messages dropped, the log ring was full\n",
+                     dropped - log_dropped_reported);
+  record.len = len < 0 ? 0 : (size_t)len;
+  log_record_t *records[] = {&record};
+  log_emit(records, 1);
+  log_dropped_reported = dropped;
+}
+
+// Writes every published record in order. Caller holds log_consumer.
+static void log_drain(void) {
+  log_record_t *batch[LOG_BATCH_MAX];
+  for (;;) {
+    size_t tail = atomic_load_explicit(&log_tail, memory_order_relaxed);
+    size_t count = 0;
+    while (count < LOG_BATCH_MAX) {
+      log_record_t *record = &log_ring[(tail + count) & (LOG_RING_SLOTS - 1)];
+      size_t seq = atomic_load_explicit(&record->seq, memory_order_acquire);
+      if (seq != tail + count + 1) {
+        break;
+      }
+      batch[count++] = record;
+    }
+    if (count == 0) {
+      break;
+    }
+
+    log_emit(batch, count);
+    for (size_t i = 0; i < count; i++) {
+      atomic_store_explicit(&batch[i]->seq, tail + i + LOG_RING_SLOTS,
+                            memory_order_release);
+    }
+    atomic_store_explicit(&log_tail, tail + count, memory_order_relaxed);
+  }
+  log_report_drops();
+}
+
+static bool log_ring_ready(void) {
+  size_t tail = atomic_load_explicit(&log_tail, memory_order_relaxed);
+  size_t seq = atomic_load_explicit(
+      &log_ring[tail & (LOG_RING_SLOTS - 1)].seq, memory_order_acquire);
+  return seq == tail + 1;
+}
+
+// =============================================================================
+// WRITER THREAD
+// =============================================================================
+
+static void log_kick_writer(void) {
+  uint64_t val = 1;
+  if (write(log_wake_fd, &val, sizeof(val)) < 0) {
+    // Counter overflow is impossible in practice; nothing to do
+  }
+}
+
+// Producers only pay for a wake-up when the writer is asleep, or once per
+// half ring while it lingers
+static void log_wake_writer(size_t pos) {
+  // Pairs with the store to log_writer_sleeping before the writer's final
+  // check: either it sees our record or we see it asleep
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit(&log_writer_sleeping, memory_order_relaxed)) {
+    if (atomic_exchange(&log_writer_sleeping, false)) {
+      log_kick_writer();
+    }
+  } else if (pos - atomic_load_explicit(&log_tail, memory_order_relaxed) ==
+             LOG_RING_SLOTS / 2) {
+    log_kick_writer();
+  }
+}
+
+static bool log_writer_wait(int timeout_ms) {
+  struct pollfd pfd = {.fd = log_wake_fd, .events = POLLIN};
+  if (poll(&pfd, 1, timeout_ms) <= 0) {
+    return false;
+  }
+  uint64_t val;
+  if (read(log_wake_fd, &val, sizeof(val)) < 0) {
+    // EAGAIN after a spurious wake; nothing to do
+  }
+  return true;
+}
 
+static void *log_writer_main([[maybe_unused]] void *arg) {
+  for (;;) {
+    bool stopping = atomic_load(&log_writer_stopping);
+    log_consumer_lock();
+    log_drain();
+    log_consumer_unlock();
+    if (stopping) {
+      break;
+    }
+
+    // Linger so that a burst is written in a few batches and its producers
+    // make no syscalls, then sleep until the next record
+    if (log_writer_wait(LOG_LINGER_MS) || log_ring_ready()) {
+      continue;
+    }
+    atomic_store(&log_writer_sleeping, true);
+    if (log_ring_ready() || atomic_load(&log_writer_stopping)) {
+      atomic_store(&log_writer_sleeping, false);
+      continue;
+    }
+    (void)log_writer_wait(-1);
+    atomic_store(&log_writer_sleeping, false);
+  }
+  return NULL;
+}
+
+static bool log_start_writer(void) {
+  bool expected = false;
+  if (!atomic_compare_exchange_strong(&log_writer_starting, &expected, true)) {
+    return atomic_load(&log_writer_running);
+  }
+
+  log_wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (log_wake_fd >= 0 &&
+      pthread_create(&log_writer, NULL, log_writer_main, NULL) == 0) {
+    atomic_store(&log_writer_running, true);
+    return true;
+  }
+
+  // Stay synchronous for good
+  if (log_wake_fd >= 0) {
+    close(log_wake_fd);
+    log_wake_fd = -1;
+  }
+  atomic_store(&log_async, false);
+  return false;
+}
+
+// Holding the consumer lock across fork() keeps the writer out of
+// localtime_r(), whose timezone lock would otherwise be copied into the child
+// held. A writer stuck on a stalled stdout is not waited for.
+static bool log_fork_locked = false;
+
+static void log_atfork_prepare(void) {
+  struct timespec pause = {.tv_nsec = 1000000L};
+  for (int attempt = 0; attempt < 100; attempt++) {
+    if (!atomic_flag_test_and_set_explicit(&log_consumer,
+                                           memory_order_acquire)) {
+      log_fork_locked = true;
+      return;
+    }
+    nanosleep(&pause, NULL);
+  }
+}
+
+static void log_atfork_parent(void) {
+  if (log_fork_locked) {
+    log_fork_locked = false;
+    log_consumer_unlock();
+  }
+}
+
+// The parent's writer does not exist in the child and its pending records
+// are the parent's to write. Mark them consumed; the child starts its own
+// writer on its first log call.
+static void log_atfork_child(void) {
+  log_fork_locked = false;
+  size_t head = atomic_load(&log_head);
+  for (size_t pos = atomic_load(&log_tail); pos != head; pos++) {
+    atomic_store(&log_ring[pos & (LOG_RING_SLOTS - 1)].seq,
+                 pos + LOG_RING_SLOTS);
+  }
+  atomic_store(&log_tail, head);
+  atomic_flag_clear(&log_consumer);
+
+  if (log_wake_fd >= 0) {
+    close(log_wake_fd);
+    log_wake_fd = -1;
+  }
+  atomic_store(&log_writer_starting, false);
+  atomic_store(&log_writer_running, false);
+  atomic_store(&log_writer_stopping, false);
+  atomic_store(&log_writer_sleeping, false);
+  atomic_store(&log_dropped, 0);
+  log_dropped_reported = 0;
+}
+
+static void log_at_exit(void) {
+  bongocat_log_stop();
+}
+
+// =============================================================================
+// PUBLIC LOGGING API
+// =============================================================================
+
+static void log_write_sync(bongocat_log_level_t level, const char *format,
+                           va_list args) {
+  log_record_t record;
+  log_record_format(&record, level, format, args);
+
+  // Keep order with anything printed through stdio
+  fflush(stdout);
+  log_record_t *records[] = {&record};
+  log_consumer_lock();
+  log_emit(records, 1);
+  log_consumer_unlock();
+}
+
+void bongocat_log_write(bongocat_log_level_t level, const char *format, ...) {
   va_list args;
-  char message[1024];
   va_start(args, format);
-  vsnprintf(message, sizeof(message), format, args);
+
+  if (!atomic_load_explicit(&log_async, memory_order_relaxed) ||
+      (!atomic_load_explicit(&log_writer_running, memory_order_acquire) &&
+       !log_start_writer())) {
+    log_write_sync(level, format, args);
+    va_end(args);
+    return;
+  }
+
+  size_t pos = atomic_load_explicit(&log_head, memory_order_relaxed);
+  log_record_t *record;
+  for (;;) {
+    record = &log_ring[pos & (LOG_RING_SLOTS - 1)];
+    size_t seq = atomic_load_explicit(&record->seq, memory_order_acquire);
+    intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+    if (diff == 0) {
+      if (atomic_compare_exchange_weak_explicit(&log_head, &pos, pos + 1,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // Full: the writer is behind (blocked terminal, stalled pipe)
+      atomic_fetch_add_explicit(&log_dropped, 1, memory_order_relaxed);
+      va_end(args);
+      return;
+    } else {
+      pos = atomic_load_explicit(&log_head, memory_order_relaxed);
+    }
+  }
+
+  log_record_format(record, level, format, args);
   va_end(args);
-  log_timestamp(stdout);
-  fprintf(stdout, "DEBUG: %s\n", message);
-  fflush(stdout);
+  atomic_store_explicit(&record->seq, pos + 1, memory_order_release);
+  log_wake_writer(pos);
 }
 
+void bongocat_log_start(void) {
+  if (atomic_load(&log_async)) {
+    return;
+  }
+
+  static bool registered = false;
+  if (!registered) {
+    registered = true;
+    log_ring_reset();
+    atexit(log_at_exit);
+    pthread_atfork(log_atfork_prepare, log_atfork_parent, log_atfork_child);
+  }
+  atomic_store(&log_async, true);
+  (void)log_start_writer();
+}
+
+void bongocat_log_flush(void) {
+  log_consumer_lock();
+  log_drain();
+  log_consumer_unlock();
+}
+
+void bongocat_log_stop(void) {
+  if (atomic_load(&log_writer_running)) {
+    atomic_store(&log_writer_stopping, true);
+    log_kick_writer();
+    pthread_join(log_writer, NULL);
+    close(log_wake_fd);
+    log_wake_fd = -1;
+    atomic_store(&log_writer_running, false);
+    atomic_store(&log_writer_stopping, false);
+  }
+  atomic_store(&log_async, false);
+  atomic_store(&log_writer_starting, false);
+  bongocat_log_flush();
+}
+
+size_t bongocat_log_dropped(void) {
+  return atomic_load(&log_dropped);
+}
+
+// =============================================================================
+// ERROR HANDLING
+// =============================================================================
+
 const char *bongocat_error_string(bongocat_error_t error) {
   switch (error) {
   case BONGOCAT_SUCCESS:
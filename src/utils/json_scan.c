@@ -0,0 +1,224 @@
+#define _POSIX_C_SOURCE 200809L
+#include "utils/json_scan.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+// =============================================================================
+// SKIPPING
+// =============================================================================
+
+const char *json_skip_ws(const char *p) {
+  if (!p) {
+    return NULL;
+  }
+  while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') {
+    p++;
+  }
+  return p;
+}
+
+// p points at the opening quote; returns the position after the closing one
+static const char *json_skip_string(const char *p) {
+  p++;
+  while (*p && *p != '"') {
+    if (*p == '\\' && p[1]) {
+      p++;
+    }
+    p++;
+  }
+  return *p == '"' ? p + 1 : NULL;
+}
+
+const char *json_skip_value(const char *p) {
+  p = json_skip_ws(p);
+  if (!p) {
+    return NULL;
+  }
+  if (*p == '"') {
+    return json_skip_string(p);
+  }
+
+  if (*p == '{' || *p == '[') {
+    int depth = 0;
+    while (*p) {
+      if (*p == '"') {
+        p = json_skip_string(p);
+        if (!p) {
+          return NULL;
+        }
+        continue;
+      }
+      if (*p == '{' || *p == '[') {
+        depth++;
+      } else if (*p == '}' || *p == ']') {
+        if (--depth == 0) {
+          return p + 1;
+        }
+      }
+      p++;
+    }
+    return NULL;
+  }
+
+  const char *start = p;
+  while (*p && *p != ',' && *p != '}' && *p != ']' && *p != ' ' &&
+         *p != '\n' && *p != '\r' && *p != '\t') {
+    p++;
+  }
+  return p == start ? NULL : p;
+}
+
+// =============================================================================
+// OBJECTS AND ARRAYS
+// =============================================================================
+
+// Parse the member whose key starts at p (the opening quote)
+static const char *json_parse_member(const char *p, json_member_t *member) {
+  if (!p || *p != '"') {
+    return NULL;
+  }
+  const char *end = json_skip_string(p);
+  if (!end) {
+    return NULL;
+  }
+  const char *colon = json_skip_ws(end);
+  if (*colon != ':') {
+    return NULL;
+  }
+
+  member->key = p + 1;
+  member->key_len = (size_t)(end - 1 - member->key);
+  member->value = json_skip_ws(colon + 1);
+  return p;
+}
+
+const char *json_object_first(const char *obj, json_member_t *member) {
+  const char *p = json_skip_ws(obj);
+  if (!p || *p != '{' || !member) {
+    return NULL;
+  }
+  return json_parse_member(json_skip_ws(p + 1), member);
+}
+
+const char *json_object_next(const char *it, json_member_t *member) {
+  if (!it || !member) {
+    return NULL;
+  }
+  const char *p = json_skip_ws(json_skip_value(member->value));
+  if (!p || *p != ',') {
+    return NULL;
+  }
+  return json_parse_member(json_skip_ws(p + 1), member);
+}
+
+const char *json_object_get(const char *obj, const char *key) {
+  if (!key) {
+    return NULL;
+  }
+
+  size_t key_len = strlen(key);
+  json_member_t member;
+  for (const char *it = json_object_first(obj, &member); it;
+       it = json_object_next(it, &member)) {
+    if (member.key_len == key_len && memcmp(member.key, key, key_len) == 0) {
+      return member.value;
+    }
+  }
+  return NULL;
+}
+
+const char *json_array_first(const char *value) {
+  value = json_skip_ws(value);
+  if (!value || *value != '[') {
+    return NULL;
+  }
+  const char *p = json_skip_ws(value + 1);
+  return *p == ']' || *p == '\0' ? NULL : p;
+}
+
+const char *json_array_next(const char *elem) {
+  const char *p = json_skip_ws(json_skip_value(elem));
+  if (!p || *p != ',') {
+    return NULL;
+  }
+  return json_skip_ws(p + 1);
+}
+
+// =============================================================================
+// SCALARS
+// =============================================================================
+
+bool json_get_int(const char *value, int *out) {
+  if (!value || !out) {
+    return false;
+  }
+  if (strncmp(value, "true", 4) == 0) {
+    *out = 1;
+    return true;
+  }
+  if (strncmp(value, "false", 5) == 0) {
+    *out = 0;
+    return true;
+  }
+
+  char *end = NULL;
+  errno = 0;
+  long parsed = strtol(value, &end, 10);
+  if (end == value || errno != 0 || parsed < -2147483647L ||
+      parsed > 2147483647L) {
+    return false;
+  }
+  *out = (int)parsed;
+  return true;
+}
+
+bool json_get_u64(const char *value, uint64_t *out) {
+  if (!value || !out || *value < '0' || *value > '9') {
+    return false;
+  }
+
+  char *end = NULL;
+  errno = 0;
+  unsigned long long parsed = strtoull(value, &end, 10);
+  if (end == value || errno != 0) {
+    return false;
+  }
+  *out = (uint64_t)parsed;
+  return true;
+}
+
+bool json_get_string(const char *value, char *out, size_t size) {
+  if (!value || *value != '"' || !out || size == 0) {
+    return false;
+  }
+
+  size_t len = 0;
+  const char *p = value + 1;
+  while (*p && *p != '"') {
+    if (*p == '\\' && p[1]) {
+      p++;
+    }
+    if (len + 1 < size) {
+      out[len++] = *p;
+    }
+    p++;
+  }
+  out[len] = '\0';
+  return *p == '"';
+}
+
+bool json_string_equals(const char *value, const char *s) {
+  if (!value || *value != '"' || !s) {
+    return false;
+  }
+  size_t len = strlen(s);
+  return strncmp(value + 1, s, len) == 0 && value[len + 1] == '"';
+}
+
+bool json_get_pair(const char *value, int *a, int *b) {
+  const char *first = json_array_first(value);
+  const char *second = json_array_next(first);
+  return first && second && json_get_int(first, a) && json_get_int(second, b);
+}
@@ -0,0 +1,255 @@
+#define _POSIX_C_SOURCE 200809L
+#include "utils/latency.h"
+
+#include "utils/error.h"
+
+#include <string.h>
+#include <time.h>
+
+// =============================================================================
+// HISTOGRAM IMPLEMENTATION
+// =============================================================================
+
+static size_t latency_bucket_index(uint64_t value_us) {
+  if (value_us < LATENCY_HIST_SUB_BUCKETS) {
+    return (size_t)value_us;
+  }
+  if (value_us >= (1ULL << LATENCY_HIST_MAX_BITS)) {
+    value_us = (1ULL << LATENCY_HIST_MAX_BITS) - 1;
+  }
+
+  int msb = 63 - __builtin_clzll(value_us);
+  size_t sub = (size_t)(value_us >> (msb - LATENCY_HIST_SUB_BITS)) &
+               (LATENCY_HIST_SUB_BUCKETS - 1);
+  return LATENCY_HIST_SUB_BUCKETS +
+         (size_t)(msb - LATENCY_HIST_SUB_BITS) * LATENCY_HIST_SUB_BUCKETS + sub;
+}
+
+// Midpoint of the value range covered by a bucket
+static uint64_t latency_bucket_value(size_t index) {
+  if (index < LATENCY_HIST_SUB_BUCKETS) {
+    return index;
+  }
+
+  size_t group = (index - LATENCY_HIST_SUB_BUCKETS) / LATENCY_HIST_SUB_BUCKETS;
+  size_t sub = (index - LATENCY_HIST_SUB_BUCKETS) % LATENCY_HIST_SUB_BUCKETS;
+  int shift = (int)group;
+  uint64_t low = (1ULL << (group + LATENCY_HIST_SUB_BITS)) + (sub << shift);
+  uint64_t width = 1ULL << shift;
+  return low + width / 2;
+}
+
+void latency_histogram_record(latency_histogram_t *hist, uint64_t value_us) {
+  if (!hist) {
+    return;
+  }
+
+  atomic_fetch_add_explicit(&hist->buckets[latency_bucket_index(value_us)], 1,
+                            memory_order_relaxed);
+  atomic_fetch_add_explicit(&hist->count, 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&hist->sum_us, value_us, memory_order_relaxed);
+
+  uint_fast64_t prev =
+      atomic_load_explicit(&hist->max_us, memory_order_relaxed);
+  while (value_us > prev &&
+         !atomic_compare_exchange_weak_explicit(&hist->max_us, &prev, value_us,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed)) {
+  }
+}
+
+void latency_histogram_reset(latency_histogram_t *hist) {
+  if (!hist) {
+    return;
+  }
+
+  for (size_t i = 0; i < LATENCY_HIST_BUCKETS; i++) {
+    atomic_store_explicit(&hist->buckets[i], 0, memory_order_relaxed);
+  }
+  atomic_store_explicit(&hist->count, 0, memory_order_relaxed);
+  atomic_store_explicit(&hist->sum_us, 0, memory_order_relaxed);
+  atomic_store_explicit(&hist->max_us, 0, memory_order_relaxed);
+}
+
+uint64_t latency_histogram_percentile(const latency_histogram_t *hist,
+                                      double pct) {
+  if (!hist) {
+    return 0;
+  }
+
+  uint64_t total = 0;
+  for (size_t i = 0; i < LATENCY_HIST_BUCKETS; i++) {
+    total += atomic_load_explicit(&hist->buckets[i], memory_order_relaxed);
+  }
+  if (total == 0) {
+    return 0;
+  }
+
+  if (pct < 0.0) {
+    pct = 0.0;
+  } else if (pct > 100.0) {
+    pct = 100.0;
+  }
+
+  // Rank of the sample at this percentile (1-based, rounded up)
+  uint64_t rank = (uint64_t)((pct / 100.0) * (double)total);
+  if ((double)rank < (pct / 100.0) * (double)total || rank == 0) {
+    rank++;
+  }
+
+  uint64_t max_us = atomic_load_explicit(&hist->max_us, memory_order_relaxed);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < LATENCY_HIST_BUCKETS; i++) {
+    seen += atomic_load_explicit(&hist->buckets[i], memory_order_relaxed);
+    if (seen >= rank) {
+      uint64_t value = latency_bucket_value(i);
+      return value > max_us ? max_us : value;
+    }
+  }
+
+  return max_us;
+}
+
+void latency_histogram_summarize(const latency_histogram_t *hist,
+                                 latency_summary_t *out) {
+  if (!out) {
+    return;
+  }
+
+  memset(out, 0, sizeof(*out));
+  if (!hist) {
+    return;
+  }
+
+  out->count = atomic_load_explicit(&hist->count, memory_order_relaxed);
+  out->p50_us = latency_histogram_percentile(hist, 50.0);
+  out->p99_us = latency_histogram_percentile(hist, 99.0);
+  out->max_us = atomic_load_explicit(&hist->max_us, memory_order_relaxed);
+}
+
+uint64_t latency_histogram_count_below(const latency_histogram_t *hist,
+                                       uint64_t limit_us) {
+  if (!hist) {
+    return 0;
+  }
+  // Values of 2^LATENCY_HIST_MAX_BITS and above share the last bucket
+  size_t end = limit_us >= (1ULL << LATENCY_HIST_MAX_BITS)
+                   ? LATENCY_HIST_BUCKETS
+                   : latency_bucket_index(limit_us);
+
+  uint64_t count = 0;
+  for (size_t i = 0; i < end; i++) {
+    count += atomic_load_explicit(&hist->buckets[i], memory_order_relaxed);
+  }
+  return count;
+}
+
+// =============================================================================
+// PIPELINE SAMPLES
+// =============================================================================
+
+typedef struct {
+  bool active;
+  int64_t event_us;
+  int64_t stage_us[LATENCY_STAGE_COUNT];
+} latency_sample_t;
+
+static latency_histogram_t stage_histograms[LATENCY_STAGE_COUNT];
+
+// Each thread drives at most one key event through the pipeline at a time,
+// so the in-flight sample is thread-local and needs no synchronization.
+static _Thread_local latency_sample_t pending_sample;
+
+static const char *const stage_names[LATENCY_STAGE_COUNT] = {
+    [LATENCY_STAGE_CHILD_READ] = "child read",
+    [LATENCY_STAGE_WAKE] = "eventfd wake",
+    [LATENCY_STAGE_UPDATE] = "state update",
+    [LATENCY_STAGE_BLIT] = "blit",
+    [LATENCY_STAGE_COMMIT] = "surface commit",
+    [LATENCY_STAGE_FLUSH] = "display flush",
+};
+
+int64_t latency_now_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000L;
+}
+
+void latency_sample_begin(int64_t event_us, int64_t read_us, int64_t wake_us) {
+  memset(&pending_sample, 0, sizeof(pending_sample));
+  if (event_us <= 0) {
+    return;
+  }
+
+  pending_sample.active = true;
+  pending_sample.event_us = event_us;
+  pending_sample.stage_us[LATENCY_STAGE_CHILD_READ] = read_us;
+  pending_sample.stage_us[LATENCY_STAGE_WAKE] = wake_us;
+}
+
+void latency_sample_mark(latency_stage_t stage) {
+  if (!pending_sample.active || stage >= LATENCY_STAGE_COUNT) {
+    return;
+  }
+  pending_sample.stage_us[stage] = latency_now_us();
+}
+
+void latency_sample_finish(void) {
+  if (!pending_sample.active) {
+    return;
+  }
+
+  for (int i = 0; i < LATENCY_STAGE_COUNT; i++) {
+    int64_t stage_us = pending_sample.stage_us[i];
+    if (stage_us <= 0) {
+      continue;
+    }
+    int64_t delta = stage_us - pending_sample.event_us;
+    latency_histogram_record(&stage_histograms[i],
+                             delta > 0 ? (uint64_t)delta : 0);
+  }
+
+  pending_sample.active = false;
+}
+
+void latency_sample_abort(void) {
+  pending_sample.active = false;
+}
+
+int64_t latency_sample_event_us(void) {
+  return pending_sample.active ? pending_sample.event_us : 0;
+}
+
+void latency_report(void) {
+  latency_summary_t total;
+  latency_histogram_summarize(&stage_histograms[LATENCY_STAGE_FLUSH], &total);
+  if (total.count == 0) {
+    bongocat_log_info("Keypress latency: no samples recorded");
+    return;
+  }
+
+  bongocat_log_info("Keypress latency (%llu samples, cumulative from evdev):",
+                    (unsigned long long)total.count);
+  for (int i = 0; i < LATENCY_STAGE_COUNT; i++) {
+    latency_summary_t s;
+    latency_histogram_summarize(&stage_histograms[i], &s);
+    bongocat_log_info("  %-14s p50=%6lluus p99=%6lluus max=%6lluus",
+                      stage_names[i], (unsigned long long)s.p50_us,
+                      (unsigned long long)s.p99_us,
+                      (unsigned long long)s.max_us);
+  }
+}
+
+const char *latency_stage_name(latency_stage_t stage) {
+  if (stage >= LATENCY_STAGE_COUNT) {
+    return "unknown";
+  }
+  return stage_names[stage];
+}
+
+const latency_histogram_t *latency_get_stage_histogram(latency_stage_t stage) {
+  if (stage >= LATENCY_STAGE_COUNT) {
+    return NULL;
+  }
+  return &stage_histograms[stage];
+}
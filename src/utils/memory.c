@@ -3,11 +3,11 @@
 #include "utils/error.h"
 
 #include <pthread.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stddef.h>
 #include <string.h>
 
-static memory_stats_t g_memory_stats = {0};
-static pthread_mutex_t memory_mutex = PTHREAD_MUTEX_INITIALIZER;
-
 #ifdef DEBUG
 typedef struct allocation_record {
   void *ptr;
@@ -20,88 +20,285 @@ typedef struct allocation_record {
 static allocation_record_t *allocations = NULL;
 #endif
 
-void *bongocat_malloc(size_t size) {
+// =============================================================================
+// ALLOCATION COUNTERS
+// =============================================================================
+//
+// Each thread owns one counter block and is its only writer, so an
+// allocation touches no shared cache line except the live byte total that
+// the peak needs. Blocks are never freed: a thread that exits hands its
+// block to the next new thread, and readers sum every block. Bytes freed by
+// another thread than the one that allocated them still sum correctly
+// because all counters wrap the same way.
+
+typedef struct memory_counters {
+  alignas(64) atomic_size_t allocated[MEMORY_TAG_COUNT];
+  atomic_size_t freed[MEMORY_TAG_COUNT];
+  atomic_size_t allocations[MEMORY_TAG_COUNT];
+  atomic_size_t frees[MEMORY_TAG_COUNT];
+  atomic_bool in_use;
+  struct memory_counters *next;
+} memory_counters_t;
+
+static _Atomic(memory_counters_t *) counter_blocks = NULL;
+static _Thread_local memory_counters_t *thread_counters = NULL;
+static pthread_key_t counter_key;
+static pthread_once_t counter_key_once = PTHREAD_ONCE_INIT;
+static atomic_size_t live_bytes = 0;
+static atomic_size_t peak_bytes = 0;
+
+// Used when a block cannot be allocated; shared, but still correct
+static memory_counters_t fallback_counters;
+
+static void counters_release(void *block) {
+  atomic_store(&((memory_counters_t *)block)->in_use, false);
+}
+
+static void counters_key_create(void) {
+  if (pthread_key_create(&counter_key, counters_release) != 0) {
+    // Exiting threads keep their blocks; only reuse is lost
+  }
+}
+
+static memory_counters_t *counters_acquire(void) {
+  pthread_once(&counter_key_once, counters_key_create);
+
+  for (memory_counters_t *block = atomic_load(&counter_blocks); block;
+       block = block->next) {
+    bool expected = false;
+    if (atomic_compare_exchange_strong(&block->in_use, &expected, true)) {
+      pthread_setspecific(counter_key, block);
+      return block;
+    }
+  }
+
+  memory_counters_t *block = aligned_alloc(64, sizeof(*block));
+  if (!block) {
+    return &fallback_counters;
+  }
+  memset(block, 0, sizeof(*block));
+  atomic_store(&block->in_use, true);
+  block->next = atomic_load(&counter_blocks);
+  while (!atomic_compare_exchange_weak(&counter_blocks, &block->next, block)) {
+  }
+  pthread_setspecific(counter_key, block);
+  return block;
+}
+
+static memory_counters_t *counters_get(void) {
+  if (!thread_counters) {
+    thread_counters = counters_acquire();
+  }
+  return thread_counters;
+}
+
+// Single writer per block: a relaxed load and store is enough, except for
+// the shared fallback block
+static void counter_add(atomic_size_t *counter, size_t value) {
+  if (thread_counters == &fallback_counters) {
+    atomic_fetch_add_explicit(counter, value, memory_order_relaxed);
+    return;
+  }
+  size_t old = atomic_load_explicit(counter, memory_order_relaxed);
+  atomic_store_explicit(counter, old + value, memory_order_relaxed);
+}
+
+static void live_add(size_t size) {
+  size_t live =
+      atomic_fetch_add_explicit(&live_bytes, size, memory_order_relaxed) +
+      size;
+  size_t peak = atomic_load_explicit(&peak_bytes, memory_order_relaxed);
+  while (live > peak &&
+         !atomic_compare_exchange_weak_explicit(&peak_bytes, &peak, live,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed)) {
+  }
+}
+
+static void account_alloc(memory_tag_t tag, size_t size) {
+  memory_counters_t *counters = counters_get();
+  counter_add(&counters->allocated[tag], size);
+  counter_add(&counters->allocations[tag], 1);
+  live_add(size);
+}
+
+static void account_free(memory_tag_t tag, size_t size) {
+  memory_counters_t *counters = counters_get();
+  counter_add(&counters->freed[tag], size);
+  counter_add(&counters->frees[tag], 1);
+  atomic_fetch_sub_explicit(&live_bytes, size, memory_order_relaxed);
+}
+
+// =============================================================================
+// TAGGED ALLOCATION
+// =============================================================================
+
+#define MEMORY_HEADER_MAGIC 0xB0C47A11u
+
+typedef struct {
+  size_t size;
+  uint32_t tag;
+  uint32_t magic;
+} memory_header_t;
+
+_Static_assert(sizeof(memory_header_t) % alignof(max_align_t) == 0,
+               "memory_header_t must keep malloc alignment");
+
+static void *header_to_user(memory_header_t *header) {
+  return (char *)header + sizeof(memory_header_t);
+}
+
+static memory_header_t *user_to_header(void *ptr) {
+  return (memory_header_t *)((char *)ptr - sizeof(memory_header_t));
+}
+
+static void *tagged_finish(memory_header_t *header, memory_tag_t tag,
+                           size_t size) {
+  header->size = size;
+  header->tag = (uint32_t)tag;
+  header->magic = MEMORY_HEADER_MAGIC;
+  account_alloc(tag, size);
+  return header_to_user(header);
+}
+
+static bool tag_valid(memory_tag_t tag) {
+  return (unsigned)tag < MEMORY_TAG_COUNT;
+}
+
+void *bongocat_malloc_tagged(memory_tag_t tag, size_t size) {
   if (size == 0) {
     bongocat_log_warning("Attempted to allocate 0 bytes");
     return NULL;
   }
-
-  void *ptr = malloc(size);
-  if (!ptr) {
-    bongocat_log_error("Failed to allocate %zu bytes", size);
+  if (!tag_valid(tag) || size > SIZE_MAX - sizeof(memory_header_t)) {
+    bongocat_log_error("Invalid allocation of %zu bytes", size);
     return NULL;
   }
 
-  pthread_mutex_lock(&memory_mutex);
-  g_memory_stats.total_allocated += size;
-  g_memory_stats.current_allocated += size;
-  if (g_memory_stats.current_allocated > g_memory_stats.peak_allocated) {
-    g_memory_stats.peak_allocated = g_memory_stats.current_allocated;
+  memory_header_t *header = malloc(sizeof(memory_header_t) + size);
+  if (!header) {
+    bongocat_log_error("Failed to allocate %zu bytes", size);
+    return NULL;
   }
-  g_memory_stats.allocation_count++;
-  pthread_mutex_unlock(&memory_mutex);
-
-  return ptr;
+  return tagged_finish(header, tag, size);
 }
 
-void *bongocat_calloc(size_t count, size_t size) {
+void *bongocat_calloc_tagged(memory_tag_t tag, size_t count, size_t size) {
   if (count == 0 || size == 0) {
     bongocat_log_warning("Attempted to allocate 0 bytes");
     return NULL;
   }
 
   // Check for overflow
-  if (count > SIZE_MAX / size) {
+  if (count > (SIZE_MAX - sizeof(memory_header_t)) / size) {
     bongocat_log_error("Integer overflow in calloc");
     return NULL;
   }
-
-  void *ptr = calloc(count, size);
-  if (!ptr) {
-    bongocat_log_error("Failed to allocate %zu bytes", count * size);
+  if (!tag_valid(tag)) {
+    bongocat_log_error("Invalid allocation tag %d", (int)tag);
     return NULL;
   }
 
-  pthread_mutex_lock(&memory_mutex);
   size_t total_size = count * size;
-  g_memory_stats.total_allocated += total_size;
-  g_memory_stats.current_allocated += total_size;
-  if (g_memory_stats.current_allocated > g_memory_stats.peak_allocated) {
-    g_memory_stats.peak_allocated = g_memory_stats.current_allocated;
+  memory_header_t *header = calloc(1, sizeof(memory_header_t) + total_size);
+  if (!header) {
+    bongocat_log_error("Failed to allocate %zu bytes", total_size);
+    return NULL;
   }
-  g_memory_stats.allocation_count++;
-  pthread_mutex_unlock(&memory_mutex);
+  return tagged_finish(header, tag, total_size);
+}
 
-  return ptr;
+char *bongocat_strdup_tagged(memory_tag_t tag, const char *str) {
+  if (!str) {
+    return NULL;
+  }
+  size_t len = strlen(str);
+  char *copy = bongocat_malloc_tagged(tag, len + 1);
+  if (copy) {
+    memcpy(copy, str, len + 1);
+  }
+  return copy;
+}
+
+void *bongocat_malloc(size_t size) {
+  return bongocat_malloc_tagged(MEMORY_TAG_OTHER, size);
+}
+
+void *bongocat_calloc(size_t count, size_t size) {
+  return bongocat_calloc_tagged(MEMORY_TAG_OTHER, count, size);
+}
+
+// Reads the header of a block, or NULL (with an error) if it has none
+static memory_header_t *header_checked(void *ptr, const char *what) {
+  memory_header_t *header = user_to_header(ptr);
+  if (header->magic != MEMORY_HEADER_MAGIC) {
+    bongocat_log_error("%s of a block not from bongocat_malloc: %p", what,
+                       ptr);
+    return NULL;
+  }
+  return header;
 }
 
 void *bongocat_realloc(void *ptr, size_t size) {
+  if (!ptr) {
+    return bongocat_malloc(size);
+  }
   if (size == 0) {
     bongocat_free(ptr);
     return NULL;
   }
 
-  void *new_ptr = realloc(ptr, size);
-  if (!new_ptr) {
-    bongocat_log_error("Failed to reallocate to %zu bytes", size);
+  memory_header_t *header = header_checked(ptr, "realloc");
+  if (!header || size > SIZE_MAX - sizeof(memory_header_t)) {
     return NULL;
   }
+  memory_tag_t tag = (memory_tag_t)header->tag;
+  size_t old_size = header->size;
 
-  // Note: We can't track size changes accurately without storing original sizes
-  // This is a limitation of this simple tracking system
+  memory_header_t *new_header =
+      realloc(header, sizeof(memory_header_t) + size);
+  if (!new_header) {
+    bongocat_log_error("Failed to reallocate to %zu bytes", size);
+    return NULL;
+  }
 
-  return new_ptr;
+  // Bytes only: a resize is neither an allocation nor a free
+  memory_counters_t *counters = counters_get();
+  counter_add(&counters->allocated[tag], size);
+  counter_add(&counters->freed[tag], old_size);
+  if (size > old_size) {
+    live_add(size - old_size);
+  } else {
+    atomic_fetch_sub_explicit(&live_bytes, old_size - size,
+                              memory_order_relaxed);
+  }
+  new_header->size = size;
+  return header_to_user(new_header);
 }
 
 void bongocat_free(void *ptr) {
   if (!ptr)
     return;
 
-  free(ptr);
+  memory_header_t *header = header_checked(ptr, "free");
+  if (!header) {
+    return;  // Leaking beats corrupting the heap
+  }
+  account_free((memory_tag_t)header->tag, header->size);
+  header->magic = 0;
+  free(header);
+}
+
+void memory_track_external(memory_tag_t tag, size_t size) {
+  if (tag_valid(tag) && size > 0) {
+    account_alloc(tag, size);
+  }
+}
 
-  pthread_mutex_lock(&memory_mutex);
-  g_memory_stats.free_count++;
-  pthread_mutex_unlock(&memory_mutex);
+void memory_untrack_external(memory_tag_t tag, size_t size) {
+  if (tag_valid(tag) && size > 0) {
+    account_free(tag, size);
+  }
 }
 
 memory_pool_t *memory_pool_create(size_t size, size_t alignment) {
@@ -165,13 +362,180 @@ void memory_pool_destroy(memory_pool_t *pool) {
   }
 }
 
+// =============================================================================
+// MEMORY ARENA
+// =============================================================================
+
+typedef struct memory_arena_chunk {
+  struct memory_arena_chunk *next;
+  memory_pool_t pool;
+  alignas(max_align_t) unsigned char data[];
+} memory_arena_chunk_t;
+
+static memory_arena_chunk_t *arena_chunk_create(memory_arena_t *arena,
+                                                size_t min_size) {
+  size_t size = arena->chunk_size ? arena->chunk_size : MEMORY_ARENA_CHUNK_SIZE;
+  if (size < min_size) {
+    size = min_size;
+  }
+  if (size > SIZE_MAX - sizeof(memory_arena_chunk_t)) {
+    return NULL;
+  }
+
+  memory_arena_chunk_t *chunk =
+      bongocat_malloc_tagged(arena->tag, sizeof(memory_arena_chunk_t) + size);
+  if (!chunk) {
+    return NULL;
+  }
+  chunk->pool = (memory_pool_t){
+      .data = chunk->data,
+      .size = size,
+      .used = 0,
+      .alignment = alignof(void *),
+  };
+  chunk->next = arena->chunks;
+  arena->chunks = chunk;
+  return chunk;
+}
+
+void *memory_arena_alloc(memory_arena_t *arena, size_t size) {
+  if (!arena || size == 0 || size > SIZE_MAX - alignof(void *)) {
+    return NULL;
+  }
+
+  // Only the newest chunk has room worth looking at
+  size_t aligned_size = (size + alignof(void *) - 1) & ~(alignof(void *) - 1);
+  memory_arena_chunk_t *chunk = arena->chunks;
+  if (!chunk || chunk->pool.used + aligned_size > chunk->pool.size) {
+    chunk = arena_chunk_create(arena, aligned_size);
+    if (!chunk) {
+      bongocat_log_error("Failed to grow arena by %zu bytes", size);
+      return NULL;
+    }
+  }
+  return memory_pool_alloc(&chunk->pool, size);
+}
+
+char *memory_arena_strndup(memory_arena_t *arena, const char *str,
+                           size_t len) {
+  if (!str || len == SIZE_MAX) {
+    return NULL;
+  }
+  char *copy = memory_arena_alloc(arena, len + 1);
+  if (copy) {
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+  }
+  return copy;
+}
+
+char *memory_arena_strdup(memory_arena_t *arena, const char *str) {
+  return str ? memory_arena_strndup(arena, str, strlen(str)) : NULL;
+}
+
+void memory_arena_reset(memory_arena_t *arena) {
+  if (!arena || !arena->chunks) {
+    return;
+  }
+
+  // Keep the oldest chunk, which usually has the configured size
+  memory_arena_chunk_t *chunk = arena->chunks;
+  while (chunk->next) {
+    memory_arena_chunk_t *next = chunk->next;
+    bongocat_free(chunk);
+    chunk = next;
+  }
+  memory_pool_reset(&chunk->pool);
+  arena->chunks = chunk;
+}
+
+void memory_arena_destroy(memory_arena_t *arena) {
+  if (!arena) {
+    return;
+  }
+  memory_arena_chunk_t *chunk = arena->chunks;
+  while (chunk) {
+    memory_arena_chunk_t *next = chunk->next;
+    bongocat_free(chunk);
+    chunk = next;
+  }
+  arena->chunks = NULL;
+}
+
+void memory_arena_usage(const memory_arena_t *arena, size_t *used,
+                        size_t *capacity) {
+  size_t total_used = 0;
+  size_t total_capacity = 0;
+  for (const memory_arena_chunk_t *chunk = arena ? arena->chunks : NULL;
+       chunk; chunk = chunk->next) {
+    total_used += chunk->pool.used;
+    total_capacity += chunk->pool.size;
+  }
+  if (used) {
+    *used = total_used;
+  }
+  if (capacity) {
+    *capacity = total_capacity;
+  }
+}
+
+const char *memory_tag_name(memory_tag_t tag) {
+  switch (tag) {
+  case MEMORY_TAG_OTHER:
+    return "other";
+  case MEMORY_TAG_CONFIG:
+    return "config";
+  case MEMORY_TAG_FRAME_CACHE:
+    return "frame cache";
+  case MEMORY_TAG_SVG:
+    return "svg";
+  case MEMORY_TAG_WAYLAND:
+    return "wayland";
+  default:
+    return "unknown";
+  }
+}
+
 void memory_get_stats(memory_stats_t *stats) {
   if (!stats)
     return;
 
-  pthread_mutex_lock(&memory_mutex);
-  *stats = g_memory_stats;
-  pthread_mutex_unlock(&memory_mutex);
+  *stats = (memory_stats_t){0};
+  size_t allocated[MEMORY_TAG_COUNT] = {0};
+  size_t freed[MEMORY_TAG_COUNT] = {0};
+  size_t alloc_counts[MEMORY_TAG_COUNT] = {0};
+  size_t free_counts[MEMORY_TAG_COUNT] = {0};
+  for (memory_counters_t *block = atomic_load(&counter_blocks); block;
+       block = block->next) {
+    for (int tag = 0; tag < MEMORY_TAG_COUNT; tag++) {
+      allocated[tag] += atomic_load_explicit(&block->allocated[tag],
+                                             memory_order_relaxed);
+      freed[tag] +=
+          atomic_load_explicit(&block->freed[tag], memory_order_relaxed);
+      alloc_counts[tag] += atomic_load_explicit(&block->allocations[tag],
+                                                memory_order_relaxed);
+      free_counts[tag] +=
+          atomic_load_explicit(&block->frees[tag], memory_order_relaxed);
+    }
+  }
+  for (int tag = 0; tag < MEMORY_TAG_COUNT; tag++) {
+    allocated[tag] += atomic_load(&fallback_counters.allocated[tag]);
+    freed[tag] += atomic_load(&fallback_counters.freed[tag]);
+    alloc_counts[tag] += atomic_load(&fallback_counters.allocations[tag]);
+    free_counts[tag] += atomic_load(&fallback_counters.frees[tag]);
+
+    // Other threads may be mid-update; never report negative live memory
+    size_t live = allocated[tag] - freed[tag];
+    size_t blocks = alloc_counts[tag] - free_counts[tag];
+    stats->tags[tag].live_bytes = live <= allocated[tag] ? live : 0;
+    stats->tags[tag].live_blocks = blocks <= alloc_counts[tag] ? blocks : 0;
+
+    stats->total_allocated += allocated[tag];
+    stats->allocation_count += alloc_counts[tag];
+    stats->free_count += free_counts[tag];
+  }
+  stats->current_allocated = atomic_load(&live_bytes);
+  stats->peak_allocated = atomic_load(&peak_bytes);
 }
 
 void memory_print_stats(void) {
@@ -186,6 +550,12 @@ void memory_print_stats(void) {
   bongocat_log_info("  Frees: %zu", stats.free_count);
   bongocat_log_info("  Potential leaks: %zu",
                     stats.allocation_count - stats.free_count);
+  bongocat_log_info("  Live by subsystem:");
+  for (int tag = 0; tag < MEMORY_TAG_COUNT; tag++) {
+    bongocat_log_info("    %-12s %10zu bytes in %zu blocks",
+                      memory_tag_name((memory_tag_t)tag),
+                      stats.tags[tag].live_bytes, stats.tags[tag].live_blocks);
+  }
 }
 
 #ifdef DEBUG
@@ -227,6 +597,17 @@ void bongocat_free_debug(void *ptr, [[maybe_unused]] const char *file,
 }
 
 void memory_leak_check(void) {
+  memory_stats_t stats;
+  memory_get_stats(&stats);
+  for (int tag = 0; tag < MEMORY_TAG_COUNT; tag++) {
+    if (stats.tags[tag].live_blocks > 0) {
+      bongocat_log_warning("%zu bytes in %zu blocks still live in %s",
+                           stats.tags[tag].live_bytes,
+                           stats.tags[tag].live_blocks,
+                           memory_tag_name((memory_tag_t)tag));
+    }
+  }
+
   if (!allocations) {
     bongocat_log_info("No memory leaks detected");
     return;
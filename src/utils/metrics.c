@@ -0,0 +1,347 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "utils/metrics.h"
+
+#include "utils/memory.h"
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// =============================================================================
+// COUNTERS
+// =============================================================================
+
+typedef struct {
+  atomic_uint_fast64_t counters[METRIC_COUNTER_COUNT];
+  atomic_uint_fast64_t wakeups[METRICS_THREAD_COUNT];
+  atomic_int input_devices;
+  latency_histogram_t draw;
+  latency_histogram_t reload;
+} metrics_state_t;
+
+// Process memory until metrics_init() maps the shared copy
+static metrics_state_t local_state;
+static metrics_state_t *state = &local_state;
+static bool state_shared = false;
+static int64_t start_us;
+
+static const char *const thread_names[METRICS_THREAD_COUNT] = {
+    [METRICS_THREAD_MAIN] = "main",
+    [METRICS_THREAD_ANIMATION] = "animation",
+    [METRICS_THREAD_CONFIG_WATCHER] = "config_watcher",
+    [METRICS_THREAD_INPUT] = "input",
+};
+
+static void metrics_reset(metrics_state_t *s) {
+  for (int i = 0; i < METRIC_COUNTER_COUNT; i++) {
+    atomic_store_explicit(&s->counters[i], 0, memory_order_relaxed);
+  }
+  for (int i = 0; i < METRICS_THREAD_COUNT; i++) {
+    atomic_store_explicit(&s->wakeups[i], 0, memory_order_relaxed);
+  }
+  atomic_store_explicit(&s->input_devices, 0, memory_order_relaxed);
+  latency_histogram_reset(&s->draw);
+  latency_histogram_reset(&s->reload);
+}
+
+bongocat_error_t metrics_init(void) {
+  start_us = latency_now_us();
+  if (state_shared) {
+    metrics_reset(state);
+    return BONGOCAT_SUCCESS;
+  }
+
+  // Each instance maps its own copy: multi-monitor children call this
+  // after they are forked, so they never share counters
+  void *map = mmap(NULL, sizeof(metrics_state_t), PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (map == MAP_FAILED) {
+    bongocat_log_warning("Cannot share metrics with the input child: %s",
+                         strerror(errno));
+    metrics_reset(state);
+    return BONGOCAT_ERROR_MEMORY;
+  }
+
+  // The mapping starts zeroed, which is a reset state
+  state = map;
+  state_shared = true;
+  return BONGOCAT_SUCCESS;
+}
+
+void metrics_cleanup(void) {
+  if (state_shared) {
+    munmap(state, sizeof(metrics_state_t));
+    state = &local_state;
+    state_shared = false;
+  }
+}
+
+void metrics_add(metrics_counter_t counter, uint64_t value) {
+  if (counter < METRIC_COUNTER_COUNT) {
+    atomic_fetch_add_explicit(&state->counters[counter], value,
+                              memory_order_relaxed);
+  }
+}
+
+void metrics_count_wakeup(metrics_thread_t thread) {
+  if (thread < METRICS_THREAD_COUNT) {
+    atomic_fetch_add_explicit(&state->wakeups[thread], 1,
+                              memory_order_relaxed);
+  }
+}
+
+void metrics_set_input_devices(int count) {
+  atomic_store_explicit(&state->input_devices, count, memory_order_relaxed);
+}
+
+void metrics_record_draw(uint64_t duration_us) {
+  latency_histogram_record(&state->draw, duration_us);
+}
+
+void metrics_record_reload(uint64_t duration_us) {
+  latency_histogram_record(&state->reload, duration_us);
+}
+
+// =============================================================================
+// SNAPSHOTS
+// =============================================================================
+
+uint64_t metrics_hist_bound_us(size_t i) {
+  return 1ULL << (METRICS_HIST_MIN_BITS + i);
+}
+
+const char *metrics_thread_name(metrics_thread_t thread) {
+  return thread < METRICS_THREAD_COUNT ? thread_names[thread] : "unknown";
+}
+
+static void metrics_snapshot_histogram(const latency_histogram_t *hist,
+                                       metrics_histogram_t *out) {
+  latency_summary_t summary;
+  latency_histogram_summarize(hist, &summary);
+  out->count = summary.count;
+  out->max_us = summary.max_us;
+  out->p50_us = summary.p50_us;
+  out->p99_us = summary.p99_us;
+  out->sum_us = atomic_load_explicit(&hist->sum_us, memory_order_relaxed);
+  for (size_t i = 0; i < METRICS_HIST_BOUNDS; i++) {
+    out->below[i] =
+        latency_histogram_count_below(hist, metrics_hist_bound_us(i));
+  }
+}
+
+void metrics_snapshot(metrics_snapshot_t *out,
+                      const metrics_snapshot_t *prev) {
+  if (!out) {
+    return;
+  }
+  *out = (metrics_snapshot_t){0};
+  out->taken_us = latency_now_us();
+  out->uptime_us =
+      out->taken_us > start_us ? (uint64_t)(out->taken_us - start_us) : 0;
+  out->pid = (int)getpid();
+
+  for (int i = 0; i < METRIC_COUNTER_COUNT; i++) {
+    out->counters[i] =
+        atomic_load_explicit(&state->counters[i], memory_order_relaxed);
+  }
+
+  int64_t since_us = prev ? out->taken_us - prev->taken_us
+                          : (int64_t)out->uptime_us;
+  for (int i = 0; i < METRICS_THREAD_COUNT; i++) {
+    out->wakeups[i] =
+        atomic_load_explicit(&state->wakeups[i], memory_order_relaxed);
+    uint64_t before = prev && prev->wakeups[i] <= out->wakeups[i]
+                          ? prev->wakeups[i]
+                          : 0;
+    out->wakeups_per_sec[i] =
+        since_us > 0 ? (double)(out->wakeups[i] - before) * 1e6 /
+                           (double)since_us
+                     : 0.0;
+  }
+
+  out->input_devices =
+      atomic_load_explicit(&state->input_devices, memory_order_relaxed);
+  metrics_snapshot_histogram(&state->draw, &out->draw);
+  metrics_snapshot_histogram(&state->reload, &out->reload);
+
+  // Frame cache and SHM buffers are accounted by the allocator already
+  memory_stats_t mem;
+  memory_get_stats(&mem);
+  out->frame_cache_bytes = mem.tags[MEMORY_TAG_FRAME_CACHE].live_bytes;
+  out->shm_bytes = mem.tags[MEMORY_TAG_WAYLAND].live_bytes;
+}
+
+// =============================================================================
+// OUTPUT FORMATS
+// =============================================================================
+
+// Text appended to a fixed buffer; len keeps counting past the end so the
+// caller learns the size it needs
+typedef struct {
+  char *buf;
+  size_t size;
+  size_t len;
+} metrics_text_t;
+
+static void text_printf(metrics_text_t *t, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+static void text_printf(metrics_text_t *t, const char *fmt, ...) {
+  size_t room = t->len < t->size ? t->size - t->len : 0;
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(room > 0 ? t->buf + t->len : NULL, room, fmt, ap);
+  va_end(ap);
+  if (n > 0) {
+    t->len += (size_t)n;
+  }
+}
+
+static size_t text_finish(const metrics_text_t *t) {
+  if (t->size > 0 && t->len >= t->size) {
+    t->buf[t->size - 1] = '\0';
+  }
+  return t->len;
+}
+
+static void json_histogram(metrics_text_t *t, const char *name,
+                           const metrics_histogram_t *h) {
+  text_printf(t,
+              "\"%s\":{\"count\":%llu,\"sum_us\":%llu,\"p50_us\":%llu,"
+              "\"p99_us\":%llu,\"max_us\":%llu,\"buckets\":[",
+              name, (unsigned long long)h->count,
+              (unsigned long long)h->sum_us, (unsigned long long)h->p50_us,
+              (unsigned long long)h->p99_us, (unsigned long long)h->max_us);
+  for (size_t i = 0; i < METRICS_HIST_BOUNDS; i++) {
+    text_printf(t, "%s{\"lt_us\":%llu,\"count\":%llu}", i > 0 ? "," : "",
+                (unsigned long long)metrics_hist_bound_us(i),
+                (unsigned long long)h->below[i]);
+  }
+  text_printf(t, "]}");
+}
+
+size_t metrics_format_json(const metrics_snapshot_t *snap, char *buf,
+                           size_t size) {
+  metrics_text_t t = {.buf = buf, .size = size};
+  if (!snap) {
+    return 0;
+  }
+
+  text_printf(&t, "{\"pid\":%d,\"uptime_s\":%.3f,", snap->pid,
+              (double)snap->uptime_us / 1e6);
+  text_printf(&t, "\"frames\":{\"drawn\":%llu,\"skipped\":%llu},",
+              (unsigned long long)snap->counters[METRIC_FRAMES_DRAWN],
+              (unsigned long long)snap->counters[METRIC_FRAMES_SKIPPED]);
+  json_histogram(&t, "draw_time", &snap->draw);
+
+  text_printf(&t, ",\"wakeups\":{");
+  for (int i = 0; i < METRICS_THREAD_COUNT; i++) {
+    text_printf(&t, "%s\"%s\":{\"total\":%llu,\"per_sec\":%.2f}",
+                i > 0 ? "," : "", thread_names[i],
+                (unsigned long long)snap->wakeups[i],
+                snap->wakeups_per_sec[i]);
+  }
+
+  text_printf(
+      &t,
+      "},\"key_presses\":{\"received\":%llu,\"coalesced\":%llu,"
+      "\"suppressed\":%llu},\"input_devices\":%d,",
+      (unsigned long long)snap->counters[METRIC_KEY_PRESSES],
+      (unsigned long long)snap->counters[METRIC_KEY_PRESSES_COALESCED],
+      (unsigned long long)snap->counters[METRIC_KEY_PRESSES_SUPPRESSED],
+      snap->input_devices);
+  json_histogram(&t, "reload_time", &snap->reload);
+  text_printf(&t, ",\"frame_cache_bytes\":%zu,\"shm_bytes\":%zu}\n",
+              snap->frame_cache_bytes, snap->shm_bytes);
+  return text_finish(&t);
+}
+
+static void openmetrics_family(metrics_text_t *t, const char *name,
+                               const char *type, const char *unit,
+                               const char *help) {
+  text_printf(t, "# TYPE %s %s\n", name, type);
+  if (unit) {
+    text_printf(t, "# UNIT %s %s\n", name, unit);
+  }
+  text_printf(t, "# HELP %s %s\n", name, help);
+}
+
+static void openmetrics_counter(metrics_text_t *t, const char *name,
+                                const char *help, uint64_t value) {
+  openmetrics_family(t, name, "counter", NULL, help);
+  text_printf(t, "%s_total %llu\n", name, (unsigned long long)value);
+}
+
+static void openmetrics_histogram(metrics_text_t *t, const char *name,
+                                  const char *help,
+                                  const metrics_histogram_t *h) {
+  openmetrics_family(t, name, "histogram", "seconds", help);
+  for (size_t i = 0; i < METRICS_HIST_BOUNDS; i++) {
+    text_printf(t, "%s_bucket{le=\"%.6f\"} %llu\n", name,
+                (double)metrics_hist_bound_us(i) / 1e6,
+                (unsigned long long)h->below[i]);
+  }
+  text_printf(t, "%s_bucket{le=\"+Inf\"} %llu\n", name,
+              (unsigned long long)h->count);
+  text_printf(t, "%s_count %llu\n", name, (unsigned long long)h->count);
+  text_printf(t, "%s_sum %.6f\n", name, (double)h->sum_us / 1e6);
+}
+
+size_t metrics_format_openmetrics(const metrics_snapshot_t *snap, char *buf,
+                                  size_t size) {
+  metrics_text_t t = {.buf = buf, .size = size};
+  if (!snap) {
+    return 0;
+  }
+
+  openmetrics_family(&t, "bongocat_frames", "counter", NULL,
+                     "Redraws by whether any surface was drawn.");
+  text_printf(&t, "bongocat_frames_total{result=\"drawn\"} %llu\n",
+              (unsigned long long)snap->counters[METRIC_FRAMES_DRAWN]);
+  text_printf(&t, "bongocat_frames_total{result=\"skipped\"} %llu\n",
+              (unsigned long long)snap->counters[METRIC_FRAMES_SKIPPED]);
+  openmetrics_histogram(&t, "bongocat_draw_seconds",
+                        "Time to compose, commit and flush a drawn frame.",
+                        &snap->draw);
+
+  openmetrics_family(&t, "bongocat_wakeups", "counter", NULL,
+                     "Times each thread returned from its wait.");
+  for (int i = 0; i < METRICS_THREAD_COUNT; i++) {
+    text_printf(&t, "bongocat_wakeups_total{thread=\"%s\"} %llu\n",
+                thread_names[i], (unsigned long long)snap->wakeups[i]);
+  }
+
+  openmetrics_counter(&t, "bongocat_key_presses",
+                      "Key presses read by the input child.",
+                      snap->counters[METRIC_KEY_PRESSES]);
+  openmetrics_counter(&t, "bongocat_key_presses_coalesced",
+                      "Key presses that shared a wakeup with another.",
+                      snap->counters[METRIC_KEY_PRESSES_COALESCED]);
+  openmetrics_counter(&t, "bongocat_key_presses_suppressed",
+                      "Key presses while rendering was suspended.",
+                      snap->counters[METRIC_KEY_PRESSES_SUPPRESSED]);
+
+  openmetrics_family(&t, "bongocat_input_devices", "gauge", NULL,
+                     "Input devices the input child is reading.");
+  text_printf(&t, "bongocat_input_devices %d\n", snap->input_devices);
+  openmetrics_histogram(&t, "bongocat_reload_seconds",
+                        "Time to apply a changed config file.",
+                        &snap->reload);
+
+  openmetrics_family(&t, "bongocat_frame_cache_bytes", "gauge", "bytes",
+                     "Rasterized cat frames.");
+  text_printf(&t, "bongocat_frame_cache_bytes %zu\n", snap->frame_cache_bytes);
+  openmetrics_family(&t, "bongocat_shm_bytes", "gauge", "bytes",
+                     "Mapped wl_shm buffers.");
+  text_printf(&t, "bongocat_shm_bytes %zu\n", snap->shm_bytes);
+  openmetrics_family(&t, "bongocat_uptime_seconds", "gauge", "seconds",
+                     "Time since the instance started.");
+  text_printf(&t, "bongocat_uptime_seconds %.3f\n",
+              (double)snap->uptime_us / 1e6);
+  text_printf(&t, "# EOF\n");
+  return text_finish(&t);
+}
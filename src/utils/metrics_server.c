@@ -0,0 +1,302 @@
+#define _GNU_SOURCE
+#include "utils/metrics_server.h"
+
+#include "utils/metrics.h"
+#include "utils/trace.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// A client that has not sent its request by then gets JSON
+#define METRICS_REQUEST_TIMEOUT_MS 100
+#define METRICS_SEND_TIMEOUT_MS    1000
+#define METRICS_REQUEST_MAX        512
+#define METRICS_RESPONSE_MAX       16384
+
+typedef enum {
+  METRICS_FORMAT_JSON,
+  METRICS_FORMAT_OPENMETRICS,
+  METRICS_FORMAT_UNKNOWN,
+} metrics_format_t;
+
+static int listen_fd = -1;
+static int shutdown_fd = -1;
+static pthread_t server_thread;
+static bool server_running = false;
+static char socket_path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+
+// Only the server thread formats responses, so these are not shared
+static char response[METRICS_RESPONSE_MAX];
+static metrics_snapshot_t last_snapshot;
+static bool have_last_snapshot = false;
+
+// =============================================================================
+// REQUESTS
+// =============================================================================
+
+// Read the request line: up to a newline, EOF or the receive timeout
+static size_t read_request(int fd, char *buf, size_t size) {
+  size_t len = 0;
+  while (len + 1 < size) {
+    ssize_t n = recv(fd, buf + len, size - 1 - len, 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      break;
+    }
+    len += (size_t)n;
+    if (memchr(buf, '\n', len)) {
+      break;
+    }
+  }
+  buf[len] = '\0';
+  return len;
+}
+
+static bool word_is(const char *p, size_t len, const char *word) {
+  return strlen(word) == len && strncmp(p, word, len) == 0;
+}
+
+// Plain requests are a format name; HTTP requests name it by path.
+// Sets *http for an HTTP request.
+static metrics_format_t parse_request(const char *req, bool *http) {
+  *http = strncmp(req, "GET ", 4) == 0;
+  const char *p = *http ? req + 4 : req;
+  size_t len = strcspn(p, *http ? " ?\r\n" : " \t\r\n");
+
+  if (*http) {
+    if (word_is(p, len, "/metrics")) {
+      return METRICS_FORMAT_OPENMETRICS;
+    }
+    return word_is(p, len, "/json") ? METRICS_FORMAT_JSON
+                                    : METRICS_FORMAT_UNKNOWN;
+  }
+  if (len == 0 || word_is(p, len, "json")) {
+    return METRICS_FORMAT_JSON;
+  }
+  return word_is(p, len, "openmetrics") ? METRICS_FORMAT_OPENMETRICS
+                                        : METRICS_FORMAT_UNKNOWN;
+}
+
+static void send_all(int fd, const char *data, size_t len) {
+  while (len > 0) {
+    ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return;
+    }
+    data += n;
+    len -= (size_t)n;
+  }
+}
+
+static void set_timeout(int fd, int option, int timeout_ms) {
+  struct timeval tv = {.tv_sec = timeout_ms / 1000,
+                       .tv_usec = (timeout_ms % 1000) * 1000};
+  setsockopt(fd, SOL_SOCKET, option, &tv, sizeof(tv));
+}
+
+static void serve_client(int fd) {
+  struct ucred cred;
+  socklen_t cred_len = sizeof(cred);
+  if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &cred_len) < 0 ||
+      cred.uid != getuid()) {
+    return;
+  }
+
+  set_timeout(fd, SO_RCVTIMEO, METRICS_REQUEST_TIMEOUT_MS);
+  set_timeout(fd, SO_SNDTIMEO, METRICS_SEND_TIMEOUT_MS);
+
+  char request[METRICS_REQUEST_MAX];
+  read_request(fd, request, sizeof(request));
+  bool http;
+  metrics_format_t format = parse_request(request, &http);
+
+  if (format == METRICS_FORMAT_UNKNOWN) {
+    const char *reply =
+        http ? "HTTP/1.0 404 Not Found\r\nContent-Length: 0\r\n"
+               "Connection: close\r\n\r\n"
+             : "error: send json or openmetrics\n";
+    send_all(fd, reply, strlen(reply));
+    return;
+  }
+
+  metrics_snapshot_t snap;
+  metrics_snapshot(&snap, have_last_snapshot ? &last_snapshot : NULL);
+  last_snapshot = snap;
+  have_last_snapshot = true;
+
+  size_t len =
+      format == METRICS_FORMAT_JSON
+          ? metrics_format_json(&snap, response, sizeof(response))
+          : metrics_format_openmetrics(&snap, response, sizeof(response));
+  if (len >= sizeof(response)) {
+    bongocat_log_warning("Metrics response truncated to %zu bytes",
+                         sizeof(response) - 1);
+    len = sizeof(response) - 1;
+  }
+
+  if (http) {
+    char header[256];
+    int header_len = snprintf(
+        header, sizeof(header),
+        "HTTP/1.0 200 OK\r\nContent-Type: %s\r\nContent-Length: %zu\r\n"
+        "Connection: close\r\n\r\n",
+        format == METRICS_FORMAT_JSON
+            ? "application/json"
+            : "application/openmetrics-text; version=1.0.0; charset=utf-8",
+        len);
+    send_all(fd, header, (size_t)header_len);
+  }
+  send_all(fd, response, len);
+}
+
+// =============================================================================
+// SERVER THREAD
+// =============================================================================
+
+static void *metrics_server_thread([[maybe_unused]] void *arg) {
+  trace_set_thread_name("metrics");
+  while (true) {
+    struct pollfd pfds[2] = {
+        {.fd = listen_fd, .events = POLLIN},
+        {.fd = shutdown_fd, .events = POLLIN},
+    };
+    if (poll(pfds, 2, -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      bongocat_log_error("Metrics socket poll failed: %s", strerror(errno));
+      break;
+    }
+    if (pfds[1].revents & POLLIN) {
+      break;
+    }
+    if (!(pfds[0].revents & POLLIN)) {
+      continue;
+    }
+
+    int client = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+    if (client < 0) {
+      continue;
+    }
+    int64_t span = trace_begin();
+    serve_client(client);
+    close(client);
+    trace_end("scrape", span);
+  }
+  return NULL;
+}
+
+// $XDG_RUNTIME_DIR/bongocat, created private to the user
+static bool make_socket_dir(char *dir, size_t size) {
+  const char *runtime = getenv("XDG_RUNTIME_DIR");
+  if (!runtime || runtime[0] == '\0') {
+    bongocat_log_warning("XDG_RUNTIME_DIR is not set, no metrics socket");
+    return false;
+  }
+  int len = snprintf(dir, size, "%s/bongocat", runtime);
+  if (len < 0 || (size_t)len >= size) {
+    return false;
+  }
+  if (mkdir(dir, S_IRWXU) < 0 && errno != EEXIST) {
+    bongocat_log_warning("Cannot create %s: %s", dir, strerror(errno));
+    return false;
+  }
+
+  struct stat st;
+  if (lstat(dir, &st) < 0 || !S_ISDIR(st.st_mode) || st.st_uid != getuid()) {
+    bongocat_log_warning("%s is not a directory we own, no metrics socket",
+                         dir);
+    return false;
+  }
+  return true;
+}
+
+bongocat_error_t metrics_server_start(void) {
+  if (server_running) {
+    return BONGOCAT_SUCCESS;
+  }
+
+  char dir[sizeof(socket_path)];
+  if (!make_socket_dir(dir, sizeof(dir))) {
+    return BONGOCAT_ERROR_FILE_IO;
+  }
+  int len = snprintf(socket_path, sizeof(socket_path), "%s/%d.sock", dir,
+                     (int)getpid());
+  if (len < 0 || (size_t)len >= sizeof(socket_path)) {
+    bongocat_log_warning("Metrics socket path is too long");
+    socket_path[0] = '\0';
+    return BONGOCAT_ERROR_FILE_IO;
+  }
+
+  struct sockaddr_un addr = {.sun_family = AF_UNIX};
+  memcpy(addr.sun_path, socket_path, (size_t)len + 1);
+
+  // A socket left by a crashed process with our pid is stale
+  unlink(socket_path);
+  listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  shutdown_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (listen_fd < 0 || shutdown_fd < 0 ||
+      bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+      chmod(socket_path, S_IRUSR | S_IWUSR) < 0 || listen(listen_fd, 4) < 0) {
+    bongocat_log_warning("Cannot create metrics socket %s: %s", socket_path,
+                         strerror(errno));
+    metrics_server_stop();
+    return BONGOCAT_ERROR_FILE_IO;
+  }
+
+  if (pthread_create(&server_thread, NULL, metrics_server_thread, NULL) !=
+      0) {
+    bongocat_log_warning("Cannot start metrics thread: %s", strerror(errno));
+    metrics_server_stop();
+    return BONGOCAT_ERROR_THREAD;
+  }
+
+  server_running = true;
+  bongocat_log_info("Metrics socket: %s", socket_path);
+  return BONGOCAT_SUCCESS;
+}
+
+void metrics_server_stop(void) {
+  if (server_running) {
+    uint64_t val = 1;
+    if (write(shutdown_fd, &val, sizeof(val)) < 0) {
+      // The thread only exits through this fd; leave it running
+      bongocat_log_warning("Failed to stop metrics thread: %s",
+                           strerror(errno));
+    } else {
+      pthread_join(server_thread, NULL);
+    }
+    server_running = false;
+  }
+
+  if (listen_fd >= 0) {
+    close(listen_fd);
+    listen_fd = -1;
+    unlink(socket_path);
+  }
+  if (shutdown_fd >= 0) {
+    close(shutdown_fd);
+    shutdown_fd = -1;
+  }
+  socket_path[0] = '\0';
+  have_last_snapshot = false;
+}
+
+const char *metrics_server_path(void) {
+  return server_running ? socket_path : NULL;
+}
@@ -0,0 +1,310 @@
+#define _GNU_SOURCE
+#include "utils/trace.h"
+
+#include "utils/latency.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// =============================================================================
+// BUFFERS
+// =============================================================================
+
+typedef struct {
+  const char *name;  // String literal
+  int64_t ts_us;
+  int64_t arg;
+  uint32_t dur_us;
+  char phase;  // 'X' span, 'i' instant
+  bool has_arg;
+} trace_event_t;
+
+typedef struct {
+  atomic_uint count;    // Events published by the owning thread
+  atomic_uint dropped;  // Events that did not fit
+  int pid;
+  int tid;
+  const char *thread_name;
+  trace_event_t events[TRACE_EVENTS_PER_SLOT];
+} trace_slot_t;
+
+typedef struct {
+  atomic_uint slots_used;  // Claimed by threads of every process
+  atomic_uint slots_missed;
+  trace_slot_t slots[TRACE_MAX_THREADS];
+} trace_buffers_t;
+
+atomic_bool trace_enabled_flag = false;
+
+static trace_buffers_t *buffers;
+static char *trace_path;
+static _Thread_local trace_slot_t *thread_slot;
+static _Thread_local bool thread_slot_claimed;
+
+// A forked child starts out on the thread that forked it, whose slot
+// belongs to the parent
+static void trace_after_fork(void) {
+  thread_slot = NULL;
+  thread_slot_claimed = false;
+}
+
+static trace_slot_t *trace_claim_slot(const char *name) {
+  thread_slot_claimed = true;
+  unsigned index = atomic_fetch_add(&buffers->slots_used, 1);
+  if (index >= TRACE_MAX_THREADS) {
+    atomic_fetch_add(&buffers->slots_missed, 1);
+    return NULL;
+  }
+
+  trace_slot_t *slot = &buffers->slots[index];
+  slot->pid = (int)getpid();
+  slot->tid = (int)gettid();
+  slot->thread_name = name;
+  return slot;
+}
+
+static void trace_record(const char *name, char phase, int64_t ts_us,
+                         int64_t dur_us, bool has_arg, int64_t arg) {
+  if (!thread_slot_claimed) {
+    thread_slot = trace_claim_slot(NULL);
+  }
+  trace_slot_t *slot = thread_slot;
+  if (!slot) {
+    return;
+  }
+
+  // Only this thread writes the slot: fill the event, then publish it
+  unsigned n = atomic_load_explicit(&slot->count, memory_order_relaxed);
+  if (n >= TRACE_EVENTS_PER_SLOT) {
+    atomic_fetch_add_explicit(&slot->dropped, 1, memory_order_relaxed);
+    return;
+  }
+  slot->events[n] = (trace_event_t){
+      .name = name,
+      .ts_us = ts_us,
+      .arg = arg,
+      .dur_us = dur_us > UINT32_MAX ? UINT32_MAX : (uint32_t)dur_us,
+      .phase = phase,
+      .has_arg = has_arg,
+  };
+  atomic_store_explicit(&slot->count, n + 1, memory_order_release);
+}
+
+// =============================================================================
+// RECORDING
+// =============================================================================
+
+bongocat_error_t trace_init(const char *path) {
+  BONGOCAT_CHECK_NULL(path, BONGOCAT_ERROR_INVALID_PARAM);
+  if (buffers) {
+    return BONGOCAT_SUCCESS;
+  }
+
+  // Check the path now rather than at exit
+  int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    bongocat_log_error("Cannot create trace %s: %s", path, strerror(errno));
+    return BONGOCAT_ERROR_FILE_IO;
+  }
+  close(fd);
+
+  trace_path = strdup(path);
+  // Shared so the input child records into it; pages are only backed
+  // once written
+  void *map = mmap(NULL, sizeof(trace_buffers_t), PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (!trace_path || map == MAP_FAILED) {
+    bongocat_log_error("Cannot allocate trace buffers: %s", strerror(errno));
+    free(trace_path);
+    trace_path = NULL;
+    return BONGOCAT_ERROR_MEMORY;
+  }
+
+  buffers = map;
+  static bool atfork_registered = false;
+  if (!atfork_registered) {
+    pthread_atfork(NULL, NULL, trace_after_fork);
+    atfork_registered = true;
+  }
+  thread_slot_claimed = false;
+  atomic_store(&trace_enabled_flag, true);
+  bongocat_log_info("Tracing thread activity to %s", path);
+  return BONGOCAT_SUCCESS;
+}
+
+void trace_set_thread_name(const char *name) {
+  if (!trace_enabled()) {
+    return;
+  }
+  if (!thread_slot_claimed) {
+    thread_slot = trace_claim_slot(name);
+  } else if (thread_slot) {
+    thread_slot->thread_name = name;
+  }
+}
+
+int64_t trace_begin(void) {
+  return trace_enabled() ? latency_now_us() : 0;
+}
+
+void trace_end(const char *name, int64_t start_us) {
+  if (start_us > 0 && trace_enabled()) {
+    trace_record(name, 'X', start_us, latency_now_us() - start_us, false, 0);
+  }
+}
+
+void trace_end_arg(const char *name, int64_t start_us, int64_t arg) {
+  if (start_us > 0 && trace_enabled()) {
+    trace_record(name, 'X', start_us, latency_now_us() - start_us, true, arg);
+  }
+}
+
+void trace_instant(const char *name) {
+  if (trace_enabled()) {
+    trace_record(name, 'i', latency_now_us(), 0, false, 0);
+  }
+}
+
+void trace_instant_arg(const char *name, int64_t arg) {
+  if (trace_enabled()) {
+    trace_record(name, 'i', latency_now_us(), 0, true, arg);
+  }
+}
+
+// =============================================================================
+// OUTPUT
+// =============================================================================
+
+// Strings come from the program itself; escape anyway so a thread name
+// can never break the document
+static void write_json_string(FILE *f, const char *s) {
+  fputc('"', f);
+  for (; *s; s++) {
+    if (*s == '"' || *s == '\\') {
+      fputc('\\', f);
+    }
+    fputc((unsigned char)*s < 0x20 ? ' ' : *s, f);
+  }
+  fputc('"', f);
+}
+
+static void write_metadata(FILE *f, const char *kind, int pid, int tid,
+                           const char *name) {
+  fprintf(f, ",\n{\"ph\":\"M\",\"name\":\"%s\",\"pid\":%d,\"tid\":%d,"
+             "\"args\":{\"name\":",
+          kind, pid, tid);
+  write_json_string(f, name);
+  fputs("}}", f);
+}
+
+static void write_event(FILE *f, const trace_slot_t *slot,
+                        const trace_event_t *ev) {
+  fputs(",\n{\"name\":", f);
+  write_json_string(f, ev->name ? ev->name : "?");
+  fprintf(f, ",\"ph\":\"%c\",\"ts\":%lld,\"pid\":%d,\"tid\":%d", ev->phase,
+          (long long)ev->ts_us, slot->pid, slot->tid);
+  if (ev->phase == 'X') {
+    fprintf(f, ",\"dur\":%u", ev->dur_us);
+  } else {
+    fputs(",\"s\":\"t\"", f);
+  }
+  if (ev->has_arg) {
+    fprintf(f, ",\"args\":{\"value\":%lld}", (long long)ev->arg);
+  }
+  fputc('}', f);
+}
+
+bongocat_error_t trace_write(void) {
+  if (!buffers || !trace_path) {
+    return BONGOCAT_ERROR_INVALID_PARAM;
+  }
+
+  int fd = open(trace_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                S_IRUSR | S_IWUSR);
+  FILE *f = fd >= 0 ? fdopen(fd, "w") : NULL;
+  if (!f) {
+    bongocat_log_error("Cannot write trace %s: %s", trace_path,
+                       strerror(errno));
+    if (fd >= 0) {
+      close(fd);
+    }
+    return BONGOCAT_ERROR_FILE_IO;
+  }
+
+  unsigned used = atomic_load_explicit(&buffers->slots_used,
+                                       memory_order_acquire);
+  used = used < TRACE_MAX_THREADS ? used : TRACE_MAX_THREADS;
+  int self = (int)getpid();
+
+  fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", f);
+  fprintf(f, "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":%d,\"tid\":0,"
+             "\"args\":{\"name\":\"bongocat\"}}",
+          self);
+
+  size_t written = 0;
+  uint64_t dropped = 0;
+  int last_child = 0;
+  for (unsigned i = 0; i < used; i++) {
+    const trace_slot_t *slot = &buffers->slots[i];
+    // A slot is claimed before its pid is set; skip one caught between
+    unsigned count =
+        atomic_load_explicit(&slot->count, memory_order_acquire);
+    if (slot->pid == 0) {
+      continue;
+    }
+    if (slot->pid != self && slot->pid != last_child) {
+      write_metadata(f, "process_name", slot->pid, 0, "bongocat input child");
+      last_child = slot->pid;
+    }
+    write_metadata(f, "thread_name", slot->pid, slot->tid,
+                   slot->thread_name ? slot->thread_name : "thread");
+
+    for (unsigned k = 0; k < count; k++) {
+      write_event(f, slot, &slot->events[k]);
+    }
+    written += count;
+    dropped += atomic_load_explicit(&slot->dropped, memory_order_relaxed);
+  }
+
+  unsigned missed = atomic_load(&buffers->slots_missed);
+  fprintf(f, "\n],\"otherData\":{\"dropped_events\":\"%llu\","
+             "\"untraced_threads\":\"%u\"}}\n",
+          (unsigned long long)dropped, missed);
+
+  bool ok = !ferror(f);
+  ok = fclose(f) == 0 && ok;
+  if (!ok) {
+    bongocat_log_error("Cannot write trace %s: %s", trace_path,
+                       strerror(errno));
+    return BONGOCAT_ERROR_FILE_IO;
+  }
+
+  bongocat_log_info("Trace written to %s: %zu events from %u threads",
+                    trace_path, written, used);
+  if (dropped > 0 || missed > 0) {
+    bongocat_log_warning("Trace buffers were full: %llu events and %u "
+                         "threads not recorded",
+                         (unsigned long long)dropped, missed);
+  }
+  return BONGOCAT_SUCCESS;
+}
+
+void trace_cleanup(void) {
+  atomic_store(&trace_enabled_flag, false);
+  if (buffers) {
+    munmap(buffers, sizeof(trace_buffers_t));
+    buffers = NULL;
+  }
+  free(trace_path);
+  trace_path = NULL;
+  thread_slot = NULL;
+  thread_slot_claimed = false;
+}
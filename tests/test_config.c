@@ -12,7 +12,9 @@ struct zxdg_output_v1;
 
 #include "../include/core/bongocat.h"
 #include "../include/config/config.h"
+#include "../include/config/config_keys.h"
 #include "../include/utils/error.h"
+#include "../include/utils/memory.h"
 
 #include <assert.h>
 #include <limits.h>
@@ -80,6 +82,8 @@ static void test_defaults(void) {
   TEST_ASSERT_EQ(config.overlay_position, POSITION_TOP,
                  "default position is top");
   TEST_ASSERT_EQ(config.layer, LAYER_TOP, "default layer is top");
+  TEST_ASSERT_EQ(config.multi_monitor_mode, MULTI_MONITOR_PROCESS,
+                 "default multi_monitor_mode is process");
   TEST_ASSERT_EQ(config.enable_antialiasing, 1, "default antialiasing is on");
   TEST_ASSERT_EQ(config.enable_hand_mapping, 1,
                  "default hand_mapping is on");
@@ -87,6 +91,8 @@ static void test_defaults(void) {
   TEST_ASSERT_EQ(config.cat_y_offset, 10, "default cat_y_offset is 10");
   TEST_ASSERT_EQ(config.keypress_duration, 100,
                  "default keypress_duration is 100");
+  TEST_ASSERT_EQ(config.enable_output_power_tracking, 0,
+                 "default output power tracking is off");
 
   config_cleanup_full(&config);
   unlink(path);
@@ -240,7 +246,7 @@ static void test_enum_parsing(void) {
   close(fd);
 
   write_temp_config(path, "overlay_position=bottom\nlayer=overlay\n"
-                          "cat_align=right\n");
+                          "cat_align=right\nmulti_monitor_mode=shared\n");
 
   config_t config = {0};
   bongocat_error_t err = load_config(&config, path);
@@ -249,6 +255,38 @@ static void test_enum_parsing(void) {
                  "position is bottom");
   TEST_ASSERT_EQ(config.layer, LAYER_OVERLAY, "layer is overlay");
   TEST_ASSERT_EQ(config.cat_align, ALIGN_RIGHT, "align is right");
+  TEST_ASSERT_EQ(config.multi_monitor_mode, MULTI_MONITOR_SHARED,
+                 "multi_monitor_mode is shared");
+
+  config_cleanup_full(&config);
+  unlink(path);
+}
+
+// ---------------------------------------------------------------------------
+// Test: output power tracking is opt-in (wlroots gives each output's power
+// object to one client, which would take it from wlopm)
+// ---------------------------------------------------------------------------
+static void test_output_power_opt_in(void) {
+  printf("test_output_power_opt_in...\n");
+  char path[] = "/tmp/bongocat_test_XXXXXX";
+  int fd = mkstemp(path);
+  assert(fd >= 0);
+  close(fd);
+
+  write_temp_config(path, "fps=30\n");
+  config_t config = {0};
+  bongocat_error_t err = load_config(&config, path);
+  TEST_ASSERT_EQ(err, BONGOCAT_SUCCESS, "config without the key loads");
+  TEST_ASSERT_EQ(config.enable_output_power_tracking, 0,
+                 "tracking stays off unless asked for");
+  config_cleanup_full(&config);
+
+  write_temp_config(path, "enable_output_power_tracking=1\n");
+  memset(&config, 0, sizeof(config));
+  err = load_config(&config, path);
+  TEST_ASSERT_EQ(err, BONGOCAT_SUCCESS, "opt-in config loads");
+  TEST_ASSERT_EQ(config.enable_output_power_tracking, 1,
+                 "tracking on when enabled");
 
   config_cleanup_full(&config);
   unlink(path);
@@ -281,6 +319,256 @@ static void test_comments_and_whitespace(void) {
   unlink(path);
 }
 
+// ---------------------------------------------------------------------------
+// Test: content hash of the config file
+// ---------------------------------------------------------------------------
+static void test_file_hash(void) {
+  printf("test_file_hash...\n");
+  char path[] = "/tmp/bongocat_test_XXXXXX";
+  int fd = mkstemp(path);
+  assert(fd >= 0);
+  close(fd);
+
+  uint64_t first = 0;
+  uint64_t second = 0;
+  write_temp_config(path, "fps=30\ncat_height=60\n");
+  TEST_ASSERT(config_file_hash(path, &first), "file hashed");
+  write_temp_config(path, "fps=30\ncat_height=60\n");
+  TEST_ASSERT(config_file_hash(path, &second) && first == second,
+              "rewrite with identical bytes hashes the same");
+  write_temp_config(path, "fps=30\ncat_height=61\n");
+  TEST_ASSERT(config_file_hash(path, &second) && first != second,
+              "edit changes the hash");
+
+  unlink(path);
+  TEST_ASSERT(!config_file_hash(path, &second), "missing file not hashed");
+}
+
+// ---------------------------------------------------------------------------
+// Test: field diff picks the cheapest reload actions
+// ---------------------------------------------------------------------------
+static unsigned diff_after(const char *before, const char *after) {
+  char path[] = "/tmp/bongocat_test_XXXXXX";
+  int fd = mkstemp(path);
+  assert(fd >= 0);
+  close(fd);
+
+  config_t old_config = {0};
+  config_t new_config = {0};
+  write_temp_config(path, before);
+  bongocat_error_t err = load_config(&old_config, path);
+  write_temp_config(path, after);
+  err |= load_config(&new_config, path);
+  unlink(path);
+
+  unsigned changes = config_diff(&old_config, &new_config);
+  config_cleanup_full(&old_config);
+  config_cleanup_full(&new_config);
+  return err == BONGOCAT_SUCCESS ? changes : ~0U;
+}
+
+static void test_config_diff(void) {
+  printf("test_config_diff...\n");
+
+  TEST_ASSERT_EQ(diff_after("fps=30\n", "# comment\nfps = 30\n"),
+                 CONFIG_CHANGE_NONE, "reformatted file changes nothing");
+  TEST_ASSERT_EQ(diff_after("overlay_opacity=100\n", "overlay_opacity=200\n"),
+                 CONFIG_CHANGE_REDRAW, "opacity is redraw only");
+  TEST_ASSERT_EQ(diff_after("keypress_duration=100\n",
+                            "keypress_duration=150\n"),
+                 CONFIG_CHANGE_REDRAW, "timing is redraw only");
+  TEST_ASSERT_EQ(diff_after("cat_height=40\n", "cat_height=60\n"),
+                 CONFIG_CHANGE_CACHE, "cat size rebuilds the cache");
+  TEST_ASSERT_EQ(diff_after("mirror_x=0\n", "mirror_x=1\n"),
+                 CONFIG_CHANGE_CACHE, "mirroring rebuilds the cache");
+  TEST_ASSERT_EQ(diff_after("overlay_height=50\n", "overlay_height=80\n"),
+                 CONFIG_CHANGE_BUFFER, "height rebuilds the buffer");
+  TEST_ASSERT_EQ(diff_after("layer=top\n", "layer=overlay\n"),
+                 CONFIG_CHANGE_SURFACE, "layer is a surface change");
+  TEST_ASSERT_EQ(diff_after("monitor=eDP-1\n", "monitor=HDMI-A-1\n"),
+                 CONFIG_CHANGE_SURFACE, "monitor is a surface change");
+  TEST_ASSERT_EQ(diff_after("keyboard_device=/dev/input/event0\n",
+                            "keyboard_device=/dev/input/event1\n"),
+                 CONFIG_CHANGE_INPUT, "device restarts input");
+  TEST_ASSERT_EQ(diff_after("hotplug_scan_interval=30\n",
+                            "hotplug_scan_interval=60\n"),
+                 CONFIG_CHANGE_INPUT, "scan interval restarts input");
+  TEST_ASSERT_EQ(diff_after("fps=30\ncat_height=40\n",
+                            "fps=60\ncat_height=50\n"),
+                 CONFIG_CHANGE_REDRAW | CONFIG_CHANGE_CACHE,
+                 "independent changes combine");
+
+  char names[64];
+  config_change_describe(CONFIG_CHANGE_CACHE | CONFIG_CHANGE_INPUT, names,
+                         sizeof(names));
+  TEST_ASSERT(strcmp(names, "cache, input") == 0, "changes described");
+  config_change_describe(CONFIG_CHANGE_NONE, names, sizeof(names));
+  TEST_ASSERT(strcmp(names, "none") == 0, "no changes described");
+}
+
+// ---------------------------------------------------------------------------
+// Test: perfect-hash key table
+// ---------------------------------------------------------------------------
+static void test_key_lookup(void) {
+  printf("test_key_lookup...\n");
+
+  bool all_found = true;
+  for (int id = 0; id < CONFIG_KEY_COUNT; id++) {
+    const char *name = config_key_names[id];
+    all_found &= config_key_lookup(name, strlen(name)) == (config_key_t)id;
+  }
+  TEST_ASSERT(all_found, "every key finds itself");
+
+  TEST_ASSERT(config_key_lookup("fp", 2) == CONFIG_KEY_NONE, "prefix rejected");
+  TEST_ASSERT(config_key_lookup("fpsx", 4) == CONFIG_KEY_NONE,
+              "longer key rejected");
+  TEST_ASSERT(config_key_lookup("fps=60", 3) == CONFIG_KEY_FPS,
+              "lookup works on an unterminated span");
+  TEST_ASSERT(config_key_lookup("", 0) == CONFIG_KEY_NONE, "empty rejected");
+}
+
+// ---------------------------------------------------------------------------
+// Test: a config generation lives in a few arena chunks, freed in one go
+// ---------------------------------------------------------------------------
+static void test_generation_release(void) {
+  printf("test_generation_release...\n");
+  char path[] = "/tmp/bongocat_test_XXXXXX";
+  int fd = mkstemp(path);
+  assert(fd >= 0);
+  close(fd);
+
+  FILE *f = fopen(path, "w");
+  assert(f != NULL);
+  fputs("monitor=", f);
+  for (int i = 0; i < 20; i++) {
+    fprintf(f, "%sDP-%d", i ? "," : "", i);
+  }
+  fputs("\nmonitor=HDMI-A-1, DP-1\n", f);  // Replaces the first list
+  for (int i = 0; i < 12; i++) {
+    fprintf(f, "keyboard_device=/dev/input/event%d\n", i);
+    fprintf(f, "keyboard_name=Keyboard %d\n", i);
+  }
+  fclose(f);
+
+  memory_stats_t before;
+  memory_get_stats(&before);
+  size_t allocations = 0;
+  for (int generation = 0; generation < 3; generation++) {
+    config_t config = {0};
+    bongocat_error_t err = load_config(&config, path);
+    TEST_ASSERT_EQ(err, BONGOCAT_SUCCESS, "config loads");
+    memory_stats_t loaded;
+    memory_get_stats(&loaded);
+    allocations = loaded.allocation_count - before.allocation_count;
+    TEST_ASSERT_EQ(config.num_output_names, 2, "later monitor list wins");
+    TEST_ASSERT(config.output_name == config.output_names[0] &&
+                    strcmp(config.output_name, "HDMI-A-1") == 0,
+                "output_name is the first monitor");
+    TEST_ASSERT(config.num_keyboard_devices >= 12 &&
+                    strcmp(config.keyboard_devices[11],
+                           "/dev/input/event11") == 0,
+                "devices kept in order past array growth");
+    TEST_ASSERT(config.num_names == 12 &&
+                    strcmp(config.keyboard_names[11], "Keyboard 11") == 0,
+                "names kept in order past array growth");
+
+    config_cleanup_full(&config);
+    memory_stats_t released;
+    memory_get_stats(&released);
+    TEST_ASSERT(released.tags[MEMORY_TAG_CONFIG].live_bytes ==
+                    before.tags[MEMORY_TAG_CONFIG].live_bytes,
+                "cleanup releases the whole generation");
+    TEST_ASSERT(config.output_names == NULL && config.num_names == 0,
+                "pointers cleared");
+    before = released;
+  }
+  printf("  %zu tracked allocations per load for 24 string entries\n",
+         allocations);
+  TEST_ASSERT(allocations <= 4, "strings share arena chunks");
+
+  unlink(path);
+}
+
+// ---------------------------------------------------------------------------
+// Test: lines are not limited in length
+// ---------------------------------------------------------------------------
+static void test_long_lines(void) {
+  printf("test_long_lines...\n");
+  char path[] = "/tmp/bongocat_test_XXXXXX";
+  int fd = mkstemp(path);
+  assert(fd >= 0);
+  close(fd);
+
+  // 100 monitors is about 1.5 KB on one line; the old 512-byte line
+  // buffer cut it and parsed the rest as a separate, broken line
+  FILE *f = fopen(path, "w");
+  assert(f != NULL);
+  fputs("monitor=", f);
+  for (int i = 0; i < 100; i++) {
+    fprintf(f, "%sMONITOR-%04d", i ? ", " : "", i);
+  }
+  fputs("\r\nfps=42\r\nkeyboard_name=", f);
+  for (int i = 0; i < 600; i++) {
+    fputc('k', f);
+  }
+  fputs("\ncat_height=77", f);  // No trailing newline
+  fclose(f);
+
+  config_t config = {0};
+  bongocat_error_t err = load_config(&config, path);
+  TEST_ASSERT_EQ(err, BONGOCAT_SUCCESS, "long line config loads");
+  TEST_ASSERT_EQ(config.num_output_names, 100, "every monitor kept");
+  TEST_ASSERT(config.num_output_names == 100 &&
+                  strcmp(config.output_names[99], "MONITOR-0099") == 0,
+              "last monitor intact");
+  TEST_ASSERT_EQ(config.fps, 42, "CRLF line parsed");
+  TEST_ASSERT(config.num_names == 1 && strlen(config.keyboard_names[0]) == 600,
+              "600-byte keyboard name kept whole");
+  TEST_ASSERT_EQ(config.cat_height, 77, "last line without newline parsed");
+
+  config_cleanup_full(&config);
+  unlink(path);
+}
+
+// ---------------------------------------------------------------------------
+// Test: a large generated config parses in full
+// ---------------------------------------------------------------------------
+static void test_large_config(void) {
+  printf("test_large_config...\n");
+  char path[] = "/tmp/bongocat_test_XXXXXX";
+  int fd = mkstemp(path);
+  assert(fd >= 0);
+  close(fd);
+
+  static const char *const lines[] = {
+      "# comment line\n",
+      "enable_output_power_tracking=1\n",
+      "disable_fullscreen_hide = 0  # inline comment\n",
+      "hotplug_scan_interval=30\n",
+      "layer=top\n",
+      "cat_align=center\n",
+      "sleep_begin=22:00\n",
+      "fps=60\n",
+  };
+  FILE *f = fopen(path, "w");
+  assert(f != NULL);
+  for (int i = 0; i < 20000; i++) {
+    fputs(lines[i % 8], f);
+  }
+  fclose(f);
+
+  config_t config = {0};
+  TEST_ASSERT_EQ(load_config(&config, path), BONGOCAT_SUCCESS,
+                 "large config loaded");
+  TEST_ASSERT_EQ(config.fps, 60, "fps parsed");
+  TEST_ASSERT_EQ(config.sleep_begin.hour, 22, "sleep_begin parsed");
+  TEST_ASSERT_EQ(config.hotplug_scan_interval, 30, "hotplug interval parsed");
+  TEST_ASSERT_EQ(config.cat_align, ALIGN_CENTER, "cat_align parsed");
+
+  config_cleanup_full(&config);
+  unlink(path);
+}
+
 int main(void) {
   bongocat_error_init(0);  // Suppress debug output
   printf("=== Config Parser Tests ===\n");
@@ -292,7 +580,14 @@ int main(void) {
   test_monitor_list();
   test_keyboard_device_validation();
   test_enum_parsing();
+  test_output_power_opt_in();
   test_comments_and_whitespace();
+  test_file_hash();
+  test_config_diff();
+  test_key_lookup();
+  test_long_lines();
+  test_generation_release();
+  test_large_config();
 
   printf("\nResults: %d passed, %d failed\n", tests_passed, tests_failed);
   return tests_failed > 0 ? 1 : 0;
@@ -0,0 +1,184 @@
+// Unit tests for the directory-based config watcher
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
+#include "../include/core/bongocat.h"
+#include "../include/utils/error.h"
+
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST_ASSERT(cond, msg)                                                 \
+  do {                                                                         \
+    if (cond) {                                                                \
+      tests_passed++;                                                          \
+    } else {                                                                   \
+      tests_failed++;                                                          \
+      fprintf(stderr, "  FAIL: %s:%d: %s\n", __FILE__, __LINE__, msg);        \
+    }                                                                          \
+  } while (0)
+
+static int reloads = 0;
+
+static void on_reload([[maybe_unused]] const char *path) {
+  reloads++;
+}
+
+static long long now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000LL;
+}
+
+// Dispatch like the watcher thread until a reload or timeout_ms pass.
+// Returns the time to the first reload, or -1.
+static long long pump(ConfigWatcher *watcher, int timeout_ms) {
+  long long start = now_ms();
+  int before = reloads;
+  while (now_ms() - start < timeout_ms) {
+    struct pollfd pfds[2] = {
+        {.fd = watcher->inotify_fd, .events = POLLIN},
+        {.fd = watcher->debounce_fd, .events = POLLIN},
+    };
+    int remaining = timeout_ms - (int)(now_ms() - start);
+    if (poll(pfds, 2, remaining > 0 ? remaining : 0) <= 0) {
+      continue;
+    }
+    config_watcher_dispatch(watcher);
+    if (reloads != before) {
+      return now_ms() - start;
+    }
+  }
+  return -1;
+}
+
+static void write_file(const char *path, const char *content) {
+  FILE *f = fopen(path, "w");
+  if (f) {
+    fputs(content, f);
+    fclose(f);
+  }
+}
+
+// Save the way vim and most editors do: write a temp file, rename it over
+static void rename_save(const char *dir, const char *path,
+                        const char *content) {
+  char tmp[512];
+  snprintf(tmp, sizeof(tmp), "%s/.bongocat.conf.swp", dir);
+  write_file(tmp, content);
+  rename(tmp, path);
+}
+
+// ---------------------------------------------------------------------------
+// Test: in-place writes and rename saves both reload, and keep working
+// ---------------------------------------------------------------------------
+static void test_saves(const char *dir) {
+  printf("test_saves...\n");
+  char path[512];
+  snprintf(path, sizeof(path), "%s/bongocat.conf", dir);
+  write_file(path, "fps=30\n");
+
+  ConfigWatcher watcher;
+  TEST_ASSERT(config_watcher_init(&watcher, path, on_reload) == 0,
+              "watcher initialized");
+
+  reloads = 0;
+  write_file(path, "fps=31\n");
+  long long latency = pump(&watcher, 1000);
+  TEST_ASSERT(latency >= 0 && reloads == 1, "in-place write reloads once");
+  printf("  in-place write: reload after %lld ms\n", latency);
+
+  // The old watcher lost the inode here; the directory watch can't
+  for (int i = 0; i < 5; i++) {
+    reloads = 0;
+    rename_save(dir, path, i % 2 ? "fps=32\n" : "fps=33\n");
+    latency = pump(&watcher, 1000);
+    TEST_ASSERT(latency >= 0 && reloads == 1, "rename save reloads once");
+  }
+  printf("  rename save: reload after %lld ms\n", latency);
+
+  // Other files in the directory are ignored
+  reloads = 0;
+  char other[512];
+  snprintf(other, sizeof(other), "%s/other.conf", dir);
+  write_file(other, "x\n");
+  TEST_ASSERT(pump(&watcher, 100) < 0 && reloads == 0,
+              "unrelated file ignored");
+  unlink(other);
+
+  // A burst of writes is one reload after the last of them
+  reloads = 0;
+  for (int i = 0; i < 10; i++) {
+    write_file(path, "fps=34\n");
+  }
+  TEST_ASSERT(pump(&watcher, 1000) >= 0, "burst reloads");
+  (void)pump(&watcher, 100);
+  TEST_ASSERT(reloads == 1, "burst coalesced into one reload");
+
+  config_watcher_cleanup(&watcher);
+  unlink(path);
+}
+
+// ---------------------------------------------------------------------------
+// Test: edits through a symlink target are seen
+// ---------------------------------------------------------------------------
+static void test_symlink(const char *dir) {
+  printf("test_symlink...\n");
+  char target_dir[512];
+  char target[600];
+  char link[512];
+  snprintf(target_dir, sizeof(target_dir), "%s/dotfiles", dir);
+  snprintf(target, sizeof(target), "%s/bongocat.conf", target_dir);
+  snprintf(link, sizeof(link), "%s/linked.conf", dir);
+  TEST_ASSERT(mkdir(target_dir, 0700) == 0, "target dir created");
+  write_file(target, "fps=30\n");
+  TEST_ASSERT(symlink(target, link) == 0, "symlink created");
+
+  ConfigWatcher watcher;
+  TEST_ASSERT(config_watcher_init(&watcher, link, on_reload) == 0,
+              "watcher initialized on symlink");
+
+  reloads = 0;
+  write_file(target, "fps=40\n");
+  TEST_ASSERT(pump(&watcher, 1000) >= 0 && reloads == 1,
+              "target edit reloads");
+
+  // Repointing the link is seen in the link's directory
+  reloads = 0;
+  unlink(link);
+  TEST_ASSERT(symlink(target, link) == 0, "symlink replaced");
+  TEST_ASSERT(pump(&watcher, 1000) >= 0 && reloads == 1,
+              "link replacement reloads");
+
+  config_watcher_cleanup(&watcher);
+  unlink(link);
+  unlink(target);
+  rmdir(target_dir);
+}
+
+int main(void) {
+  bongocat_error_init(0);
+  printf("=== Config Watcher Tests ===\n");
+
+  char dir[] = "/tmp/bongocat_watch_XXXXXX";
+  if (!mkdtemp(dir)) {
+    perror("mkdtemp");
+    return 1;
+  }
+
+  test_saves(dir);
+  test_symlink(dir);
+  rmdir(dir);
+
+  printf("\nResults: %d passed, %d failed\n", tests_passed, tests_failed);
+  return tests_failed > 0 ? 1 : 0;
+}
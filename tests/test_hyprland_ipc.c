@@ -0,0 +1,330 @@
+// Unit tests for the Hyprland IPC client, against a fake socket server
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/platform/hyprland_ipc.h"
+#include "../include/utils/error.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST_ASSERT(cond, msg)                                                 \
+  do {                                                                         \
+    if (cond) {                                                                \
+      tests_passed++;                                                          \
+    } else {                                                                   \
+      tests_failed++;                                                          \
+      fprintf(stderr, "  FAIL: %s:%d: %s\n", __FILE__, __LINE__, msg);        \
+    }                                                                          \
+  } while (0)
+
+static const char active_window_json[] =
+    "{\n"
+    "    \"address\": \"0x55d1\",\n"
+    "    \"mapped\": true,\n"
+    "    \"at\": [10, 50],\n"
+    "    \"size\": [1900, 1020],\n"
+    "    \"workspace\": {\"id\": 3, \"name\": \"3\"},\n"
+    "    \"title\": \"say \\\"monitor\\\": 9, [nested]\",\n"
+    "    \"monitor\": 1,\n"
+    "    \"fullscreen\": 2,\n"
+    "    \"grouped\": []\n"
+    "}\n";
+
+static const char monitors_json[] =
+    "[{\n"
+    "    \"id\": 0,\n"
+    "    \"name\": \"eDP-1\",\n"
+    "    \"activeWorkspace\": {\"id\": 1, \"name\": \"1\"},\n"
+    "    \"availableModes\": [\"1920x1080@60.00Hz\"]\n"
+    "},{\n"
+    "    \"id\": 1,\n"
+    "    \"name\": \"HDMI-A-1\"\n"
+    "}]\n";
+
+// ---------------------------------------------------------------------------
+// Test: reply parsers
+// ---------------------------------------------------------------------------
+static void test_parse_replies(void) {
+  printf("test_parse_replies...\n");
+
+  window_info_t win;
+  TEST_ASSERT(hypr_parse_active_window(active_window_json, &win),
+              "active window parsed");
+  TEST_ASSERT(win.monitor_id == 1, "monitor id (not the one in the title)");
+  TEST_ASSERT(win.fullscreen, "fullscreen mode 2 is fullscreen");
+  TEST_ASSERT(win.x == 10 && win.y == 50, "position");
+  TEST_ASSERT(win.width == 1900 && win.height == 1020, "size");
+
+  TEST_ASSERT(hypr_parse_active_window("{\"monitor\": 0, \"fullscreen\": "
+                                       "false}",
+                                       &win) &&
+                  !win.fullscreen,
+              "boolean fullscreen from older Hyprland");
+  TEST_ASSERT(!hypr_parse_active_window("{}", &win), "no active window");
+  TEST_ASSERT(win.monitor_id == -1, "monitor reset for no active window");
+  TEST_ASSERT(!hypr_parse_active_window("{\"monitor\": ", &win),
+              "truncated reply rejected");
+  TEST_ASSERT(!hypr_parse_active_window("ok", &win), "non-JSON rejected");
+
+  hypr_monitor_t monitors[4];
+  size_t count = hypr_parse_monitors(monitors_json, monitors, 4);
+  TEST_ASSERT(count == 2, "two monitors");
+  TEST_ASSERT(monitors[0].id == 0 && strcmp(monitors[0].name, "eDP-1") == 0,
+              "first monitor");
+  TEST_ASSERT(monitors[1].id == 1 &&
+                  strcmp(monitors[1].name, "HDMI-A-1") == 0,
+              "second monitor");
+  TEST_ASSERT(hypr_parse_monitors(monitors_json, monitors, 1) == 1,
+              "output capacity respected");
+  TEST_ASSERT(hypr_parse_monitors("[]", monitors, 4) == 0, "no monitors");
+}
+
+// ---------------------------------------------------------------------------
+// Test: event lines
+// ---------------------------------------------------------------------------
+static void test_parse_events(void) {
+  printf("test_parse_events...\n");
+  hypr_event_t event;
+
+  const char *line = "fullscreen>>1";
+  TEST_ASSERT(hypr_parse_event(line, strlen(line), &event) &&
+                  event.type == HYPR_EVENT_FULLSCREEN && event.fullscreen,
+              "fullscreen enter");
+  line = "fullscreen>>0";
+  TEST_ASSERT(hypr_parse_event(line, strlen(line), &event) &&
+                  event.type == HYPR_EVENT_FULLSCREEN && !event.fullscreen,
+              "fullscreen exit");
+  line = "activewindow>>kitty,~/src>>build";
+  TEST_ASSERT(hypr_parse_event(line, strlen(line), &event) &&
+                  event.type == HYPR_EVENT_ACTIVE_WINDOW,
+              "active window (separator in data)");
+  line = "monitoradded>>DP-2";
+  TEST_ASSERT(hypr_parse_event(line, strlen(line), &event) &&
+                  event.type == HYPR_EVENT_MONITOR_ADDED &&
+                  strcmp(event.monitor_name, "DP-2") == 0,
+              "monitor added");
+  line = "activewindowv2>>55d1";
+  TEST_ASSERT(hypr_parse_event(line, strlen(line), &event) &&
+                  event.type == HYPR_EVENT_OTHER,
+              "other events are recognized but ignored");
+  line = "garbage";
+  TEST_ASSERT(!hypr_parse_event(line, strlen(line), &event),
+              "line without separator rejected");
+}
+
+// ---------------------------------------------------------------------------
+// Test: event reader handles split and batched lines
+// ---------------------------------------------------------------------------
+static int seen_fullscreen = 0;
+static int seen_active = 0;
+static int seen_monitor = 0;
+
+static void count_event(const hypr_event_t *event, [[maybe_unused]] void *d) {
+  switch (event->type) {
+  case HYPR_EVENT_FULLSCREEN:
+    seen_fullscreen++;
+    break;
+  case HYPR_EVENT_ACTIVE_WINDOW:
+    seen_active++;
+    break;
+  case HYPR_EVENT_MONITOR_ADDED:
+    seen_monitor++;
+    break;
+  case HYPR_EVENT_OTHER:
+    break;
+  }
+}
+
+static void write_all(int fd, const char *data) {
+  size_t len = strlen(data);
+  while (len > 0) {
+    ssize_t n = write(fd, data, len);
+    if (n <= 0) {
+      return;
+    }
+    data += n;
+    len -= (size_t)n;
+  }
+}
+
+static void test_event_reader(void) {
+  printf("test_event_reader...\n");
+  int sv[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sv) < 0) {
+    TEST_ASSERT(false, "socketpair");
+    return;
+  }
+
+  hypr_event_reader_t reader;
+  hypr_event_reader_init(&reader, sv[0]);
+
+  TEST_ASSERT(hypr_event_reader_dispatch(&reader, count_event, NULL) == 0,
+              "nothing to read");
+
+  write_all(sv[1], "fullscreen>>1\nactivewin");
+  TEST_ASSERT(hypr_event_reader_dispatch(&reader, count_event, NULL) == 1,
+              "complete line dispatched, partial kept");
+  write_all(sv[1], "dow>>kitty,vim\nmonitoradded>>DP-2\n");
+  TEST_ASSERT(hypr_event_reader_dispatch(&reader, count_event, NULL) == 2,
+              "partial line completed");
+  TEST_ASSERT(seen_fullscreen == 1 && seen_active == 1 && seen_monitor == 1,
+              "each event seen once");
+
+  // A line longer than the buffer is dropped without losing the next one
+  char *huge = malloc(HYPR_EVENT_BUF_SIZE * 2);
+  if (huge) {
+    memset(huge, 'x', HYPR_EVENT_BUF_SIZE * 2 - 1);
+    huge[HYPR_EVENT_BUF_SIZE * 2 - 1] = '\0';
+    write_all(sv[1], "openwindow>>");
+    write_all(sv[1], huge);
+    write_all(sv[1], "\nfullscreen>>0\n");
+    free(huge);
+    TEST_ASSERT(hypr_event_reader_dispatch(&reader, count_event, NULL) == 1,
+                "overlong line dropped");
+    TEST_ASSERT(seen_fullscreen == 2, "event after overlong line seen");
+  }
+
+  close(sv[1]);
+  TEST_ASSERT(hypr_event_reader_dispatch(&reader, count_event, NULL) == -1,
+              "closed stream reported");
+  close(sv[0]);
+}
+
+// ---------------------------------------------------------------------------
+// Test: requests against a fake Hyprland socket
+// ---------------------------------------------------------------------------
+typedef struct {
+  int listen_fd;
+  int connections;
+  char last_request[64];
+} fake_server_t;
+
+static void *fake_server_main(void *arg) {
+  fake_server_t *server = arg;
+  for (int i = 0; i < server->connections; i++) {
+    int fd = accept(server->listen_fd, NULL, NULL);
+    if (fd < 0) {
+      return NULL;
+    }
+
+    ssize_t n = read(fd, server->last_request,
+                     sizeof(server->last_request) - 1);
+    server->last_request[n > 0 ? n : 0] = '\0';
+    if (strcmp(server->last_request, "j/activewindow") == 0) {
+      write_all(fd, active_window_json);
+    } else if (strcmp(server->last_request, "j/monitors") == 0) {
+      write_all(fd, monitors_json);
+    } else {
+      write_all(fd, "unknown request");
+    }
+    close(fd);
+  }
+  return NULL;
+}
+
+static void test_fake_server(void) {
+  printf("test_fake_server...\n");
+
+  char runtime_dir[] = "/tmp/bongocat_hypr_XXXXXX";
+  if (!mkdtemp(runtime_dir)) {
+    TEST_ASSERT(false, "mkdtemp");
+    return;
+  }
+  char hypr_dir[128];
+  char instance_dir[160];
+  snprintf(hypr_dir, sizeof(hypr_dir), "%s/hypr", runtime_dir);
+  snprintf(instance_dir, sizeof(instance_dir), "%s/test_sig", hypr_dir);
+  mkdir(hypr_dir, 0700);
+  mkdir(instance_dir, 0700);
+
+  char path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+  setenv("XDG_RUNTIME_DIR", runtime_dir, 1);
+  unsetenv("HYPRLAND_INSTANCE_SIGNATURE");
+  TEST_ASSERT(!hypr_ipc_socket_path(".socket.sock", path, sizeof(path)),
+              "no socket path outside Hyprland");
+  setenv("HYPRLAND_INSTANCE_SIGNATURE", "../escape", 1);
+  TEST_ASSERT(!hypr_ipc_socket_path(".socket.sock", path, sizeof(path)),
+              "signature with a slash rejected");
+  setenv("HYPRLAND_INSTANCE_SIGNATURE", "test_sig", 1);
+
+  // Bind the fake server where the client will look for it
+  char expected[sizeof(path)];
+  int len =
+      snprintf(expected, sizeof(expected), "%s/.socket.sock", instance_dir);
+  if (len < 0 || (size_t)len >= sizeof(expected)) {
+    TEST_ASSERT(false, "socket path fits in sun_path");
+    return;
+  }
+  int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  struct sockaddr_un addr = {.sun_family = AF_UNIX};
+  memcpy(addr.sun_path, expected, (size_t)len + 1);
+  if (listen_fd < 0 ||
+      bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+      listen(listen_fd, 4) < 0) {
+    TEST_ASSERT(false, "fake server listening");
+    return;
+  }
+
+  TEST_ASSERT(hypr_ipc_socket_path(".socket.sock", path, sizeof(path)) &&
+                  strcmp(path, expected) == 0,
+              "socket path under XDG_RUNTIME_DIR");
+
+  fake_server_t server = {.listen_fd = listen_fd, .connections = 3};
+  pthread_t thread;
+  pthread_create(&thread, NULL, fake_server_main, &server);
+
+  char buf[4096];
+  window_info_t win;
+  TEST_ASSERT(hypr_ipc_request(path, "j/activewindow", buf, sizeof(buf)) > 0,
+              "activewindow request answered");
+  TEST_ASSERT(hypr_parse_active_window(buf, &win) && win.monitor_id == 1 &&
+                  win.fullscreen,
+              "activewindow reply parsed");
+
+  hypr_monitor_t monitors[4];
+  TEST_ASSERT(hypr_ipc_request(path, "j/monitors", buf, sizeof(buf)) > 0,
+              "monitors request answered");
+  TEST_ASSERT(hypr_parse_monitors(buf, monitors, 4) == 2,
+              "monitors reply parsed");
+  TEST_ASSERT(strcmp(server.last_request, "j/monitors") == 0,
+              "request sent verbatim");
+
+  char small[8];
+  TEST_ASSERT(hypr_ipc_request(path, "j/monitors", small, sizeof(small)) == 7,
+              "reply truncated to the buffer");
+
+  pthread_join(thread, NULL);
+  close(listen_fd);
+
+  TEST_ASSERT(hypr_ipc_request(path, "j/monitors", buf, sizeof(buf)) == -1,
+              "request fails once the server is gone");
+
+  unlink(expected);
+  rmdir(instance_dir);
+  rmdir(hypr_dir);
+  rmdir(runtime_dir);
+}
+
+int main(void) {
+  bongocat_error_init(0);
+  printf("=== Hyprland IPC Tests ===\n");
+
+  test_parse_replies();
+  test_parse_events();
+  test_event_reader();
+  test_fake_server();
+
+  printf("\nResults: %d passed, %d failed\n", tests_passed, tests_failed);
+  return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,227 @@
+// Unit tests for input recordings (--record / --replay file format)
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/platform/input_record.h"
+#include "../include/utils/error.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST_ASSERT(cond, msg)                                                 \
+  do {                                                                         \
+    if (cond) {                                                                \
+      tests_passed++;                                                          \
+    } else {                                                                   \
+      tests_failed++;                                                          \
+      fprintf(stderr, "  FAIL: %s:%d: %s\n", __FILE__, __LINE__, msg);        \
+    }                                                                          \
+  } while (0)
+
+static char path[] = "/tmp/bongocat_record_XXXXXX";
+
+static struct input_event make_event(int64_t us, uint16_t type, uint16_t code,
+                                     int32_t value) {
+  struct input_event ev = {.type = type, .code = code, .value = value};
+  ev.input_event_sec = us / 1000000;
+  ev.input_event_usec = us % 1000000;
+  return ev;
+}
+
+// A key press and its SYN_REPORT, as one read() returns them
+static void write_press(input_recorder_t *rec, uint8_t device, int64_t us,
+                        uint16_t code, int32_t value) {
+  struct input_event ev[3] = {
+      make_event(us, EV_MSC, MSC_SCAN, code),
+      make_event(us, EV_KEY, code, value),
+      make_event(us, EV_SYN, SYN_REPORT, 0),
+  };
+  TEST_ASSERT(input_recorder_write(rec, device, ev, 3, 0), "batch written");
+}
+
+static off_t file_size(void) {
+  struct stat st;
+  return stat(path, &st) == 0 ? st.st_size : -1;
+}
+
+// ---------------------------------------------------------------------------
+// Test: recorded events come back with their deltas, devices and values
+// ---------------------------------------------------------------------------
+static void test_round_trip(void) {
+  printf("test_round_trip...\n");
+  unlink(path);  // Created by the recorder, with its mode
+  input_recorder_t rec;
+  TEST_ASSERT(input_recorder_open(&rec, path) == BONGOCAT_SUCCESS,
+              "recorder opened");
+
+  write_press(&rec, 0, 5000000, KEY_A, 1);
+  write_press(&rec, 0, 5080000, KEY_A, 0);
+  write_press(&rec, 1, 5100000, KEY_B, 1);
+  write_press(&rec, 1, 5350000, KEY_B, 2);  // Key repeat
+  TEST_ASSERT(rec.records == 12, "12 records written");
+  input_recorder_close(&rec);
+
+  struct stat st;
+  TEST_ASSERT(stat(path, &st) == 0 && (st.st_mode & 0777) == 0600,
+              "recording is private");
+  TEST_ASSERT(file_size() ==
+                  INPUT_RECORD_HEADER_SIZE + 12 * INPUT_RECORD_SIZE,
+              "12-byte records after an 8-byte header");
+
+  input_recording_t recording;
+  TEST_ASSERT(input_recording_load(&recording, path) == BONGOCAT_SUCCESS,
+              "recording loads");
+  TEST_ASSERT(recording.count == 12, "12 records read");
+  TEST_ASSERT(recording.duration_us == 350000, "duration is the sum");
+  if (recording.count == 12) {
+    const input_record_t *r = recording.records;
+    TEST_ASSERT(r[0].delta_us == 0, "first record has no delta");
+    TEST_ASSERT(r[1].type == EV_KEY && r[1].code == KEY_A && r[1].value == 1,
+                "key press decoded");
+    TEST_ASSERT(r[2].delta_us == 0, "same packet, no delta");
+    TEST_ASSERT(r[3].delta_us == 80000, "release 80 ms later");
+    TEST_ASSERT(r[6].device == 1 && r[6].delta_us == 20000,
+                "second keyboard, 20 ms later");
+    TEST_ASSERT(r[10].value == 2, "repeat value kept");
+    TEST_ASSERT(r[0].type == EV_MSC && r[0].value == KEY_A, "scan decoded");
+  }
+  input_recording_free(&recording);
+  TEST_ASSERT(recording.records == NULL && recording.count == 0,
+              "freed recording cleared");
+}
+
+// ---------------------------------------------------------------------------
+// Test: timestamps going back and clock offsets
+// ---------------------------------------------------------------------------
+static void test_deltas(void) {
+  printf("test_deltas...\n");
+  input_recorder_t rec;
+  TEST_ASSERT(input_recorder_open(&rec, path) == BONGOCAT_SUCCESS,
+              "recorder opened");
+
+  struct input_event ev[3] = {
+      make_event(1000000, EV_KEY, KEY_A, 1),
+      make_event(900000, EV_KEY, KEY_B, 1),   // Earlier: another clock
+      make_event(1000500, EV_KEY, KEY_C, 1),  // 500 us after the latest
+  };
+  TEST_ASSERT(input_recorder_write(&rec, 0, ev, 3, 0), "written");
+
+  // A realtime device shifted onto the monotonic clock
+  struct input_event late = make_event(7001000, EV_KEY, KEY_D, 1);
+  TEST_ASSERT(input_recorder_write(&rec, 0, &late, 1, -6000000),
+              "offset written");
+  input_recorder_close(&rec);
+
+  input_recording_t recording;
+  TEST_ASSERT(input_recording_load(&recording, path) == BONGOCAT_SUCCESS,
+              "recording loads");
+  TEST_ASSERT(recording.count == 4, "4 records");
+  if (recording.count == 4) {
+    TEST_ASSERT(recording.records[1].delta_us == 0, "step back clamps to 0");
+    TEST_ASSERT(recording.records[2].delta_us == 500,
+                "delta from the latest time");
+    TEST_ASSERT(recording.records[3].delta_us == 500,
+                "offset applied before the delta");
+  }
+  input_recording_free(&recording);
+}
+
+// ---------------------------------------------------------------------------
+// Test: batches end at SYN_REPORT, a time step or another device
+// ---------------------------------------------------------------------------
+static void test_batches(void) {
+  printf("test_batches...\n");
+  input_record_t records[] = {
+      {.delta_us = 0, .device = 0, .type = EV_MSC, .code = MSC_SCAN},
+      {.delta_us = 0, .device = 0, .type = EV_KEY, .code = KEY_A},
+      {.delta_us = 0, .device = 0, .type = EV_SYN, .code = SYN_REPORT},
+      {.delta_us = 0, .device = 1, .type = EV_KEY, .code = KEY_B},
+      {.delta_us = 0, .device = 0, .type = EV_KEY, .code = KEY_C},
+      {.delta_us = 10, .device = 0, .type = EV_KEY, .code = KEY_D},
+      {.delta_us = 0, .device = 0, .type = EV_KEY, .code = KEY_E},
+  };
+  input_recording_t recording = {.records = records, .count = 7};
+
+  TEST_ASSERT(input_recording_next_batch(&recording, 0, 64) == 3,
+              "packet ends at SYN_REPORT");
+  TEST_ASSERT(input_recording_next_batch(&recording, 3, 64) == 4,
+              "device change ends a batch");
+  TEST_ASSERT(input_recording_next_batch(&recording, 4, 64) == 5,
+              "time step ends a batch");
+  TEST_ASSERT(input_recording_next_batch(&recording, 5, 64) == 7,
+              "last batch runs to the end");
+  TEST_ASSERT(input_recording_next_batch(&recording, 0, 2) == 2,
+              "batch capped at max");
+  TEST_ASSERT(input_recording_next_batch(&recording, 7, 64) == 7,
+              "nothing past the end");
+}
+
+// ---------------------------------------------------------------------------
+// Test: foreign and truncated files
+// ---------------------------------------------------------------------------
+static void test_invalid(void) {
+  printf("test_invalid...\n");
+  input_recording_t recording;
+
+  FILE *f = fopen(path, "wb");
+  fputs("not a recording", f);
+  fclose(f);
+  TEST_ASSERT(input_recording_load(&recording, path) == BONGOCAT_ERROR_INPUT,
+              "wrong magic rejected");
+
+  f = fopen(path, "wb");
+  fclose(f);
+  TEST_ASSERT(input_recording_load(&recording, path) == BONGOCAT_ERROR_INPUT,
+              "empty file rejected");
+
+  TEST_ASSERT(input_recording_load(&recording, "/nonexistent/rec") ==
+                  BONGOCAT_ERROR_FILE_IO,
+              "missing file reported");
+
+  // A last record cut short is dropped
+  input_recorder_t rec;
+  TEST_ASSERT(input_recorder_open(&rec, path) == BONGOCAT_SUCCESS,
+              "recorder opened");
+  write_press(&rec, 0, 1000, KEY_A, 1);
+  input_recorder_close(&rec);
+  TEST_ASSERT(truncate(path, file_size() - 5) == 0, "file truncated");
+  TEST_ASSERT(input_recording_load(&recording, path) == BONGOCAT_SUCCESS,
+              "truncated recording loads");
+  TEST_ASSERT(recording.count == 2, "whole records kept");
+  input_recording_free(&recording);
+
+  // Header only: a recording without events
+  TEST_ASSERT(truncate(path, INPUT_RECORD_HEADER_SIZE) == 0, "emptied");
+  TEST_ASSERT(input_recording_load(&recording, path) == BONGOCAT_SUCCESS &&
+                  recording.count == 0 && recording.duration_us == 0,
+              "empty recording loads");
+  input_recording_free(&recording);
+}
+
+int main(void) {
+  bongocat_error_init(0);
+  printf("=== Input Recording Tests ===\n");
+
+  int fd = mkstemp(path);
+  if (fd < 0) {
+    perror("mkstemp");
+    return 1;
+  }
+  close(fd);
+
+  test_round_trip();
+  test_deltas();
+  test_batches();
+  test_invalid();
+
+  unlink(path);
+  printf("\nResults: %d passed, %d failed\n", tests_passed, tests_failed);
+  return tests_failed > 0 ? 1 : 0;
+}
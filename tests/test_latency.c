@@ -0,0 +1,196 @@
+// Unit tests for latency histograms and pipeline samples
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/utils/error.h"
+#include "../include/utils/latency.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST_ASSERT(cond, msg)                                                 \
+  do {                                                                         \
+    if (cond) {                                                                \
+      tests_passed++;                                                          \
+    } else {                                                                   \
+      tests_failed++;                                                          \
+      fprintf(stderr, "  FAIL: %s:%d: %s\n", __FILE__, __LINE__, msg);        \
+    }                                                                          \
+  } while (0)
+
+// True if value is within the histogram's ~6% bucket error of expected
+static int within_bucket_error(uint64_t value, uint64_t expected) {
+  uint64_t tolerance = expected / 16 + 1;
+  return value + tolerance >= expected && value <= expected + tolerance;
+}
+
+// ---------------------------------------------------------------------------
+// Test: empty histogram
+// ---------------------------------------------------------------------------
+static void test_histogram_empty(void) {
+  printf("test_histogram_empty...\n");
+  static latency_histogram_t hist;
+  latency_histogram_reset(&hist);
+
+  latency_summary_t s;
+  latency_histogram_summarize(&hist, &s);
+  TEST_ASSERT(s.count == 0, "empty histogram has no samples");
+  TEST_ASSERT(s.p50_us == 0, "empty p50 is 0");
+  TEST_ASSERT(s.max_us == 0, "empty max is 0");
+}
+
+// ---------------------------------------------------------------------------
+// Test: small values are recorded exactly
+// ---------------------------------------------------------------------------
+static void test_histogram_exact_small(void) {
+  printf("test_histogram_exact_small...\n");
+  static latency_histogram_t hist;
+  latency_histogram_reset(&hist);
+
+  for (uint64_t v = 1; v <= 10; v++) {
+    latency_histogram_record(&hist, v);
+  }
+  TEST_ASSERT(latency_histogram_percentile(&hist, 50.0) == 5,
+              "p50 of 1..10 is 5");
+  TEST_ASSERT(latency_histogram_percentile(&hist, 100.0) == 10,
+              "p100 of 1..10 is 10");
+  TEST_ASSERT(latency_histogram_percentile(&hist, 0.0) == 1,
+              "p0 of 1..10 is 1");
+}
+
+// ---------------------------------------------------------------------------
+// Test: percentiles across a wide range
+// ---------------------------------------------------------------------------
+static void test_histogram_percentiles(void) {
+  printf("test_histogram_percentiles...\n");
+  static latency_histogram_t hist;
+  latency_histogram_reset(&hist);
+
+  for (uint64_t v = 1; v <= 1000; v++) {
+    latency_histogram_record(&hist, v * 100);
+  }
+
+  latency_summary_t s;
+  latency_histogram_summarize(&hist, &s);
+  TEST_ASSERT(s.count == 1000, "1000 samples recorded");
+  TEST_ASSERT(s.max_us == 100000, "max is exact");
+  TEST_ASSERT(within_bucket_error(s.p50_us, 50000), "p50 near 50ms");
+  TEST_ASSERT(within_bucket_error(s.p99_us, 99000), "p99 near 99ms");
+  TEST_ASSERT(s.p99_us <= s.max_us, "p99 never exceeds max");
+}
+
+// ---------------------------------------------------------------------------
+// Test: huge values are clamped, not dropped
+// ---------------------------------------------------------------------------
+static void test_histogram_clamp(void) {
+  printf("test_histogram_clamp...\n");
+  static latency_histogram_t hist;
+  latency_histogram_reset(&hist);
+
+  latency_histogram_record(&hist, UINT64_MAX);
+  latency_summary_t s;
+  latency_histogram_summarize(&hist, &s);
+  TEST_ASSERT(s.count == 1, "clamped sample counted");
+  TEST_ASSERT(s.p50_us > 0, "clamped sample lands in top bucket");
+}
+
+// ---------------------------------------------------------------------------
+// Test: cumulative counts at power-of-two limits, and the sum
+// ---------------------------------------------------------------------------
+static void test_histogram_count_below(void) {
+  printf("test_histogram_count_below...\n");
+  static latency_histogram_t hist;
+  latency_histogram_reset(&hist);
+
+  uint64_t values[] = {3, 63, 64, 65, 255, 256, 1000, 5000};
+  uint64_t sum = 0;
+  for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+    latency_histogram_record(&hist, values[i]);
+    sum += values[i];
+  }
+  TEST_ASSERT(latency_histogram_count_below(&hist, 4) == 1, "below 4");
+  TEST_ASSERT(latency_histogram_count_below(&hist, 64) == 2, "below 64");
+  TEST_ASSERT(latency_histogram_count_below(&hist, 256) == 5, "below 256");
+  TEST_ASSERT(latency_histogram_count_below(&hist, 1024) == 7, "below 1024");
+  TEST_ASSERT(latency_histogram_count_below(&hist, 1ULL << 40) == 8,
+              "everything below a huge limit");
+  TEST_ASSERT(atomic_load(&hist.sum_us) == sum, "sum of the values");
+
+  latency_histogram_reset(&hist);
+  TEST_ASSERT(atomic_load(&hist.sum_us) == 0, "reset clears the sum");
+}
+
+// ---------------------------------------------------------------------------
+// Test: sample lifecycle records every marked stage
+// ---------------------------------------------------------------------------
+static void test_sample_finish(void) {
+  printf("test_sample_finish...\n");
+  const latency_histogram_t *flush =
+      latency_get_stage_histogram(LATENCY_STAGE_FLUSH);
+  const latency_histogram_t *read =
+      latency_get_stage_histogram(LATENCY_STAGE_CHILD_READ);
+  uint64_t flush_before = atomic_load(&flush->count);
+  uint64_t read_before = atomic_load(&read->count);
+
+  int64_t now = latency_now_us();
+  latency_sample_begin(now - 2000, now - 1500, now - 1000);
+  TEST_ASSERT(latency_sample_event_us() == now - 2000,
+              "pending sample exposes event time");
+  latency_sample_mark(LATENCY_STAGE_UPDATE);
+  latency_sample_mark(LATENCY_STAGE_BLIT);
+  latency_sample_mark(LATENCY_STAGE_COMMIT);
+  latency_sample_mark(LATENCY_STAGE_FLUSH);
+  latency_sample_finish();
+
+  TEST_ASSERT(atomic_load(&flush->count) == flush_before + 1,
+              "flush stage recorded");
+  TEST_ASSERT(atomic_load(&read->count) == read_before + 1,
+              "child read stage recorded");
+  TEST_ASSERT(atomic_load(&flush->max_us) >= 2000,
+              "flush latency includes time since event");
+  TEST_ASSERT(latency_sample_event_us() == 0, "sample cleared after finish");
+}
+
+// ---------------------------------------------------------------------------
+// Test: aborted and untimed samples record nothing
+// ---------------------------------------------------------------------------
+static void test_sample_abort(void) {
+  printf("test_sample_abort...\n");
+  const latency_histogram_t *flush =
+      latency_get_stage_histogram(LATENCY_STAGE_FLUSH);
+  uint64_t before = atomic_load(&flush->count);
+
+  int64_t now = latency_now_us();
+  latency_sample_begin(now - 500, now - 400, now - 300);
+  latency_sample_mark(LATENCY_STAGE_UPDATE);
+  latency_sample_abort();
+  latency_sample_mark(LATENCY_STAGE_FLUSH);
+  latency_sample_finish();
+  TEST_ASSERT(atomic_load(&flush->count) == before, "aborted sample dropped");
+
+  // Events without an evdev timestamp are never sampled
+  latency_sample_begin(0, now, now);
+  latency_sample_mark(LATENCY_STAGE_FLUSH);
+  latency_sample_finish();
+  TEST_ASSERT(atomic_load(&flush->count) == before, "untimed sample ignored");
+}
+
+int main(void) {
+  bongocat_error_init(0);
+  printf("=== Latency Tests ===\n");
+
+  test_histogram_empty();
+  test_histogram_exact_small();
+  test_histogram_percentiles();
+  test_histogram_clamp();
+  test_histogram_count_below();
+  test_sample_finish();
+  test_sample_abort();
+
+  printf("\nResults: %d passed, %d failed\n", tests_passed, tests_failed);
+  return tests_failed > 0 ? 1 : 0;
+}
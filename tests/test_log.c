@@ -0,0 +1,346 @@
+// Unit tests and producer-cost benchmark for the asynchronous logger
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/utils/error.h"
+
+#include <assert.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST_ASSERT(cond, msg)                                                 \
+  do {                                                                         \
+    if (cond) {                                                                \
+      tests_passed++;                                                          \
+    } else {                                                                   \
+      tests_failed++;                                                          \
+      fprintf(stderr, "  FAIL: %s:%d: %s\n", __FILE__, __LINE__, msg);        \
+    }                                                                          \
+  } while (0)
+
+typedef struct {
+  int out;
+  int err;
+} saved_streams_t;
+
+// Point stdout and stderr at fd
+static saved_streams_t redirect_output(int fd) {
+  fflush(stdout);
+  fflush(stderr);
+  saved_streams_t saved = {dup(STDOUT_FILENO), dup(STDERR_FILENO)};
+  dup2(fd, STDOUT_FILENO);
+  dup2(fd, STDERR_FILENO);
+  return saved;
+}
+
+static void restore_output(saved_streams_t saved) {
+  fflush(stdout);
+  fflush(stderr);
+  dup2(saved.out, STDOUT_FILENO);
+  dup2(saved.err, STDERR_FILENO);
+  close(saved.out);
+  close(saved.err);
+}
+
+static int temp_file(char *path) {
+  int fd = mkstemp(path);
+  assert(fd >= 0);
+  return fd;
+}
+
+static char *read_file(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    return NULL;
+  }
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  char *data = calloc(1, (size_t)size + 1);
+  if (data && fread(data, 1, (size_t)size, f) != (size_t)size) {
+    data[0] = '\0';
+  }
+  fclose(f);
+  return data;
+}
+
+static size_t count_occurrences(const char *text, const char *needle) {
+  size_t count = 0;
+  for (const char *p = text; (p = strstr(p, needle)) != NULL; p++) {
+    count++;
+  }
+  return count;
+}
+
+// ---------------------------------------------------------------------------
+// Test: concurrent producers keep per-thread order and account for drops
+// ---------------------------------------------------------------------------
+
+#define PRODUCERS           4
+#define MESSAGES_PER_THREAD 5000
+
+static void *producer_main(void *arg) {
+  int id = (int)(intptr_t)arg;
+  for (int i = 0; i < MESSAGES_PER_THREAD; i++) {
+    bongocat_log_info("producer %d message %d", id, i);
+  }
+  return NULL;
+}
+
+static void test_producers(void) {
+  printf("test_producers...\n");
+  char path[] = "/tmp/bongocat_log_XXXXXX";
+  int fd = temp_file(path);
+  saved_streams_t saved = redirect_output(fd);
+
+  size_t dropped_before = bongocat_log_dropped();
+  bongocat_log_start();
+  pthread_t threads[PRODUCERS];
+  for (intptr_t i = 0; i < PRODUCERS; i++) {
+    pthread_create(&threads[i], NULL, producer_main, (void *)i);
+  }
+  for (int i = 0; i < PRODUCERS; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  size_t dropped = bongocat_log_dropped() - dropped_before;
+  bongocat_log_stop();
+  restore_output(saved);
+  close(fd);
+
+  char *text = read_file(path);
+  TEST_ASSERT(text != NULL, "log captured");
+  if (!text) {
+    unlink(path);
+    return;
+  }
+
+  size_t lines = 0;
+  bool ordered = true;
+  int last[PRODUCERS] = {-1, -1, -1, -1};
+  for (const char *p = text; (p = strstr(p, "INFO: producer ")) != NULL;
+       p++) {
+    int id = -1;
+    int seq = -1;
+    if (sscanf(p, "INFO: producer %d message %d", &id, &seq) == 2 && id >= 0 &&
+        id < PRODUCERS) {
+      ordered &= seq > last[id];
+      last[id] = seq;
+      lines++;
+    }
+  }
+  printf("  %zu lines written, %zu dropped\n", lines, dropped);
+  TEST_ASSERT(lines + dropped == PRODUCERS * MESSAGES_PER_THREAD,
+              "every message written or counted as dropped");
+  TEST_ASSERT(ordered, "per-thread order kept");
+  TEST_ASSERT(dropped == 0 || strstr(text, "log messages dropped") != NULL,
+              "drops reported in the log");
+  TEST_ASSERT(strstr(text, "] INFO: producer 0 message") != NULL,
+              "line format kept");
+
+  free(text);
+  unlink(path);
+}
+
+// ---------------------------------------------------------------------------
+// Test: a stalled stdout fills the ring and drops instead of blocking
+// ---------------------------------------------------------------------------
+
+typedef struct {
+  int fd;
+  size_t bytes;
+  bool saw_report;
+} pipe_reader_t;
+
+static void *pipe_reader_main(void *arg) {
+  pipe_reader_t *reader = arg;
+  char buf[4096];
+  char carry[64] = {0};
+  ssize_t n;
+  while ((n = read(reader->fd, buf, sizeof(buf) - 1)) > 0) {
+    buf[n] = '\0';
+    reader->bytes += (size_t)n;
+    // The report line may straddle two reads
+    char joined[sizeof(carry) + sizeof(buf)];
+    snprintf(joined, sizeof(joined), "%s%s", carry, buf);
+    reader->saw_report |= strstr(joined, "log messages dropped") != NULL;
+    size_t len = strlen(buf);
+    size_t keep = len < sizeof(carry) - 1 ? len : sizeof(carry) - 1;
+    memcpy(carry, buf + len - keep, keep);
+    carry[keep] = '\0';
+  }
+  return NULL;
+}
+
+static void test_overflow(void) {
+  printf("test_overflow...\n");
+  int fds[2];
+  if (pipe(fds) != 0) {
+    TEST_ASSERT(false, "pipe created");
+    return;
+  }
+  saved_streams_t saved = redirect_output(fds[1]);
+  close(fds[1]);
+
+  char payload[900];
+  memset(payload, 'x', sizeof(payload) - 1);
+  payload[sizeof(payload) - 1] = '\0';
+
+  size_t dropped_before = bongocat_log_dropped();
+  bongocat_log_start();
+  uint64_t start = 0;
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  start = (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+  // Nobody reads the pipe yet: the writer blocks once it holds ~64 KB
+  for (int i = 0; i < 1000; i++) {
+    bongocat_log_info("%d %s", i, payload);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  uint64_t elapsed_ms =
+      (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000 - start;
+  size_t dropped = bongocat_log_dropped() - dropped_before;
+
+  pipe_reader_t reader = {.fd = fds[0]};
+  pthread_t thread;
+  pthread_create(&thread, NULL, pipe_reader_main, &reader);
+  bongocat_log_stop();
+  restore_output(saved);  // Closes the last write ends
+  pthread_join(thread, NULL);
+  close(fds[0]);
+
+  printf("  1000 messages into a stalled pipe: %zu dropped in %llu ms\n",
+         dropped, (unsigned long long)elapsed_ms);
+  TEST_ASSERT(dropped > 0, "full ring drops");
+  TEST_ASSERT(elapsed_ms < 1000, "producers never block");
+  TEST_ASSERT(reader.saw_report, "drop count reported once drained");
+}
+
+// ---------------------------------------------------------------------------
+// Test: a forked child writes its own lines, not the parent's
+// ---------------------------------------------------------------------------
+static void test_fork(void) {
+  printf("test_fork...\n");
+  char path[] = "/tmp/bongocat_log_XXXXXX";
+  int fd = temp_file(path);
+  saved_streams_t saved = redirect_output(fd);
+
+  bongocat_log_start();
+  for (int i = 0; i < 50; i++) {
+    bongocat_log_info("before fork %d", i);
+  }
+  pid_t pid = fork();
+  if (pid == 0) {
+    bongocat_log_info("from the child");
+    exit(0);  // atexit drains the child's ring
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  bongocat_log_stop();
+  restore_output(saved);
+  close(fd);
+
+  char *text = read_file(path);
+  TEST_ASSERT(text && count_occurrences(text, "before fork 49\n") == 1,
+              "parent records written once");
+  TEST_ASSERT(text && count_occurrences(text, "from the child\n") == 1,
+              "child started its own writer");
+  free(text);
+  unlink(path);
+}
+
+// ---------------------------------------------------------------------------
+// Test: disabled debug calls do not evaluate their arguments
+// ---------------------------------------------------------------------------
+static int evaluated = 0;
+
+static int side_effect(void) {
+  return ++evaluated;
+}
+
+static void test_debug_disabled(void) {
+  printf("test_debug_disabled...\n");
+  bongocat_error_init(0);
+  bongocat_log_debug("never %d", side_effect());
+  TEST_ASSERT(evaluated == 0, "arguments not evaluated");
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark: cost of one log call to the caller
+// ---------------------------------------------------------------------------
+
+#define BENCH_BURST 200
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Same shape as the input child's per-key debug line
+static void log_key(int i) {
+  bongocat_log_info("Key: %d from %s", 30 + i % 20, "/dev/input/event3");
+}
+
+static uint64_t bench_burst(void) {
+  uint64_t start = now_ns();
+  for (int i = 0; i < BENCH_BURST; i++) {
+    log_key(i);
+  }
+  uint64_t elapsed = (now_ns() - start) / BENCH_BURST;
+  bongocat_log_flush();
+  return elapsed;
+}
+
+static void bench_producer_cost(const char *target) {
+  printf("bench_producer_cost (%s)...\n", target);
+  int fd = open(target, O_WRONLY | O_APPEND);
+  if (fd < 0) {
+    TEST_ASSERT(false, "bench target opened");
+    return;
+  }
+  saved_streams_t saved = redirect_output(fd);
+
+  uint64_t sync_ns = bench_burst();
+  bongocat_log_start();
+  size_t dropped_before = bongocat_log_dropped();
+  uint64_t async_ns = bench_burst();
+  size_t dropped = bongocat_log_dropped() - dropped_before;
+  bongocat_log_stop();
+
+  restore_output(saved);
+  close(fd);
+
+  printf("  %d calls in a burst\n", BENCH_BURST);
+  printf("  synchronous format + write: %6llu ns/call\n",
+         (unsigned long long)sync_ns);
+  printf("  ring append:                %6llu ns/call\n",
+         (unsigned long long)async_ns);
+  TEST_ASSERT(dropped == 0, "a key burst fits in the ring");
+}
+
+int main(void) {
+  printf("=== Logger Tests ===\n");
+
+  test_producers();
+  test_overflow();
+  test_fork();
+  test_debug_disabled();
+  char path[] = "/tmp/bongocat_log_XXXXXX";
+  close(temp_file(path));
+  bench_producer_cost("/dev/null");
+  bench_producer_cost(path);
+  unlink(path);
+
+  printf("\nResults: %d passed, %d failed\n", tests_passed, tests_failed);
+  return tests_failed > 0 ? 1 : 0;
+}
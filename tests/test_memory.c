@@ -13,9 +13,12 @@ struct zxdg_output_v1;
 #include "../include/utils/error.h"
 #include "../include/utils/memory.h"
 
+#include <pthread.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 static int tests_passed = 0;
 static int tests_failed = 0;
@@ -135,6 +138,257 @@ static void test_malloc_free(void) {
   tests_passed++;  // If we got here, no crash
 }
 
+// ---------------------------------------------------------------------------
+// Test: arena grows in chunks and is released as a whole
+// ---------------------------------------------------------------------------
+static void test_arena(void) {
+  printf("test_arena...\n");
+  memory_stats_t before;
+  memory_get_stats(&before);
+
+  memory_arena_t arena = {.chunk_size = 256, .tag = MEMORY_TAG_CONFIG};
+  TEST_ASSERT(memory_arena_alloc(&arena, 0) == NULL, "zero size rejected");
+
+  char *first = memory_arena_strdup(&arena, "eDP-1");
+  char *part = memory_arena_strndup(&arena, "HDMI-A-1,DP-2", 8);
+  TEST_ASSERT(first && strcmp(first, "eDP-1") == 0, "strdup copies");
+  TEST_ASSERT(part && strcmp(part, "HDMI-A-1") == 0, "strndup terminates");
+  TEST_ASSERT(((uintptr_t)part % sizeof(void *)) == 0, "pointer-aligned");
+
+  bool aligned = true;
+  for (int i = 0; i < 100; i++) {
+    void **slot = memory_arena_alloc(&arena, 3 * sizeof(void *) + 1);
+    aligned &= slot && ((uintptr_t)slot % sizeof(void *)) == 0;
+  }
+  TEST_ASSERT(aligned, "growth keeps alignment");
+  char *big = memory_arena_alloc(&arena, 1000);
+  TEST_ASSERT(big != NULL, "oversized block gets its own chunk");
+  TEST_ASSERT(strcmp(first, "eDP-1") == 0, "old blocks stay valid");
+
+  size_t used = 0;
+  size_t capacity = 0;
+  memory_arena_usage(&arena, &used, &capacity);
+  TEST_ASSERT(used >= 100 * (3 * sizeof(void *) + 1) + 1000, "usage");
+  TEST_ASSERT(capacity >= used, "capacity covers usage");
+
+  memory_stats_t stats;
+  memory_get_stats(&stats);
+  TEST_ASSERT(stats.tags[MEMORY_TAG_CONFIG].live_blocks <
+                  before.tags[MEMORY_TAG_CONFIG].live_blocks + 20,
+              "chunks, not blocks, are allocated");
+
+  memory_arena_reset(&arena);
+  memory_arena_usage(&arena, &used, &capacity);
+  TEST_ASSERT(used == 0 && capacity == 256, "reset keeps the first chunk");
+  TEST_ASSERT(memory_arena_strdup(&arena, "again") != NULL, "reuse");
+
+  memory_arena_destroy(&arena);
+  memory_get_stats(&stats);
+  TEST_ASSERT(stats.tags[MEMORY_TAG_CONFIG].live_bytes ==
+                  before.tags[MEMORY_TAG_CONFIG].live_bytes,
+              "destroy releases every chunk");
+
+  memory_arena_t empty = {0};
+  memory_arena_reset(&empty);
+  memory_arena_destroy(&empty);
+  TEST_ASSERT(empty.chunks == NULL, "zeroed arena is valid");
+}
+
+// ---------------------------------------------------------------------------
+// Test: frees and reallocs are accounted to the byte
+// ---------------------------------------------------------------------------
+static void test_exact_accounting(void) {
+  printf("test_exact_accounting...\n");
+  memory_stats_t before;
+  memory_get_stats(&before);
+
+  void *p = bongocat_malloc(1000);
+  memory_stats_t stats;
+  memory_get_stats(&stats);
+  TEST_ASSERT(stats.current_allocated == before.current_allocated + 1000,
+              "malloc adds its exact size");
+
+  p = bongocat_realloc(p, 300);
+  memory_get_stats(&stats);
+  TEST_ASSERT(p != NULL, "realloc shrinks");
+  TEST_ASSERT(stats.current_allocated == before.current_allocated + 300,
+              "realloc replaces the old size");
+  TEST_ASSERT(stats.allocation_count == before.allocation_count + 1,
+              "realloc is not an allocation");
+
+  bongocat_free(p);
+  memory_get_stats(&stats);
+  TEST_ASSERT(stats.current_allocated == before.current_allocated,
+              "free returns to the baseline");
+  TEST_ASSERT(stats.free_count == before.free_count + 1, "free counted");
+  TEST_ASSERT(stats.peak_allocated >= before.current_allocated + 1000,
+              "peak kept");
+}
+
+// ---------------------------------------------------------------------------
+// Test: live memory is reported per subsystem
+// ---------------------------------------------------------------------------
+static void test_tags(void) {
+  printf("test_tags...\n");
+  memory_stats_t before;
+  memory_get_stats(&before);
+
+  char *name = bongocat_strdup_tagged(MEMORY_TAG_CONFIG, "HDMI-A-1");
+  uint32_t *frame = bongocat_calloc_tagged(MEMORY_TAG_FRAME_CACHE, 64, 4);
+  memory_track_external(MEMORY_TAG_WAYLAND, 4096);
+
+  memory_stats_t stats;
+  memory_get_stats(&stats);
+  TEST_ASSERT(name && strcmp(name, "HDMI-A-1") == 0, "strdup copies");
+  TEST_ASSERT(stats.tags[MEMORY_TAG_CONFIG].live_bytes ==
+                  before.tags[MEMORY_TAG_CONFIG].live_bytes + 9,
+              "config bytes");
+  TEST_ASSERT(stats.tags[MEMORY_TAG_FRAME_CACHE].live_blocks ==
+                  before.tags[MEMORY_TAG_FRAME_CACHE].live_blocks + 1,
+              "frame cache blocks");
+  TEST_ASSERT(stats.tags[MEMORY_TAG_FRAME_CACHE].live_bytes ==
+                  before.tags[MEMORY_TAG_FRAME_CACHE].live_bytes + 256,
+              "frame cache bytes");
+  TEST_ASSERT(stats.tags[MEMORY_TAG_WAYLAND].live_bytes ==
+                  before.tags[MEMORY_TAG_WAYLAND].live_bytes + 4096,
+              "external mapping tracked");
+  TEST_ASSERT(stats.current_allocated == before.current_allocated + 9 + 256 +
+                                             4096,
+              "tags add up to the total");
+
+  bongocat_free(name);
+  bongocat_free(frame);
+  memory_untrack_external(MEMORY_TAG_WAYLAND, 4096);
+  memory_get_stats(&stats);
+  for (int tag = 0; tag < MEMORY_TAG_COUNT; tag++) {
+    TEST_ASSERT(stats.tags[tag].live_bytes == before.tags[tag].live_bytes,
+                memory_tag_name((memory_tag_t)tag));
+  }
+  TEST_ASSERT(strcmp(memory_tag_name(MEMORY_TAG_SVG), "svg") == 0,
+              "tag names");
+}
+
+// ---------------------------------------------------------------------------
+// Test: per-thread counters sum correctly, also across threads
+// ---------------------------------------------------------------------------
+
+#define WORKERS            4
+#define ALLOCS_PER_WORKER  10000
+
+static void *handoff[WORKERS][ALLOCS_PER_WORKER];
+
+static void *alloc_worker(void *arg) {
+  void **slots = arg;
+  for (int i = 0; i < ALLOCS_PER_WORKER; i++) {
+    void *p = bongocat_malloc((size_t)(i % 64) + 1);
+    // Keep every other block for the main thread to free
+    if (i % 2 == 0) {
+      slots[i] = p;
+    } else {
+      bongocat_free(p);
+    }
+  }
+  return NULL;
+}
+
+static void test_threads(void) {
+  printf("test_threads...\n");
+  memory_stats_t before;
+  memory_get_stats(&before);
+
+  // Two rounds so the second reuses the blocks of exited threads
+  for (int round = 0; round < 2; round++) {
+    pthread_t threads[WORKERS];
+    for (int t = 0; t < WORKERS; t++) {
+      pthread_create(&threads[t], NULL, alloc_worker, handoff[t]);
+    }
+    for (int t = 0; t < WORKERS; t++) {
+      pthread_join(threads[t], NULL);
+    }
+    for (int t = 0; t < WORKERS; t++) {
+      for (int i = 0; i < ALLOCS_PER_WORKER; i += 2) {
+        bongocat_free(handoff[t][i]);
+      }
+    }
+  }
+
+  memory_stats_t stats;
+  memory_get_stats(&stats);
+  size_t total = 2 * WORKERS * ALLOCS_PER_WORKER;
+  TEST_ASSERT(stats.allocation_count == before.allocation_count + total,
+              "every allocation counted");
+  TEST_ASSERT(stats.free_count == before.free_count + total,
+              "every free counted");
+  TEST_ASSERT(stats.current_allocated == before.current_allocated,
+              "cross-thread frees balance");
+  TEST_ASSERT(stats.tags[MEMORY_TAG_OTHER].live_blocks ==
+                  before.tags[MEMORY_TAG_OTHER].live_blocks,
+              "no live blocks left");
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark: accounting cost with one counter mutex vs per-thread counters
+// ---------------------------------------------------------------------------
+
+#define BENCH_OPS 200000
+
+static pthread_mutex_t baseline_mutex = PTHREAD_MUTEX_INITIALIZER;
+static size_t baseline_total = 0;
+static size_t baseline_current = 0;
+
+// What every allocation used to do: bump the global stats under a mutex
+static void *baseline_worker([[maybe_unused]] void *arg) {
+  for (int i = 0; i < BENCH_OPS; i++) {
+    void *p = malloc(64);
+    pthread_mutex_lock(&baseline_mutex);
+    baseline_total += 64;
+    baseline_current += 64;
+    pthread_mutex_unlock(&baseline_mutex);
+    pthread_mutex_lock(&baseline_mutex);
+    baseline_current -= 64;
+    pthread_mutex_unlock(&baseline_mutex);
+    free(p);
+  }
+  return NULL;
+}
+
+static void *tracked_worker([[maybe_unused]] void *arg) {
+  for (int i = 0; i < BENCH_OPS; i++) {
+    bongocat_free(bongocat_malloc(64));
+  }
+  return NULL;
+}
+
+static uint64_t bench_threads(void *(*worker)(void *), int count) {
+  struct timespec start, end;
+  pthread_t threads[WORKERS];
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int t = 0; t < count; t++) {
+    pthread_create(&threads[t], NULL, worker, NULL);
+  }
+  for (int t = 0; t < count; t++) {
+    pthread_join(threads[t], NULL);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  uint64_t ns = (uint64_t)(end.tv_sec - start.tv_sec) * 1000000000ull +
+                (uint64_t)(end.tv_nsec - start.tv_nsec);
+  return ns / BENCH_OPS;
+}
+
+static void bench_accounting(void) {
+  printf("bench_accounting...\n");
+  for (int count = 1; count <= WORKERS; count *= WORKERS) {
+    uint64_t baseline_ns = bench_threads(baseline_worker, count);
+    uint64_t tracked_ns = bench_threads(tracked_worker, count);
+    printf("  %d thread(s), malloc + free of 64 bytes:\n", count);
+    printf("    global mutex:        %4llu ns/op\n",
+           (unsigned long long)baseline_ns);
+    printf("    per-thread counters: %4llu ns/op\n",
+           (unsigned long long)tracked_ns);
+  }
+  TEST_ASSERT(baseline_current == 0, "baseline balanced");
+}
+
 int main(void) {
   bongocat_error_init(0);
   printf("=== Memory Pool Tests ===\n");
@@ -145,6 +399,11 @@ int main(void) {
   test_pool_reset();
   test_calloc_overflow();
   test_malloc_free();
+  test_arena();
+  test_exact_accounting();
+  test_tags();
+  test_threads();
+  bench_accounting();
 
   printf("\nResults: %d passed, %d failed\n", tests_passed, tests_failed);
   return tests_failed > 0 ? 1 : 0;
@@ -0,0 +1,332 @@
+// Unit tests for runtime metrics, their formats and the metrics socket
+
+#define _GNU_SOURCE
+
+#include "../include/utils/error.h"
+#include "../include/utils/json_scan.h"
+#include "../include/utils/metrics.h"
+#include "../include/utils/metrics_server.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST_ASSERT(cond, msg)                                                 \
+  do {                                                                         \
+    if (cond) {                                                                \
+      tests_passed++;                                                          \
+    } else {                                                                   \
+      tests_failed++;                                                          \
+      fprintf(stderr, "  FAIL: %s:%d: %s\n", __FILE__, __LINE__, msg);        \
+    }                                                                          \
+  } while (0)
+
+static char text[16384];
+
+// Value at a dotted path such as "frames.drawn" in the JSON document
+static bool json_u64_at(const char *doc, const char *path, uint64_t *out) {
+  char key[64];
+  const char *value = doc;
+  while (value && *path) {
+    size_t len = strcspn(path, ".");
+    snprintf(key, sizeof(key), "%.*s", (int)len, path);
+    value = json_object_get(value, key);
+    path += len + (path[len] == '.');
+  }
+  return json_get_u64(value, out);
+}
+
+// ---------------------------------------------------------------------------
+// Test: counters are shared with a forked child, like the input child
+// ---------------------------------------------------------------------------
+static void test_counters(void) {
+  printf("test_counters...\n");
+  metrics_add(METRIC_FRAMES_DRAWN, 5);
+  TEST_ASSERT(metrics_init() == BONGOCAT_SUCCESS, "metrics initialized");
+
+  metrics_snapshot_t snap;
+  metrics_snapshot(&snap, NULL);
+  TEST_ASSERT(snap.counters[METRIC_FRAMES_DRAWN] == 0,
+              "init starts from zero");
+
+  metrics_add(METRIC_FRAMES_DRAWN, 2);
+  metrics_add(METRIC_FRAMES_SKIPPED, 1);
+  pid_t child = fork();
+  if (child == 0) {
+    metrics_add(METRIC_KEY_PRESSES, 3);
+    metrics_count_wakeup(METRICS_THREAD_INPUT);
+    metrics_set_input_devices(2);
+    _exit(0);
+  }
+  waitpid(child, NULL, 0);
+
+  metrics_snapshot(&snap, NULL);
+  TEST_ASSERT(snap.counters[METRIC_FRAMES_DRAWN] == 2, "drawn counted");
+  TEST_ASSERT(snap.counters[METRIC_FRAMES_SKIPPED] == 1, "skipped counted");
+  TEST_ASSERT(snap.counters[METRIC_KEY_PRESSES] == 3,
+              "child's key presses visible");
+  TEST_ASSERT(snap.wakeups[METRICS_THREAD_INPUT] == 1,
+              "child's wakeup visible");
+  TEST_ASSERT(snap.input_devices == 2, "device gauge visible");
+  TEST_ASSERT(snap.pid == (int)getpid(), "pid reported");
+
+  metrics_add(METRIC_COUNTER_COUNT, 1);  // Out of range: ignored
+  metrics_count_wakeup(METRICS_THREAD_COUNT);
+  TEST_ASSERT(strcmp(metrics_thread_name(METRICS_THREAD_COUNT), "unknown") ==
+                  0,
+              "unknown thread name");
+}
+
+// ---------------------------------------------------------------------------
+// Test: histogram buckets and wakeup rates in snapshots
+// ---------------------------------------------------------------------------
+static void test_snapshot(void) {
+  printf("test_snapshot...\n");
+  TEST_ASSERT(metrics_init() == BONGOCAT_SUCCESS, "metrics reset");
+
+  metrics_record_draw(50);    // Below the first bound (64 us)
+  metrics_record_draw(100);   // Below 128 us
+  metrics_record_draw(3000);  // Below 4096 us
+  metrics_record_reload(20000);
+
+  metrics_snapshot_t first;
+  metrics_snapshot(&first, NULL);
+  TEST_ASSERT(first.draw.count == 3, "3 draws");
+  TEST_ASSERT(first.draw.sum_us == 3150, "draw time sum");
+  TEST_ASSERT(first.draw.max_us == 3000, "draw time max");
+  TEST_ASSERT(metrics_hist_bound_us(0) == 64, "first bound is 64 us");
+  TEST_ASSERT(first.draw.below[0] == 1, "1 draw below 64 us");
+  TEST_ASSERT(first.draw.below[1] == 2, "2 draws below 128 us");
+  TEST_ASSERT(first.draw.below[5] == 2, "2 draws below 2048 us");
+  TEST_ASSERT(first.draw.below[6] == 3, "3 draws below 4096 us");
+  TEST_ASSERT(first.draw.below[METRICS_HIST_BOUNDS - 1] == 3,
+              "last bound holds every draw");
+  TEST_ASSERT(first.reload.count == 1 && first.reload.sum_us == 20000,
+              "reload recorded");
+
+  for (int i = 0; i < 10; i++) {
+    metrics_count_wakeup(METRICS_THREAD_ANIMATION);
+  }
+  usleep(20000);
+  metrics_snapshot_t second;
+  metrics_snapshot(&second, &first);
+  double rate = second.wakeups_per_sec[METRICS_THREAD_ANIMATION];
+  TEST_ASSERT(second.wakeups[METRICS_THREAD_ANIMATION] == 10, "10 wakeups");
+  TEST_ASSERT(rate > 10.0 && rate <= 500.0,
+              "rate over the time since the previous snapshot");
+  TEST_ASSERT(second.wakeups_per_sec[METRICS_THREAD_MAIN] == 0.0,
+              "idle thread has no wakeups");
+}
+
+// ---------------------------------------------------------------------------
+// Test: JSON output parses and carries the counters
+// ---------------------------------------------------------------------------
+static void test_json(void) {
+  printf("test_json...\n");
+  metrics_snapshot_t snap;
+  metrics_snapshot(&snap, NULL);
+  size_t len = metrics_format_json(&snap, text, sizeof(text));
+  TEST_ASSERT(len > 0 && len < sizeof(text), "JSON fits");
+  TEST_ASSERT(strlen(text) == len, "length returned");
+
+  uint64_t v = 0;
+  TEST_ASSERT(json_u64_at(text, "draw_time.count", &v) && v == 3,
+              "draw_time.count");
+  TEST_ASSERT(json_u64_at(text, "draw_time.sum_us", &v) && v == 3150,
+              "draw_time.sum_us");
+  TEST_ASSERT(json_u64_at(text, "wakeups.animation.total", &v) && v == 10,
+              "wakeups.animation.total");
+  TEST_ASSERT(json_u64_at(text, "key_presses.received", &v) && v == 0,
+              "key_presses.received");
+  TEST_ASSERT(json_u64_at(text, "reload_time.count", &v) && v == 1,
+              "reload_time.count");
+  TEST_ASSERT(json_u64_at(text, "pid", &v) && v == (uint64_t)getpid(),
+              "pid");
+  TEST_ASSERT(json_object_get(text, "frame_cache_bytes") &&
+                  json_object_get(text, "shm_bytes"),
+              "memory gauges present");
+
+  const char *buckets = json_object_get(json_object_get(text, "draw_time"),
+                                        "buckets");
+  size_t n = 0;
+  for (const char *b = json_array_first(buckets); b; b = json_array_next(b)) {
+    n++;
+  }
+  TEST_ASSERT(n == METRICS_HIST_BOUNDS, "one entry per bucket bound");
+
+  // Truncated like snprintf
+  char small[32];
+  TEST_ASSERT(metrics_format_json(&snap, small, sizeof(small)) == len,
+              "full length reported when truncated");
+  TEST_ASSERT(strlen(small) == sizeof(small) - 1, "truncated and terminated");
+}
+
+// ---------------------------------------------------------------------------
+// Test: OpenMetrics output is complete and its buckets are cumulative
+// ---------------------------------------------------------------------------
+static void test_openmetrics(void) {
+  printf("test_openmetrics...\n");
+  metrics_snapshot_t snap;
+  metrics_snapshot(&snap, NULL);
+  size_t len = metrics_format_openmetrics(&snap, text, sizeof(text));
+  TEST_ASSERT(len > 6 && len < sizeof(text), "exposition fits");
+  TEST_ASSERT(strcmp(text + len - 6, "# EOF\n") == 0, "ends with # EOF");
+
+  TEST_ASSERT(strstr(text, "# TYPE bongocat_frames counter\n") != NULL,
+              "counter family");
+  TEST_ASSERT(strstr(text, "bongocat_frames_total{result=\"drawn\"} ") !=
+                  NULL,
+              "drawn sample");
+  TEST_ASSERT(strstr(text, "# UNIT bongocat_draw_seconds seconds\n") != NULL,
+              "histogram unit");
+  TEST_ASSERT(strstr(text, "bongocat_draw_seconds_bucket{le=\"0.000064\"} "
+                           "1\n") != NULL,
+              "first bucket in seconds");
+  TEST_ASSERT(strstr(text, "bongocat_draw_seconds_bucket{le=\"+Inf\"} 3\n") !=
+                  NULL,
+              "+Inf bucket is the count");
+  TEST_ASSERT(strstr(text, "bongocat_draw_seconds_sum 0.003150\n") != NULL,
+              "sum in seconds");
+  TEST_ASSERT(strstr(text, "bongocat_wakeups_total{thread=\"animation\"} "
+                           "10\n") != NULL,
+              "wakeups per thread");
+  TEST_ASSERT(strstr(text, "bongocat_key_presses_coalesced_total 0\n") != NULL,
+              "coalesced presses");
+  TEST_ASSERT(strstr(text, "bongocat_shm_bytes ") != NULL, "shm gauge");
+
+  // Bucket counts never decrease
+  uint64_t prev = 0;
+  bool cumulative = true;
+  for (const char *p = strstr(text, "bongocat_draw_seconds_bucket"); p;
+       p = strstr(p + 1, "bongocat_draw_seconds_bucket")) {
+    uint64_t count = strtoull(strchr(p, ' ') + 1, NULL, 10);
+    cumulative = cumulative && count >= prev;
+    prev = count;
+  }
+  TEST_ASSERT(cumulative && prev == 3, "buckets cumulative");
+}
+
+// ---------------------------------------------------------------------------
+// Test: the socket answers plain and HTTP requests
+// ---------------------------------------------------------------------------
+
+// Connect, send request (shut the write side if NULL) and read the reply
+static size_t query(const char *path, const char *request, char *out,
+                    size_t size) {
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  struct sockaddr_un addr = {.sun_family = AF_UNIX};
+  snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+  if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+    if (fd >= 0) {
+      close(fd);
+    }
+    out[0] = '\0';
+    return 0;
+  }
+
+  if (request) {
+    ssize_t sent = write(fd, request, strlen(request));
+    (void)sent;
+  } else {
+    shutdown(fd, SHUT_WR);
+  }
+
+  size_t len = 0;
+  ssize_t n;
+  while (len + 1 < size && (n = read(fd, out + len, size - 1 - len)) > 0) {
+    len += (size_t)n;
+  }
+  out[len] = '\0';
+  close(fd);
+  return len;
+}
+
+static void test_socket(void) {
+  printf("test_socket...\n");
+  char dir[] = "/tmp/bongocat_metrics_XXXXXX";
+  TEST_ASSERT(mkdtemp(dir) != NULL, "runtime dir created");
+  setenv("XDG_RUNTIME_DIR", dir, 1);
+
+  TEST_ASSERT(metrics_server_start() == BONGOCAT_SUCCESS, "server started");
+  const char *path = metrics_server_path();
+  TEST_ASSERT(path != NULL, "socket path set");
+  if (!path) {
+    return;
+  }
+  char expected[256];
+  snprintf(expected, sizeof(expected), "%s/bongocat/%d.sock", dir,
+           (int)getpid());
+  TEST_ASSERT(strcmp(path, expected) == 0, "per-instance path");
+
+  struct stat st;
+  TEST_ASSERT(stat(path, &st) == 0 && (st.st_mode & 0777) == 0600,
+              "socket private");
+  snprintf(expected, sizeof(expected), "%s/bongocat", dir);
+  TEST_ASSERT(stat(expected, &st) == 0 && (st.st_mode & 0777) == 0700,
+              "directory private");
+
+  uint64_t v = 0;
+  query(path, NULL, text, sizeof(text));
+  TEST_ASSERT(json_u64_at(text, "draw_time.count", &v) && v == 3,
+              "JSON without a request");
+  query(path, "json\n", text, sizeof(text));
+  TEST_ASSERT(json_u64_at(text, "pid", &v), "JSON on request");
+  query(path, "openmetrics\n", text, sizeof(text));
+  TEST_ASSERT(strncmp(text, "# TYPE", 6) == 0 && strstr(text, "# EOF\n"),
+              "OpenMetrics on request");
+  query(path, "xml\n", text, sizeof(text));
+  TEST_ASSERT(strncmp(text, "error:", 6) == 0, "unknown format refused");
+
+  query(path, "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n", text,
+        sizeof(text));
+  TEST_ASSERT(strncmp(text, "HTTP/1.0 200 OK\r\n", 17) == 0, "HTTP 200");
+  TEST_ASSERT(strstr(text, "application/openmetrics-text") != NULL,
+              "OpenMetrics content type");
+  const char *body = strstr(text, "\r\n\r\n");
+  const char *length = strstr(text, "Content-Length: ");
+  TEST_ASSERT(body && length &&
+                  strtoul(length + 16, NULL, 10) == strlen(body + 4),
+              "Content-Length matches the body");
+
+  query(path, "GET /json HTTP/1.1\r\n\r\n", text, sizeof(text));
+  body = strstr(text, "\r\n\r\n");
+  TEST_ASSERT(body && json_u64_at(body + 4, "pid", &v), "JSON over HTTP");
+  query(path, "GET /other HTTP/1.1\r\n\r\n", text, sizeof(text));
+  TEST_ASSERT(strncmp(text, "HTTP/1.0 404", 12) == 0, "HTTP 404");
+
+  char socket_file[256];
+  snprintf(socket_file, sizeof(socket_file), "%s", path);
+  metrics_server_stop();
+  TEST_ASSERT(metrics_server_path() == NULL, "server stopped");
+  TEST_ASSERT(access(socket_file, F_OK) != 0, "socket removed");
+
+  unsetenv("XDG_RUNTIME_DIR");
+  TEST_ASSERT(metrics_server_start() != BONGOCAT_SUCCESS,
+              "no socket without XDG_RUNTIME_DIR");
+
+  rmdir(expected);
+  rmdir(dir);
+}
+
+int main(void) {
+  bongocat_error_init(0);
+  printf("=== Metrics Tests ===\n");
+
+  test_counters();
+  test_snapshot();
+  test_json();
+  test_openmetrics();
+  test_socket();
+
+  metrics_cleanup();
+  printf("\nResults: %d passed, %d failed\n", tests_passed, tests_failed);
+  return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,286 @@
+// Unit tests for the niri IPC client, against a mock IPC server
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/platform/niri_ipc.h"
+#include "../include/utils/error.h"
+
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST_ASSERT(cond, msg)                                                 \
+  do {                                                                         \
+    if (cond) {                                                                \
+      tests_passed++;                                                          \
+    } else {                                                                   \
+      tests_failed++;                                                          \
+      fprintf(stderr, "  FAIL: %s:%d: %s\n", __FILE__, __LINE__, msg);        \
+    }                                                                          \
+  } while (0)
+
+static const char outputs_reply[] =
+    "{\"Ok\":{\"Outputs\":{"
+    "\"DP-1\":{\"name\":\"DP-1\",\"make\":\"Dell\",\"logical\":"
+    "{\"x\":0,\"y\":0,\"width\":1920,\"height\":1080,\"scale\":1.0}},"
+    "\"HDMI-A-1\":{\"name\":\"HDMI-A-1\",\"logical\":"
+    "{\"x\":1920,\"y\":0,\"width\":1280,\"height\":720,\"scale\":1.5}},"
+    "\"DP-3\":{\"name\":\"DP-3\",\"logical\":null}"
+    "}}}\n";
+
+// The event stream: initial state, then one change per line
+static const char *const event_lines[] = {
+    "{\"Ok\":\"Handled\"}",
+    // 1: both outputs reported, windows not known yet
+    "{\"WorkspacesChanged\":{\"workspaces\":["
+    "{\"id\":1,\"idx\":1,\"name\":null,\"output\":\"DP-1\",\"is_active\":true,"
+    "\"is_focused\":true,\"active_window_id\":10},"
+    "{\"id\":2,\"idx\":1,\"name\":null,\"output\":\"HDMI-A-1\","
+    "\"is_active\":true,\"is_focused\":false,\"active_window_id\":20},"
+    "{\"id\":3,\"idx\":2,\"name\":\"web\",\"output\":\"DP-1\","
+    "\"is_active\":false,\"is_focused\":false,\"active_window_id\":null}]}}",
+    // 2: window 10 covers DP-1
+    "{\"WindowsChanged\":{\"windows\":["
+    "{\"id\":10,\"title\":\"mpv\",\"app_id\":\"mpv\",\"workspace_id\":1,"
+    "\"is_focused\":true,\"layout\":{\"tile_size\":[1920.0,1080.0],"
+    "\"window_size\":[1920,1080]}},"
+    "{\"id\":20,\"title\":\"term\",\"app_id\":\"foot\",\"workspace_id\":2,"
+    "\"is_focused\":false,\"layout\":{\"window_size\":[800,600]}}]}}",
+    // 3: window 10 shrinks
+    "{\"WindowLayoutsChanged\":{\"changes\":[[10,"
+    "{\"window_size\":[960,1040]}]]}}",
+    // 4: window 20 goes fullscreen, reported explicitly
+    "{\"WindowOpenedOrChanged\":{\"window\":{\"id\":20,\"title\":\"term\","
+    "\"workspace_id\":2,\"is_fullscreen\":true,"
+    "\"layout\":{\"window_size\":[800,600]}}}}",
+    // 5: an event that does not matter
+    "{\"KeyboardLayoutsChanged\":{\"keyboard_layouts\":{\"names\":[\"us\"],"
+    "\"current_idx\":0}}}",
+    // 6: DP-1 switches to the empty workspace, no change
+    "{\"WorkspaceActivated\":{\"id\":3,\"focused\":true}}",
+    // 7: window 20 closes
+    "{\"WindowClosed\":{\"id\":20}}",
+    "{\"WorkspaceActiveWindowChanged\":{\"workspace_id\":2,"
+    "\"active_window_id\":null}}",
+};
+
+typedef struct {
+  int calls;
+  bool dp1_fullscreen;
+  bool hdmi_fullscreen;
+  bool dp1_ever_fullscreen;
+} output_log_t;
+
+static void log_output(const char *name, bool fullscreen, void *data) {
+  output_log_t *log = data;
+  log->calls++;
+  if (strcmp(name, "DP-1") == 0) {
+    log->dp1_fullscreen = fullscreen;
+    log->dp1_ever_fullscreen |= fullscreen;
+  } else if (strcmp(name, "HDMI-A-1") == 0) {
+    log->hdmi_fullscreen = fullscreen;
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Test: Outputs reply
+// ---------------------------------------------------------------------------
+static void test_parse_outputs(void) {
+  printf("test_parse_outputs...\n");
+
+  niri_output_t outputs[4];
+  size_t count = niri_parse_outputs(outputs_reply, outputs, 4);
+  TEST_ASSERT(count == 3, "three outputs");
+  TEST_ASSERT(strcmp(outputs[0].name, "DP-1") == 0 &&
+                  outputs[0].width == 1920 && outputs[0].height == 1080,
+              "logical size");
+  TEST_ASSERT(outputs[1].width == 1280 && outputs[1].height == 720,
+              "scaled output uses logical size");
+  TEST_ASSERT(outputs[2].width == 0, "disabled output has no size");
+  TEST_ASSERT(niri_parse_outputs("{\"Err\":\"nope\"}", outputs, 4) == 0,
+              "error reply");
+}
+
+// ---------------------------------------------------------------------------
+// Test: event stream state machine
+// ---------------------------------------------------------------------------
+static niri_session_t session;
+
+static void test_handle_lines(void) {
+  printf("test_handle_lines...\n");
+
+  output_log_t log = {0};
+  memset(&session, 0, sizeof(session));
+  session.fd = -1;
+  session.handler = log_output;
+  session.data = &log;
+  session.output_count =
+      niri_parse_outputs(outputs_reply, session.outputs, NIRI_MAX_OUTPUTS);
+
+  TEST_ASSERT(niri_session_handle_line(&session, event_lines[0]),
+              "stream accepted");
+  niri_session_handle_line(&session, event_lines[1]);
+  TEST_ASSERT(log.calls == 3 && !log.dp1_fullscreen && !log.hdmi_fullscreen,
+              "initial state reported for every output");
+  niri_session_handle_line(&session, event_lines[2]);
+  TEST_ASSERT(log.calls == 4 && log.dp1_fullscreen,
+              "window covering the output is fullscreen");
+  niri_session_handle_line(&session, event_lines[3]);
+  TEST_ASSERT(log.calls == 5 && !log.dp1_fullscreen, "layout change clears");
+  niri_session_handle_line(&session, event_lines[4]);
+  TEST_ASSERT(log.calls == 6 && log.hdmi_fullscreen, "explicit fullscreen");
+  niri_session_handle_line(&session, event_lines[5]);
+  niri_session_handle_line(&session, event_lines[6]);
+  TEST_ASSERT(log.calls == 6, "unchanged outputs not reported again");
+  niri_session_handle_line(&session, event_lines[7]);
+  TEST_ASSERT(log.calls == 7 && !log.hdmi_fullscreen, "closed window clears");
+
+  niri_session_t refused = {.fd = -1};
+  TEST_ASSERT(!niri_session_handle_line(&refused, "{\"Err\":\"unknown\"}"),
+              "refused stream reported");
+}
+
+// ---------------------------------------------------------------------------
+// Mock niri
+// ---------------------------------------------------------------------------
+typedef struct {
+  int listen_fd;
+  bool outputs_requested;
+  bool stream_requested;
+} mock_niri_t;
+
+static bool mock_read_line(int fd, char *buf, size_t size) {
+  size_t len = 0;
+  while (len + 1 < size) {
+    if (read(fd, &buf[len], 1) != 1) {
+      return false;
+    }
+    if (buf[len] == '\n') {
+      break;
+    }
+    len++;
+  }
+  buf[len] = '\0';
+  return true;
+}
+
+static void *mock_niri_main(void *arg) {
+  mock_niri_t *mock = arg;
+  char request[64];
+
+  int fd = accept(mock->listen_fd, NULL, NULL);
+  if (fd < 0) {
+    return NULL;
+  }
+  if (mock_read_line(fd, request, sizeof(request)) &&
+      strcmp(request, "\"Outputs\"") == 0) {
+    mock->outputs_requested = true;
+    (void)!write(fd, outputs_reply, strlen(outputs_reply));
+  }
+  close(fd);
+
+  fd = accept(mock->listen_fd, NULL, NULL);
+  if (fd < 0) {
+    return NULL;
+  }
+  if (mock_read_line(fd, request, sizeof(request)) &&
+      strcmp(request, "\"EventStream\"") == 0) {
+    mock->stream_requested = true;
+    // Split lines across writes to exercise the line reader
+    for (size_t i = 0; i < sizeof(event_lines) / sizeof(event_lines[0]);
+         i++) {
+      size_t len = strlen(event_lines[i]);
+      (void)!write(fd, event_lines[i], len / 2);
+      struct timespec delay = {0, 1000000L};  // 1ms
+      nanosleep(&delay, NULL);
+      (void)!write(fd, event_lines[i] + len / 2, len - len / 2);
+      (void)!write(fd, "\n", 1);
+    }
+  }
+  close(fd);
+  return NULL;
+}
+
+// ---------------------------------------------------------------------------
+// Test: full session against the mock server
+// ---------------------------------------------------------------------------
+static void test_mock_session(void) {
+  printf("test_mock_session...\n");
+
+  char dir[] = "/tmp/bongocat_niri_XXXXXX";
+  if (!mkdtemp(dir)) {
+    TEST_ASSERT(false, "mkdtemp");
+    return;
+  }
+  char path[108];
+  snprintf(path, sizeof(path), "%s/niri.sock", dir);
+
+  int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  struct sockaddr_un addr = {.sun_family = AF_UNIX};
+  snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+  if (listen_fd < 0 ||
+      bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+      listen(listen_fd, 2) < 0) {
+    TEST_ASSERT(false, "mock server listening");
+    return;
+  }
+
+  setenv("NIRI_SOCKET", path, 1);
+  char resolved[108];
+  TEST_ASSERT(niri_ipc_socket_path(resolved, sizeof(resolved)) &&
+                  strcmp(resolved, path) == 0,
+              "socket path from NIRI_SOCKET");
+
+  mock_niri_t mock = {.listen_fd = listen_fd};
+  pthread_t thread;
+  pthread_create(&thread, NULL, mock_niri_main, &mock);
+
+  output_log_t log = {0};
+  bool opened = niri_session_open(&session, path, log_output, &log);
+  TEST_ASSERT(opened, "session opened");
+
+  int result = 0;
+  while (opened && result >= 0) {
+    struct pollfd pfd = {.fd = session.fd, .events = POLLIN};
+    if (poll(&pfd, 1, 2000) <= 0) {
+      break;
+    }
+    result = niri_session_dispatch(&session);
+  }
+  TEST_ASSERT(result == -1, "closed stream ends the session");
+  niri_session_close(&session);
+
+  pthread_join(thread, NULL);
+  close(listen_fd);
+
+  TEST_ASSERT(mock.outputs_requested, "output sizes queried");
+  TEST_ASSERT(mock.stream_requested, "event stream requested");
+  TEST_ASSERT(log.calls == 7, "every change reported once");
+  TEST_ASSERT(log.dp1_ever_fullscreen && !log.dp1_fullscreen,
+              "DP-1 fullscreen detected, then cleared");
+  TEST_ASSERT(!log.hdmi_fullscreen, "HDMI-A-1 cleared");
+
+  unlink(path);
+  rmdir(dir);
+}
+
+int main(void) {
+  bongocat_error_init(0);
+  printf("=== Niri IPC Tests ===\n");
+
+  test_parse_outputs();
+  test_handle_lines();
+  test_mock_session();
+
+  printf("\nResults: %d passed, %d failed\n", tests_passed, tests_failed);
+  return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,313 @@
+// Unit and golden-image tests for the offscreen render backend
+//
+// The golden images in tests/golden/ are PAM files of whole rendered bars.
+// After an intended rendering change, regenerate them with
+//   BONGOCAT_UPDATE_GOLDEN=1 make test
+// and review the new images before committing them.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/graphics/frame_cache.h"
+#include "../include/graphics/offscreen.h"
+#include "../include/graphics/render_backend.h"
+#include "../include/utils/error.h"
+#include "../include/utils/memory.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST_ASSERT(cond, msg)                                                 \
+  do {                                                                         \
+    if (cond) {                                                                \
+      tests_passed++;                                                          \
+    } else {                                                                   \
+      tests_failed++;                                                          \
+      fprintf(stderr, "  FAIL: %s:%d: %s\n", __FILE__, __LINE__, msg);        \
+    }                                                                          \
+  } while (0)
+
+#define GOLDEN_DIR "tests/golden"
+
+static config_t make_config(int width, int height, int cat_height) {
+  config_t config = {0};
+  config.screen_width = width;
+  config.overlay_height = height;
+  config.overlay_opacity = 150;
+  config.cat_height = cat_height;
+  config.cat_align = ALIGN_CENTER;
+  return config;
+}
+
+static uint32_t pixel_at(const offscreen_surface_t *surface, int x, int y) {
+  uint32_t px;
+  memcpy(&px, surface->pixels + ((size_t)y * (size_t)surface->width + x) * 4,
+         sizeof(px));
+  return px;
+}
+
+static char *read_file(const char *path, size_t *size) {
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    return NULL;
+  }
+  fseek(f, 0, SEEK_END);
+  long len = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  char *data = len >= 0 ? malloc((size_t)len + 1) : NULL;
+  if (data && fread(data, 1, (size_t)len, f) != (size_t)len) {
+    free(data);
+    data = NULL;
+  }
+  fclose(f);
+  *size = data ? (size_t)len : 0;
+  return data;
+}
+
+// ---------------------------------------------------------------------------
+// Test: the bar is filled and the frame blitted at the cat position
+// ---------------------------------------------------------------------------
+static void test_compose(void) {
+  printf("test_compose...\n");
+  config_t config = make_config(20, 10, 4);
+  offscreen_surface_t surface;
+  TEST_ASSERT(offscreen_surface_init(&surface, 20, 10) == BONGOCAT_SUCCESS,
+              "surface allocated");
+
+  render_snapshot_t *snap = render_snapshot_create(&config);
+  TEST_ASSERT(offscreen_add_target(snap, &surface), "target added");
+
+  // A 2x2 opaque white frame instead of the SVG cat
+  uint8_t white[2 * 2 * 4];
+  memset(white, 0xff, sizeof(white));
+  snap->frame_set = frame_set_create();
+  snap->frame_set->frames[0] =
+      (cached_frame_t){bongocat_malloc(sizeof(white)), 2, 2};
+  memcpy(snap->frame_set->frames[0].data, white, sizeof(white));
+
+  offscreen_t offscreen = {0};
+  render_backend_t backend = offscreen_backend(&offscreen);
+  TEST_ASSERT(render_frame(&backend, snap, 0) == 1, "one target presented");
+  TEST_ASSERT(offscreen.frames == 1, "frame counted");
+
+  const render_target_t *target = &snap->targets[0];
+  TEST_ASSERT(pixel_at(&surface, 0, 0) == 150U << 24, "background filled");
+  TEST_ASSERT(pixel_at(&surface, target->cat_x, target->cat_y) == 0xffffffff,
+              "frame blitted at cat position");
+  TEST_ASSERT(pixel_at(&surface, target->cat_x + 2, target->cat_y) ==
+                  150U << 24,
+              "blit clipped to frame size");
+
+  // A frame missing from the cache still clears the bar
+  memset(surface.pixels, 0x55, 20 * 10 * 4);
+  TEST_ASSERT(!render_compose_target(snap, target, 1), "missing frame");
+  TEST_ASSERT(pixel_at(&surface, target->cat_x, target->cat_y) == 150U << 24,
+              "bar filled without frame");
+
+  render_snapshot_release(snap);
+  offscreen_surface_destroy(&surface);
+
+  config.overlay_height = 12;
+  snap = render_snapshot_create(&config);
+  TEST_ASSERT(offscreen_surface_init(&surface, 20, 10) == BONGOCAT_SUCCESS,
+              "surface allocated");
+  TEST_ASSERT(!offscreen_add_target(snap, &surface),
+              "height mismatch rejected");
+  render_snapshot_release(snap);
+  offscreen_surface_destroy(&surface);
+}
+
+// ---------------------------------------------------------------------------
+// Test: hidden targets are skipped, the overlay layer is not
+// ---------------------------------------------------------------------------
+static void test_hidden_targets(void) {
+  printf("test_hidden_targets...\n");
+  config_t config = make_config(8, 4, 2);
+  offscreen_surface_t a;
+  offscreen_surface_t b;
+  TEST_ASSERT(offscreen_surface_init(&a, 8, 4) == BONGOCAT_SUCCESS &&
+                  offscreen_surface_init(&b, 8, 4) == BONGOCAT_SUCCESS,
+              "surfaces allocated");
+  atomic_store(&b.fullscreen, true);
+
+  render_snapshot_t *snap = render_snapshot_create(&config);
+  TEST_ASSERT(offscreen_add_target(snap, &a) && offscreen_add_target(snap, &b),
+              "targets added");
+  offscreen_t offscreen = {0};
+  render_backend_t backend = offscreen_backend(&offscreen);
+  TEST_ASSERT(render_frame(&backend, snap, 0) == 1, "fullscreen bar skipped");
+  TEST_ASSERT(pixel_at(&b, 0, 0) == 0, "hidden bar untouched");
+  render_snapshot_release(snap);
+
+  config.layer = LAYER_OVERLAY;
+  snap = render_snapshot_create(&config);
+  TEST_ASSERT(offscreen_add_target(snap, &a) && offscreen_add_target(snap, &b),
+              "targets added");
+  TEST_ASSERT(render_frame(&backend, snap, 0) == 2, "overlay layer shows");
+  TEST_ASSERT(offscreen.frames == 2 && offscreen.presented == 3,
+              "frames and targets counted");
+  render_snapshot_release(snap);
+
+  atomic_store(&a.fullscreen, true);
+  config.layer = LAYER_TOP;
+  snap = render_snapshot_create(&config);
+  TEST_ASSERT(offscreen_add_target(snap, &a) && offscreen_add_target(snap, &b),
+              "targets added");
+  TEST_ASSERT(render_frame(&backend, snap, 0) == 0, "all hidden");
+  TEST_ASSERT(offscreen.frames == 2, "empty frame not counted");
+  render_snapshot_release(snap);
+
+  offscreen_surface_destroy(&a);
+  offscreen_surface_destroy(&b);
+}
+
+// ---------------------------------------------------------------------------
+// Test: PPM composites over black, PAM un-premultiplies
+// ---------------------------------------------------------------------------
+static void test_image_formats(void) {
+  printf("test_image_formats...\n");
+  // B, G, R, A: opaque orange and half-transparent premultiplied blue
+  const uint8_t pixels[] = {0x00, 0x80, 0xff, 0xff, 0x40, 0x00, 0x00, 0x80};
+  char path[] = "/tmp/bongocat_offscreen_XXXXXX";
+  int fd = mkstemp(path);
+  TEST_ASSERT(fd >= 0, "temp file created");
+  if (fd < 0) {
+    return;
+  }
+  close(fd);
+
+  static const char ppm[] = "P6\n2 1\n255\n\xff\x80\x00\x00\x00\x40";
+  size_t size = 0;
+  TEST_ASSERT(offscreen_write_image(path, pixels, 2, 1, OFFSCREEN_IMAGE_PPM) ==
+                  BONGOCAT_SUCCESS,
+              "PPM written");
+  char *data = read_file(path, &size);
+  TEST_ASSERT(data && size == sizeof(ppm) - 1 && !memcmp(data, ppm, size),
+              "PPM bytes");
+  free(data);
+
+  static const char pam[] = "P7\nWIDTH 2\nHEIGHT 1\nDEPTH 4\nMAXVAL 255\n"
+                            "TUPLTYPE RGB_ALPHA\nENDHDR\n"
+                            "\xff\x80\x00\xff\x00\x00\x80\x80";
+  TEST_ASSERT(offscreen_write_image(path, pixels, 2, 1, OFFSCREEN_IMAGE_PAM) ==
+                  BONGOCAT_SUCCESS,
+              "PAM written");
+  data = read_file(path, &size);
+  TEST_ASSERT(data && size == sizeof(pam) - 1 && !memcmp(data, pam, size),
+              "PAM bytes");
+  free(data);
+
+  unlink(path);
+  TEST_ASSERT(offscreen_write_image("/nonexistent/x.pam", pixels, 2, 1,
+                                    OFFSCREEN_IMAGE_PAM) ==
+                  BONGOCAT_ERROR_FILE_IO,
+              "unwritable path reported");
+}
+
+// ---------------------------------------------------------------------------
+// Test: rendered bars match the golden images pixel for pixel
+// ---------------------------------------------------------------------------
+typedef struct {
+  const char *name;
+  int frame;
+  align_type_t align;
+  int mirror_x;
+  int opacity;
+} golden_case_t;
+
+static const golden_case_t golden_cases[] = {
+    {"idle_center", BONGOCAT_FRAME_BOTH_UP, ALIGN_CENTER, 0, 150},
+    {"left_down_mirrored", BONGOCAT_FRAME_LEFT_DOWN, ALIGN_LEFT, 1, 0},
+    {"sleeping_right", BONGOCAT_FRAME_SLEEPING, ALIGN_RIGHT, 0, 255},
+};
+
+static void check_golden(const golden_case_t *gc, bool update) {
+  config_t config = make_config(160, 48, 40);
+  config.cat_align = gc->align;
+  config.cat_x_offset = 6;
+  config.mirror_x = gc->mirror_x;
+  config.overlay_opacity = gc->opacity;
+
+  offscreen_surface_t surface;
+  if (offscreen_surface_init(&surface, 160, 48) != BONGOCAT_SUCCESS) {
+    TEST_ASSERT(false, "surface allocated");
+    return;
+  }
+  render_snapshot_t *snap = render_snapshot_create(&config);
+  int cat_w = (config.cat_height * CAT_IMAGE_WIDTH) / CAT_IMAGE_HEIGHT;
+  snap->frame_set = frame_cache_acquire(cat_w, config.cat_height,
+                                        config.mirror_x, config.mirror_y);
+  TEST_ASSERT(offscreen_add_target(snap, &surface), "target added");
+
+  offscreen_t offscreen = {0};
+  render_backend_t backend = offscreen_backend(&offscreen);
+  TEST_ASSERT(render_frame(&backend, snap, gc->frame) == 1, "frame rendered");
+
+  char golden[256];
+  snprintf(golden, sizeof(golden), GOLDEN_DIR "/%s.pam", gc->name);
+  if (update) {
+    TEST_ASSERT(offscreen_write_image(golden, surface.pixels, 160, 48,
+                                      OFFSCREEN_IMAGE_PAM) ==
+                    BONGOCAT_SUCCESS,
+                "golden image written");
+    printf("  updated %s\n", golden);
+  } else {
+    char actual[] = "/tmp/bongocat_golden_XXXXXX";
+    int fd = mkstemp(actual);
+    if (fd >= 0) {
+      close(fd);
+    }
+    size_t expected_size = 0;
+    size_t actual_size = 0;
+    char *expected = read_file(golden, &expected_size);
+    char *got = fd >= 0 && offscreen_write_image(actual, surface.pixels, 160,
+                                                 48, OFFSCREEN_IMAGE_PAM) ==
+                               BONGOCAT_SUCCESS
+                    ? read_file(actual, &actual_size)
+                    : NULL;
+    bool match = expected && got && expected_size == actual_size &&
+                 memcmp(expected, got, expected_size) == 0;
+    TEST_ASSERT(match, gc->name);
+    if (match) {
+      unlink(actual);
+    } else if (got) {
+      fprintf(stderr, "  %s differs from %s, rendered image kept at %s\n",
+              gc->name, golden, actual);
+    }
+    free(expected);
+    free(got);
+  }
+
+  render_snapshot_release(snap);
+  offscreen_surface_destroy(&surface);
+}
+
+static void test_golden_images(void) {
+  printf("test_golden_images...\n");
+  TEST_ASSERT(frame_cache_load_assets() == BONGOCAT_SUCCESS, "assets loaded");
+  bool update = getenv("BONGOCAT_UPDATE_GOLDEN") != NULL;
+  for (size_t i = 0; i < sizeof(golden_cases) / sizeof(golden_cases[0]);
+       i++) {
+    check_golden(&golden_cases[i], update);
+  }
+  frame_cache_cleanup();
+}
+
+int main(void) {
+  bongocat_error_init(0);
+  printf("=== Offscreen Render Tests ===\n");
+
+  test_compose();
+  test_hidden_targets();
+  test_image_formats();
+  test_golden_images();
+
+  TEST_ASSERT(render_state_live_snapshots() == 0, "no snapshots leaked");
+
+  printf("\nResults: %d passed, %d failed\n", tests_passed, tests_failed);
+  return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,331 @@
+// Unit tests for render snapshot publication and lifetime
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/graphics/render_state.h"
+#include "../include/utils/error.h"
+#include "../include/utils/memory.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST_ASSERT(cond, msg)                                                 \
+  do {                                                                         \
+    if (cond) {                                                                \
+      tests_passed++;                                                          \
+    } else {                                                                   \
+      tests_failed++;                                                          \
+      fprintf(stderr, "  FAIL: %s:%d: %s\n", __FILE__, __LINE__, msg);        \
+    }                                                                          \
+  } while (0)
+
+static config_t make_config(int cat_height, align_type_t align) {
+  static char output_name[] = "DP-1";
+  config_t config = {0};
+  config.screen_width = 1000;
+  config.overlay_height = 100;
+  config.overlay_opacity = 150;
+  config.cat_height = cat_height;
+  config.cat_x_offset = 10;
+  config.cat_y_offset = 5;
+  config.cat_align = align;
+  config.output_name = output_name;
+  return config;
+}
+
+// ---------------------------------------------------------------------------
+// Test: snapshot copies scalars, drops pointers and places the cat
+// ---------------------------------------------------------------------------
+static void test_snapshot_create(void) {
+  printf("test_snapshot_create...\n");
+  config_t config = make_config(277, ALIGN_CENTER);
+
+  render_snapshot_t *snap = render_snapshot_create(&config);
+  TEST_ASSERT(snap != NULL, "snapshot allocated");
+  if (!snap) {
+    return;
+  }
+  TEST_ASSERT(snap->config.overlay_opacity == 150, "scalars copied");
+  TEST_ASSERT(snap->config.output_name == NULL, "pointer members cleared");
+  TEST_ASSERT(snap->num_targets == 0, "no targets until added");
+  render_snapshot_release(snap);
+
+  TEST_ASSERT(render_snapshot_create(NULL) == NULL, "NULL config rejected");
+  TEST_ASSERT(render_state_live_snapshots() == 0, "no snapshots leaked");
+}
+
+// ---------------------------------------------------------------------------
+// Test: each target gets its own cat placement
+// ---------------------------------------------------------------------------
+static void test_snapshot_targets(void) {
+  printf("test_snapshot_targets...\n");
+  config_t config = make_config(277, ALIGN_CENTER);
+  render_snapshot_t *snap = render_snapshot_create(&config);
+  if (!snap) {
+    TEST_ASSERT(false, "snapshot allocated");
+    return;
+  }
+
+  render_target_t target = {.width = 1000};
+  TEST_ASSERT(render_snapshot_add_target(snap, &target), "first target added");
+  target.width = 2000;
+  TEST_ASSERT(render_snapshot_add_target(snap, &target), "second target added");
+  TEST_ASSERT(snap->num_targets == 2, "two targets");
+  TEST_ASSERT(snap->targets[0].cat_x == (1000 - 500) / 2 + 10,
+              "centered cat x on the first output");
+  TEST_ASSERT(snap->targets[1].cat_x == (2000 - 500) / 2 + 10,
+              "centered cat x on the wider output");
+  TEST_ASSERT(snap->targets[0].cat_y == (100 - 277) / 2 + 5, "cat y");
+  TEST_ASSERT(snap->targets[1].height == 100, "height from overlay_height");
+
+  for (size_t i = snap->num_targets; i < RENDER_MAX_TARGETS; i++) {
+    TEST_ASSERT(render_snapshot_add_target(snap, &target), "fill table");
+  }
+  TEST_ASSERT(!render_snapshot_add_target(snap, &target),
+              "full target table rejected");
+  render_snapshot_release(snap);
+
+  config = make_config(277, ALIGN_RIGHT);
+  snap = render_snapshot_create(&config);
+  target.width = 1000;
+  TEST_ASSERT(snap && render_snapshot_add_target(snap, &target) &&
+                  snap->targets[0].cat_x == 1000 - 500 - 10,
+              "right-aligned cat x");
+  render_snapshot_release(snap);
+
+  TEST_ASSERT(!render_snapshot_add_target(NULL, &target), "NULL snapshot");
+  TEST_ASSERT(render_state_live_snapshots() == 0, "no snapshots leaked");
+}
+
+// ---------------------------------------------------------------------------
+// Test: rendering suspends only when no target is visible
+// ---------------------------------------------------------------------------
+static void test_visibility(void) {
+  printf("test_visibility...\n");
+  config_t config = make_config(277, ALIGN_CENTER);
+  config.layer = LAYER_TOP;
+  render_snapshot_t *snap = render_snapshot_create(&config);
+  if (!snap) {
+    TEST_ASSERT(false, "snapshot allocated");
+    return;
+  }
+  TEST_ASSERT(!render_snapshot_nothing_visible(snap), "no targets");
+
+  atomic_bool fullscreen_a = true;
+  atomic_bool fullscreen_b = false;
+  render_target_t target = {.width = 1000, .fullscreen = &fullscreen_a};
+  (void)render_snapshot_add_target(snap, &target);
+  target.fullscreen = &fullscreen_b;
+  (void)render_snapshot_add_target(snap, &target);
+
+  TEST_ASSERT(render_target_is_hidden(snap, &snap->targets[0]) &&
+                  !render_target_is_hidden(snap, &snap->targets[1]),
+              "hidden per output");
+  TEST_ASSERT(!render_snapshot_nothing_visible(snap),
+              "one output still visible");
+  atomic_store(&fullscreen_b, true);
+  TEST_ASSERT(render_snapshot_nothing_visible(snap), "every output hidden");
+
+  snap->config.disable_fullscreen_hide = 1;
+  TEST_ASSERT(!render_snapshot_nothing_visible(snap), "hiding disabled");
+  snap->config.disable_fullscreen_hide = 0;
+  snap->config.layer = LAYER_OVERLAY;
+  TEST_ASSERT(!render_snapshot_nothing_visible(snap),
+              "overlay layer never hides");
+
+  // Powered-off outputs count as invisible whatever the layer
+  atomic_bool off_a = true;
+  atomic_bool off_b = false;
+  snap->targets[0].powered_off = &off_a;
+  snap->targets[1].powered_off = &off_b;
+  TEST_ASSERT(render_target_is_powered_off(&snap->targets[0]) &&
+                  !render_target_is_powered_off(&snap->targets[1]),
+              "power state per output");
+  TEST_ASSERT(!render_snapshot_nothing_visible(snap), "one output still on");
+  atomic_store(&off_b, true);
+  TEST_ASSERT(render_snapshot_nothing_visible(snap), "every output off");
+  snap->config.layer = LAYER_TOP;
+  atomic_store(&off_a, false);
+  TEST_ASSERT(render_snapshot_nothing_visible(snap),
+              "one output hidden, the other off");
+
+  render_snapshot_release(snap);
+}
+
+// ---------------------------------------------------------------------------
+// Test: snapshots share one frame set, freed with the last reference
+// ---------------------------------------------------------------------------
+static void test_shared_frame_set(void) {
+  printf("test_shared_frame_set...\n");
+  memory_stats_t before;
+  memory_get_stats(&before);
+
+  frame_set_t *set = frame_set_create();
+  TEST_ASSERT(set && atomic_load(&set->refs) == 1, "set created");
+  set->frames[0] = (cached_frame_t){bongocat_malloc(64), 4, 4};
+
+  config_t config = make_config(100, ALIGN_LEFT);
+  render_snapshot_t *a = render_snapshot_create(&config);
+  render_snapshot_t *b = render_snapshot_create(&config);
+  a->frame_set = frame_set_retain(set);
+  b->frame_set = frame_set_retain(set);
+  TEST_ASSERT(atomic_load(&set->refs) == 3, "one reference per holder");
+  TEST_ASSERT(render_snapshot_frame(a, 0) == render_snapshot_frame(b, 0),
+              "snapshots share the pixels");
+  TEST_ASSERT(render_snapshot_frame(a, NUM_FRAMES) == NULL,
+              "out-of-range frame");
+  TEST_ASSERT(frame_set_retain(NULL) == NULL, "NULL passes through");
+
+  // The cache drops its set while snapshots still draw from it
+  frame_set_release(set);
+  render_snapshot_release(a);
+  TEST_ASSERT(atomic_load(&set->refs) == 1 &&
+                  render_snapshot_frame(b, 0)->data != NULL,
+              "last holder keeps the frames");
+  render_snapshot_release(b);
+
+  memory_stats_t after;
+  memory_get_stats(&after);
+  TEST_ASSERT(after.current_allocated == before.current_allocated,
+              "frames freed with the last reference");
+
+  render_snapshot_t *empty = render_snapshot_create(&config);
+  TEST_ASSERT(render_snapshot_frame(empty, 0) == NULL, "no frame set");
+  render_snapshot_release(empty);
+}
+
+// ---------------------------------------------------------------------------
+// Test: readers keep a replaced snapshot alive until they release it
+// ---------------------------------------------------------------------------
+static void test_publish_acquire(void) {
+  printf("test_publish_acquire...\n");
+  TEST_ASSERT(render_state_acquire() == NULL, "nothing published yet");
+
+  config_t config = make_config(100, ALIGN_LEFT);
+  render_snapshot_t *first = render_snapshot_create(&config);
+  first->frame_set = frame_set_create();  // Released with the snapshot
+  first->frame_set->frames[0].data = bongocat_malloc(16);
+  render_state_publish(first);
+
+  render_snapshot_t *held = render_state_acquire();
+  TEST_ASSERT(held == first, "acquire returns the published snapshot");
+
+  config.overlay_opacity = 42;
+  render_state_publish(render_snapshot_create(&config));
+  TEST_ASSERT(render_state_live_snapshots() == 2,
+              "replaced snapshot survives while held");
+  TEST_ASSERT(held->config.overlay_opacity == 150,
+              "held snapshot is unchanged by publish");
+
+  render_snapshot_t *current = render_state_acquire();
+  TEST_ASSERT(current && current->config.overlay_opacity == 42,
+              "new readers see the new snapshot");
+  render_snapshot_release(current);
+
+  render_snapshot_release(held);
+  TEST_ASSERT(render_state_live_snapshots() == 1,
+              "last release frees the replaced snapshot");
+
+  render_state_retire();
+  TEST_ASSERT(render_state_acquire() == NULL, "retire unpublishes");
+  TEST_ASSERT(render_state_live_snapshots() == 0, "retire frees the snapshot");
+}
+
+// ---------------------------------------------------------------------------
+// Test: retire waits for a draw in progress
+// ---------------------------------------------------------------------------
+static atomic_bool reader_done = false;
+
+static void *slow_reader(void *arg) {
+  render_snapshot_t *snap = arg;
+  struct timespec delay = {0, 20000000L};  // 20ms "draw"
+  nanosleep(&delay, NULL);
+  atomic_store(&reader_done, true);
+  render_snapshot_release(snap);
+  return NULL;
+}
+
+static void test_retire_waits(void) {
+  printf("test_retire_waits...\n");
+  config_t config = make_config(100, ALIGN_CENTER);
+  render_state_publish(render_snapshot_create(&config));
+
+  render_snapshot_t *snap = render_state_acquire();
+  pthread_t reader;
+  pthread_create(&reader, NULL, slow_reader, snap);
+
+  render_state_retire();
+  TEST_ASSERT(atomic_load(&reader_done), "retire returned after the reader");
+  TEST_ASSERT(render_state_live_snapshots() == 0, "snapshot freed");
+  pthread_join(reader, NULL);
+}
+
+// ---------------------------------------------------------------------------
+// Test: concurrent readers never see a freed or torn snapshot
+// ---------------------------------------------------------------------------
+#define STRESS_READERS 3
+#define STRESS_PUBLISHES 20000
+
+static atomic_bool stress_running = true;
+static atomic_int stress_torn = 0;
+
+static void *stress_reader([[maybe_unused]] void *arg) {
+  while (atomic_load(&stress_running)) {
+    render_snapshot_t *snap = render_state_acquire();
+    if (!snap) {
+      continue;
+    }
+    // Every published snapshot has opacity == cat_height
+    if (snap->config.overlay_opacity != snap->config.cat_height ||
+        atomic_load(&snap->refs) == 0) {
+      atomic_fetch_add(&stress_torn, 1);
+    }
+    render_snapshot_release(snap);
+  }
+  return NULL;
+}
+
+static void test_concurrent_readers(void) {
+  printf("test_concurrent_readers...\n");
+  pthread_t readers[STRESS_READERS];
+  for (int i = 0; i < STRESS_READERS; i++) {
+    pthread_create(&readers[i], NULL, stress_reader, NULL);
+  }
+
+  for (int i = 0; i < STRESS_PUBLISHES; i++) {
+    config_t config = make_config(i % 200 + 1, ALIGN_CENTER);
+    config.overlay_opacity = config.cat_height;
+    render_state_publish(render_snapshot_create(&config));
+  }
+
+  atomic_store(&stress_running, false);
+  for (int i = 0; i < STRESS_READERS; i++) {
+    pthread_join(readers[i], NULL);
+  }
+  render_state_retire();
+
+  TEST_ASSERT(atomic_load(&stress_torn) == 0, "readers saw consistent data");
+  TEST_ASSERT(render_state_live_snapshots() == 0, "every snapshot freed");
+}
+
+int main(void) {
+  bongocat_error_init(0);
+  printf("=== Render State Tests ===\n");
+
+  test_snapshot_create();
+  test_snapshot_targets();
+  test_visibility();
+  test_shared_frame_set();
+  test_publish_acquire();
+  test_retire_waits();
+  test_concurrent_readers();
+
+  printf("\nResults: %d passed, %d failed\n", tests_passed, tests_failed);
+  return tests_failed > 0 ? 1 : 0;
+}
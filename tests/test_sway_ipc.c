@@ -0,0 +1,306 @@
+// Unit tests for the sway i3-ipc client, against a mock IPC server
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/platform/sway_ipc.h"
+#include "../include/utils/error.h"
+
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST_ASSERT(cond, msg)                                                 \
+  do {                                                                         \
+    if (cond) {                                                                \
+      tests_passed++;                                                          \
+    } else {                                                                   \
+      tests_failed++;                                                          \
+      fprintf(stderr, "  FAIL: %s:%d: %s\n", __FILE__, __LINE__, msg);        \
+    }                                                                          \
+  } while (0)
+
+// eDP-1 shows workspace 1, which has a fullscreen container two levels
+// down. HDMI-A-1 shows workspace 3; the fullscreen window on workspace 4 is
+// hidden. DP-2 reports no current_workspace, so visibility decides.
+static const char tree_fullscreen[] =
+    "{\"id\": 1, \"type\": \"root\", \"nodes\": ["
+    " {\"type\": \"output\", \"name\": \"__i3\", \"nodes\": []},"
+    " {\"type\": \"output\", \"name\": \"eDP-1\","
+    "  \"current_workspace\": \"1\", \"nodes\": ["
+    "   {\"type\": \"workspace\", \"name\": \"1\", \"nodes\": ["
+    "     {\"type\": \"con\", \"fullscreen_mode\": 0, \"nodes\": ["
+    "       {\"type\": \"con\", \"name\": \"mpv\", \"fullscreen_mode\": 1,"
+    "        \"visible\": true, \"nodes\": []}]}],"
+    "    \"floating_nodes\": []}]},"
+    " {\"type\": \"output\", \"name\": \"HDMI-A-1\","
+    "  \"current_workspace\": \"3\", \"nodes\": ["
+    "   {\"type\": \"workspace\", \"name\": \"3\", \"nodes\": ["
+    "     {\"type\": \"con\", \"fullscreen_mode\": 0, \"nodes\": []}],"
+    "    \"floating_nodes\": ["
+    "     {\"type\": \"floating_con\", \"fullscreen_mode\": 0}]},"
+    "   {\"type\": \"workspace\", \"name\": \"4\", \"nodes\": ["
+    "     {\"type\": \"con\", \"fullscreen_mode\": 1, \"nodes\": []}]}]},"
+    " {\"type\": \"output\", \"name\": \"DP-2\", \"nodes\": ["
+    "   {\"type\": \"workspace\", \"name\": \"5\", \"nodes\": ["
+    "     {\"type\": \"con\", \"fullscreen_mode\": 1, \"visible\": false,"
+    "      \"nodes\": []}]}]}"
+    "]}";
+
+static const char tree_plain[] =
+    "{\"type\": \"root\", \"nodes\": ["
+    " {\"type\": \"output\", \"name\": \"eDP-1\","
+    "  \"current_workspace\": \"1\", \"nodes\": ["
+    "   {\"type\": \"workspace\", \"name\": \"1\", \"nodes\": []}]}]}";
+
+// ---------------------------------------------------------------------------
+// Test: GET_TREE parsing
+// ---------------------------------------------------------------------------
+static void test_parse_tree(void) {
+  printf("test_parse_tree...\n");
+
+  sway_output_state_t outputs[8];
+  size_t count = sway_parse_tree(tree_fullscreen, outputs, 8);
+  TEST_ASSERT(count == 3, "three outputs, scratchpad skipped");
+  TEST_ASSERT(strcmp(outputs[0].name, "eDP-1") == 0 && outputs[0].fullscreen,
+              "nested fullscreen container on the visible workspace");
+  TEST_ASSERT(strcmp(outputs[1].name, "HDMI-A-1") == 0 &&
+                  !outputs[1].fullscreen,
+              "fullscreen on a hidden workspace ignored");
+  TEST_ASSERT(strcmp(outputs[2].name, "DP-2") == 0 && !outputs[2].fullscreen,
+              "invisible fullscreen container ignored");
+
+  count = sway_parse_tree(tree_plain, outputs, 8);
+  TEST_ASSERT(count == 1 && !outputs[0].fullscreen, "no fullscreen");
+  TEST_ASSERT(sway_parse_tree(tree_fullscreen, outputs, 1) == 1,
+              "output capacity respected");
+  TEST_ASSERT(sway_parse_tree("{\"nodes\": [", outputs, 8) == 0,
+              "truncated tree");
+}
+
+// ---------------------------------------------------------------------------
+// Test: event filtering
+// ---------------------------------------------------------------------------
+static void test_event_relevance(void) {
+  printf("test_event_relevance...\n");
+
+  TEST_ASSERT(sway_event_is_relevant(SWAY_IPC_EVENT_WINDOW,
+                                     "{\"change\": \"fullscreen_mode\"}"),
+              "fullscreen toggle");
+  TEST_ASSERT(sway_event_is_relevant(SWAY_IPC_EVENT_WINDOW,
+                                     "{\"change\": \"close\"}"),
+              "window closed");
+  TEST_ASSERT(!sway_event_is_relevant(SWAY_IPC_EVENT_WINDOW,
+                                      "{\"change\": \"title\"}"),
+              "title change ignored");
+  TEST_ASSERT(sway_event_is_relevant(SWAY_IPC_EVENT_WORKSPACE,
+                                     "{\"change\": \"focus\"}"),
+              "workspace switch");
+  TEST_ASSERT(!sway_event_is_relevant(SWAY_IPC_EVENT_WORKSPACE,
+                                      "{\"change\": \"rename\"}"),
+              "workspace rename ignored");
+  TEST_ASSERT(!sway_event_is_relevant(SWAY_IPC_EVENT_BIT | 5u, "{}"),
+              "binding events ignored");
+}
+
+// ---------------------------------------------------------------------------
+// Mock sway
+// ---------------------------------------------------------------------------
+typedef struct {
+  int listen_fd;
+  bool subscribed;
+  int tree_requests;
+} mock_sway_t;
+
+static bool read_full(int fd, void *buf, size_t len) {
+  uint8_t *p = buf;
+  while (len > 0) {
+    ssize_t n = read(fd, p, len);
+    if (n <= 0) {
+      return false;
+    }
+    p += n;
+    len -= (size_t)n;
+  }
+  return true;
+}
+
+static bool mock_read_message(int fd, uint32_t *type, char *payload,
+                              size_t size) {
+  uint8_t header[SWAY_IPC_HEADER_SIZE];
+  uint32_t len;
+  if (!read_full(fd, header, sizeof(header))) {
+    return false;
+  }
+  memcpy(&len, header + SWAY_IPC_MAGIC_LEN, sizeof(len));
+  memcpy(type, header + SWAY_IPC_MAGIC_LEN + 4, sizeof(*type));
+  if (memcmp(header, SWAY_IPC_MAGIC, SWAY_IPC_MAGIC_LEN) != 0 ||
+      len >= size) {
+    return false;
+  }
+  payload[len] = '\0';
+  return read_full(fd, payload, len);
+}
+
+// Append one message to out; returns the new length
+static size_t mock_encode(uint8_t *out, size_t len, uint32_t type,
+                          const char *payload) {
+  size_t payload_len = strlen(payload);
+  sway_ipc_encode_header(out + len, type, (uint32_t)payload_len);
+  memcpy(out + len + SWAY_IPC_HEADER_SIZE, payload, payload_len);
+  return len + SWAY_IPC_HEADER_SIZE + payload_len;
+}
+
+static void mock_send(int fd, uint32_t type, const char *payload) {
+  static uint8_t msg[8192];
+  size_t len = mock_encode(msg, 0, type, payload);
+  (void)!write(fd, msg, len);
+}
+
+static void *mock_sway_main(void *arg) {
+  mock_sway_t *mock = arg;
+  int fd = accept(mock->listen_fd, NULL, NULL);
+  if (fd < 0) {
+    return NULL;
+  }
+
+  uint32_t type;
+  char payload[256];
+  if (mock_read_message(fd, &type, payload, sizeof(payload)) &&
+      type == SWAY_IPC_SUBSCRIBE && strstr(payload, "\"window\"") &&
+      strstr(payload, "\"workspace\"")) {
+    mock->subscribed = true;
+    mock_send(fd, SWAY_IPC_SUBSCRIBE, "{\"success\": true}");
+  }
+
+  // Initial tree
+  if (mock_read_message(fd, &type, payload, sizeof(payload)) &&
+      type == SWAY_IPC_GET_TREE) {
+    mock->tree_requests++;
+    mock_send(fd, SWAY_IPC_GET_TREE, tree_plain);
+  }
+
+  // An irrelevant event and two fullscreen toggles in one burst
+  uint8_t burst[512];
+  size_t len = 0;
+  len = mock_encode(burst, len, SWAY_IPC_EVENT_WINDOW,
+                    "{\"change\": \"title\"}");
+  len = mock_encode(burst, len, SWAY_IPC_EVENT_WINDOW,
+                    "{\"change\": \"fullscreen_mode\"}");
+  len = mock_encode(burst, len, SWAY_IPC_EVENT_WINDOW,
+                    "{\"change\": \"fullscreen_mode\"}");
+  (void)!write(fd, burst, len);
+
+  // The burst must be answered with two trees at most: one for the first
+  // toggle and one for everything seen while it was outstanding
+  struct pollfd pfd = {.fd = fd, .events = POLLIN};
+  while (poll(&pfd, 1, 300) > 0 &&
+         mock_read_message(fd, &type, payload, sizeof(payload)) &&
+         type == SWAY_IPC_GET_TREE) {
+    mock->tree_requests++;
+    mock_send(fd, SWAY_IPC_GET_TREE, tree_fullscreen);
+  }
+
+  mock_send(fd, SWAY_IPC_EVENT_SHUTDOWN, "{\"change\": \"exit\"}");
+  close(fd);
+  return NULL;
+}
+
+typedef struct {
+  int calls;
+  bool edp_fullscreen;
+  bool hdmi_fullscreen;
+} output_log_t;
+
+static void log_output(const char *name, bool fullscreen, void *data) {
+  output_log_t *log = data;
+  log->calls++;
+  if (strcmp(name, "eDP-1") == 0) {
+    log->edp_fullscreen = fullscreen;
+  } else if (strcmp(name, "HDMI-A-1") == 0) {
+    log->hdmi_fullscreen = fullscreen;
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Test: full session against the mock server
+// ---------------------------------------------------------------------------
+static void test_mock_session(void) {
+  printf("test_mock_session...\n");
+
+  char dir[] = "/tmp/bongocat_sway_XXXXXX";
+  if (!mkdtemp(dir)) {
+    TEST_ASSERT(false, "mkdtemp");
+    return;
+  }
+  char path[108];
+  snprintf(path, sizeof(path), "%s/sway-ipc.sock", dir);
+
+  int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  struct sockaddr_un addr = {.sun_family = AF_UNIX};
+  snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+  if (listen_fd < 0 ||
+      bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+      listen(listen_fd, 1) < 0) {
+    TEST_ASSERT(false, "mock server listening");
+    return;
+  }
+
+  setenv("SWAYSOCK", path, 1);
+  char resolved[108];
+  TEST_ASSERT(sway_ipc_socket_path(resolved, sizeof(resolved)) &&
+                  strcmp(resolved, path) == 0,
+              "socket path from SWAYSOCK");
+
+  mock_sway_t mock = {.listen_fd = listen_fd};
+  pthread_t thread;
+  pthread_create(&thread, NULL, mock_sway_main, &mock);
+
+  output_log_t log = {0};
+  sway_session_t session;
+  bool opened = sway_session_open(&session, path, log_output, &log);
+  TEST_ASSERT(opened, "session opened");
+
+  int result = 0;
+  while (opened && result >= 0) {
+    struct pollfd pfd = {.fd = session.fd, .events = POLLIN};
+    if (poll(&pfd, 1, 2000) <= 0) {
+      break;
+    }
+    result = sway_session_dispatch(&session);
+  }
+  TEST_ASSERT(result == -1, "shutdown event ends the session");
+  sway_session_close(&session);
+
+  pthread_join(thread, NULL);
+  close(listen_fd);
+
+  TEST_ASSERT(mock.subscribed, "subscribed to window and workspace");
+  TEST_ASSERT(mock.tree_requests == 3, "events coalesced into one follow-up");
+  TEST_ASSERT(log.calls == 1 + 2 * 3,
+              "every output of every tree reported");
+  TEST_ASSERT(log.edp_fullscreen, "fullscreen reported for eDP-1");
+  TEST_ASSERT(!log.hdmi_fullscreen, "HDMI-A-1 not fullscreen");
+
+  unlink(path);
+  rmdir(dir);
+}
+
+int main(void) {
+  bongocat_error_init(0);
+  printf("=== Sway IPC Tests ===\n");
+
+  test_parse_tree();
+  test_event_relevance();
+  test_mock_session();
+
+  printf("\nResults: %d passed, %d failed\n", tests_passed, tests_failed);
+  return tests_failed > 0 ? 1 : 0;
+}
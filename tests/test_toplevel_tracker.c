@@ -0,0 +1,165 @@
+// Unit tests for the foreign toplevel tracker
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/platform/toplevel_tracker.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST_ASSERT(cond, msg)                                                 \
+  do {                                                                         \
+    if (cond) {                                                                \
+      tests_passed++;                                                          \
+    } else {                                                                   \
+      tests_failed++;                                                          \
+      fprintf(stderr, "  FAIL: %s:%d: %s\n", __FILE__, __LINE__, msg);        \
+    }                                                                          \
+  } while (0)
+
+// Stand-ins for wl_output and handle proxies
+static int output_a;
+static int output_b;
+
+// ---------------------------------------------------------------------------
+// Test: pending state only shows after done
+// ---------------------------------------------------------------------------
+static void test_double_buffering(void) {
+  printf("test_double_buffering...\n");
+  toplevel_tracker_t tracker = {0};
+  toplevel_change_t change;
+
+  toplevel_entry_t *entry = toplevel_tracker_add(&tracker, (void *)0x1);
+  TEST_ASSERT(entry && tracker.count == 1, "entry added");
+  if (!entry) {
+    return;
+  }
+
+  toplevel_entry_output_enter(entry, &output_a);
+  toplevel_entry_set_state(entry, true, true);
+  TEST_ASSERT(!entry->fullscreen && entry->output == NULL,
+              "pending state not visible");
+  TEST_ASSERT(!toplevel_tracker_output_has_fullscreen(&tracker, &output_a),
+              "output not fullscreen before done");
+
+  TEST_ASSERT(toplevel_tracker_commit(&tracker, entry, &change),
+              "done commits");
+  TEST_ASSERT(change.state_changed && change.output_changed,
+              "both changes reported");
+  TEST_ASSERT(!change.was_fullscreen && change.old_output == NULL,
+              "old values reported");
+  TEST_ASSERT(entry->fullscreen && entry->activated &&
+                  entry->output == &output_a,
+              "state committed");
+  TEST_ASSERT(toplevel_tracker_output_has_fullscreen(&tracker, &output_a),
+              "fullscreen on output A");
+  TEST_ASSERT(!toplevel_tracker_output_has_fullscreen(&tracker, &output_b),
+              "not on output B");
+
+  TEST_ASSERT(!toplevel_tracker_commit(&tracker, entry, &change),
+              "empty batch changes nothing");
+
+  // A storm of flips within one batch collapses to its final state
+  for (int i = 0; i < 100; i++) {
+    toplevel_entry_set_state(entry, i % 2 == 0, true);
+  }
+  toplevel_entry_set_state(entry, true, true);
+  TEST_ASSERT(!toplevel_tracker_commit(&tracker, entry, &change),
+              "batch ending in the committed state changes nothing");
+
+  toplevel_tracker_clear(&tracker);
+  TEST_ASSERT(tracker.count == 0 && tracker.head == NULL, "cleared");
+}
+
+// ---------------------------------------------------------------------------
+// Test: output enter and leave
+// ---------------------------------------------------------------------------
+static void test_outputs(void) {
+  printf("test_outputs...\n");
+  toplevel_tracker_t tracker = {0};
+  toplevel_change_t change;
+
+  toplevel_entry_t *entry = toplevel_tracker_add(&tracker, (void *)0x1);
+  if (!entry) {
+    TEST_ASSERT(false, "entry added");
+    return;
+  }
+  toplevel_entry_output_enter(entry, &output_a);
+  toplevel_entry_set_state(entry, true, false);
+  (void)toplevel_tracker_commit(&tracker, entry, &change);
+
+  // Leaving an output it is not on is ignored
+  toplevel_entry_output_leave(entry, &output_b);
+  TEST_ASSERT(!toplevel_tracker_commit(&tracker, entry, &change),
+              "unrelated leave ignored");
+
+  // Moving between outputs within one batch
+  toplevel_entry_output_leave(entry, &output_a);
+  toplevel_entry_output_enter(entry, &output_b);
+  TEST_ASSERT(toplevel_tracker_commit(&tracker, entry, &change) &&
+                  change.output_changed && !change.state_changed &&
+                  change.old_output == &output_a && change.was_fullscreen,
+              "move reported with the old output");
+  TEST_ASSERT(toplevel_tracker_output_has_fullscreen(&tracker, &output_b) &&
+                  !toplevel_tracker_output_has_fullscreen(&tracker,
+                                                          &output_a),
+              "fullscreen follows the move");
+
+  toplevel_tracker_clear(&tracker);
+}
+
+// ---------------------------------------------------------------------------
+// Test: removal anywhere in the list keeps counts right
+// ---------------------------------------------------------------------------
+static void test_remove(void) {
+  printf("test_remove...\n");
+  toplevel_tracker_t tracker = {0};
+  toplevel_change_t change;
+  toplevel_entry_t *entries[5];
+
+  for (uintptr_t i = 0; i < 5; i++) {
+    entries[i] = toplevel_tracker_add(&tracker, (void *)(i + 1));
+    if (!entries[i]) {
+      TEST_ASSERT(false, "entry added");
+      return;
+    }
+    toplevel_entry_output_enter(entries[i], &output_a);
+    toplevel_entry_set_state(entries[i], i % 2 == 0, false);
+    (void)toplevel_tracker_commit(&tracker, entries[i], &change);
+  }
+  TEST_ASSERT(tracker.count == 5 && tracker.fullscreen_count == 3,
+              "three of five fullscreen");
+
+  toplevel_tracker_remove(&tracker, entries[2]);  // middle
+  toplevel_tracker_remove(&tracker, entries[4]);  // head
+  toplevel_tracker_remove(&tracker, entries[0]);  // tail
+  TEST_ASSERT(tracker.count == 2 && tracker.fullscreen_count == 0,
+              "counts follow removals");
+  TEST_ASSERT(!toplevel_tracker_output_has_fullscreen(&tracker, &output_a),
+              "no fullscreen left");
+
+  size_t walked = 0;
+  for (toplevel_entry_t *e = tracker.head; e; e = e->next) {
+    walked++;
+    TEST_ASSERT(e == entries[1] || e == entries[3], "survivor");
+  }
+  TEST_ASSERT(walked == 2, "list intact");
+
+  toplevel_tracker_clear(&tracker);
+}
+
+int main(void) {
+  printf("=== Toplevel Tracker Tests ===\n");
+
+  test_double_buffering();
+  test_outputs();
+  test_remove();
+
+  printf("\nResults: %d passed, %d failed\n", tests_passed, tests_failed);
+  return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,271 @@
+// Unit tests for the thread activity trace (--trace)
+
+#define _GNU_SOURCE
+
+#include "../include/utils/error.h"
+#include "../include/utils/json_scan.h"
+#include "../include/utils/trace.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST_ASSERT(cond, msg)                                                 \
+  do {                                                                         \
+    if (cond) {                                                                \
+      tests_passed++;                                                          \
+    } else {                                                                   \
+      tests_failed++;                                                          \
+      fprintf(stderr, "  FAIL: %s:%d: %s\n", __FILE__, __LINE__, msg);        \
+    }                                                                          \
+  } while (0)
+
+static char trace_file[256];
+
+static char *read_file(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    return NULL;
+  }
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  char *buf = malloc((size_t)size + 1);
+  if (buf) {
+    buf[fread(buf, 1, (size_t)size, f)] = '\0';
+  }
+  fclose(f);
+  return buf;
+}
+
+// First event in traceEvents with the given name and phase
+static const char *find_event(const char *doc, const char *name,
+                              const char *phase) {
+  const char *events = json_object_get(doc, "traceEvents");
+  for (const char *ev = json_array_first(events); ev;
+       ev = json_array_next(ev)) {
+    if (json_string_equals(json_object_get(ev, "name"), name) &&
+        json_string_equals(json_object_get(ev, "ph"), phase)) {
+      return ev;
+    }
+  }
+  return NULL;
+}
+
+// Metadata naming the thread (or process) that owns pid/tid
+static bool has_name(const char *doc, const char *kind, int pid,
+                     const char *name) {
+  const char *events = json_object_get(doc, "traceEvents");
+  for (const char *ev = json_array_first(events); ev;
+       ev = json_array_next(ev)) {
+    int ev_pid = 0;
+    if (json_string_equals(json_object_get(ev, "ph"), "M") &&
+        json_string_equals(json_object_get(ev, "name"), kind) &&
+        json_get_int(json_object_get(ev, "pid"), &ev_pid) && ev_pid == pid &&
+        json_string_equals(
+            json_object_get(json_object_get(ev, "args"), "name"), name)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static int event_int(const char *ev, const char *key) {
+  int value = -1;
+  json_get_int(json_object_get(ev, key), &value);
+  return value;
+}
+
+static size_t count_events(const char *doc, const char *name) {
+  size_t count = 0;
+  const char *events = json_object_get(doc, "traceEvents");
+  for (const char *ev = json_array_first(events); ev;
+       ev = json_array_next(ev)) {
+    count += json_string_equals(json_object_get(ev, "name"), name);
+  }
+  return count;
+}
+
+static void *worker_thread([[maybe_unused]] void *arg) {
+  trace_set_thread_name("worker");
+  int64_t span = trace_begin();
+  usleep(1000);
+  trace_end("work", span);
+  return NULL;
+}
+
+// ---------------------------------------------------------------------------
+// Test: nothing is recorded or written while tracing is off
+// ---------------------------------------------------------------------------
+static void test_disabled(void) {
+  printf("test_disabled...\n");
+  TEST_ASSERT(!trace_enabled(), "off by default");
+  TEST_ASSERT(trace_begin() == 0, "no span start while off");
+  trace_end("ignored", trace_begin());
+  trace_instant("ignored");
+  trace_set_thread_name("ignored");
+  TEST_ASSERT(trace_write() != BONGOCAT_SUCCESS, "nothing to write");
+  TEST_ASSERT(trace_init("/nonexistent/dir/trace.json") != BONGOCAT_SUCCESS,
+              "unwritable path rejected");
+  TEST_ASSERT(!trace_enabled(), "still off after a failed init");
+}
+
+// ---------------------------------------------------------------------------
+// Test: spans and instants from threads and a forked child
+// ---------------------------------------------------------------------------
+static void test_events(void) {
+  printf("test_events...\n");
+  TEST_ASSERT(trace_init(trace_file) == BONGOCAT_SUCCESS, "trace started");
+  TEST_ASSERT(trace_enabled(), "tracing on");
+  trace_set_thread_name("main");
+
+  int64_t span = trace_begin();
+  TEST_ASSERT(span > 0, "span start recorded");
+  usleep(2000);
+  trace_end_arg("sleep", span, 42);
+  trace_instant_arg("mark", 7);
+
+  pthread_t thread;
+  pthread_create(&thread, NULL, worker_thread, NULL);
+  pthread_join(thread, NULL);
+
+  // Like the input child: records after fork, then exits
+  pid_t child = fork();
+  if (child == 0) {
+    trace_set_thread_name("child");
+    trace_instant("from child");
+    _exit(0);
+  }
+  waitpid(child, NULL, 0);
+
+  TEST_ASSERT(trace_write() == BONGOCAT_SUCCESS, "trace written");
+  struct stat st;
+  TEST_ASSERT(stat(trace_file, &st) == 0 && (st.st_mode & 0777) == 0600,
+              "trace file is private");
+
+  char *doc = read_file(trace_file);
+  TEST_ASSERT(doc != NULL, "trace readable");
+  TEST_ASSERT(json_skip_value(json_skip_ws(doc)) != NULL, "valid JSON");
+  int self = (int)getpid();
+
+  const char *ev = find_event(doc, "sleep", "X");
+  TEST_ASSERT(ev != NULL, "span present");
+  TEST_ASSERT(event_int(ev, "dur") >= 2000, "span duration in us");
+  uint64_t ts = 0;
+  TEST_ASSERT(json_get_u64(json_object_get(ev, "ts"), &ts) && ts > 0,
+              "span timestamp");
+  TEST_ASSERT(event_int(ev, "pid") == self, "span pid");
+  TEST_ASSERT(event_int(ev, "tid") == (int)gettid(), "span tid");
+  TEST_ASSERT(event_int(json_object_get(ev, "args"), "value") == 42,
+              "span argument");
+
+  ev = find_event(doc, "mark", "i");
+  TEST_ASSERT(ev != NULL, "instant present");
+  TEST_ASSERT(json_string_equals(json_object_get(ev, "s"), "t"),
+              "instant scoped to its thread");
+  TEST_ASSERT(event_int(json_object_get(ev, "args"), "value") == 7,
+              "instant argument");
+
+  ev = find_event(doc, "work", "X");
+  TEST_ASSERT(ev != NULL, "worker span present");
+  TEST_ASSERT(event_int(ev, "tid") != (int)gettid(), "worker on own track");
+
+  ev = find_event(doc, "from child", "i");
+  TEST_ASSERT(ev != NULL, "child event present");
+  TEST_ASSERT(event_int(ev, "pid") == (int)child, "child pid");
+
+  TEST_ASSERT(has_name(doc, "process_name", self, "bongocat"),
+              "process named");
+  TEST_ASSERT(has_name(doc, "process_name", (int)child,
+                       "bongocat input child"),
+              "child process named");
+  TEST_ASSERT(has_name(doc, "thread_name", self, "main"), "main named");
+  TEST_ASSERT(has_name(doc, "thread_name", self, "worker"), "worker named");
+  TEST_ASSERT(has_name(doc, "thread_name", (int)child, "child"),
+              "child thread named");
+  free(doc);
+
+  // A second write replaces the first and keeps everything so far
+  trace_instant("later");
+  TEST_ASSERT(trace_write() == BONGOCAT_SUCCESS, "trace rewritten");
+  doc = read_file(trace_file);
+  TEST_ASSERT(doc && count_events(doc, "sleep") == 1, "no duplicates");
+  TEST_ASSERT(doc && find_event(doc, "later", "i") != NULL,
+              "new events added");
+  free(doc);
+
+  trace_cleanup();
+  TEST_ASSERT(!trace_enabled(), "off after cleanup");
+}
+
+// ---------------------------------------------------------------------------
+// Test: a full buffer drops and counts events instead of growing
+// ---------------------------------------------------------------------------
+static void *flood_thread([[maybe_unused]] void *arg) {
+  for (int i = 0; i < TRACE_EVENTS_PER_SLOT + 3; i++) {
+    trace_instant("flood");
+  }
+  return NULL;
+}
+
+static void *idle_thread([[maybe_unused]] void *arg) {
+  trace_instant("idle");
+  return NULL;
+}
+
+static void test_drops(void) {
+  printf("test_drops...\n");
+  TEST_ASSERT(trace_init(trace_file) == BONGOCAT_SUCCESS, "trace started");
+
+  pthread_t thread;
+  pthread_create(&thread, NULL, flood_thread, NULL);
+  pthread_join(thread, NULL);
+  // One slot is taken; every further thread beyond the limit is untraced
+  for (int i = 0; i < TRACE_MAX_THREADS + 1; i++) {
+    pthread_create(&thread, NULL, idle_thread, NULL);
+    pthread_join(thread, NULL);
+  }
+  TEST_ASSERT(trace_write() == BONGOCAT_SUCCESS, "trace written");
+
+  char *doc = read_file(trace_file);
+  TEST_ASSERT(doc != NULL, "trace readable");
+  TEST_ASSERT(count_events(doc, "flood") == TRACE_EVENTS_PER_SLOT,
+              "full buffer kept");
+  TEST_ASSERT(count_events(doc, "idle") == TRACE_MAX_THREADS - 1,
+              "one event per traced thread");
+
+  const char *other = json_object_get(doc, "otherData");
+  char value[32] = "";
+  json_get_string(json_object_get(other, "dropped_events"), value,
+                  sizeof(value));
+  TEST_ASSERT(strcmp(value, "3") == 0, "drops counted");
+  json_get_string(json_object_get(other, "untraced_threads"), value,
+                  sizeof(value));
+  TEST_ASSERT(strcmp(value, "2") == 0, "untraced threads counted");
+  free(doc);
+
+  trace_cleanup();
+}
+
+int main(void) {
+  bongocat_error_init(0);
+  printf("=== Trace Tests ===\n");
+
+  snprintf(trace_file, sizeof(trace_file), "/tmp/bongocat-trace-%d.json",
+           (int)getpid());
+
+  test_disabled();
+  test_events();
+  test_drops();
+
+  unlink(trace_file);
+  printf("\nResults: %d passed, %d failed\n", tests_passed, tests_failed);
+  return tests_failed > 0 ? 1 : 0;
+}